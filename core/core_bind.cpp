@@ -68,8 +68,8 @@ static const unsigned int MONTH_DAYS_TABLE[2][12] = {
 
 _ResourceLoader *_ResourceLoader::singleton = nullptr;
 
-Error _ResourceLoader::load_threaded_request(const String &p_path, const String &p_type_hint, bool p_use_sub_threads) {
-	return ResourceLoader::load_threaded_request(p_path, p_type_hint, p_use_sub_threads);
+Error _ResourceLoader::load_threaded_request(const String &p_path, const String &p_type_hint, bool p_use_sub_threads, int p_priority) {
+	return ResourceLoader::load_threaded_request(p_path, p_type_hint, p_use_sub_threads, p_priority);
 }
 
 _ResourceLoader::ThreadLoadStatus _ResourceLoader::load_threaded_get_status(const String &p_path, Array r_progress) {
@@ -86,6 +86,14 @@ RES _ResourceLoader::load_threaded_get(const String &p_path) {
 	return res;
 }
 
+Error _ResourceLoader::load_threaded_cancel(const String &p_path) {
+	return ResourceLoader::load_threaded_cancel(p_path);
+}
+
+Error _ResourceLoader::load_threaded_set_priority(const String &p_path, int p_priority) {
+	return ResourceLoader::load_threaded_set_priority(p_path, p_priority);
+}
+
 RES _ResourceLoader::load(const String &p_path, const String &p_type_hint, bool p_no_cache) {
 	Error err = OK;
 	RES ret = ResourceLoader::load(p_path, p_type_hint, p_no_cache, &err);
@@ -131,9 +139,11 @@ bool _ResourceLoader::exists(const String &p_path, const String &p_type_hint) {
 }
 
 void _ResourceLoader::_bind_methods() {
-	ClassDB::bind_method(D_METHOD("load_threaded_request", "path", "type_hint", "use_sub_threads"), &_ResourceLoader::load_threaded_request, DEFVAL(""), DEFVAL(false));
+	ClassDB::bind_method(D_METHOD("load_threaded_request", "path", "type_hint", "use_sub_threads", "priority"), &_ResourceLoader::load_threaded_request, DEFVAL(""), DEFVAL(false), DEFVAL(0));
 	ClassDB::bind_method(D_METHOD("load_threaded_get_status", "path", "progress"), &_ResourceLoader::load_threaded_get_status, DEFVAL(Array()));
 	ClassDB::bind_method(D_METHOD("load_threaded_get", "path"), &_ResourceLoader::load_threaded_get);
+	ClassDB::bind_method(D_METHOD("load_threaded_cancel", "path"), &_ResourceLoader::load_threaded_cancel);
+	ClassDB::bind_method(D_METHOD("load_threaded_set_priority", "path", "priority"), &_ResourceLoader::load_threaded_set_priority);
 
 	ClassDB::bind_method(D_METHOD("load", "path", "type_hint", "no_cache"), &_ResourceLoader::load, DEFVAL(""), DEFVAL(false));
 	ClassDB::bind_method(D_METHOD("get_recognized_extensions_for_type", "type"), &_ResourceLoader::get_recognized_extensions_for_type);
@@ -58,9 +58,11 @@ public:
 
 	static _ResourceLoader *get_singleton() { return singleton; }
 
-	Error load_threaded_request(const String &p_path, const String &p_type_hint = "", bool p_use_sub_threads = false);
+	Error load_threaded_request(const String &p_path, const String &p_type_hint = "", bool p_use_sub_threads = false, int p_priority = 0);
 	ThreadLoadStatus load_threaded_get_status(const String &p_path, Array r_progress = Array());
 	RES load_threaded_get(const String &p_path);
+	Error load_threaded_cancel(const String &p_path);
+	Error load_threaded_set_priority(const String &p_path, int p_priority);
 
 	RES load(const String &p_path, const String &p_type_hint = "", bool p_no_cache = false);
 	Vector<String> get_recognized_extensions_for_type(const String &p_type);
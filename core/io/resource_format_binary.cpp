@@ -314,11 +314,25 @@ Error ResourceLoaderBinary::parse_variant(Variant &r_v) {
 					String path = res_path + "::" + itos(index);
 
 					if (use_nocache) {
+						if (load_on_demand && !internal_index_cache.has(path)) {
+							//not loaded by this loader yet, materialize it on first access
+							Error err = _load_internal_resource_on_demand(index);
+							if (err != OK) {
+								return err;
+							}
+						}
 						if (!internal_index_cache.has(path)) {
 							WARN_PRINT(String("Couldn't load resource (no cache): " + path).utf8().get_data());
 						}
 						r_v = internal_index_cache[path];
 					} else {
+						if (load_on_demand && !ResourceCache::has(path)) {
+							//materialize it on first access
+							Error err = _load_internal_resource_on_demand(index);
+							if (err != OK) {
+								return err;
+							}
+						}
 						RES res = ResourceLoader::load(path);
 						if (res.is_null()) {
 							WARN_PRINT(String("Couldn't load resource: " + path).utf8().get_data());
@@ -360,11 +374,15 @@ Error ResourceLoaderBinary::parse_variant(Variant &r_v) {
 					} else {
 						if (external_resources[erindex].cache.is_null()) {
 							//cache not here yet, wait for it?
-							if (use_sub_threads) {
-								Error err;
-								external_resources.write[erindex].cache = ResourceLoader::load_threaded_get(external_resources[erindex].path, &err);
+							if (external_resources[erindex].pending) {
+								Error err = _join_external_resource(erindex);
+								if (err != OK) {
+									return err;
+								}
+							} else if (load_on_demand) {
+								external_resources.write[erindex].cache = ResourceLoader::load(external_resources[erindex].path, external_resources[erindex].type);
 
-								if (err != OK || external_resources[erindex].cache.is_null()) {
+								if (external_resources[erindex].cache.is_null()) {
 									if (!ResourceLoader::get_abort_on_missing_resources()) {
 										ResourceLoader::notify_dependency_error(local_path, external_resources[erindex].path, external_resources[erindex].type);
 									} else {
@@ -611,13 +629,135 @@ Ref<Resource> ResourceLoaderBinary::get_resource() {
 	return resource;
 }
 
-Error ResourceLoaderBinary::load() {
-	if (error != OK) {
-		return error;
+String ResourceLoaderBinary::_get_internal_path(int p_index, int *r_subindex) const {
+	String path = internal_resources[p_index].path;
+
+	if (path.begins_with("local://")) {
+		path = path.replace_first("local://", "");
+		if (r_subindex) {
+			*r_subindex = path.to_int();
+		}
+		path = res_path + "::" + path;
 	}
 
-	int stage = 0;
+	return path;
+}
+
+Error ResourceLoaderBinary::_load_internal_resource(int p_index, RES &r_resource) {
+	bool main = p_index == (internal_resources.size() - 1);
+
+	String path;
+	int subindex = 0;
+
+	if (!main) {
+		path = _get_internal_path(p_index, &subindex);
+	} else {
+		if (!use_nocache && !ResourceCache::has(res_path)) {
+			path = res_path;
+		}
+	}
+
+	uint64_t offset = internal_resources[p_index].offset;
+
+	f->seek(offset);
+
+	String t = get_unicode_string();
+
+	Object *obj = ClassDB::instance(t);
+	if (!obj) {
+		error = ERR_FILE_CORRUPT;
+		ERR_FAIL_V_MSG(ERR_FILE_CORRUPT, local_path + ":Resource of unrecognized type in file: " + t + ".");
+	}
+
+	Resource *r = Object::cast_to<Resource>(obj);
+	if (!r) {
+		String obj_class = obj->get_class();
+		error = ERR_FILE_CORRUPT;
+		memdelete(obj); //bye
+		ERR_FAIL_V_MSG(ERR_FILE_CORRUPT, local_path + ":Resource type in resource field not a resource, type is: " + obj_class + ".");
+	}
+
+	RES res = RES(r);
+
+	if (path != String()) {
+		r->set_path(path);
+	}
+	r->set_subindex(subindex);
+
+	if (!main) {
+		internal_index_cache[path] = res;
+	}
+
+	int pc = f->get_32();
+
+	//set properties
+
+	for (int j = 0; j < pc; j++) {
+		StringName name = _get_string();
+
+		if (name == StringName()) {
+			error = ERR_FILE_CORRUPT;
+			ERR_FAIL_V(ERR_FILE_CORRUPT);
+		}
+
+		Variant value;
+
+		error = parse_variant(value);
+		if (error) {
+			return error;
+		}
+
+		res->set(name, value);
+	}
+#ifdef TOOLS_ENABLED
+	res->set_edited(false);
+#endif
+
+	resource_cache.push_back(res);
+	r_resource = res;
 
+	return OK;
+}
+
+int ResourceLoaderBinary::_find_internal_resource(int p_subindex) const {
+	const int *index = internal_subindices.getptr(p_subindex);
+	return index ? *index : -1;
+}
+
+Error ResourceLoaderBinary::_load_internal_resource_on_demand(int p_subindex) {
+	int index = _find_internal_resource(p_subindex);
+	ERR_FAIL_COND_V_MSG(index == -1, ERR_FILE_CORRUPT, local_path + ": Sub-resource not found: " + itos(p_subindex) + ".");
+
+	// The position is restored afterwards, as this can happen while parsing another resource.
+	uint64_t pos = f->get_position();
+
+	RES res;
+	Error err = _load_internal_resource(index, res);
+
+	f->seek(pos);
+	return err;
+}
+
+Error ResourceLoaderBinary::_join_external_resource(int p_index) {
+	ExtResource &er = external_resources.write[p_index];
+	er.pending = false;
+
+	Error err;
+	er.cache = ResourceLoader::load_threaded_get(er.path, &err);
+
+	if (err != OK || er.cache.is_null()) {
+		if (!ResourceLoader::get_abort_on_missing_resources()) {
+			ResourceLoader::notify_dependency_error(local_path, er.path, er.type);
+		} else {
+			error = ERR_FILE_MISSING_DEPENDENCIES;
+			ERR_FAIL_V_MSG(error, "Can't load dependency: " + er.path + ".");
+		}
+	}
+
+	return OK;
+}
+
+void ResourceLoaderBinary::_remap_external_resources() {
 	for (int i = 0; i < external_resources.size(); i++) {
 		String path = external_resources[i].path;
 
@@ -631,6 +771,20 @@ Error ResourceLoaderBinary::load() {
 		}
 
 		external_resources.write[i].path = path; //remap happens here, not on load because on load it can actually be used for filesystem dock resource remap
+	}
+}
+
+Error ResourceLoaderBinary::load() {
+	if (error != OK) {
+		return error;
+	}
+
+	int stage = 0;
+
+	_remap_external_resources();
+
+	for (int i = 0; i < external_resources.size(); i++) {
+		String path = external_resources[i].path;
 
 		if (!use_sub_threads) {
 			external_resources.write[i].cache = ResourceLoader::load(path, external_resources[i].type);
@@ -645,8 +799,11 @@ Error ResourceLoaderBinary::load() {
 			}
 
 		} else {
-			Error err = ResourceLoader::load_threaded_request(path, external_resources[i].type, use_sub_threads, local_path);
-			if (err != OK) {
+			Error err = ResourceLoader::load_threaded_request(path, external_resources[i].type, use_sub_threads, 0, local_path);
+			if (err == OK) {
+				//loads concurrently with the internal resources, joined on first use
+				external_resources.write[i].pending = true;
+			} else {
 				if (!ResourceLoader::get_abort_on_missing_resources()) {
 					ResourceLoader::notify_dependency_error(local_path, path, external_resources[i].type);
 				} else {
@@ -663,95 +820,40 @@ Error ResourceLoaderBinary::load() {
 		bool main = i == (internal_resources.size() - 1);
 
 		//maybe it is loaded already
-		String path;
-		int subindex = 0;
-
-		if (!main) {
-			path = internal_resources[i].path;
-
-			if (path.begins_with("local://")) {
-				path = path.replace_first("local://", "");
-				subindex = path.to_int();
-				path = res_path + "::" + path;
+		if (!main && !use_nocache) {
+			if (ResourceCache::has(_get_internal_path(i))) {
+				//already loaded, don't do anything
+				stage++;
+				error = OK;
+				continue;
 			}
+		}
 
-			if (!use_nocache) {
-				if (ResourceCache::has(path)) {
-					//already loaded, don't do anything
-					stage++;
-					error = OK;
-					continue;
+		if (main) {
+			//every dependency loading in a thread must be done before the main resource is assembled,
+			//including the ones not referenced by any property, so their tasks are not left behind
+			for (int j = 0; j < external_resources.size(); j++) {
+				if (external_resources[j].pending) {
+					Error err = _join_external_resource(j);
+					if (err != OK) {
+						return err;
+					}
 				}
 			}
-		} else {
-			if (!use_nocache && !ResourceCache::has(res_path)) {
-				path = res_path;
-			}
 		}
 
-		uint64_t offset = internal_resources[i].offset;
-
-		f->seek(offset);
-
-		String t = get_unicode_string();
-
-		Object *obj = ClassDB::instance(t);
-		if (!obj) {
-			error = ERR_FILE_CORRUPT;
-			ERR_FAIL_V_MSG(ERR_FILE_CORRUPT, local_path + ":Resource of unrecognized type in file: " + t + ".");
-		}
-
-		Resource *r = Object::cast_to<Resource>(obj);
-		if (!r) {
-			String obj_class = obj->get_class();
-			error = ERR_FILE_CORRUPT;
-			memdelete(obj); //bye
-			ERR_FAIL_V_MSG(ERR_FILE_CORRUPT, local_path + ":Resource type in resource field not a resource, type is: " + obj_class + ".");
-		}
-
-		RES res = RES(r);
-
-		if (path != String()) {
-			r->set_path(path);
-		}
-		r->set_subindex(subindex);
-
-		if (!main) {
-			internal_index_cache[path] = res;
+		RES res;
+		Error err = _load_internal_resource(i, res);
+		if (err != OK) {
+			return err;
 		}
 
-		int pc = f->get_32();
-
-		//set properties
-
-		for (int j = 0; j < pc; j++) {
-			StringName name = _get_string();
-
-			if (name == StringName()) {
-				error = ERR_FILE_CORRUPT;
-				ERR_FAIL_V(ERR_FILE_CORRUPT);
-			}
-
-			Variant value;
-
-			error = parse_variant(value);
-			if (error) {
-				return error;
-			}
-
-			res->set(name, value);
-		}
-#ifdef TOOLS_ENABLED
-		res->set_edited(false);
-#endif
 		stage++;
 
 		if (progress) {
 			*progress = (i + 1) / float(internal_resources.size());
 		}
 
-		resource_cache.push_back(res);
-
 		if (main) {
 			f->close();
 			resource = res;
@@ -764,6 +866,39 @@ Error ResourceLoaderBinary::load() {
 	return ERR_FILE_EOF;
 }
 
+Error ResourceLoaderBinary::load_sub_resource(int p_subindex) {
+	if (error != OK) {
+		return error;
+	}
+
+	// Only what the requested sub-resource references is loaded, on first access,
+	// so the rest of the file (including the main resource) is never parsed.
+	load_on_demand = true;
+
+	_remap_external_resources();
+
+	int index = _find_internal_resource(p_subindex);
+	if (index == -1) {
+		error = ERR_DOES_NOT_EXIST;
+		ERR_FAIL_V_MSG(error, local_path + ": Sub-resource not found: " + itos(p_subindex) + ".");
+	}
+
+	RES res;
+	Error err = _load_internal_resource(index, res);
+	if (err != OK) {
+		return err;
+	}
+
+	if (progress) {
+		*progress = 1.0;
+	}
+
+	f->close();
+	resource = res;
+	error = OK;
+	return OK;
+}
+
 void ResourceLoaderBinary::set_translation_remapped(bool p_remapped) {
 	translation_remapped = p_remapped;
 }
@@ -903,6 +1038,15 @@ void ResourceLoaderBinary::open(FileAccess *p_f) {
 		internal_resources.push_back(ir);
 	}
 
+	//the main resource is last and has no subindex
+	for (int i = 0; i < internal_resources.size() - 1; i++) {
+		int subindex = 0;
+		_get_internal_path(i, &subindex);
+		if (!internal_subindices.has(subindex)) {
+			internal_subindices[subindex] = i;
+		}
+	}
+
 	print_bl("int resources: " + itos(int_resources_size));
 
 	if (f->eof_reached()) {
@@ -961,27 +1105,52 @@ ResourceLoaderBinary::~ResourceLoaderBinary() {
 	}
 }
 
+bool ResourceFormatLoaderBinary::recognize_path(const String &p_path, const String &p_for_type) const {
+	// Sub-resources can be loaded on their own with a "path::subindex" path.
+	int sub_pos = p_path.find("::");
+	if (sub_pos != -1) {
+		return ResourceFormatLoader::recognize_path(p_path.substr(0, sub_pos), p_for_type);
+	}
+	return ResourceFormatLoader::recognize_path(p_path, p_for_type);
+}
+
 RES ResourceFormatLoaderBinary::load(const String &p_path, const String &p_original_path, Error *r_error, bool p_use_sub_threads, float *r_progress, bool p_no_cache) {
 	if (r_error) {
 		*r_error = ERR_FILE_CANT_OPEN;
 	}
 
+	String file_path = p_path;
+	String path = p_original_path != "" ? p_original_path : p_path;
+	int subindex = -1;
+
+	int sub_pos = file_path.find("::");
+	if (sub_pos != -1) {
+		subindex = file_path.substr(sub_pos + 2, file_path.length()).to_int();
+		file_path = file_path.substr(0, sub_pos);
+		if (path.find("::") != -1) {
+			path = path.substr(0, path.find("::"));
+		}
+	}
+
 	Error err;
-	FileAccess *f = FileAccess::open(p_path, FileAccess::READ, &err);
+	FileAccess *f = FileAccess::open(file_path, FileAccess::READ, &err);
 
-	ERR_FAIL_COND_V_MSG(err != OK, RES(), "Cannot open file '" + p_path + "'.");
+	ERR_FAIL_COND_V_MSG(err != OK, RES(), "Cannot open file '" + file_path + "'.");
 
 	ResourceLoaderBinary loader;
 	loader.use_nocache = p_no_cache;
 	loader.use_sub_threads = p_use_sub_threads;
 	loader.progress = r_progress;
-	String path = p_original_path != "" ? p_original_path : p_path;
 	loader.local_path = ProjectSettings::get_singleton()->localize_path(path);
 	loader.res_path = loader.local_path;
 	//loader.set_local_path( Globals::get_singleton()->localize_path(p_path) );
 	loader.open(f);
 
-	err = loader.load();
+	if (subindex != -1) {
+		err = loader.load_sub_resource(subindex);
+	} else {
+		err = loader.load();
+	}
 
 	if (r_error) {
 		*r_error = err;
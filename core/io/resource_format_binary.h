@@ -58,6 +58,7 @@ class ResourceLoaderBinary {
 		String path;
 		String type;
 		RES cache;
+		bool pending = false;
 	};
 
 	bool use_sub_threads = false;
@@ -70,6 +71,7 @@ class ResourceLoaderBinary {
 	};
 
 	Vector<IntResource> internal_resources;
+	HashMap<int, int> internal_subindices; // Subindex to internal resource index, for on demand loading.
 	Map<String, RES> internal_index_cache;
 
 	String get_unicode_string();
@@ -79,17 +81,26 @@ class ResourceLoaderBinary {
 	Error error = OK;
 
 	bool use_nocache = false;
+	bool load_on_demand = false;
 
 	friend class ResourceFormatLoaderBinary;
 
 	Error parse_variant(Variant &r_v);
 
+	String _get_internal_path(int p_index, int *r_subindex = nullptr) const;
+	Error _load_internal_resource(int p_index, RES &r_resource);
+	int _find_internal_resource(int p_subindex) const;
+	Error _load_internal_resource_on_demand(int p_subindex);
+	Error _join_external_resource(int p_index);
+	void _remap_external_resources();
+
 	Map<String, RES> dependency_cache;
 
 public:
 	void set_local_path(const String &p_local_path);
 	Ref<Resource> get_resource();
 	Error load();
+	Error load_sub_resource(int p_subindex);
 	void set_translation_remapped(bool p_remapped);
 
 	void set_remaps(const Map<String, String> &p_remaps) { remaps = p_remaps; }
@@ -103,6 +114,7 @@ public:
 
 class ResourceFormatLoaderBinary : public ResourceFormatLoader {
 public:
+	virtual bool recognize_path(const String &p_path, const String &p_for_type = String()) const;
 	virtual RES load(const String &p_path, const String &p_original_path = "", Error *r_error = nullptr, bool p_use_sub_threads = false, float *r_progress = nullptr, bool p_no_cache = false);
 	virtual void get_recognized_extensions_for_type(const String &p_type, List<String> *p_extensions) const;
 	virtual void get_recognized_extensions(List<String> *p_extensions) const;
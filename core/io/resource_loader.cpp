@@ -211,8 +211,12 @@ void ResourceLoader::_thread_load_function(void *p_userdata) {
 	load_task.loader_id = Thread::get_caller_id();
 
 	if (load_task.semaphore) {
-		//this is an actual thread, so wait for Ok fom semaphore
-		thread_load_semaphore->wait(); //wait until its ok to start loading
+		//this is an actual thread, so wait until the scheduler allows it to start loading
+		load_task.start_semaphore->wait();
+		if (load_task.cancelled && load_task.status == THREAD_LOAD_FAILED) {
+			//cancelled before it could start, the canceller is waiting to join this thread
+			return;
+		}
 	}
 	load_task.resource = _load(load_task.remapped_path, load_task.remapped_path != load_task.local_path ? load_task.local_path : String(), load_task.type_hint, false, &load_task.error, load_task.use_sub_threads, &load_task.progress);
 
@@ -225,21 +229,29 @@ void ResourceLoader::_thread_load_function(void *p_userdata) {
 		load_task.status = THREAD_LOAD_LOADED;
 	}
 	if (load_task.semaphore) {
-		if (load_task.start_next && thread_waiting_count > 0) {
-			thread_waiting_count--;
-			//thread loading count remains constant, this ends but another one begins
-			thread_load_semaphore->post();
-		} else {
+		//thread loading count remains constant if another one begins, this ends
+		if (!load_task.start_next || !_thread_load_start_next()) {
 			thread_loading_count--; //no threads waiting, just reduce loading count
 		}
 
-		print_lt("END: load count: " + itos(thread_loading_count) + " / wait count: " + itos(thread_waiting_count) + " / suspended count: " + itos(thread_suspended_count) + " / active: " + itos(thread_loading_count - thread_suspended_count));
+		print_lt("END: load count: " + itos(thread_loading_count) + " / wait count: " + itos(thread_load_queue.size()) + " / suspended count: " + itos(thread_suspended_count) + " / active: " + itos(thread_loading_count - thread_suspended_count));
 
 		for (int i = 0; i < load_task.poll_requests; i++) {
 			load_task.semaphore->post();
 		}
 		memdelete(load_task.semaphore);
 		load_task.semaphore = nullptr;
+		memdelete(load_task.start_semaphore);
+		load_task.start_semaphore = nullptr;
+
+		if (load_task.cancelled) {
+			//nobody wants this resource anymore, release it now, this thread is joined on the next scheduler call
+			thread_load_finished.push_back(load_task.thread);
+			String local_path = load_task.local_path;
+			thread_load_tasks.erase(local_path);
+			thread_load_mutex->unlock();
+			return;
+		}
 	}
 
 	if (load_task.resource.is_valid()) {
@@ -267,7 +279,59 @@ void ResourceLoader::_thread_load_function(void *p_userdata) {
 	thread_load_mutex->unlock();
 }
 
-Error ResourceLoader::load_threaded_request(const String &p_path, const String &p_type_hint, bool p_use_sub_threads, const String &p_source_resource) {
+void ResourceLoader::_thread_load_start(ThreadLoadTask *p_task) {
+	//thread_load_mutex must be locked
+	thread_load_started_count++;
+	thread_load_wait_time_usec += OS::get_singleton()->get_ticks_usec() - p_task->request_time;
+	p_task->start_semaphore->post();
+}
+
+bool ResourceLoader::_thread_load_start_next(ThreadLoadTask *p_preferred) {
+	//thread_load_mutex must be locked
+	if (thread_load_queue.size() == 0) {
+		return false;
+	}
+
+	int64_t index = p_preferred ? thread_load_queue.find(p_preferred) : -1;
+	if (index < 0) {
+		//pick the highest priority, the queue is in request order so ties start the oldest request first
+		index = 0;
+		for (uint32_t i = 1; i < thread_load_queue.size(); i++) {
+			if (thread_load_queue[i]->priority > thread_load_queue[index]->priority) {
+				index = i;
+			}
+		}
+	}
+
+	ThreadLoadTask *task = thread_load_queue[index];
+	thread_load_queue.remove(index);
+	_thread_load_start(task);
+	return true;
+}
+
+void ResourceLoader::_thread_load_set_priority(ThreadLoadTask &p_task, int p_priority) {
+	//thread_load_mutex must be locked
+	p_task.priority = p_priority;
+
+	//sub-resources must be loaded before their owner can finish, so never leave them behind it
+	for (Set<String>::Element *E = p_task.sub_tasks.front(); E; E = E->next()) {
+		ThreadLoadTask *sub_task = thread_load_tasks.getptr(E->get());
+		if (sub_task && sub_task->priority < p_priority) {
+			_thread_load_set_priority(*sub_task, p_priority);
+		}
+	}
+}
+
+void ResourceLoader::_thread_load_join_finished() {
+	//thread_load_mutex must be locked
+	for (uint32_t i = 0; i < thread_load_finished.size(); i++) {
+		Thread::wait_to_finish(thread_load_finished[i]);
+		memdelete(thread_load_finished[i]);
+	}
+	thread_load_finished.clear();
+}
+
+Error ResourceLoader::load_threaded_request(const String &p_path, const String &p_type_hint, bool p_use_sub_threads, int p_priority, const String &p_source_resource) {
 	String local_path;
 	if (p_path.is_rel_path()) {
 		local_path = "res://" + p_path;
@@ -277,6 +341,8 @@ Error ResourceLoader::load_threaded_request(const String &p_path, const String &
 
 	thread_load_mutex->lock();
 
+	_thread_load_join_finished();
+
 	if (p_source_resource != String()) {
 		//must be loading from this resource
 		if (!thread_load_tasks.has(p_source_resource)) {
@@ -296,8 +362,22 @@ Error ResourceLoader::load_threaded_request(const String &p_path, const String &
 		}
 	}
 
+	if (p_source_resource != String()) {
+		//sub-resources inherit the priority of the resource that depends on them
+		p_priority = MAX(p_priority, thread_load_tasks[p_source_resource].priority);
+	}
+
 	if (thread_load_tasks.has(local_path)) {
-		thread_load_tasks[local_path].requests++;
+		ThreadLoadTask &load_task = thread_load_tasks[local_path];
+		if (load_task.cancelled) {
+			//still loading from a cancelled request, just take it over
+			load_task.cancelled = false;
+			load_task.priority = p_priority;
+		}
+		load_task.requests++;
+		if (load_task.priority < p_priority) {
+			_thread_load_set_priority(load_task, p_priority);
+		}
 		if (p_source_resource != String()) {
 			thread_load_tasks[p_source_resource].sub_tasks.insert(local_path);
 		}
@@ -315,6 +395,7 @@ Error ResourceLoader::load_threaded_request(const String &p_path, const String &
 		load_task.local_path = local_path;
 		load_task.type_hint = p_type_hint;
 		load_task.use_sub_threads = p_use_sub_threads;
+		load_task.priority = p_priority;
 
 		{ //must check if resource is already loaded before attempting to load it in a thread
 
@@ -353,14 +434,16 @@ Error ResourceLoader::load_threaded_request(const String &p_path, const String &
 	if (load_task.resource.is_null()) { //needs  to be loaded in thread
 
 		load_task.semaphore = memnew(Semaphore);
+		load_task.start_semaphore = memnew(Semaphore);
+		load_task.request_time = OS::get_singleton()->get_ticks_usec();
 		if (thread_loading_count < thread_load_max) {
 			thread_loading_count++;
-			thread_load_semaphore->post(); //we have free threads, so allow one
+			_thread_load_start(&load_task); //we have free threads, so allow one
 		} else {
-			thread_waiting_count++;
+			thread_load_queue.push_back(&load_task);
 		}
 
-		print_lt("REQUEST: load count: " + itos(thread_loading_count) + " / wait count: " + itos(thread_waiting_count) + " / suspended count: " + itos(thread_suspended_count) + " / active: " + itos(thread_loading_count - thread_suspended_count));
+		print_lt("REQUEST: load count: " + itos(thread_loading_count) + " / wait count: " + itos(thread_load_queue.size()) + " / suspended count: " + itos(thread_suspended_count) + " / active: " + itos(thread_loading_count - thread_suspended_count));
 
 		load_task.thread = Thread::create(_thread_load_function, &thread_load_tasks[local_path]);
 		load_task.loader_id = load_task.thread->get_id();
@@ -402,7 +485,7 @@ ResourceLoader::ThreadLoadStatus ResourceLoader::load_threaded_get_status(const
 	}
 
 	thread_load_mutex->lock();
-	if (!thread_load_tasks.has(local_path)) {
+	if (!thread_load_tasks.has(local_path) || thread_load_tasks[local_path].cancelled) {
 		thread_load_mutex->unlock();
 		return THREAD_LOAD_INVALID_RESOURCE;
 	}
@@ -427,7 +510,7 @@ RES ResourceLoader::load_threaded_get(const String &p_path, Error *r_error) {
 	}
 
 	thread_load_mutex->lock();
-	if (!thread_load_tasks.has(local_path)) {
+	if (!thread_load_tasks.has(local_path) || thread_load_tasks[local_path].cancelled) {
 		thread_load_mutex->unlock();
 		if (r_error) {
 			*r_error = ERR_INVALID_PARAMETER;
@@ -451,18 +534,19 @@ RES ResourceLoader::load_threaded_get(const String &p_path, Error *r_error) {
 			//
 			// This ensures loading is never blocked and that is also within
 			// the maximum number of active threads.
+			//
+			// If the resource we wait for is still queued, it is the one
+			// started, as nothing else can unblock this thread.
 
-			if (thread_waiting_count > 0) {
-				thread_waiting_count--;
+			if (_thread_load_start_next(&load_task)) {
 				thread_loading_count++;
-				thread_load_semaphore->post();
 
 				load_task.start_next = false; //do not start next since we are doing it here
 			}
 
 			thread_suspended_count++;
 
-			print_lt("GET: load count: " + itos(thread_loading_count) + " / wait count: " + itos(thread_waiting_count) + " / suspended count: " + itos(thread_suspended_count) + " / active: " + itos(thread_loading_count - thread_suspended_count));
+			print_lt("GET: load count: " + itos(thread_loading_count) + " / wait count: " + itos(thread_load_queue.size()) + " / suspended count: " + itos(thread_suspended_count) + " / active: " + itos(thread_loading_count - thread_suspended_count));
 		}
 
 		thread_load_mutex->unlock();
@@ -500,6 +584,104 @@ RES ResourceLoader::load_threaded_get(const String &p_path, Error *r_error) {
 	return resource;
 }
 
+Error ResourceLoader::load_threaded_cancel(const String &p_path) {
+	String local_path;
+	if (p_path.is_rel_path()) {
+		local_path = "res://" + p_path;
+	} else {
+		local_path = ProjectSettings::get_singleton()->localize_path(p_path);
+	}
+
+	thread_load_mutex->lock();
+
+	_thread_load_join_finished();
+
+	ThreadLoadTask *load_task = thread_load_tasks.getptr(local_path);
+	if (!load_task || load_task->cancelled) {
+		thread_load_mutex->unlock();
+		return ERR_INVALID_PARAMETER;
+	}
+
+	load_task->requests--;
+	if (load_task->requests > 0) {
+		//still requested from elsewhere, keep loading
+		thread_load_mutex->unlock();
+		return OK;
+	}
+
+	int64_t queue_index = thread_load_queue.find(load_task);
+	if (queue_index >= 0) {
+		//not started yet, so abort it right away
+		thread_load_queue.remove(queue_index);
+
+		load_task->cancelled = true;
+		load_task->status = THREAD_LOAD_FAILED;
+		load_task->start_semaphore->post();
+		Thread::wait_to_finish(load_task->thread);
+		memdelete(load_task->thread);
+		memdelete(load_task->semaphore);
+		memdelete(load_task->start_semaphore);
+		thread_load_tasks.erase(local_path);
+
+		print_lt("CANCEL: load count: " + itos(thread_loading_count) + " / wait count: " + itos(thread_load_queue.size()) + " / suspended count: " + itos(thread_suspended_count) + " / active: " + itos(thread_loading_count - thread_suspended_count));
+	} else if (load_task->status == THREAD_LOAD_IN_PROGRESS) {
+		//a running load can't be interrupted, discard the result once it ends
+		load_task->cancelled = true;
+	} else {
+		//already done, same as getting it and dropping the resource
+		if (load_task->thread) {
+			Thread::wait_to_finish(load_task->thread);
+			memdelete(load_task->thread);
+		}
+		thread_load_tasks.erase(local_path);
+	}
+
+	thread_load_mutex->unlock();
+
+	return OK;
+}
+
+Error ResourceLoader::load_threaded_set_priority(const String &p_path, int p_priority) {
+	String local_path;
+	if (p_path.is_rel_path()) {
+		local_path = "res://" + p_path;
+	} else {
+		local_path = ProjectSettings::get_singleton()->localize_path(p_path);
+	}
+
+	thread_load_mutex->lock();
+
+	ThreadLoadTask *load_task = thread_load_tasks.getptr(local_path);
+	if (!load_task || load_task->cancelled) {
+		thread_load_mutex->unlock();
+		return ERR_INVALID_PARAMETER;
+	}
+
+	_thread_load_set_priority(*load_task, p_priority);
+
+	thread_load_mutex->unlock();
+
+	return OK;
+}
+
+int ResourceLoader::load_threaded_get_queued_count() {
+	MutexLock lock(*thread_load_mutex);
+	return thread_load_queue.size();
+}
+
+int ResourceLoader::load_threaded_get_active_count() {
+	MutexLock lock(*thread_load_mutex);
+	return thread_loading_count - thread_suspended_count;
+}
+
+float ResourceLoader::load_threaded_get_average_wait_time() {
+	MutexLock lock(*thread_load_mutex);
+	if (thread_load_started_count == 0) {
+		return 0;
+	}
+	return (thread_load_wait_time_usec / double(thread_load_started_count)) / 1000000.0;
+}
+
 RES ResourceLoader::load(const String &p_path, const String &p_type_hint, bool p_no_cache, Error *r_error) {
 	if (r_error) {
 		*r_error = ERR_CANT_OPEN;
@@ -1093,14 +1275,16 @@ void ResourceLoader::initialize() {
 	thread_load_mutex = memnew(Mutex);
 	thread_load_max = OS::get_singleton()->get_processor_count();
 	thread_loading_count = 0;
-	thread_waiting_count = 0;
 	thread_suspended_count = 0;
-	thread_load_semaphore = memnew(Semaphore);
+	thread_load_started_count = 0;
+	thread_load_wait_time_usec = 0;
 }
 
 void ResourceLoader::finalize() {
+	thread_load_mutex->lock();
+	_thread_load_join_finished();
+	thread_load_mutex->unlock();
 	memdelete(thread_load_mutex);
-	memdelete(thread_load_semaphore);
 }
 
 ResourceLoadErrorNotify ResourceLoader::err_notify = nullptr;
@@ -1114,12 +1298,14 @@ bool ResourceLoader::timestamp_on_load = false;
 
 Mutex *ResourceLoader::thread_load_mutex = nullptr;
 HashMap<String, ResourceLoader::ThreadLoadTask> ResourceLoader::thread_load_tasks;
-Semaphore *ResourceLoader::thread_load_semaphore = nullptr;
+LocalVector<ResourceLoader::ThreadLoadTask *> ResourceLoader::thread_load_queue;
+LocalVector<Thread *> ResourceLoader::thread_load_finished;
 
 int ResourceLoader::thread_loading_count = 0;
-int ResourceLoader::thread_waiting_count = 0;
 int ResourceLoader::thread_suspended_count = 0;
 int ResourceLoader::thread_load_max = 0;
+uint64_t ResourceLoader::thread_load_started_count = 0;
+uint64_t ResourceLoader::thread_load_wait_time_usec = 0;
 
 SelfList<Resource>::List ResourceLoader::remapped_list;
 HashMap<String, Vector<String>> ResourceLoader::translation_remaps;
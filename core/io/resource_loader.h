@@ -34,6 +34,7 @@
 #include "core/io/resource.h"
 #include "core/os/semaphore.h"
 #include "core/os/thread.h"
+#include "core/templates/local_vector.h"
 
 class ResourceFormatLoader : public Reference {
 	GDCLASS(ResourceFormatLoader, Reference);
@@ -109,6 +110,7 @@ private:
 		Thread *thread = nullptr;
 		Thread::ID loader_id = 0;
 		Semaphore *semaphore = nullptr;
+		Semaphore *start_semaphore = nullptr;
 		String local_path;
 		String remapped_path;
 		String type_hint;
@@ -119,6 +121,9 @@ private:
 		bool xl_remapped = false;
 		bool use_sub_threads = false;
 		bool start_next = true;
+		bool cancelled = false;
+		int priority = 0;
+		uint64_t request_time = 0;
 		int requests = 0;
 		int poll_requests = 0;
 		Set<String> sub_tasks;
@@ -127,18 +132,30 @@ private:
 	static void _thread_load_function(void *p_userdata);
 	static Mutex *thread_load_mutex;
 	static HashMap<String, ThreadLoadTask> thread_load_tasks;
-	static Semaphore *thread_load_semaphore;
-	static int thread_waiting_count;
+	static LocalVector<ThreadLoadTask *> thread_load_queue;
+	static LocalVector<Thread *> thread_load_finished; // Of cancelled loads, to join.
 	static int thread_loading_count;
 	static int thread_suspended_count;
 	static int thread_load_max;
+	static uint64_t thread_load_started_count;
+	static uint64_t thread_load_wait_time_usec;
 
+	static void _thread_load_start(ThreadLoadTask *p_task);
+	static bool _thread_load_start_next(ThreadLoadTask *p_preferred = nullptr);
+	static void _thread_load_set_priority(ThreadLoadTask &p_task, int p_priority);
+	static void _thread_load_join_finished();
 	static float _dependency_get_progress(const String &p_path);
 
 public:
-	static Error load_threaded_request(const String &p_path, const String &p_type_hint = "", bool p_use_sub_threads = false, const String &p_source_resource = String());
+	static Error load_threaded_request(const String &p_path, const String &p_type_hint = "", bool p_use_sub_threads = false, int p_priority = 0, const String &p_source_resource = String());
 	static ThreadLoadStatus load_threaded_get_status(const String &p_path, float *r_progress = nullptr);
 	static RES load_threaded_get(const String &p_path, Error *r_error = nullptr);
+	static Error load_threaded_cancel(const String &p_path);
+	static Error load_threaded_set_priority(const String &p_path, int p_priority);
+
+	static int load_threaded_get_queued_count();
+	static int load_threaded_get_active_count();
+	static float load_threaded_get_average_wait_time();
 
 	static RES load(const String &p_path, const String &p_type_hint = "", bool p_no_cache = false, Error *r_error = nullptr);
 	static bool exists(const String &p_path, const String &p_type_hint = "");
@@ -426,6 +426,14 @@ int DynamicBVH::get_max_depth() const {
 	}
 }
 
+AABB DynamicBVH::get_bounds() const {
+	if (bvh_root) {
+		return AABB(bvh_root->volume.min, bvh_root->volume.max - bvh_root->volume.min);
+	} else {
+		return AABB();
+	}
+}
+
 DynamicBVH::~DynamicBVH() {
 	clear();
 }
@@ -289,6 +289,7 @@ public:
 
 	int get_leaf_count() const;
 	int get_max_depth() const;
+	AABB get_bounds() const;
 
 	/* Discouraged, but works as a reference on how it must be used */
 	struct DefaultQueryResult {
@@ -537,7 +537,7 @@ bool ClassDB::can_instance(const StringName &p_class) {
 	return (!ti->disabled && ti->creation_func != nullptr);
 }
 
-void ClassDB::_add_class2(const StringName &p_class, const StringName &p_inherits) {
+void ClassDB::_add_class2(const StringName &p_class, const StringName &p_inherits, bool p_call_overridden) {
 	OBJTYPE_WLOCK;
 
 	const StringName &name = p_class;
@@ -549,6 +549,7 @@ void ClassDB::_add_class2(const StringName &p_class, const StringName &p_inherit
 	ti.name = name;
 	ti.inherits = p_inherits;
 	ti.api = current_api;
+	ti.call_overridden = p_call_overridden;
 
 	if (ti.inherits) {
 		ERR_FAIL_COND(!classes.has(ti.inherits)); //it MUST be registered.
@@ -701,6 +702,54 @@ MethodBind *ClassDB::get_method(StringName p_class, StringName p_name) {
 	return nullptr;
 }
 
+const MethodCallCacheEntry *ClassDB::_get_method_cache_miss(MethodCallCache &r_cache, const StringName &p_class, const StringName &p_name) {
+	OBJTYPE_RLOCK;
+
+	ClassInfo *type = classes.getptr(p_class);
+	if (!type) {
+		return nullptr;
+	}
+
+	// Binding takes the write lock, so the version can't change while resolving.
+	uint32_t version = method_version.load(std::memory_order_acquire);
+	MethodCallCacheEntry *entry = nullptr;
+	{
+		MutexLock cache_lock(method_cache_mutex);
+
+		MethodCallCacheEntry **E = type->method_cache_entries.getptr(p_name);
+		if (E && (*E)->version == version) {
+			entry = *E;
+		} else {
+			entry = memnew(MethodCallCacheEntry);
+			entry->class_name = p_class;
+			entry->name = p_name;
+			entry->version = version;
+			entry->call_overridden = type->call_overridden;
+
+			ClassInfo *t = type;
+			while (t && !entry->method) {
+				MethodBind **method = t->method_map.getptr(p_name);
+				if (method) {
+					entry->method = *method;
+				}
+				t = t->inherits_ptr;
+			}
+
+			if (E) {
+				// Call site caches may still point to it.
+				retired_method_cache_entries.push_back(*E);
+				*E = entry;
+			} else {
+				type->method_cache_entries[p_name] = entry;
+			}
+		}
+	}
+
+	uint32_t slot = r_cache.next_entry.fetch_add(1, std::memory_order_relaxed) % MethodCallCache::SIZE;
+	r_cache.entries[slot].store(entry, std::memory_order_release);
+	return entry;
+}
+
 void ClassDB::bind_integer_constant(const StringName &p_class, const StringName &p_enum, const StringName &p_name, int p_constant) {
 	OBJTYPE_WLOCK;
 
@@ -1350,6 +1399,7 @@ MethodBind *ClassDB::bind_methodfi(uint32_t p_flags, MethodBind *p_bind, const c
 #endif
 
 	type->method_map[mdname] = p_bind;
+	method_version.fetch_add(1, std::memory_order_release);
 
 	Vector<Variant> defvals;
 
@@ -1542,6 +1592,9 @@ Variant ClassDB::class_get_default_property_value(const StringName &p_class, con
 }
 
 RWLock ClassDB::lock;
+std::atomic<uint32_t> ClassDB::method_version(0);
+Mutex ClassDB::method_cache_mutex;
+List<MethodCallCacheEntry *> ClassDB::retired_method_cache_entries;
 
 void ClassDB::cleanup_defaults() {
 	default_values.clear();
@@ -1560,7 +1613,17 @@ void ClassDB::cleanup() {
 		while ((m = ti.method_map.next(m))) {
 			memdelete(ti.method_map[*m]);
 		}
+
+		m = nullptr;
+		while ((m = ti.method_cache_entries.next(m))) {
+			memdelete(ti.method_cache_entries[*m]);
+		}
+	}
+	for (List<MethodCallCacheEntry *>::Element *E = retired_method_cache_entries.front(); E; E = E->next()) {
+		memdelete(E->get());
 	}
+	retired_method_cache_entries.clear();
+	method_version.fetch_add(1, std::memory_order_release);
 	classes.clear();
 	resource_base_extensions.clear();
 	compat_classes.clear();
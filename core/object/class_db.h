@@ -32,7 +32,9 @@
 #define CLASS_DB_H
 
 #include "core/object/method_bind.h"
+#include "core/object/method_call_cache.h"
 #include "core/object/object.h"
+#include "core/os/mutex.h"
 #include "core/string/print_string.h"
 
 /** To bind more then 6 parameters include this:
@@ -116,6 +118,7 @@ public:
 		void *class_ptr = nullptr;
 
 		HashMap<StringName, MethodBind *> method_map;
+		HashMap<StringName, MethodCallCacheEntry *> method_cache_entries; // Guarded by method_cache_mutex.
 		HashMap<StringName, int> constant_map;
 		HashMap<StringName, List<StringName>> enum_map;
 		HashMap<StringName, MethodInfo> signal_map;
@@ -135,6 +138,7 @@ public:
 		StringName name;
 		bool disabled = false;
 		bool exposed = false;
+		bool call_overridden = false; // Object::call() is overridden, so methods can't be called through their binds directly.
 		Object *(*creation_func)() = nullptr;
 
 		ClassInfo() {}
@@ -151,6 +155,12 @@ public:
 	static HashMap<StringName, StringName> resource_base_extensions;
 	static HashMap<StringName, StringName> compat_classes;
 
+	// Bumped whenever a method is bound, which invalidates all the resolutions
+	// made before in call site caches.
+	static std::atomic<uint32_t> method_version;
+	static Mutex method_cache_mutex;
+	static List<MethodCallCacheEntry *> retired_method_cache_entries;
+
 #ifdef DEBUG_METHODS_ENABLED
 	static MethodBind *bind_methodfi(uint32_t p_flags, MethodBind *p_bind, const MethodDefinition &method_name, const Variant **p_defs, int p_defcount);
 #else
@@ -159,7 +169,7 @@ public:
 
 	static APIType current_api;
 
-	static void _add_class2(const StringName &p_class, const StringName &p_inherits);
+	static void _add_class2(const StringName &p_class, const StringName &p_inherits, bool p_call_overridden);
 
 	static HashMap<StringName, HashMap<StringName, Variant>> default_values;
 	static Set<StringName> default_values_cached;
@@ -173,7 +183,7 @@ public:
 	// DO NOT USE THIS!!!!!! NEEDS TO BE PUBLIC BUT DO NOT USE NO MATTER WHAT!!!
 	template <class T>
 	static void _add_class() {
-		_add_class2(T::get_class_static(), T::get_parent_class_static());
+		_add_class2(T::get_class_static(), T::get_parent_class_static(), T::_is_call_overridden_static());
 	}
 
 	template <class T>
@@ -359,6 +369,27 @@ public:
 	static void get_method_list(StringName p_class, List<MethodInfo> *p_methods, bool p_no_inheritance = false, bool p_exclude_from_properties = false);
 	static bool get_method_info(StringName p_class, StringName p_method, MethodInfo *r_info, bool p_no_inheritance = false, bool p_exclude_from_properties = false);
 	static MethodBind *get_method(StringName p_class, StringName p_name);
+	static const MethodCallCacheEntry *_get_method_cache_miss(MethodCallCache &r_cache, const StringName &p_class, const StringName &p_name);
+
+	// Resolves a method through an inline cache. When the class was resolved
+	// recently through the same cache, it neither locks nor looks up any map.
+	// Returns nullptr if the class doesn't exist.
+	static _FORCE_INLINE_ const MethodCallCacheEntry *get_method_cache_entry(MethodCallCache &r_cache, const StringName &p_class, const StringName &p_name) {
+		uint32_t version = method_version.load(std::memory_order_acquire);
+		for (int i = 0; i < MethodCallCache::SIZE; i++) {
+			const MethodCallCacheEntry *entry = r_cache.entries[i].load(std::memory_order_acquire);
+			if (entry && entry->class_name == p_class && entry->name == p_name && entry->version == version) {
+				return entry;
+			}
+		}
+		return _get_method_cache_miss(r_cache, p_class, p_name);
+	}
+
+	// Same as get_method(), but through an inline cache (see get_method_cache_entry()).
+	static _FORCE_INLINE_ MethodBind *get_method_cached(MethodCallCache &r_cache, const StringName &p_class, const StringName &p_name) {
+		const MethodCallCacheEntry *entry = get_method_cache_entry(r_cache, p_class, p_name);
+		return entry ? entry->method : nullptr;
+	}
 
 	static void add_virtual_method(const StringName &p_class, const MethodInfo &p_method, bool p_virtual = true);
 	static void get_virtual_methods(const StringName &p_class, List<MethodInfo> *p_methods, bool p_no_inheritance = false);
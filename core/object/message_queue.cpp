@@ -34,12 +34,76 @@
 #include "core/core_string_names.h"
 #include "core/object/script_language.h"
 
+#include <thread>
+
 MessageQueue *MessageQueue::singleton = nullptr;
 
 MessageQueue *MessageQueue::get_singleton() {
 	return singleton;
 }
 
+MessageQueue::Page *MessageQueue::_alloc_page(uint32_t p_size) {
+	Page *page = memnew(Page);
+	page->next.store(nullptr, std::memory_order_relaxed);
+	page->write_pos.store(0, std::memory_order_relaxed);
+	page->size = p_size;
+	page->data = memnew_arr(uint8_t, p_size);
+	memset(page->data, 0, p_size);
+	return page;
+}
+
+void MessageQueue::_free_page(Page *p_page) {
+	memdelete_arr(p_page->data);
+	memdelete(p_page);
+}
+
+uint32_t MessageQueue::_get_message_size(const Message *p_message) {
+	uint32_t size = sizeof(Message);
+	if ((p_message->type & FLAG_MASK) != TYPE_NOTIFICATION) {
+		size += sizeof(Variant) * p_message->args;
+	}
+	return size;
+}
+
+uint8_t *MessageQueue::_reserve(uint32_t p_size) {
+	// Counted before loading the page, so pages are not recycled while in use here.
+	pushing.fetch_add(1, std::memory_order_seq_cst);
+	Page *page = write_page.load(std::memory_order_seq_cst);
+
+	while (true) {
+		uint32_t pos = page->write_pos.fetch_add(p_size, std::memory_order_acq_rel);
+		if (pos + p_size <= page->size) {
+			return page->data + pos;
+		}
+
+		if (pos + sizeof(Message) <= page->size) {
+			// The flushing thread has to know this room won't be used.
+			Message *end = (Message *)(page->data + pos);
+			end->state.store(STATE_PAGE_END, std::memory_order_release);
+		}
+
+		Page *next = page->next.load(std::memory_order_acquire);
+		if (!next) {
+			Page *new_page = _alloc_page(MAX(page_size, p_size));
+			if (page->next.compare_exchange_strong(next, new_page, std::memory_order_acq_rel)) {
+				next = new_page;
+			} else {
+				// Another thread linked one first, next was set to it.
+				_free_page(new_page);
+			}
+		}
+
+		Page *expected = page;
+		write_page.compare_exchange_strong(expected, next, std::memory_order_acq_rel);
+		page = next;
+	}
+}
+
+void MessageQueue::_publish(Message *p_message) {
+	p_message->state.store(STATE_READY, std::memory_order_release);
+	pushing.fetch_sub(1, std::memory_order_seq_cst);
+}
+
 Error MessageQueue::push_call(ObjectID p_id, const StringName &p_method, const Variant **p_args, int p_argcount, bool p_show_error) {
 	return push_callable(Callable(p_id, p_method), p_args, p_argcount, p_show_error);
 }
@@ -60,56 +124,32 @@ Error MessageQueue::push_call(ObjectID p_id, const StringName &p_method, VARIANT
 }
 
 Error MessageQueue::push_set(ObjectID p_id, const StringName &p_prop, const Variant &p_value) {
-	_THREAD_SAFE_METHOD_
-
-	uint8_t room_needed = sizeof(Message) + sizeof(Variant);
-
-	if ((buffer_end + room_needed) >= buffer_size) {
-		String type;
-		if (ObjectDB::get_instance(p_id)) {
-			type = ObjectDB::get_instance(p_id)->get_class();
-		}
-		print_line("Failed set: " + type + ":" + p_prop + " target ID: " + itos(p_id));
-		statistics();
-		ERR_FAIL_V_MSG(ERR_OUT_OF_MEMORY, "Message queue out of memory. Try increasing 'memory/limits/message_queue/max_size_kb' in project settings.");
-	}
+	uint32_t room_needed = sizeof(Message) + sizeof(Variant);
+	uint8_t *room = _reserve(room_needed);
 
-	Message *msg = memnew_placement(&buffer[buffer_end], Message);
+	Message *msg = memnew_placement(room, Message);
 	msg->args = 1;
 	msg->callable = Callable(p_id, p_prop);
 	msg->type = TYPE_SET;
 
-	buffer_end += sizeof(Message);
-
-	Variant *v = memnew_placement(&buffer[buffer_end], Variant);
-	buffer_end += sizeof(Variant);
+	Variant *v = memnew_placement(room + sizeof(Message), Variant);
 	*v = p_value;
 
+	_publish(msg);
 	return OK;
 }
 
 Error MessageQueue::push_notification(ObjectID p_id, int p_notification) {
-	_THREAD_SAFE_METHOD_
-
 	ERR_FAIL_COND_V(p_notification < 0, ERR_INVALID_PARAMETER);
 
-	uint8_t room_needed = sizeof(Message);
-
-	if ((buffer_end + room_needed) >= buffer_size) {
-		print_line("Failed notification: " + itos(p_notification) + " target ID: " + itos(p_id));
-		statistics();
-		ERR_FAIL_V_MSG(ERR_OUT_OF_MEMORY, "Message queue out of memory. Try increasing 'memory/limits/message_queue/max_size_kb' in project settings.");
-	}
-
-	Message *msg = memnew_placement(&buffer[buffer_end], Message);
+	Message *msg = memnew_placement(_reserve(sizeof(Message)), Message);
 
 	msg->type = TYPE_NOTIFICATION;
 	msg->callable = Callable(p_id, CoreStringNames::get_singleton()->notification); //name is meaningless but callable needs it
 	//msg->target;
 	msg->notification = p_notification;
 
-	buffer_end += sizeof(Message);
-
+	_publish(msg);
 	return OK;
 }
 
@@ -126,17 +166,12 @@ Error MessageQueue::push_set(Object *p_object, const StringName &p_prop, const V
 }
 
 Error MessageQueue::push_callable(const Callable &p_callable, const Variant **p_args, int p_argcount, bool p_show_error) {
-	_THREAD_SAFE_METHOD_
+	ERR_FAIL_COND_V(p_argcount < 0 || p_argcount > FLAG_MASK, ERR_INVALID_PARAMETER);
 
-	int room_needed = sizeof(Message) + sizeof(Variant) * p_argcount;
+	uint32_t room_needed = sizeof(Message) + sizeof(Variant) * p_argcount;
+	uint8_t *room = _reserve(room_needed);
 
-	if ((buffer_end + room_needed) >= buffer_size) {
-		print_line("Failed method: " + p_callable);
-		statistics();
-		ERR_FAIL_V_MSG(ERR_OUT_OF_MEMORY, "Message queue out of memory. Try increasing 'memory/limits/message_queue/max_size_kb' in project settings.");
-	}
-
-	Message *msg = memnew_placement(&buffer[buffer_end], Message);
+	Message *msg = memnew_placement(room, Message);
 	msg->args = p_argcount;
 	msg->callable = p_callable;
 	msg->type = TYPE_CALL;
@@ -144,14 +179,13 @@ Error MessageQueue::push_callable(const Callable &p_callable, const Variant **p_
 		msg->type |= FLAG_SHOW_ERROR;
 	}
 
-	buffer_end += sizeof(Message);
-
+	Variant *args = (Variant *)(room + sizeof(Message));
 	for (int i = 0; i < p_argcount; i++) {
-		Variant *v = memnew_placement(&buffer[buffer_end], Variant);
-		buffer_end += sizeof(Variant);
+		Variant *v = memnew_placement(&args[i], Variant);
 		*v = *p_args[i];
 	}
 
+	_publish(msg);
 	return OK;
 }
 
@@ -170,61 +204,168 @@ Error MessageQueue::push_callable(const Callable &p_callable, VARIANT_ARG_DECLAR
 	return push_callable(p_callable, argptr, argc);
 }
 
+MessageQueue::Message *MessageQueue::_next_message() {
+	while (true) {
+		Page *page = read_page;
+		uint32_t end = page->sealed ? page->sealed_end : MIN(page->write_pos.load(std::memory_order_acquire), page->size);
+
+		if (read_pos + sizeof(Message) <= end) {
+			Message *message = (Message *)(page->data + read_pos);
+			uint32_t state = message->state.load(std::memory_order_acquire);
+			while (state == STATE_EMPTY) {
+				// Reserved, but another thread is still writing it.
+				std::this_thread::yield();
+				state = message->state.load(std::memory_order_acquire);
+			}
+
+			if (state == STATE_READY) {
+				return message;
+			}
+
+			// The rest of the page is unused.
+			message->state.store(STATE_EMPTY, std::memory_order_relaxed);
+			read_pos = page->size;
+		} else if (!page->sealed && page->write_pos.load(std::memory_order_acquire) < page->size) {
+			return nullptr; // Read everything pushed so far.
+		}
+
+		Page *next = page->next.load(std::memory_order_acquire);
+		if (!next) {
+			return nullptr; // A producer is linking the next page.
+		}
+
+		retired_pages.push_back(page);
+		read_page = next;
+		read_pos = 0;
+	}
+}
+
+void MessageQueue::_destroy_message(Message *p_message) {
+	uint32_t size = _get_message_size(p_message);
+
+	if ((p_message->type & FLAG_MASK) != TYPE_NOTIFICATION) {
+		Variant *args = (Variant *)(p_message + 1);
+		for (int i = 0; i < p_message->args; i++) {
+			args[i].~Variant();
+		}
+	}
+	p_message->~Message();
+
+	// So the room can be reserved again once the page is recycled.
+	memset((void *)p_message, 0, size);
+}
+
+void MessageQueue::_recycle_pages() {
+	if (read_pos > 0 && !read_page->sealed) {
+		// Continue in another page, so this one can be recycled once read.
+		Page *page = read_page;
+		Page *spare = nullptr;
+		if (spare_pages.size()) {
+			spare = spare_pages[spare_pages.size() - 1];
+			spare_pages.resize(spare_pages.size() - 1);
+		} else {
+			spare = _alloc_page(page_size);
+		}
+
+		Page *next = nullptr;
+		if (!page->next.compare_exchange_strong(next, spare, std::memory_order_acq_rel)) {
+			spare_pages.push_back(spare); // A producer linked one already.
+		}
+
+		// Producers reserving from now on won't fit, and move on to the next page.
+		uint32_t reserved = page->write_pos.fetch_add(page->size, std::memory_order_acq_rel);
+		page->sealed_end = MIN(reserved, page->size);
+		page->sealed = true;
+
+		Page *expected = page;
+		write_page.compare_exchange_strong(expected, page->next.load(std::memory_order_acquire), std::memory_order_acq_rel);
+	}
+
+	if (retired_pages.size() == 0 || pushing.load(std::memory_order_seq_cst) != 0) {
+		return;
+	}
+
+	// No producer is pushing, so none can still hold a retired page: new pushes start from the write page.
+	for (uint32_t i = 0; i < retired_pages.size(); i++) {
+		Page *page = retired_pages[i];
+		if (page->size == page_size && spare_pages.size() < MAX_SPARE_PAGES) {
+			page->next.store(nullptr, std::memory_order_relaxed);
+			page->write_pos.store(0, std::memory_order_relaxed);
+			page->sealed = false;
+			page->sealed_end = 0;
+			spare_pages.push_back(page);
+		} else {
+			_free_page(page);
+		}
+	}
+	retired_pages.clear();
+}
+
 void MessageQueue::statistics() {
 	Map<StringName, int> set_count;
 	Map<int, int> notify_count;
 	Map<Callable, int> call_count;
 	int null_count = 0;
+	uint32_t total_bytes = 0;
+
+	Page *page = read_page;
+	uint32_t pos = read_pos;
+	while (page) {
+		uint32_t end = page->sealed ? page->sealed_end : MIN(page->write_pos.load(std::memory_order_acquire), page->size);
+		while (pos + sizeof(Message) <= end) {
+			Message *message = (Message *)&page->data[pos];
+			if (message->state.load(std::memory_order_acquire) != STATE_READY) {
+				break; // End of the page, or still being written.
+			}
 
-	uint32_t read_pos = 0;
-	while (read_pos < buffer_end) {
-		Message *message = (Message *)&buffer[read_pos];
+			Object *target = message->callable.get_object();
 
-		Object *target = message->callable.get_object();
+			if (target != nullptr) {
+				switch (message->type & FLAG_MASK) {
+					case TYPE_CALL: {
+						if (!call_count.has(message->callable)) {
+							call_count[message->callable] = 0;
+						}
 
-		if (target != nullptr) {
-			switch (message->type & FLAG_MASK) {
-				case TYPE_CALL: {
-					if (!call_count.has(message->callable)) {
-						call_count[message->callable] = 0;
-					}
+						call_count[message->callable]++;
 
-					call_count[message->callable]++;
+					} break;
+					case TYPE_NOTIFICATION: {
+						if (!notify_count.has(message->notification)) {
+							notify_count[message->notification] = 0;
+						}
 
-				} break;
-				case TYPE_NOTIFICATION: {
-					if (!notify_count.has(message->notification)) {
-						notify_count[message->notification] = 0;
-					}
+						notify_count[message->notification]++;
 
-					notify_count[message->notification]++;
+					} break;
+					case TYPE_SET: {
+						StringName t = message->callable.get_method();
+						if (!set_count.has(t)) {
+							set_count[t] = 0;
+						}
 
-				} break;
-				case TYPE_SET: {
-					StringName t = message->callable.get_method();
-					if (!set_count.has(t)) {
-						set_count[t] = 0;
-					}
+						set_count[t]++;
 
-					set_count[t]++;
+					} break;
+				}
 
-				} break;
-			}
+			} else {
+				//object was deleted
+				print_line("Object was deleted while awaiting a callback");
 
-		} else {
-			//object was deleted
-			print_line("Object was deleted while awaiting a callback");
+				null_count++;
+			}
 
-			null_count++;
+			uint32_t size = _get_message_size(message);
+			pos += size;
+			total_bytes += size;
 		}
 
-		read_pos += sizeof(Message);
-		if ((message->type & FLAG_MASK) != TYPE_NOTIFICATION) {
-			read_pos += sizeof(Variant) * message->args;
-		}
+		page = page->next.load(std::memory_order_acquire);
+		pos = 0;
 	}
 
-	print_line("TOTAL BYTES: " + itos(buffer_end));
+	print_line("TOTAL BYTES: " + itos(total_bytes));
 	print_line("NULL count: " + itos(null_count));
 
 	for (Map<StringName, int>::Element *E = set_count.front(); E; E = E->next()) {
@@ -262,35 +403,18 @@ void MessageQueue::_call_function(const Callable &p_callable, const Variant *p_a
 }
 
 void MessageQueue::flush() {
-	if (buffer_end > buffer_max_used) {
-		buffer_max_used = buffer_end;
-	}
-
-	uint32_t read_pos = 0;
-
-	//using reverse locking strategy
-	_THREAD_SAFE_LOCK_
-
-	if (flushing) {
-		_THREAD_SAFE_UNLOCK_
-		ERR_FAIL_COND(flushing); //already flushing, you did something odd
-	}
+	ERR_FAIL_COND(flushing); //already flushing, you did something odd
 	flushing = true;
 
-	while (read_pos < buffer_end) {
-		//lock on each iteration, so a call can re-add itself to the message queue
-
-		Message *message = (Message *)&buffer[read_pos];
-
-		uint32_t advance = sizeof(Message);
-		if ((message->type & FLAG_MASK) != TYPE_NOTIFICATION) {
-			advance += sizeof(Variant) * message->args;
-		}
+	uint32_t flushed_bytes = 0;
 
+	// Messages pushed by the calls are flushed too.
+	Message *message = nullptr;
+	while ((message = _next_message())) {
 		//pre-advance so this function is reentrant
-		read_pos += advance;
-
-		_THREAD_SAFE_UNLOCK_
+		uint32_t size = _get_message_size(message);
+		read_pos += size;
+		flushed_bytes += size;
 
 		Object *target = message->callable.get_object();
 
@@ -318,21 +442,15 @@ void MessageQueue::flush() {
 			}
 		}
 
-		if ((message->type & FLAG_MASK) != TYPE_NOTIFICATION) {
-			Variant *args = (Variant *)(message + 1);
-			for (int i = 0; i < message->args; i++) {
-				args[i].~Variant();
-			}
-		}
-
-		message->~Message();
+		_destroy_message(message);
+	}
 
-		_THREAD_SAFE_LOCK_
+	if (flushed_bytes > buffer_max_used) {
+		buffer_max_used = flushed_bytes;
 	}
 
-	buffer_end = 0; // reset buffer
+	_recycle_pages();
 	flushing = false;
-	_THREAD_SAFE_UNLOCK_
 }
 
 bool MessageQueue::is_flushing() const {
@@ -343,32 +461,34 @@ MessageQueue::MessageQueue() {
 	ERR_FAIL_COND_MSG(singleton != nullptr, "A MessageQueue singleton already exists.");
 	singleton = this;
 
-	buffer_size = GLOBAL_DEF_RST("memory/limits/message_queue/max_size_kb", DEFAULT_QUEUE_SIZE_KB);
+	page_size = GLOBAL_DEF_RST("memory/limits/message_queue/max_size_kb", DEFAULT_QUEUE_SIZE_KB);
 	ProjectSettings::get_singleton()->set_custom_property_info("memory/limits/message_queue/max_size_kb", PropertyInfo(Variant::INT, "memory/limits/message_queue/max_size_kb", PROPERTY_HINT_RANGE, "1024,4096,1,or_greater"));
-	buffer_size *= 1024;
-	buffer = memnew_arr(uint8_t, buffer_size);
+	page_size *= 1024;
+
+	read_page = _alloc_page(page_size);
+	write_page.store(read_page, std::memory_order_relaxed);
+	pushing.store(0, std::memory_order_relaxed);
 }
 
 MessageQueue::~MessageQueue() {
-	uint32_t read_pos = 0;
-
-	while (read_pos < buffer_end) {
-		Message *message = (Message *)&buffer[read_pos];
-		Variant *args = (Variant *)(message + 1);
-		int argc = message->args;
-		if ((message->type & FLAG_MASK) != TYPE_NOTIFICATION) {
-			for (int i = 0; i < argc; i++) {
-				args[i].~Variant();
-			}
-		}
-		message->~Message();
+	Message *message = nullptr;
+	while ((message = _next_message())) {
+		read_pos += _get_message_size(message);
+		_destroy_message(message);
+	}
 
-		read_pos += sizeof(Message);
-		if ((message->type & FLAG_MASK) != TYPE_NOTIFICATION) {
-			read_pos += sizeof(Variant) * message->args;
-		}
+	Page *page = read_page;
+	while (page) {
+		Page *next = page->next.load(std::memory_order_acquire);
+		_free_page(page);
+		page = next;
+	}
+	for (uint32_t i = 0; i < retired_pages.size(); i++) {
+		_free_page(retired_pages[i]);
+	}
+	for (uint32_t i = 0; i < spare_pages.size(); i++) {
+		_free_page(spare_pages[i]);
 	}
 
 	singleton = nullptr;
-	memdelete_arr(buffer);
 }
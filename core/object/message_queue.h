@@ -32,13 +32,23 @@
 #define MESSAGE_QUEUE_H
 
 #include "core/object/class_db.h"
-#include "core/os/thread_safe.h"
-
+#include "core/templates/local_vector.h"
+
+#include <atomic>
+
+// Queue of deferred calls, notifications and property sets, pushed from any
+// thread and flushed on the main thread.
+//
+// Messages are written to a chain of pages without locking: a producer reserves
+// room by bumping the write position of the last page, and links a new page
+// when it doesn't fit, so the queue grows instead of failing. Reservations keep
+// the order of the pushes, and each message is flagged ready once written.
+// The flushing thread reads pages in order, and recycles the ones it finished
+// once no producer is in the middle of a push.
 class MessageQueue {
-	_THREAD_SAFE_CLASS_
-
 	enum {
-		DEFAULT_QUEUE_SIZE_KB = 4096
+		DEFAULT_QUEUE_SIZE_KB = 4096,
+		MAX_SPARE_PAGES = 2
 	};
 
 	enum {
@@ -50,7 +60,14 @@ class MessageQueue {
 
 	};
 
+	enum {
+		STATE_EMPTY, // Not reserved yet, or reserved and still being written.
+		STATE_READY,
+		STATE_PAGE_END, // Didn't fit, the rest of the page is unused.
+	};
+
 	struct Message {
+		std::atomic<uint32_t> state; // Not initialized, page memory is kept zeroed when unused.
 		Callable callable;
 		int16_t type;
 		union {
@@ -59,10 +76,36 @@ class MessageQueue {
 		};
 	};
 
-	uint8_t *buffer;
-	uint32_t buffer_end = 0;
+	struct Page {
+		std::atomic<Page *> next;
+		std::atomic<uint32_t> write_pos; // Bytes reserved, goes past size once full.
+		uint32_t size = 0;
+		uint32_t sealed_end = 0; // Bytes reserved when sealed by the flushing thread.
+		bool sealed = false;
+		uint8_t *data = nullptr;
+	};
+
+	std::atomic<Page *> write_page;
+	std::atomic<uint32_t> pushing; // Producers between reserving and publishing a message.
+
+	// Only used by the flushing thread.
+	Page *read_page = nullptr;
+	uint32_t read_pos = 0;
+	LocalVector<Page *> retired_pages;
+	LocalVector<Page *> spare_pages;
+
+	uint32_t page_size;
 	uint32_t buffer_max_used = 0;
-	uint32_t buffer_size;
+
+	static Page *_alloc_page(uint32_t p_size);
+	static void _free_page(Page *p_page);
+	static uint32_t _get_message_size(const Message *p_message);
+
+	uint8_t *_reserve(uint32_t p_size);
+	void _publish(Message *p_message);
+	Message *_next_message();
+	void _destroy_message(Message *p_message);
+	void _recycle_pages();
 
 	void _call_function(const Callable &p_callable, const Variant *p_args, int p_argcount, bool p_show_error);
 
@@ -84,6 +127,7 @@ public:
 	Error push_notification(Object *p_object, int p_notification);
 	Error push_set(Object *p_object, const StringName &p_prop, const Variant &p_value);
 
+	// Only from the flushing thread.
 	void statistics();
 	void flush();
 
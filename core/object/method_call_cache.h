@@ -0,0 +1,79 @@
+/*************************************************************************/
+/*  method_call_cache.h                                                  */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef METHOD_CALL_CACHE_H
+#define METHOD_CALL_CACHE_H
+
+#include "core/string/string_name.h"
+
+#include <atomic>
+
+class MethodBind;
+
+// Resolution of a method name on a class, made by ClassDB::get_method_cached().
+// Entries are never modified nor freed until ClassDB::cleanup(), so call sites
+// can keep pointers to them without locking.
+struct MethodCallCacheEntry {
+	StringName class_name;
+	StringName name;
+	MethodBind *method = nullptr; // nullptr if the class has no such method.
+	uint32_t version = 0; // ClassDB method version this was resolved at.
+	bool call_overridden = false; // The class overrides Object::call(), so method must go through it.
+};
+
+// Inline cache for a call site (e.g. a signal connection or a method name in a
+// GDScript function), remembering the method resolved for the last few classes
+// of the objects called there. Lookups and updates are single atomic pointer
+// loads and stores, so a cache can be shared by threads. Copying gives an empty
+// cache, as the entries are only hints.
+struct MethodCallCache {
+	enum {
+		SIZE = 4
+	};
+
+	std::atomic<const MethodCallCacheEntry *> entries[SIZE];
+	std::atomic<uint32_t> next_entry;
+
+	void clear() {
+		for (int i = 0; i < SIZE; i++) {
+			entries[i].store(nullptr, std::memory_order_relaxed);
+		}
+		next_entry.store(0, std::memory_order_relaxed);
+	}
+
+	MethodCallCache() { clear(); }
+	MethodCallCache(const MethodCallCache &p_from) { clear(); }
+	MethodCallCache &operator=(const MethodCallCache &p_from) {
+		clear();
+		return *this;
+	}
+};
+
+#endif // METHOD_CALL_CACHE_H
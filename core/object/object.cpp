@@ -38,6 +38,7 @@
 #include "core/os/os.h"
 #include "core/string/print_string.h"
 #include "core/string/translation.h"
+#include "core/variant/variant_internal.h"
 
 #ifdef DEBUG_ENABLED
 
@@ -729,7 +730,7 @@ Variant Object::call(const StringName &p_name, VARIANT_ARG_DECLARE) {
 	return ret;
 }
 
-Variant Object::call(const StringName &p_method, const Variant **p_args, int p_argcount, Callable::CallError &r_error) {
+Variant Object::call(const StringName &p_method, const Variant **p_args, int p_argcount, Callable::CallError &r_error, MethodCallCache *p_cache) {
 	r_error.error = Callable::CallError::CALL_OK;
 
 	if (p_method == CoreStringNames::get_singleton()->_free) {
@@ -778,7 +779,7 @@ Variant Object::call(const StringName &p_method, const Variant **p_args, int p_a
 		}
 	}
 
-	MethodBind *method = ClassDB::get_method(get_class_name(), p_method);
+	MethodBind *method = p_cache ? ClassDB::get_method_cached(*p_cache, get_class_name(), p_method) : ClassDB::get_method(get_class_name(), p_method);
 
 	if (method) {
 		ret = method->call(this, p_args, p_argcount, r_error);
@@ -992,6 +993,40 @@ Variant Object::_emit_signal(const Variant **p_args, int p_argcount, Callable::C
 	return Variant();
 }
 
+// Calls a method of a signal target with ptrcall, which skips the argument checks and
+// conversions of MethodBind::call(). Only done when the arguments have the exact types
+// of the method, and nothing is returned, as signals ignore it. The argument types are
+// only known with DEBUG_METHODS_ENABLED, other builds always go through call().
+static bool _signal_ptrcall(MethodBind *p_method, Object *p_target, const Variant **p_args, int p_argcount) {
+#ifdef DEBUG_METHODS_ENABLED
+	const int max_args = 8;
+	if (p_method->is_vararg() || p_method->has_return() || p_method->get_argument_count() != p_argcount || p_argcount > max_args) {
+		return false;
+	}
+
+	const void *argptrs[max_args];
+	for (int i = 0; i < p_argcount; i++) {
+		Variant::Type type = p_method->get_argument_type(i);
+		if (type == Variant::NIL) {
+			argptrs[i] = p_args[i]; // Takes a Variant.
+		} else if (type == p_args[i]->get_type() && type != Variant::OBJECT) {
+			// Objects are left out, their class would need to be checked.
+			argptrs[i] = VariantInternal::get_opaque_pointer(p_args[i]);
+		} else {
+			return false;
+		}
+	}
+
+#ifdef DEBUG_ENABLED
+	_ObjectDebugLock debug_lock(p_target);
+#endif
+	p_method->ptrcall(p_target, argptrs, nullptr);
+	return true;
+#else
+	return false;
+#endif
+}
+
 Error Object::emit_signal(const StringName &p_name, const Variant **p_args, int p_argcount) {
 	if (_block_signals) {
 		return ERR_CANT_ACQUIRE_RESOURCE; //no emit, signals blocked
@@ -1013,18 +1048,23 @@ Error Object::emit_signal(const StringName &p_name, const Variant **p_args, int
 	//copy on write will ensure that disconnecting the signal or even deleting the object will not affect the signal calling.
 	//this happens automatically and will not change the performance of calling.
 	//awesome, isn't it?
-	VMap<Callable, SignalData::Slot> slot_map = s->slot_map;
+	//const, so reading it does not copy, and the call site caches of the slots are shared with the signal.
+	const VMap<Callable, SignalData::Slot> slot_map = s->slot_map;
 
 	int ssize = slot_map.size();
 
 	OBJ_DEBUG_LOCK
 
+	// Arguments followed by the binds of a connection. Only allocated when there are many.
+	const int bind_stack_size = 16;
+	const Variant *bind_stack[bind_stack_size];
 	Vector<const Variant *> bind_mem;
 
 	Error err = OK;
 
 	for (int i = 0; i < ssize; i++) {
-		const Connection &c = slot_map.getv(i).conn;
+		const SignalData::Slot &slot = slot_map.getv(i);
+		const Connection &c = slot.conn;
 
 		Object *target = c.callable.get_object();
 		if (!target) {
@@ -1037,17 +1077,21 @@ Error Object::emit_signal(const StringName &p_name, const Variant **p_args, int
 
 		if (c.binds.size()) {
 			//handle binds
-			bind_mem.resize(p_argcount + c.binds.size());
+			argc = p_argcount + c.binds.size();
+			const Variant **bind_args = bind_stack;
+			if (argc > bind_stack_size) {
+				bind_mem.resize(argc);
+				bind_args = bind_mem.ptrw();
+			}
 
 			for (int j = 0; j < p_argcount; j++) {
-				bind_mem.write[j] = p_args[j];
+				bind_args[j] = p_args[j];
 			}
 			for (int j = 0; j < c.binds.size(); j++) {
-				bind_mem.write[p_argcount + j] = &c.binds[j];
+				bind_args[p_argcount + j] = &c.binds[j];
 			}
 
-			args = (const Variant **)bind_mem.ptr();
-			argc = bind_mem.size();
+			args = bind_args;
 		}
 
 		if (c.flags & CONNECT_DEFERRED) {
@@ -1055,8 +1099,25 @@ Error Object::emit_signal(const StringName &p_name, const Variant **p_args, int
 		} else {
 			Callable::CallError ce;
 			_emitting = true;
-			Variant ret;
-			c.callable.call(args, argc, ret, ce);
+			if (c.callable.is_standard()) {
+				// Same as Callable::call(), without looking up the target again, and with
+				// a ptrcall when the target is native and the arguments allow it. Classes
+				// overriding call() (e.g. JNISingleton) must still get the call through it.
+				StringName method_name = c.callable.get_method();
+				MethodBind *method = nullptr;
+				if (!target->get_script_instance()) {
+					const MethodCallCacheEntry *entry = ClassDB::get_method_cache_entry(slot.method_cache, target->get_class_name(), method_name);
+					if (entry && !entry->call_overridden) {
+						method = entry->method;
+					}
+				}
+				if (!method || !_signal_ptrcall(method, target, args, argc)) {
+					target->call(method_name, args, argc, ce, &slot.method_cache);
+				}
+			} else {
+				Variant ret;
+				c.callable.call(args, argc, ret, ce);
+			}
 			_emitting = false;
 
 			if (ce.error != Callable::CallError::CALL_OK) {
@@ -31,6 +31,7 @@
 #ifndef OBJECT_H
 #define OBJECT_H
 
+#include "core/object/method_call_cache.h"
 #include "core/object/object_id.h"
 #include "core/os/rw_lock.h"
 #include "core/os/spin_lock.h"
@@ -310,6 +311,9 @@ protected:
 	}                                                                                                                                            \
                                                                                                                                                  \
 public:                                                                                                                                          \
+	static bool _is_call_overridden_static() {                                                                                                   \
+		return _is_call_overridden(&m_class::call);                                                                                              \
+	}                                                                                                                                            \
 	static void initialize_class() {                                                                                                             \
 		static bool initialized = false;                                                                                                         \
 		if (initialized) {                                                                                                                       \
@@ -441,6 +445,7 @@ private:
 			int reference_count = 0;
 			Connection conn;
 			List<Connection>::Element *cE = nullptr;
+			mutable MethodCallCache method_cache;
 		};
 
 		MethodInfo user;
@@ -493,6 +498,10 @@ private:
 
 protected:
 	virtual void _initialize_classv() { initialize_class(); }
+	// Only used by _is_call_overridden_static(), the argument's class is the one that last overrode call().
+	static bool _is_call_overridden(Variant (Object::*)(const StringName &, const Variant **, int, Callable::CallError &, MethodCallCache *)) { return false; }
+	template <class T>
+	static bool _is_call_overridden(Variant (T::*)(const StringName &, const Variant **, int, Callable::CallError &, MethodCallCache *)) { return true; }
 	virtual bool _setv(const StringName &p_name, const Variant &p_property) { return false; };
 	virtual bool _getv(const StringName &p_name, Variant &r_property) const { return false; };
 	virtual void _get_property_listv(List<PropertyInfo> *p_list, bool p_reversed) const {};
@@ -553,6 +562,7 @@ protected:
 public: //should be protected, but bug in clang++
 	static void initialize_class();
 	_FORCE_INLINE_ static void register_custom_data_to_otdb() {}
+	static bool _is_call_overridden_static() { return false; }
 
 public:
 #ifdef TOOLS_ENABLED
@@ -650,7 +660,8 @@ public:
 	bool has_method(const StringName &p_method) const;
 	void get_method_list(List<MethodInfo> *p_list) const;
 	Variant callv(const StringName &p_method, const Array &p_args);
-	virtual Variant call(const StringName &p_method, const Variant **p_args, int p_argcount, Callable::CallError &r_error);
+	// p_cache, if given, is the inline cache of the call site, used to skip the ClassDB lookup.
+	virtual Variant call(const StringName &p_method, const Variant **p_args, int p_argcount, Callable::CallError &r_error, MethodCallCache *p_cache = nullptr);
 	Variant call(const StringName &p_name, VARIANT_ARG_LIST); // C++ helper
 
 	void notification(int p_notification, bool p_reversed = false);
@@ -0,0 +1,215 @@
+/*************************************************************************/
+/*  frame_arena.cpp                                                      */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "frame_arena.h"
+
+#include "core/error/error_macros.h"
+#include "core/os/copymem.h"
+#include "core/os/memory.h"
+
+// Each allocation is prefixed by its size, so it can be grown or copied when reallocated.
+struct FrameArenaHeader {
+	uint64_t size;
+	uint64_t pad;
+};
+
+static_assert(sizeof(FrameArenaHeader) == FrameArena::ALIGN, "The header must keep allocations aligned.");
+
+// Trivially destructible, so it can still be used while the thread exits.
+static thread_local FrameArena::ThreadArena frame_arena;
+
+static _FORCE_INLINE_ uint8_t *_get_block_data(FrameArena::Block *p_block) {
+	return reinterpret_cast<uint8_t *>(p_block) + ((sizeof(FrameArena::Block) + FrameArena::ALIGN - 1) & ~(FrameArena::ALIGN - 1));
+}
+
+static FrameArena::Block *_create_block(size_t p_size) {
+	size_t data_offset = (sizeof(FrameArena::Block) + FrameArena::ALIGN - 1) & ~(FrameArena::ALIGN - 1);
+	FrameArena::Block *block = (FrameArena::Block *)memalloc(data_offset + p_size);
+	ERR_FAIL_COND_V(!block, nullptr);
+	block->next = nullptr;
+	block->size = p_size;
+	block->used = 0;
+	return block;
+}
+
+static void _free_blocks(FrameArena::Block *p_first) {
+	while (p_first) {
+		FrameArena::Block *next = p_first->next;
+		memfree(p_first);
+		p_first = next;
+	}
+}
+
+struct FrameArenaThreadExit {
+	~FrameArenaThreadExit() {
+		_free_blocks(frame_arena.first);
+		frame_arena.first = nullptr;
+		frame_arena.current = nullptr;
+	}
+};
+
+FrameArena::ThreadArena &FrameArena::get_thread_arena() {
+	return frame_arena;
+}
+
+void *FrameArena::_alloc_in_new_block(ThreadArena &p_arena, size_t p_size) {
+	if (!p_arena.registered) {
+		// Frees the blocks at thread exit.
+		static thread_local FrameArenaThreadExit thread_exit;
+		(void)thread_exit;
+		p_arena.registered = true;
+	}
+
+	Block *current = p_arena.current;
+	if (current && current->next && current->next->size >= p_size) {
+		// Reuse the next block, left over by a rewound scope.
+		current = current->next;
+		current->used = 0;
+	} else {
+		Block *block = _create_block(MAX(size_t(BLOCK_SIZE), p_size));
+		ERR_FAIL_COND_V(!block, nullptr);
+		if (current) {
+			block->next = current->next;
+			current->next = block;
+		} else {
+			p_arena.first = block;
+		}
+		current = block;
+	}
+	p_arena.current = current;
+
+	void *mem = _get_block_data(current);
+	current->used = p_size;
+	return mem;
+}
+
+void *FrameArena::alloc(size_t p_bytes) {
+	ThreadArena &arena = frame_arena;
+	size_t size = (sizeof(FrameArenaHeader) + p_bytes + ALIGN - 1) & ~size_t(ALIGN - 1);
+
+	FrameArenaHeader *header;
+	Block *current = arena.current;
+	if (likely(current && current->size - current->used >= size)) {
+		header = (FrameArenaHeader *)(_get_block_data(current) + current->used);
+		current->used += size;
+	} else {
+		header = (FrameArenaHeader *)_alloc_in_new_block(arena, size);
+		ERR_FAIL_COND_V(!header, nullptr);
+	}
+
+	header->size = p_bytes;
+	return header + 1;
+}
+
+void *FrameArena::realloc(void *p_ptr, size_t p_bytes) {
+	if (!p_ptr) {
+		return alloc(p_bytes);
+	}
+
+	FrameArenaHeader *header = (FrameArenaHeader *)p_ptr - 1;
+	size_t old_size = (sizeof(FrameArenaHeader) + header->size + ALIGN - 1) & ~size_t(ALIGN - 1);
+	size_t size = (sizeof(FrameArenaHeader) + p_bytes + ALIGN - 1) & ~size_t(ALIGN - 1);
+
+	Block *current = frame_arena.current;
+	if (current && (uint8_t *)header + old_size == _get_block_data(current) + current->used && (uint8_t *)header >= _get_block_data(current)) {
+		// Last allocation of this thread, grow or shrink it in place if it fits.
+		size_t start = (uint8_t *)header - _get_block_data(current);
+		if (current->size - start >= size) {
+			current->used = start + size;
+			header->size = p_bytes;
+			return p_ptr;
+		}
+	} else if (size <= old_size) {
+		header->size = p_bytes;
+		return p_ptr;
+	}
+
+	void *mem = alloc(p_bytes);
+	ERR_FAIL_COND_V(!mem, nullptr);
+	copymem(mem, p_ptr, MIN(uint64_t(p_bytes), header->size));
+	return mem;
+}
+
+void FrameArena::reset() {
+	ThreadArena &arena = frame_arena;
+	arena.generation++;
+
+	if (!arena.first) {
+		return;
+	}
+
+	if (arena.first->next) {
+		// Use a single block big enough for a whole frame from now on.
+		size_t size = 0;
+		for (Block *block = arena.first; block; block = block->next) {
+			size += block->size;
+		}
+		_free_blocks(arena.first);
+		arena.first = _create_block(size);
+	}
+
+	arena.current = arena.first;
+	if (arena.current) {
+		arena.current->used = 0;
+	}
+}
+
+size_t FrameArena::get_thread_memory_used() {
+	ThreadArena &arena = frame_arena;
+	size_t used = 0;
+	for (Block *block = arena.first; block; block = block->next) {
+		used += block->used;
+		if (block == arena.current) {
+			break;
+		}
+	}
+	return used;
+}
+
+FrameArenaScope::FrameArenaScope() {
+	FrameArena::ThreadArena &arena = FrameArena::get_thread_arena();
+	block = arena.current;
+	used = block ? block->used : 0;
+	generation = arena.generation;
+}
+
+FrameArenaScope::~FrameArenaScope() {
+	FrameArena::ThreadArena &arena = FrameArena::get_thread_arena();
+	ERR_FAIL_COND_MSG(arena.generation != generation, "The frame arena was reset while a FrameArenaScope was alive.");
+
+	if (block) {
+		arena.current = block;
+		block->used = used;
+	} else if (arena.first) {
+		// Nothing was allocated before the scope.
+		arena.current = arena.first;
+		arena.first->used = 0;
+	}
+}
@@ -0,0 +1,100 @@
+/*************************************************************************/
+/*  frame_arena.h                                                        */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef FRAME_ARENA_H
+#define FRAME_ARENA_H
+
+#include "core/typedefs.h"
+
+#include <stddef.h>
+
+// Linear allocator for temporary data that doesn't outlive the current frame,
+// like cull results and scratch arrays. Each thread allocates from its own
+// arena without locking, by moving a pointer forward; freeing does nothing.
+//
+// The memory is reclaimed all at once, either when the thread calls reset()
+// at the end of its frame (the main loop, the render thread and the physics
+// thread do), or when a FrameArenaScope ends, which works on any thread.
+// Threads that neither reset nor use scopes keep growing their arena.
+//
+// It can be used as the allocator of LocalVector and List:
+//
+//     FrameArenaScope scope;
+//     LocalVector<Instance *, uint32_t, false, FrameArena> result;
+//
+// Containers must be destroyed before the scope or frame they were filled in ends.
+class FrameArena {
+public:
+	enum {
+		BLOCK_SIZE = 64 * 1024,
+		ALIGN = 16,
+	};
+
+	struct Block {
+		Block *next;
+		size_t size;
+		size_t used;
+	};
+
+	struct ThreadArena {
+		Block *first;
+		Block *current;
+		uint32_t generation; // Increased on each reset, so scopes spanning a reset can be told apart.
+		bool registered;
+	};
+
+private:
+	static void *_alloc_in_new_block(ThreadArena &p_arena, size_t p_size);
+
+public:
+	static ThreadArena &get_thread_arena();
+
+	static void *alloc(size_t p_bytes);
+	static void *realloc(void *p_ptr, size_t p_bytes);
+	static void free(void *p_ptr) {} // Released when the arena is reset or rewound.
+
+	// Releases all the memory allocated by this thread since the last reset.
+	static void reset();
+	// Memory allocated by this thread since the last reset, including the allocation headers.
+	static size_t get_thread_memory_used();
+};
+
+// Gives back everything the thread allocated from its arena while the scope was alive.
+class FrameArenaScope {
+	FrameArena::Block *block = nullptr;
+	size_t used = 0;
+	uint32_t generation = 0;
+
+public:
+	FrameArenaScope();
+	~FrameArenaScope();
+};
+
+#endif // FRAME_ARENA_H
@@ -32,6 +32,7 @@
 
 #include "core/error/error_macros.h"
 #include "core/os/copymem.h"
+#include "core/os/spin_lock.h"
 #include "core/templates/safe_refcount.h"
 
 #include <stdio.h>
@@ -62,11 +63,250 @@ void operator delete(void *p_mem, void *p_pointer, size_t check, const char *p_d
 #ifdef DEBUG_ENABLED
 uint64_t Memory::mem_usage = 0;
 uint64_t Memory::max_usage = 0;
+uint64_t Memory::alloc_total = 0;
 #endif
 
 uint64_t Memory::alloc_count = 0;
 
+#ifdef SMALL_OBJECT_ALLOCATOR_ENABLED
+
+// Size class allocator for small allocations, enabled with the
+// small_object_allocator build option. Each thread keeps a free list per
+// size class, so most allocations and frees don't lock or touch shared
+// memory. The lists are refilled from, and returned to, central lists in
+// batches. Memory used for small objects is kept by the allocator once freed,
+// it's not returned to the system.
+//
+// Allocations are always prefixed by their size (like in debug builds), which
+// gives their size class back when they are freed. The usage counters are
+// also kept per thread, and merged into the global ones once they change
+// enough, so they lag behind a little.
+
+enum {
+	SMALL_OBJECT_MAX_SIZE = 1024, // Including the padding.
+	SMALL_OBJECT_CLASS_COUNT = 20,
+	SMALL_OBJECT_CHUNK_SIZE = 64 * 1024,
+	SMALL_OBJECT_BATCH_BYTES = 4096,
+	SMALL_OBJECT_COUNTER_MERGE_BYTES = 64 * 1024,
+	SMALL_OBJECT_COUNTER_MERGE_ALLOCS = 256,
+};
+
+// Classes are 16 bytes apart up to 128 bytes, then four per power of two.
+static _FORCE_INLINE_ uint32_t _small_object_get_class(size_t p_size) {
+	if (p_size <= 128) {
+		return (p_size - 1) >> 4;
+	}
+	uint32_t shift = p_size <= 256 ? 5 : (p_size <= 512 ? 6 : 7);
+	return 8 + (shift - 5) * 4 + ((p_size - 1) >> shift) - 4;
+}
+
+struct SmallObjectClasses {
+	uint32_t size[SMALL_OBJECT_CLASS_COUNT] = {};
+	uint32_t batch[SMALL_OBJECT_CLASS_COUNT] = {}; // Objects moved at once between the thread and central lists.
+
+	constexpr SmallObjectClasses() {
+		for (uint32_t i = 0; i < SMALL_OBJECT_CLASS_COUNT; i++) {
+			size[i] = i < 8 ? (i + 1) << 4 : ((i - 8) % 4 + 5) << ((i - 8) / 4 + 5);
+			batch[i] = CLAMP(SMALL_OBJECT_BATCH_BYTES / size[i], 4u, 64u);
+		}
+	}
+};
+
+static constexpr SmallObjectClasses small_object_classes;
+
+struct SmallObjectNode {
+	SmallObjectNode *next;
+};
+
+struct SmallObjectCentralList {
+	SpinLock lock;
+	SmallObjectNode *free_list = nullptr;
+	uint8_t *chunk_pos = nullptr;
+	uint8_t *chunk_end = nullptr;
+};
+
+// Trivially destructible, so it can still be used while the thread exits.
+struct SmallObjectThreadCache {
+	SmallObjectNode *free_list[SMALL_OBJECT_CLASS_COUNT];
+	uint32_t free_count[SMALL_OBJECT_CLASS_COUNT];
+	int64_t alloc_count_delta;
+	int64_t mem_usage_delta;
+	int64_t alloc_total_delta;
+	bool registered;
+	bool finished; // Past the thread exit flush, everything goes to the central lists.
+};
+
+static SmallObjectCentralList small_object_central[SMALL_OBJECT_CLASS_COUNT];
+static thread_local SmallObjectThreadCache small_object_cache;
+
+static void _small_object_give_back(uint32_t p_class, SmallObjectNode *p_first, SmallObjectNode *p_last) {
+	SmallObjectCentralList &central = small_object_central[p_class];
+	central.lock.lock();
+	p_last->next = central.free_list;
+	central.free_list = p_first;
+	central.lock.unlock();
+}
+
+void Memory::_merge_thread_counters() {
+	SmallObjectThreadCache &cache = small_object_cache;
+	atomic_add(&alloc_count, uint64_t(cache.alloc_count_delta));
+#ifdef DEBUG_ENABLED
+	uint64_t usage = atomic_add(&mem_usage, uint64_t(cache.mem_usage_delta));
+	atomic_exchange_if_greater(&max_usage, usage);
+	atomic_add(&alloc_total, uint64_t(cache.alloc_total_delta));
+#endif
+	cache.alloc_count_delta = 0;
+	cache.mem_usage_delta = 0;
+	cache.alloc_total_delta = 0;
+}
+
+struct SmallObjectThreadExit {
+	~SmallObjectThreadExit() {
+		SmallObjectThreadCache &cache = small_object_cache;
+		for (uint32_t i = 0; i < SMALL_OBJECT_CLASS_COUNT; i++) {
+			SmallObjectNode *first = cache.free_list[i];
+			if (first) {
+				SmallObjectNode *last = first;
+				while (last->next) {
+					last = last->next;
+				}
+				_small_object_give_back(i, first, last);
+			}
+			cache.free_list[i] = nullptr;
+			cache.free_count[i] = 0;
+		}
+		cache.finished = true;
+		Memory::_merge_thread_counters();
+	}
+};
+
+// Registers the flush at thread exit. Needed by threads that only free too
+// (e.g. consuming commands), as they also fill free lists and counter deltas.
+static void _small_object_register_thread() {
+	static thread_local SmallObjectThreadExit thread_exit;
+	(void)thread_exit;
+	small_object_cache.registered = true;
+}
+
+// p_allocs is the change in live allocations, p_made tells if an allocation was made.
+// Every allocation and free goes through here.
+static _FORCE_INLINE_ void _small_object_count(int64_t p_allocs, int64_t p_bytes, bool p_made) {
+	SmallObjectThreadCache &cache = small_object_cache;
+	if (unlikely(!cache.registered)) {
+		_small_object_register_thread();
+	}
+	cache.alloc_count_delta += p_allocs;
+	cache.mem_usage_delta += p_bytes;
+	cache.alloc_total_delta += p_made;
+	if (cache.finished || ABS(cache.alloc_count_delta) >= SMALL_OBJECT_COUNTER_MERGE_ALLOCS || ABS(cache.mem_usage_delta) >= SMALL_OBJECT_COUNTER_MERGE_BYTES) {
+		Memory::_merge_thread_counters();
+	}
+}
+
+static void *_small_object_refill(uint32_t p_class) {
+	SmallObjectThreadCache &cache = small_object_cache;
+	if (unlikely(!cache.registered)) {
+		_small_object_register_thread();
+	}
+
+	uint32_t batch = cache.finished ? 1 : small_object_classes.batch[p_class];
+	uint32_t size = small_object_classes.size[p_class];
+	SmallObjectCentralList &central = small_object_central[p_class];
+
+	SmallObjectNode *first = nullptr;
+	uint32_t count = 0;
+
+	central.lock.lock();
+	while (central.free_list && count < batch) {
+		SmallObjectNode *node = central.free_list;
+		central.free_list = node->next;
+		node->next = first;
+		first = node;
+		count++;
+	}
+	while (count < batch) {
+		if (central.chunk_pos + size > central.chunk_end) {
+			if (count > 0) {
+				break; // Enough for now.
+			}
+			// The rest of the previous chunk (less than one object) is wasted.
+			uint8_t *chunk = (uint8_t *)malloc(SMALL_OBJECT_CHUNK_SIZE);
+			if (!chunk) {
+				break;
+			}
+			central.chunk_pos = chunk;
+			central.chunk_end = chunk + SMALL_OBJECT_CHUNK_SIZE;
+		}
+		SmallObjectNode *node = (SmallObjectNode *)central.chunk_pos;
+		central.chunk_pos += size;
+		node->next = first;
+		first = node;
+		count++;
+	}
+	central.lock.unlock();
+
+	if (!first) {
+		return nullptr;
+	}
+
+	cache.free_list[p_class] = first->next;
+	cache.free_count[p_class] = count - 1;
+	return first;
+}
+
+static _FORCE_INLINE_ void *_small_object_alloc(uint32_t p_class) {
+	SmallObjectThreadCache &cache = small_object_cache;
+	SmallObjectNode *node = cache.free_list[p_class];
+	if (likely(node)) {
+		cache.free_list[p_class] = node->next;
+		cache.free_count[p_class]--;
+		return node;
+	}
+	return _small_object_refill(p_class);
+}
+
+static _FORCE_INLINE_ void _small_object_free(uint32_t p_class, void *p_ptr) {
+	SmallObjectThreadCache &cache = small_object_cache;
+	SmallObjectNode *node = (SmallObjectNode *)p_ptr;
+
+	if (unlikely(cache.finished)) {
+		_small_object_give_back(p_class, node, node);
+		return;
+	}
+
+	node->next = cache.free_list[p_class];
+	cache.free_list[p_class] = node;
+	uint32_t batch = small_object_classes.batch[p_class];
+	if (unlikely(++cache.free_count[p_class] > batch * 2)) {
+		// Keep one batch, give the rest back for other threads.
+		SmallObjectNode *last_kept = node;
+		for (uint32_t i = 1; i < batch; i++) {
+			last_kept = last_kept->next;
+		}
+		SmallObjectNode *first = last_kept->next;
+		SmallObjectNode *last = first;
+		while (last->next) {
+			last = last->next;
+		}
+		last_kept->next = nullptr;
+		cache.free_count[p_class] = batch;
+		_small_object_give_back(p_class, first, last);
+	}
+}
+
+#endif // SMALL_OBJECT_ALLOCATOR_ENABLED
+
 void *Memory::alloc_static(size_t p_bytes, bool p_pad_align) {
+#ifdef SMALL_OBJECT_ALLOCATOR_ENABLED
+	size_t size = p_bytes + PAD_ALIGN;
+	void *mem = size <= SMALL_OBJECT_MAX_SIZE ? _small_object_alloc(_small_object_get_class(size)) : malloc(size);
+
+	ERR_FAIL_COND_V(!mem, nullptr);
+
+	*(uint64_t *)mem = p_bytes;
+	_small_object_count(1, p_bytes, true);
+	return (uint8_t *)mem + PAD_ALIGN;
+#else
 #ifdef DEBUG_ENABLED
 	bool prepad = true;
 #else
@@ -88,11 +328,13 @@ void *Memory::alloc_static(size_t p_bytes, bool p_pad_align) {
 #ifdef DEBUG_ENABLED
 		atomic_add(&mem_usage, p_bytes);
 		atomic_exchange_if_greater(&max_usage, mem_usage);
+		atomic_increment(&alloc_total);
 #endif
 		return s8 + PAD_ALIGN;
 	} else {
 		return mem;
 	}
+#endif
 }
 
 void *Memory::realloc_static(void *p_memory, size_t p_bytes, bool p_pad_align) {
@@ -100,6 +342,34 @@ void *Memory::realloc_static(void *p_memory, size_t p_bytes, bool p_pad_align) {
 		return alloc_static(p_bytes, p_pad_align);
 	}
 
+#ifdef SMALL_OBJECT_ALLOCATOR_ENABLED
+	if (p_bytes == 0) {
+		free_static(p_memory, p_pad_align);
+		return nullptr;
+	}
+
+	uint8_t *mem = (uint8_t *)p_memory - PAD_ALIGN;
+	uint64_t old_bytes = *(uint64_t *)mem;
+	size_t old_size = old_bytes + PAD_ALIGN;
+	size_t size = p_bytes + PAD_ALIGN;
+
+	if (old_size > SMALL_OBJECT_MAX_SIZE && size > SMALL_OBJECT_MAX_SIZE) {
+		mem = (uint8_t *)realloc(mem, size);
+		ERR_FAIL_COND_V(!mem, nullptr);
+	} else if (old_size > SMALL_OBJECT_MAX_SIZE || size > SMALL_OBJECT_MAX_SIZE || _small_object_get_class(old_size) != _small_object_get_class(size)) {
+		uint8_t *new_memory = (uint8_t *)alloc_static(p_bytes, p_pad_align);
+		ERR_FAIL_COND_V(!new_memory, nullptr);
+		// Also copy the padding, CowData keeps its reference count there.
+		copymem(new_memory - PAD_ALIGN + sizeof(uint64_t), mem + sizeof(uint64_t), PAD_ALIGN - sizeof(uint64_t) + MIN(old_bytes, p_bytes));
+		free_static(p_memory, p_pad_align);
+		return new_memory;
+	}
+
+	// Still fits in the same place.
+	*(uint64_t *)mem = p_bytes;
+	_small_object_count(0, int64_t(p_bytes) - int64_t(old_bytes), true);
+	return mem + PAD_ALIGN;
+#else
 	uint8_t *mem = (uint8_t *)p_memory;
 
 #ifdef DEBUG_ENABLED
@@ -119,6 +389,9 @@ void *Memory::realloc_static(void *p_memory, size_t p_bytes, bool p_pad_align) {
 		} else {
 			atomic_sub(&mem_usage, *s - p_bytes);
 		}
+		if (p_bytes > 0) {
+			atomic_increment(&alloc_total);
+		}
 #endif
 
 		if (p_bytes == 0) {
@@ -143,11 +416,25 @@ void *Memory::realloc_static(void *p_memory, size_t p_bytes, bool p_pad_align) {
 
 		return mem;
 	}
+#endif
 }
 
 void Memory::free_static(void *p_ptr, bool p_pad_align) {
 	ERR_FAIL_COND(p_ptr == nullptr);
 
+#ifdef SMALL_OBJECT_ALLOCATOR_ENABLED
+	uint8_t *mem = (uint8_t *)p_ptr - PAD_ALIGN;
+	uint64_t bytes = *(uint64_t *)mem;
+	size_t size = bytes + PAD_ALIGN;
+
+	_small_object_count(-1, -int64_t(bytes), false);
+
+	if (size <= SMALL_OBJECT_MAX_SIZE) {
+		_small_object_free(_small_object_get_class(size), mem);
+	} else {
+		free(mem);
+	}
+#else
 	uint8_t *mem = (uint8_t *)p_ptr;
 
 #ifdef DEBUG_ENABLED
@@ -170,6 +457,7 @@ void Memory::free_static(void *p_ptr, bool p_pad_align) {
 	} else {
 		free(mem);
 	}
+#endif
 }
 
 uint64_t Memory::get_mem_available() {
@@ -192,6 +480,17 @@ uint64_t Memory::get_mem_max_usage() {
 #endif
 }
 
+uint64_t Memory::get_alloc_total() {
+#ifdef DEBUG_ENABLED
+#ifdef SMALL_OBJECT_ALLOCATOR_ENABLED
+	_merge_thread_counters(); // Be exact at least for this thread.
+#endif
+	return alloc_total;
+#else
+	return 0;
+#endif
+}
+
 _GlobalNil::_GlobalNil() {
 	left = this;
 	right = this;
@@ -45,6 +45,7 @@ class Memory {
 #ifdef DEBUG_ENABLED
 	static uint64_t mem_usage;
 	static uint64_t max_usage;
+	static uint64_t alloc_total;
 #endif
 
 	static uint64_t alloc_count;
@@ -57,11 +58,17 @@ public:
 	static uint64_t get_mem_available();
 	static uint64_t get_mem_usage();
 	static uint64_t get_mem_max_usage();
+	static uint64_t get_alloc_total(); // Allocations and reallocations made so far, only counted in debug builds.
+
+#ifdef SMALL_OBJECT_ALLOCATOR_ENABLED
+	static void _merge_thread_counters(); // Used by the small object allocator.
+#endif
 };
 
 class DefaultAllocator {
 public:
 	_FORCE_INLINE_ static void *alloc(size_t p_memory) { return Memory::alloc_static(p_memory, false); }
+	_FORCE_INLINE_ static void *realloc(void *p_ptr, size_t p_memory) { return Memory::realloc_static(p_ptr, p_memory, false); }
 	_FORCE_INLINE_ static void free(void *p_ptr) { Memory::free_static(p_ptr, false); }
 };
 
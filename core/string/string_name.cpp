@@ -39,66 +39,172 @@ StaticCString StaticCString::create(const char *p_ptr) {
 	return scs;
 }
 
-StringName::_Data *StringName::_table[STRING_TABLE_LEN];
+StringName::_Table StringName::_tables[STRING_TABLE_SHARDS];
 
 StringName _scs_create(const char *p_chr) {
 	return (p_chr[0] ? StringName(StaticCString::create(p_chr)) : StringName());
 }
 
 bool StringName::configured = false;
-Mutex StringName::mutex;
 
 void StringName::setup() {
 	ERR_FAIL_COND(configured);
-	for (int i = 0; i < STRING_TABLE_LEN; i++) {
-		_table[i] = nullptr;
+	for (int i = 0; i < STRING_TABLE_SHARDS; i++) {
+		_Table &table = _tables[i];
+		table.buckets = memnew_arr(_Data *, STRING_TABLE_SHARD_MIN_LEN);
+		for (int j = 0; j < STRING_TABLE_SHARD_MIN_LEN; j++) {
+			table.buckets[j] = nullptr;
+		}
+		table.mask = STRING_TABLE_SHARD_MIN_LEN - 1;
+		table.count = 0;
 	}
 	configured = true;
 }
 
 void StringName::cleanup() {
-	MutexLock lock(mutex);
-
 	int lost_strings = 0;
-	for (int i = 0; i < STRING_TABLE_LEN; i++) {
-		while (_table[i]) {
-			_Data *d = _table[i];
-			lost_strings++;
-			if (OS::get_singleton()->is_stdout_verbose()) {
-				if (d->cname) {
-					print_line("Orphan StringName: " + String(d->cname));
-				} else {
-					print_line("Orphan StringName: " + String(d->name));
+	for (int i = 0; i < STRING_TABLE_SHARDS; i++) {
+		_Table &table = _tables[i];
+		RWLockWrite lock(table.lock);
+
+		for (uint32_t j = 0; j <= table.mask; j++) {
+			while (table.buckets[j]) {
+				_Data *d = table.buckets[j];
+				lost_strings++;
+				if (OS::get_singleton()->is_stdout_verbose()) {
+					if (d->cname) {
+						print_line("Orphan StringName: " + String(d->cname));
+					} else {
+						print_line("Orphan StringName: " + String(d->name));
+					}
 				}
-			}
 
-			_table[i] = _table[i]->next;
-			memdelete(d);
+				table.buckets[j] = d->next;
+				memdelete(d);
+			}
 		}
+
+		memdelete_arr(table.buckets);
+		table.buckets = nullptr;
+		table.mask = 0;
+		table.count = 0;
 	}
 	if (lost_strings) {
 		print_verbose("StringName: " + itos(lost_strings) + " unclaimed string names at exit.");
 	}
 }
 
+// Must be called with the table locked, either for reading or writing.
+// Names whose last reference is being released can still be in the table
+// until unref() gets the write lock, those are skipped.
+template <class T>
+StringName::_Data *StringName::_ref_existing(const _Table &p_table, uint32_t p_hash, const T &p_name) {
+	_Data *data = p_table.buckets[p_hash & p_table.mask];
+
+	while (data) {
+		// compare hash first
+		if (data->hash == p_hash && data->get_name() == p_name && data->refcount.ref()) {
+			return data;
+		}
+		data = data->next;
+	}
+
+	return nullptr;
+}
+
+template <class T>
+StringName::_Data *StringName::_ref_or_create(uint32_t p_hash, const T &p_name, const char *p_static_cname) {
+	_Table &table = _get_table(p_hash);
+
+	{
+		RWLockRead lock(table.lock);
+		_Data *data = _ref_existing(table, p_hash, p_name);
+		if (data) {
+			return data;
+		}
+	}
+
+	RWLockWrite lock(table.lock);
+
+	// Another thread may have added it while the lock was released.
+	_Data *data = _ref_existing(table, p_hash, p_name);
+	if (data) {
+		return data;
+	}
+
+	if (table.count > table.mask) {
+		_grow(table);
+	}
+
+	data = memnew(_Data);
+	if (p_static_cname) {
+		data->cname = p_static_cname;
+	} else {
+		data->name = p_name;
+	}
+	data->refcount.init();
+	data->hash = p_hash;
+
+	uint32_t idx = p_hash & table.mask;
+	data->next = table.buckets[idx];
+	data->prev = nullptr;
+	if (table.buckets[idx]) {
+		table.buckets[idx]->prev = data;
+	}
+	table.buckets[idx] = data;
+	table.count++;
+
+	return data;
+}
+
+void StringName::_grow(_Table &p_table) {
+	uint32_t new_len = (p_table.mask + 1) * 2;
+	_Data **new_buckets = memnew_arr(_Data *, new_len);
+	for (uint32_t i = 0; i < new_len; i++) {
+		new_buckets[i] = nullptr;
+	}
+
+	for (uint32_t i = 0; i <= p_table.mask; i++) {
+		_Data *data = p_table.buckets[i];
+		while (data) {
+			_Data *next = data->next;
+			uint32_t idx = data->hash & (new_len - 1);
+			data->prev = nullptr;
+			data->next = new_buckets[idx];
+			if (new_buckets[idx]) {
+				new_buckets[idx]->prev = data;
+			}
+			new_buckets[idx] = data;
+			data = next;
+		}
+	}
+
+	memdelete_arr(p_table.buckets);
+	p_table.buckets = new_buckets;
+	p_table.mask = new_len - 1;
+}
+
 void StringName::unref() {
 	ERR_FAIL_COND(!configured);
 
 	if (_data && _data->refcount.unref()) {
-		MutexLock lock(mutex);
+		_Table &table = _get_table(_data->hash);
+		RWLockWrite lock(table.lock);
 
 		if (_data->prev) {
 			_data->prev->next = _data->next;
 		} else {
-			if (_table[_data->idx] != _data) {
+			uint32_t idx = _data->hash & table.mask;
+			if (table.buckets[idx] != _data) {
 				ERR_PRINT("BUG!");
 			}
-			_table[_data->idx] = _data->next;
+			table.buckets[idx] = _data->next;
 		}
 
 		if (_data->next) {
 			_data->next->prev = _data->prev;
 		}
+		table.count--;
 		memdelete(_data);
 	}
 
@@ -162,41 +268,7 @@ StringName::StringName(const char *p_name) {
 		return; //empty, ignore
 	}
 
-	MutexLock lock(mutex);
-
-	uint32_t hash = String::hash(p_name);
-
-	uint32_t idx = hash & STRING_TABLE_MASK;
-
-	_data = _table[idx];
-
-	while (_data) {
-		// compare hash first
-		if (_data->hash == hash && _data->get_name() == p_name) {
-			break;
-		}
-		_data = _data->next;
-	}
-
-	if (_data) {
-		if (_data->refcount.ref()) {
-			// exists
-			return;
-		}
-	}
-
-	_data = memnew(_Data);
-	_data->name = p_name;
-	_data->refcount.init();
-	_data->hash = hash;
-	_data->idx = idx;
-	_data->cname = nullptr;
-	_data->next = _table[idx];
-	_data->prev = nullptr;
-	if (_table[idx]) {
-		_table[idx]->prev = _data;
-	}
-	_table[idx] = _data;
+	_data = _ref_or_create(String::hash(p_name), p_name, nullptr);
 }
 
 StringName::StringName(const StaticCString &p_static_string) {
@@ -206,41 +278,7 @@ StringName::StringName(const StaticCString &p_static_string) {
 
 	ERR_FAIL_COND(!p_static_string.ptr || !p_static_string.ptr[0]);
 
-	MutexLock lock(mutex);
-
-	uint32_t hash = String::hash(p_static_string.ptr);
-
-	uint32_t idx = hash & STRING_TABLE_MASK;
-
-	_data = _table[idx];
-
-	while (_data) {
-		// compare hash first
-		if (_data->hash == hash && _data->get_name() == p_static_string.ptr) {
-			break;
-		}
-		_data = _data->next;
-	}
-
-	if (_data) {
-		if (_data->refcount.ref()) {
-			// exists
-			return;
-		}
-	}
-
-	_data = memnew(_Data);
-
-	_data->refcount.init();
-	_data->hash = hash;
-	_data->idx = idx;
-	_data->cname = p_static_string.ptr;
-	_data->next = _table[idx];
-	_data->prev = nullptr;
-	if (_table[idx]) {
-		_table[idx]->prev = _data;
-	}
-	_table[idx] = _data;
+	_data = _ref_or_create(String::hash(p_static_string.ptr), p_static_string.ptr, p_static_string.ptr);
 }
 
 StringName::StringName(const String &p_name) {
@@ -252,39 +290,7 @@ StringName::StringName(const String &p_name) {
 		return;
 	}
 
-	MutexLock lock(mutex);
-
-	uint32_t hash = p_name.hash();
-	uint32_t idx = hash & STRING_TABLE_MASK;
-
-	_data = _table[idx];
-
-	while (_data) {
-		if (_data->hash == hash && _data->get_name() == p_name) {
-			break;
-		}
-		_data = _data->next;
-	}
-
-	if (_data) {
-		if (_data->refcount.ref()) {
-			// exists
-			return;
-		}
-	}
-
-	_data = memnew(_Data);
-	_data->name = p_name;
-	_data->refcount.init();
-	_data->hash = hash;
-	_data->idx = idx;
-	_data->cname = nullptr;
-	_data->next = _table[idx];
-	_data->prev = nullptr;
-	if (_table[idx]) {
-		_table[idx]->prev = _data;
-	}
-	_table[idx] = _data;
+	_data = _ref_or_create(p_name.hash(), p_name, nullptr);
 }
 
 StringName StringName::search(const char *p_name) {
@@ -295,23 +301,13 @@ StringName StringName::search(const char *p_name) {
 		return StringName();
 	}
 
-	MutexLock lock(mutex);
-
 	uint32_t hash = String::hash(p_name);
-	uint32_t idx = hash & STRING_TABLE_MASK;
+	const _Table &table = _get_table(hash);
+	RWLockRead lock(table.lock);
 
-	_Data *_data = _table[idx];
-
-	while (_data) {
-		// compare hash first
-		if (_data->hash == hash && _data->get_name() == p_name) {
-			break;
-		}
-		_data = _data->next;
-	}
-
-	if (_data && _data->refcount.ref()) {
-		return StringName(_data);
+	_Data *data = _ref_existing(table, hash, p_name);
+	if (data) {
+		return StringName(data);
 	}
 
 	return StringName(); //does not exist
@@ -325,24 +321,13 @@ StringName StringName::search(const char32_t *p_name) {
 		return StringName();
 	}
 
-	MutexLock lock(mutex);
-
 	uint32_t hash = String::hash(p_name);
+	const _Table &table = _get_table(hash);
+	RWLockRead lock(table.lock);
 
-	uint32_t idx = hash & STRING_TABLE_MASK;
-
-	_Data *_data = _table[idx];
-
-	while (_data) {
-		// compare hash first
-		if (_data->hash == hash && _data->get_name() == p_name) {
-			break;
-		}
-		_data = _data->next;
-	}
-
-	if (_data && _data->refcount.ref()) {
-		return StringName(_data);
+	_Data *data = _ref_existing(table, hash, p_name);
+	if (data) {
+		return StringName(data);
 	}
 
 	return StringName(); //does not exist
@@ -351,24 +336,13 @@ StringName StringName::search(const char32_t *p_name) {
 StringName StringName::search(const String &p_name) {
 	ERR_FAIL_COND_V(p_name == "", StringName());
 
-	MutexLock lock(mutex);
-
 	uint32_t hash = p_name.hash();
+	const _Table &table = _get_table(hash);
+	RWLockRead lock(table.lock);
 
-	uint32_t idx = hash & STRING_TABLE_MASK;
-
-	_Data *_data = _table[idx];
-
-	while (_data) {
-		// compare hash first
-		if (_data->hash == hash && p_name == _data->get_name()) {
-			break;
-		}
-		_data = _data->next;
-	}
-
-	if (_data && _data->refcount.ref()) {
-		return StringName(_data);
+	_Data *data = _ref_existing(table, hash, p_name);
+	if (data) {
+		return StringName(data);
 	}
 
 	return StringName(); //does not exist
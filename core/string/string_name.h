@@ -32,6 +32,7 @@
 #define STRING_NAME_H
 
 #include "core/os/mutex.h"
+#include "core/os/rw_lock.h"
 #include "core/string/ustring.h"
 #include "core/templates/safe_refcount.h"
 
@@ -43,10 +44,14 @@ struct StaticCString {
 };
 
 class StringName {
+	// The table is split in shards picked by the top bits of the hash, each with
+	// its own lock and bucket array, so threads interning unrelated names rarely
+	// contend. Lookups of existing names only take a shard's read lock, and each
+	// shard doubles its buckets when it holds more names than buckets.
 	enum {
-		STRING_TABLE_BITS = 12,
-		STRING_TABLE_LEN = 1 << STRING_TABLE_BITS,
-		STRING_TABLE_MASK = STRING_TABLE_LEN - 1
+		STRING_TABLE_SHARD_BITS = 6,
+		STRING_TABLE_SHARDS = 1 << STRING_TABLE_SHARD_BITS,
+		STRING_TABLE_SHARD_MIN_LEN = 64,
 	};
 
 	struct _Data {
@@ -55,14 +60,20 @@ class StringName {
 		String name;
 
 		String get_name() const { return cname ? String(cname) : name; }
-		int idx = 0;
 		uint32_t hash = 0;
 		_Data *prev = nullptr;
 		_Data *next = nullptr;
 		_Data() {}
 	};
 
-	static _Data *_table[STRING_TABLE_LEN];
+	struct _Table {
+		RWLock lock;
+		_Data **buckets = nullptr;
+		uint32_t mask = 0;
+		uint32_t count = 0;
+	};
+
+	static _Table _tables[STRING_TABLE_SHARDS];
 
 	_Data *_data = nullptr;
 
@@ -71,11 +82,19 @@ class StringName {
 		uint32_t hash;
 	};
 
+	static _FORCE_INLINE_ _Table &_get_table(uint32_t p_hash) {
+		return _tables[p_hash >> (32 - STRING_TABLE_SHARD_BITS)];
+	}
+	template <class T>
+	static _Data *_ref_existing(const _Table &p_table, uint32_t p_hash, const T &p_name);
+	template <class T>
+	static _Data *_ref_or_create(uint32_t p_hash, const T &p_name, const char *p_static_cname);
+	static void _grow(_Table &p_table);
+
 	void unref();
 	friend void register_core_types();
 	friend void unregister_core_types();
 	friend class Main;
-	static Mutex mutex;
 	static void setup();
 	static void cleanup();
 	static bool configured;
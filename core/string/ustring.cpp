@@ -46,6 +46,14 @@
 #include <stdlib.h>
 #endif
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define USTRING_SSE2
+#elif defined(__ARM_NEON) && (defined(__aarch64__) || defined(_M_ARM64))
+#include <arm_neon.h>
+#define USTRING_NEON
+#endif
+
 #ifdef _MSC_VER
 #define _CRT_SECURE_NO_WARNINGS // to disable build-time warning which suggested to use strcpy_s instead strcpy
 #endif
@@ -60,6 +68,186 @@
 #define IS_DIGIT(m_d) ((m_d) >= '0' && (m_d) <= '9')
 #define IS_HEX_DIGIT(m_d) (((m_d) >= '0' && (m_d) <= '9') || ((m_d) >= 'a' && (m_d) <= 'f') || ((m_d) >= 'A' && (m_d) <= 'F'))
 
+/*
+ * Helpers for the hottest loops: searching, UTF-8 conversion and case
+ * conversion. They work on 16 bytes at a time with SSE2 or NEON, which all
+ * x86_64 and arm64 CPUs have, and the scalar loops finish the job (or do all
+ * of it on other architectures).
+ */
+
+// Index of the first p_char in [p_from, p_to), or -1.
+static _FORCE_INLINE_ int _find_char32(const char32_t *p_str, int p_from, int p_to, char32_t p_char) {
+	int i = p_from;
+#if defined(USTRING_SSE2)
+	const __m128i needle = _mm_set1_epi32(p_char);
+	for (; i + 4 <= p_to; i += 4) {
+		const __m128i chars = _mm_loadu_si128((const __m128i *)&p_str[i]);
+		if (_mm_movemask_epi8(_mm_cmpeq_epi32(chars, needle))) {
+			break; // It's in these four, the scalar loop tells which.
+		}
+	}
+#elif defined(USTRING_NEON)
+	const uint32x4_t needle = vdupq_n_u32(p_char);
+	for (; i + 4 <= p_to; i += 4) {
+		const uint32x4_t chars = vld1q_u32((const uint32_t *)&p_str[i]);
+		if (vmaxvq_u32(vceqq_u32(chars, needle))) {
+			break;
+		}
+	}
+#endif
+	for (; i < p_to; i++) {
+		if (p_str[i] == p_char) {
+			return i;
+		}
+	}
+	return -1;
+}
+
+// Length of the run of ASCII bytes at the start of p_str, stopping at a zero byte.
+static _FORCE_INLINE_ int _ascii_run_utf8(const char *p_str, int p_len) {
+	int i = 0;
+#if defined(USTRING_SSE2)
+	const __m128i zero = _mm_setzero_si128();
+	for (; i + 16 <= p_len; i += 16) {
+		const __m128i bytes = _mm_loadu_si128((const __m128i *)&p_str[i]);
+		// The top bit is set in bytes that aren't ASCII, and in the zero ones after comparing.
+		if (_mm_movemask_epi8(_mm_or_si128(bytes, _mm_cmpeq_epi8(bytes, zero)))) {
+			break;
+		}
+	}
+#elif defined(USTRING_NEON)
+	const uint8x16_t one = vdupq_n_u8(1);
+	for (; i + 16 <= p_len; i += 16) {
+		const uint8x16_t bytes = vld1q_u8((const uint8_t *)&p_str[i]);
+		// Subtracting one, zero wraps around, and bytes that aren't ASCII stay above 0x7e.
+		if (vmaxvq_u8(vsubq_u8(bytes, one)) >= 0x7f) {
+			break;
+		}
+	}
+#endif
+	for (; i < p_len; i++) {
+		const uint8_t c = p_str[i];
+		if (c == 0 || c >= 0x80) {
+			break;
+		}
+	}
+	return i;
+}
+
+// Copies p_len ASCII bytes to characters.
+static _FORCE_INLINE_ void _widen_ascii(const char *p_src, char32_t *p_dst, int p_len) {
+	int i = 0;
+#if defined(USTRING_SSE2)
+	const __m128i zero = _mm_setzero_si128();
+	for (; i + 16 <= p_len; i += 16) {
+		const __m128i bytes = _mm_loadu_si128((const __m128i *)&p_src[i]);
+		const __m128i low = _mm_unpacklo_epi8(bytes, zero);
+		const __m128i high = _mm_unpackhi_epi8(bytes, zero);
+		_mm_storeu_si128((__m128i *)&p_dst[i], _mm_unpacklo_epi16(low, zero));
+		_mm_storeu_si128((__m128i *)&p_dst[i + 4], _mm_unpackhi_epi16(low, zero));
+		_mm_storeu_si128((__m128i *)&p_dst[i + 8], _mm_unpacklo_epi16(high, zero));
+		_mm_storeu_si128((__m128i *)&p_dst[i + 12], _mm_unpackhi_epi16(high, zero));
+	}
+#elif defined(USTRING_NEON)
+	for (; i + 16 <= p_len; i += 16) {
+		const uint8x16_t bytes = vld1q_u8((const uint8_t *)&p_src[i]);
+		const uint16x8_t low = vmovl_u8(vget_low_u8(bytes));
+		const uint16x8_t high = vmovl_u8(vget_high_u8(bytes));
+		vst1q_u32((uint32_t *)&p_dst[i], vmovl_u16(vget_low_u16(low)));
+		vst1q_u32((uint32_t *)&p_dst[i + 4], vmovl_u16(vget_high_u16(low)));
+		vst1q_u32((uint32_t *)&p_dst[i + 8], vmovl_u16(vget_low_u16(high)));
+		vst1q_u32((uint32_t *)&p_dst[i + 12], vmovl_u16(vget_high_u16(high)));
+	}
+#endif
+	for (; i < p_len; i++) {
+		p_dst[i] = uint8_t(p_src[i]);
+	}
+}
+
+// Length of the run of ASCII characters at the start of p_str.
+static _FORCE_INLINE_ int _ascii_run_utf32(const char32_t *p_str, int p_len) {
+	int i = 0;
+#if defined(USTRING_SSE2)
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i high_bits = _mm_set1_epi32(~0x7f);
+	for (; i + 8 <= p_len; i += 8) {
+		const __m128i chars = _mm_or_si128(_mm_loadu_si128((const __m128i *)&p_str[i]), _mm_loadu_si128((const __m128i *)&p_str[i + 4]));
+		if (_mm_movemask_epi8(_mm_cmpeq_epi32(_mm_and_si128(chars, high_bits), zero)) != 0xffff) {
+			break;
+		}
+	}
+#elif defined(USTRING_NEON)
+	for (; i + 8 <= p_len; i += 8) {
+		const uint32x4_t chars = vorrq_u32(vld1q_u32((const uint32_t *)&p_str[i]), vld1q_u32((const uint32_t *)&p_str[i + 4]));
+		if (vmaxvq_u32(chars) >= 0x80) {
+			break;
+		}
+	}
+#endif
+	for (; i < p_len; i++) {
+		if (p_str[i] >= 0x80) {
+			break;
+		}
+	}
+	return i;
+}
+
+// Copies p_len ASCII characters to bytes.
+static _FORCE_INLINE_ void _narrow_ascii(const char32_t *p_src, uint8_t *p_dst, int p_len) {
+	int i = 0;
+#if defined(USTRING_SSE2)
+	for (; i + 8 <= p_len; i += 8) {
+		const __m128i words = _mm_packs_epi32(_mm_loadu_si128((const __m128i *)&p_src[i]), _mm_loadu_si128((const __m128i *)&p_src[i + 4]));
+		_mm_storel_epi64((__m128i *)&p_dst[i], _mm_packus_epi16(words, words));
+	}
+#elif defined(USTRING_NEON)
+	for (; i + 8 <= p_len; i += 8) {
+		const uint16x8_t words = vcombine_u16(vmovn_u32(vld1q_u32((const uint32_t *)&p_src[i])), vmovn_u32(vld1q_u32((const uint32_t *)&p_src[i + 4])));
+		vst1_u8(&p_dst[i], vmovn_u16(words));
+	}
+#endif
+	for (; i < p_len; i++) {
+		p_dst[i] = p_src[i];
+	}
+}
+
+// Index of the first ASCII uppercase letter or non ASCII character in [p_from, p_to), or p_to.
+static _FORCE_INLINE_ int _find_upper_or_non_ascii(const char32_t *p_str, int p_from, int p_to) {
+	int i = p_from;
+#if defined(USTRING_SSE2)
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i high_bits = _mm_set1_epi32(~0x7f);
+	const __m128i before_a = _mm_set1_epi32('A' - 1);
+	const __m128i after_z = _mm_set1_epi32('Z' + 1);
+	for (; i + 4 <= p_to; i += 4) {
+		const __m128i chars = _mm_loadu_si128((const __m128i *)&p_str[i]);
+		const __m128i ascii = _mm_cmpeq_epi32(_mm_and_si128(chars, high_bits), zero);
+		const __m128i upper = _mm_and_si128(_mm_cmpgt_epi32(chars, before_a), _mm_cmplt_epi32(chars, after_z));
+		if (_mm_movemask_epi8(_mm_andnot_si128(upper, ascii)) != 0xffff) {
+			break;
+		}
+	}
+#elif defined(USTRING_NEON)
+	const uint32x4_t a = vdupq_n_u32('A');
+	const uint32x4_t letters = vdupq_n_u32('Z' - 'A' + 1);
+	const uint32x4_t non_ascii = vdupq_n_u32(0x80);
+	for (; i + 4 <= p_to; i += 4) {
+		const uint32x4_t chars = vld1q_u32((const uint32_t *)&p_str[i]);
+		const uint32x4_t upper = vcltq_u32(vsubq_u32(chars, a), letters);
+		if (vmaxvq_u32(vorrq_u32(upper, vcgeq_u32(chars, non_ascii)))) {
+			break;
+		}
+	}
+#endif
+	for (; i < p_to; i++) {
+		const char32_t c = p_str[i];
+		if ((c >= 'A' && c <= 'Z') || c >= 0x80) {
+			break;
+		}
+	}
+	return i;
+}
+
 const char CharString::_null = 0;
 const char16_t Char16String::_null = 0;
 const char32_t String::_null = 0;
@@ -589,14 +777,8 @@ bool String::operator==(const String &p_str) const {
 	const char32_t *src = get_data();
 	const char32_t *dst = p_str.get_data();
 
-	/* Compare char by char */
-	for (int i = 0; i < l; i++) {
-		if (src[i] != dst[i]) {
-			return false;
-		}
-	}
-
-	return true;
+	// memcmp is vectorized by the C library.
+	return memcmp(src, dst, l * sizeof(char32_t)) == 0;
 }
 
 bool String::operator==(const StrRange &p_str_range) const {
@@ -1282,14 +1464,28 @@ String String::to_upper() const {
 }
 
 String String::to_lower() const {
-	String lower = *this;
+	const int len = length();
+	const char32_t *src = get_data();
 
-	for (int i = 0; i < lower.size(); i++) {
-		const char32_t s = lower[i];
-		const char32_t t = _find_lower(s);
-		if (s != t) { // avoid copy on write
-			lower[i] = t;
+	// Skip what is already lowercase, so unchanged strings aren't copied.
+	int from = 0;
+	while (from < len) {
+		from = _find_upper_or_non_ascii(src, from, len);
+		if (from == len || src[from] < 0x80 || char32_t(_find_lower(src[from])) != src[from]) {
+			break;
 		}
+		from++;
+	}
+
+	if (from == len) {
+		return *this;
+	}
+
+	String lower = *this;
+	char32_t *dst = lower.ptrw();
+	for (int i = from; i < len; i++) {
+		const char32_t c = dst[i];
+		dst[i] = c < 0x80 ? LOWERCASE(c) : _find_lower(c);
 	}
 
 	return lower;
@@ -1713,6 +1909,11 @@ bool String::parse_utf8(const char *p_utf8, int p_len) {
 	int cstr_size = 0;
 	int str_size = 0;
 
+	if (p_len < 0) {
+		// Knowing the length, ASCII runs can be scanned in blocks.
+		p_len = strlen(p_utf8);
+	}
+
 	/* HANDLE BOM (Byte Order Mark) */
 	if (p_len < 0 || p_len >= 3) {
 		bool has_bom = uint8_t(p_utf8[0]) == 0xef && uint8_t(p_utf8[1]) == 0xbb && uint8_t(p_utf8[2]) == 0xbf;
@@ -1733,10 +1934,17 @@ bool String::parse_utf8(const char *p_utf8, int p_len) {
 			if (skip == 0) {
 				uint8_t c = *ptrtmp >= 0 ? *ptrtmp : uint8_t(256 + *ptrtmp);
 
-				/* Determine the number of characters in sequence */
 				if ((c & 0x80) == 0) {
-					skip = 0;
-				} else if ((c & 0xe0) == 0xc0) {
+					// Runs of ASCII characters are the common case.
+					const int ascii = _ascii_run_utf8(ptrtmp, ptrtmp_limit - ptrtmp);
+					str_size += ascii;
+					cstr_size += ascii;
+					ptrtmp += ascii;
+					continue;
+				}
+
+				/* Determine the number of characters in sequence */
+				if ((c & 0xe0) == 0xc0) {
 					skip = 1;
 				} else if ((c & 0xf0) == 0xe0) {
 					skip = 2;
@@ -1780,10 +1988,17 @@ bool String::parse_utf8(const char *p_utf8, int p_len) {
 	while (cstr_size) {
 		int len = 0;
 
-		/* Determine the number of characters in sequence */
 		if ((*p_utf8 & 0x80) == 0) {
-			len = 1;
-		} else if ((*p_utf8 & 0xe0) == 0xc0) {
+			const int ascii = _ascii_run_utf8(p_utf8, cstr_size);
+			_widen_ascii(p_utf8, dst, ascii);
+			dst += ascii;
+			cstr_size -= ascii;
+			p_utf8 += ascii;
+			continue;
+		}
+
+		/* Determine the number of characters in sequence */
+		if ((*p_utf8 & 0xe0) == 0xc0) {
 			len = 2;
 		} else if ((*p_utf8 & 0xf0) == 0xe0) {
 			len = 3;
@@ -1849,8 +2064,11 @@ CharString String::utf8() const {
 	int fl = 0;
 	for (int i = 0; i < l; i++) {
 		uint32_t c = d[i];
-		if (c <= 0x7f) { // 7 bits.
-			fl += 1;
+		if (c <= 0x7f) { // 7 bits, usually a run of them.
+			const int ascii = _ascii_run_utf32(&d[i], l - i);
+			fl += ascii;
+			i += ascii - 1;
+			continue;
 		} else if (c <= 0x7ff) { // 11 bits
 			fl += 2;
 		} else if (c <= 0xffff) { // 16 bits
@@ -1881,7 +2099,10 @@ CharString String::utf8() const {
 		uint32_t c = d[i];
 
 		if (c <= 0x7f) { // 7 bits.
-			APPEND_CHAR(c);
+			const int ascii = _ascii_run_utf32(&d[i], l - i);
+			_narrow_ascii(&d[i], cdst, ascii);
+			cdst += ascii;
+			i += ascii - 1;
 		} else if (c <= 0x7ff) { // 11 bits
 			APPEND_CHAR(uint32_t(0xc0 | ((c >> 6) & 0x1f))); // Top 5 bits.
 			APPEND_CHAR(uint32_t(0x80 | (c & 0x3f))); // Bottom 6 bits.
@@ -2797,17 +3018,12 @@ int String::find(const String &p_str, int p_from) const {
 	const char32_t *src = get_data();
 	const char32_t *str = p_str.get_data();
 
-	for (int i = p_from; i <= (len - src_len); i++) {
+	// Only compare the rest where the first character matches.
+	const int last = len - src_len;
+	for (int i = _find_char32(src, p_from, last + 1, str[0]); i != -1; i = _find_char32(src, i + 1, last + 1, str[0])) {
 		bool found = true;
-		for (int j = 0; j < src_len; j++) {
-			int read_pos = i + j;
-
-			if (read_pos >= len) {
-				ERR_PRINT("read_pos>=len");
-				return -1;
-			}
-
-			if (src[read_pos] != str[j]) {
+		for (int j = 1; j < src_len; j++) {
+			if (src[i + j] != str[j]) {
 				found = false;
 				break;
 			}
@@ -2840,26 +3056,18 @@ int String::find(const char *p_str, int p_from) const {
 	}
 
 	if (src_len == 1) {
-		const char32_t needle = p_str[0];
+		return _find_char32(src, p_from, len, (char32_t)p_str[0]);
 
-		for (int i = p_from; i < len; i++) {
-			if (src[i] == needle) {
-				return i;
-			}
-		}
+	} else if (src_len == 0) {
+		return p_from <= len ? p_from : -1;
 
 	} else {
-		for (int i = p_from; i <= (len - src_len); i++) {
+		const char32_t first = (char32_t)p_str[0];
+		const int last = len - src_len;
+		for (int i = _find_char32(src, p_from, last + 1, first); i != -1; i = _find_char32(src, i + 1, last + 1, first)) {
 			bool found = true;
-			for (int j = 0; j < src_len; j++) {
-				int read_pos = i + j;
-
-				if (read_pos >= len) {
-					ERR_PRINT("read_pos>=len");
-					return -1;
-				}
-
-				if (src[read_pos] != (char32_t)p_str[j]) {
+			for (int j = 1; j < src_len; j++) {
+				if (src[i + j] != (char32_t)p_str[j]) {
 					found = false;
 					break;
 				}
@@ -2875,7 +3083,11 @@ int String::find(const char *p_str, int p_from) const {
 }
 
 int String::find_char(const char32_t &p_char, int p_from) const {
-	return _cowdata.find(p_char, p_from);
+	if (p_from < 0) {
+		return -1;
+	}
+	// Like CowData::find(), the terminating zero is included.
+	return _find_char32(get_data(), p_from, size(), p_char);
 }
 
 int String::findmk(const Vector<String> &p_keys, int p_from, int *r_key) const {
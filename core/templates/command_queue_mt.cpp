@@ -70,35 +70,47 @@ CommandQueueMT::SyncSemaphore *CommandQueueMT::_alloc_sync_sem() {
 	return &sync_sems[idx];
 }
 
-bool CommandQueueMT::dealloc_one() {
-tryagain:
-	if (dealloc_ptr == (write_ptr_and_epoch >> 1)) {
-		// The queue is empty
-		return false;
-	}
+CommandQueueMT::Block *CommandQueueMT::_create_block(uint32_t p_size) {
+	void *mem = memalloc(DATA_OFFSET + p_size);
+	Block *block = memnew_placement(mem, Block);
+	block->size = p_size;
+	return block;
+}
 
-	uint32_t size = *(uint32_t *)&command_mem[dealloc_ptr];
+void CommandQueueMT::_free_block(Block *p_block) {
+	p_block->~Block();
+	memfree(p_block);
+}
 
-	if (size == 0) {
-		// End of command buffer wrap down
-		dealloc_ptr = 0;
-		goto tryagain;
+void CommandQueueMT::_retire_block(Block *p_block) {
+	if (flush_depth > 0) {
+		// A command from this block is still running (it flushed the queue), release it later.
+		p_block->retired_next = retired_blocks;
+		retired_blocks = p_block;
+		return;
 	}
 
-	if (size & 1) {
-		// Still used, nothing can be deallocated
-		return false;
+	Block *expected = nullptr;
+	if (!spare_block.compare_exchange_strong(expected, p_block)) {
+		_free_block(p_block);
 	}
+}
 
-	dealloc_ptr += (size >> 1) + 8;
-	return true;
+void CommandQueueMT::_release_retired_blocks() {
+	while (retired_blocks) {
+		Block *block = retired_blocks;
+		retired_blocks = block->retired_next;
+		block->retired_next = nullptr;
+		_retire_block(block);
+	}
 }
 
 CommandQueueMT::CommandQueueMT(bool p_sync) {
-	command_mem_size = GLOBAL_DEF_RST("memory/limits/command_queue/multithreading_queue_size_kb", DEFAULT_COMMAND_MEM_SIZE_KB);
+	block_size = GLOBAL_DEF_RST("memory/limits/command_queue/multithreading_queue_size_kb", DEFAULT_COMMAND_MEM_SIZE_KB);
 	ProjectSettings::get_singleton()->set_custom_property_info("memory/limits/command_queue/multithreading_queue_size_kb", PropertyInfo(Variant::INT, "memory/limits/command_queue/multithreading_queue_size_kb", PROPERTY_HINT_RANGE, "1,4096,1,or_greater"));
-	command_mem_size *= 1024;
-	command_mem = (uint8_t *)memalloc(command_mem_size);
+	block_size *= 1024;
+	write_block = _create_block(block_size);
+	read_block = write_block;
 	if (p_sync) {
 		sync = memnew(Semaphore);
 	}
@@ -108,5 +120,15 @@ CommandQueueMT::~CommandQueueMT() {
 	if (sync) {
 		memdelete(sync);
 	}
-	memfree(command_mem);
+	_release_retired_blocks();
+	Block *block = read_block;
+	while (block) {
+		Block *next = block->next.load();
+		_free_block(block);
+		block = next;
+	}
+	Block *spare = spare_block.exchange(nullptr);
+	if (spare) {
+		_free_block(spare);
+	}
 }
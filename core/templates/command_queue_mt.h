@@ -37,6 +37,8 @@
 #include "core/templates/simple_type.h"
 #include "core/typedefs.h"
 
+#include <atomic>
+
 #define COMMA(N) _COMMA_##N
 #define _COMMA_0
 #define _COMMA_1 ,
@@ -252,9 +254,7 @@
 		cmd->instance = p_instance;                                          \
 		cmd->method = p_method;                                              \
 		SEMIC_SEP_LIST(CMD_ASSIGN_PARAM, N);                                 \
-		unlock();                                                            \
-		if (sync)                                                            \
-			sync->post();                                                    \
+		commit_and_unlock();                                                 \
 	}
 
 #define CMD_RET_TYPE(N) CommandRet##N<T, M, COMMA_SEP_LIST(TYPE_ARG, N) COMMA(N) R>
@@ -269,9 +269,7 @@
 		SEMIC_SEP_LIST(CMD_ASSIGN_PARAM, N);                                                   \
 		cmd->ret = r_ret;                                                                      \
 		cmd->sync_sem = ss;                                                                    \
-		unlock();                                                                              \
-		if (sync)                                                                              \
-			sync->post();                                                                      \
+		commit_and_unlock();                                                                   \
 		ss->sem.wait();                                                                        \
 		ss->in_use = false;                                                                    \
 	}
@@ -287,9 +285,7 @@
 		cmd->method = p_method;                                                       \
 		SEMIC_SEP_LIST(CMD_ASSIGN_PARAM, N);                                          \
 		cmd->sync_sem = ss;                                                           \
-		unlock();                                                                     \
-		if (sync)                                                                     \
-			sync->post();                                                             \
+		commit_and_unlock();                                                          \
 		ss->sem.wait();                                                               \
 		ss->in_use = false;                                                           \
 	}
@@ -299,7 +295,7 @@
 class CommandQueueMT {
 	struct SyncSemaphore {
 		Semaphore sem;
-		bool in_use = false;
+		std::atomic<bool> in_use = { false };
 	};
 
 	struct CommandBase {
@@ -334,141 +330,144 @@ class CommandQueueMT {
 		SYNC_SEMAPHORES = 8
 	};
 
-	uint8_t *command_mem = nullptr;
-	uint32_t read_ptr_and_epoch = 0;
-	uint32_t write_ptr_and_epoch = 0;
-	uint32_t dealloc_ptr = 0;
-	uint32_t command_mem_size = 0;
+	// Commands are written to a chain of blocks, each one prefixed by its size.
+	// Only the producer writes to the last block and only the consumer reads
+	// from the first one, so the consumer never has to lock. When the last block
+	// is full, a new one is linked after it instead of waiting for the consumer
+	// to make room.
+	struct Block {
+		std::atomic<Block *> next = { nullptr };
+		std::atomic<uint32_t> write_pos = { 0 }; // Commands before this are ready to be read.
+		uint32_t read_pos = 0; // Only used by the consumer.
+		uint32_t size = 0;
+		Block *retired_next = nullptr; // Only used by the consumer.
+
+		uint8_t *get_data() { return reinterpret_cast<uint8_t *>(this) + DATA_OFFSET; }
+	};
+
+	static const uint32_t DATA_OFFSET = (sizeof(Block) + 8 - 1) & ~(8 - 1);
+
+	// Producer side, guarded by the mutex.
+	Block *write_block = nullptr;
+	Block *link_from = nullptr; // Set until the first command of a new write_block is committed.
+	uint32_t write_pos = 0;
+
+	// Consumer side.
+	Block *read_block = nullptr;
+	Block *retired_blocks = nullptr; // Blocks left while a command was running, released after it returns.
+	uint32_t flush_depth = 0;
+
+	// Kept by the consumer when it's done with a block, so the producer rarely has to allocate.
+	std::atomic<Block *> spare_block = { nullptr };
+	// Set by the consumer before it sleeps, so producers only post the semaphore when needed.
+	std::atomic<bool> consumer_waiting = { false };
+
+	uint32_t block_size = 0;
 	SyncSemaphore sync_sems[SYNC_SEMAPHORES];
 	Mutex mutex;
 	Semaphore *sync = nullptr;
 
 	template <class T>
 	T *allocate() {
-		// alloc size is size+T+safeguard
-		uint32_t alloc_size = ((sizeof(T) + 8 - 1) & ~(8 - 1)) + 8;
-
-		// Assert that the buffer is big enough to hold at least two messages.
-		ERR_FAIL_COND_V(alloc_size * 2 + sizeof(uint32_t) > command_mem_size, nullptr);
-
-	tryagain:
-		uint32_t write_ptr = write_ptr_and_epoch >> 1;
-
-		if (write_ptr < dealloc_ptr) {
-			// behind dealloc_ptr, check that there is room
-			if ((dealloc_ptr - write_ptr) <= alloc_size) {
-				// There is no more room, try to deallocate something
-				if (dealloc_one()) {
-					goto tryagain;
-				}
-				return nullptr;
+		// The command is prefixed by its size, both padded to 8 bytes.
+		uint32_t size = (sizeof(T) + 8 - 1) & ~(8 - 1);
+		uint32_t alloc_size = size + 8;
+
+		if (write_block->size - write_pos < alloc_size) {
+			// No room left, continue on another block. It's linked when the command is committed.
+			Block *block = spare_block.exchange(nullptr);
+			if (block && block->size < alloc_size) {
+				_free_block(block);
+				block = nullptr;
 			}
-		} else {
-			// ahead of dealloc_ptr, check that there is room
-
-			if ((command_mem_size - write_ptr) < alloc_size + sizeof(uint32_t)) {
-				// no room at the end, wrap down;
-
-				if (dealloc_ptr == 0) { // don't want write_ptr to become dealloc_ptr
-
-					// There is no more room, try to deallocate something
-					if (dealloc_one()) {
-						goto tryagain;
-					}
-					return nullptr;
-				}
-
-				// if this happens, it's a bug
-				ERR_FAIL_COND_V((command_mem_size - write_ptr) < 8, nullptr);
-				// zero means, wrap to beginning
-
-				uint32_t *p = (uint32_t *)&command_mem[write_ptr];
-				*p = 1;
-				write_ptr_and_epoch = 0 | (1 & ~write_ptr_and_epoch); // Invert epoch.
-				// See if we can get the thread to run and clear up some more space while we wait.
-				// This is required if alloc_size * 2 + 4 > COMMAND_MEM_SIZE
-				if (sync) {
-					sync->post();
-				}
-				goto tryagain;
+			if (block) {
+				block->next.store(nullptr, std::memory_order_relaxed);
+				block->write_pos.store(0, std::memory_order_relaxed);
+				block->read_pos = 0;
+			} else {
+				block = _create_block(MAX(block_size, alloc_size));
 			}
+			link_from = write_block;
+			write_block = block;
+			write_pos = 0;
 		}
-		// Allocate the size and the 'in use' bit.
-		// First bit used to mark if command is still in use (1)
-		// or if it has been destroyed and can be deallocated (0).
-		uint32_t size = (sizeof(T) + 8 - 1) & ~(8 - 1);
-		uint32_t *p = (uint32_t *)&command_mem[write_ptr];
-		*p = (size << 1) | 1;
-		write_ptr += 8;
-		// allocate the command
-		T *cmd = memnew_placement(&command_mem[write_ptr], T);
-		write_ptr += size;
-		write_ptr_and_epoch = (write_ptr << 1) | (write_ptr_and_epoch & 1);
+
+		uint32_t *p = (uint32_t *)&write_block->get_data()[write_pos];
+		*p = size;
+		T *cmd = memnew_placement(&write_block->get_data()[write_pos + 8], T);
+		write_pos += alloc_size;
 		return cmd;
 	}
 
 	template <class T>
 	T *allocate_and_lock() {
 		lock();
-		T *ret;
+		return allocate<T>();
+	}
 
-		while ((ret = allocate<T>()) == nullptr) {
-			unlock();
-			// sleep a little until fetch happened and some room is made
-			wait_for_flush();
-			lock();
+	void commit_and_unlock() {
+		write_block->write_pos.store(write_pos);
+		if (link_from) {
+			// Only link the new block once it holds a command, so the consumer never finds an empty one.
+			link_from->next.store(write_block);
+			link_from = nullptr;
 		}
+		unlock();
 
-		return ret;
+		if (sync && consumer_waiting.load() && consumer_waiting.exchange(false)) {
+			sync->post();
+		}
 	}
 
-	bool flush_one(bool p_lock = true) {
-		if (p_lock) {
-			lock();
-		}
-	tryagain:
+	bool _has_commands() const {
+		return read_block->read_pos != read_block->write_pos.load() || read_block->next.load() != nullptr;
+	}
 
-		// tried to read an empty queue
-		if (read_ptr_and_epoch == write_ptr_and_epoch) {
-			if (p_lock) {
-				unlock();
+	void _wait_for_commands() {
+		while (!_has_commands()) {
+			consumer_waiting.store(true);
+			if (_has_commands()) {
+				if (!consumer_waiting.exchange(false)) {
+					// A producer already cleared the flag, take its post so the semaphore stays balanced.
+					sync->wait();
+				}
+				break;
 			}
-			return false;
+			sync->wait();
 		}
+	}
 
-		uint32_t read_ptr = read_ptr_and_epoch >> 1;
-		uint32_t size_ptr = read_ptr;
-		uint32_t size = *(uint32_t *)&command_mem[read_ptr] >> 1;
+	bool flush_one() {
+		Block *block = read_block;
 
-		if (size == 0) {
-			*(uint32_t *)&command_mem[read_ptr] = 0; // clear in-use bit.
-			//end of ringbuffer, wrap
-			read_ptr_and_epoch = 0 | (1 & ~read_ptr_and_epoch); // Invert epoch.
-			goto tryagain;
+		if (block->read_pos == block->write_pos.load()) {
+			Block *next = block->next.load();
+			if (!next) {
+				// tried to read an empty queue
+				return false;
+			}
+			// The producer was done with this block before linking the next one, check for last commands.
+			if (block->read_pos == block->write_pos.load()) {
+				read_block = next;
+				_retire_block(block);
+				block = next;
+			}
 		}
 
-		read_ptr += 8;
-
-		CommandBase *cmd = reinterpret_cast<CommandBase *>(&command_mem[read_ptr]);
+		uint8_t *ptr = &block->get_data()[block->read_pos];
+		uint32_t size = *(uint32_t *)ptr;
+		block->read_pos += size + 8;
 
-		read_ptr += size;
+		CommandBase *cmd = reinterpret_cast<CommandBase *>(ptr + 8);
 
-		read_ptr_and_epoch = (read_ptr << 1) | (read_ptr_and_epoch & 1);
-
-		if (p_lock) {
-			unlock();
-		}
+		flush_depth++;
 		cmd->call();
-		if (p_lock) {
-			lock();
-		}
-
 		cmd->post();
 		cmd->~CommandBase();
-		*(uint32_t *)&command_mem[size_ptr] &= ~1;
+		flush_depth--;
 
-		if (p_lock) {
-			unlock();
+		if (flush_depth == 0 && retired_blocks) {
+			_release_retired_blocks();
 		}
 		return true;
 	}
@@ -477,7 +476,10 @@ class CommandQueueMT {
 	void unlock();
 	void wait_for_flush();
 	SyncSemaphore *_alloc_sync_sem();
-	bool dealloc_one();
+	Block *_create_block(uint32_t p_size);
+	void _free_block(Block *p_block);
+	void _retire_block(Block *p_block);
+	void _release_retired_blocks();
 
 public:
 	/* NORMAL PUSH COMMANDS */
@@ -492,18 +494,25 @@ public:
 	DECL_PUSH_AND_SYNC(0)
 	SPACE_SEP_LIST(DECL_PUSH_AND_SYNC, 15)
 
+	// Consumer side. Only one thread may flush at a time.
+
 	void wait_and_flush_one() {
 		ERR_FAIL_COND(!sync);
-		sync->wait();
+		_wait_for_commands();
 		flush_one();
 	}
 
+	// Waits for commands, then runs all those available, so the consumer
+	// wakes up once per batch instead of once per command.
+	void wait_and_flush() {
+		ERR_FAIL_COND(!sync);
+		_wait_for_commands();
+		flush_all();
+	}
+
 	void flush_all() {
-		//ERR_FAIL_COND(sync);
-		lock();
-		while (flush_one(false)) {
+		while (flush_one()) {
 		}
-		unlock();
 	}
 
 	CommandQueueMT(bool p_sync);
@@ -0,0 +1,324 @@
+/*************************************************************************/
+/*  flat_hash_map.h                                                      */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef FLAT_HASH_MAP_H
+#define FLAT_HASH_MAP_H
+
+#include "core/os/copymem.h"
+#include "core/os/memory.h"
+#include "core/templates/hashfuncs.h"
+#include "core/templates/local_vector.h"
+
+/**
+ * A hash map that keeps its elements packed in an array, and finds them with
+ * an open addressed index using Robin Hood hashing and backward shift deletion
+ * (like OAHashMap). Lookups only touch small index slots until the key
+ * matches, iterating only touches the elements, and an empty map allocates
+ * nothing, which makes it a good replacement for Map in hot paths where the
+ * key order is not needed.
+ *
+ * Elements are iterated by index, in insertion order. Erasing an element moves
+ * the last one into its place, so the loop must not advance after erase_index():
+ *
+ *     for (uint32_t i = 0; i < map.size();) {
+ *         if (map.get_value(i).remove_me) {
+ *             map.erase_index(i);
+ *         } else {
+ *             i++;
+ *         }
+ *     }
+ *
+ * Inserting or erasing invalidates pointers to the elements, use Map when
+ * they need to stay stable.
+ */
+template <class TKey, class TValue,
+		class Hasher = HashMapHasherDefault,
+		class Comparator = HashMapComparatorDefault<TKey>>
+class FlatHashMap {
+public:
+	struct Element {
+		TKey key;
+		TValue value;
+	};
+
+private:
+	struct Slot {
+		uint32_t hash;
+		uint32_t index; // In elements.
+	};
+
+	static const uint32_t EMPTY_HASH = 0;
+	static const uint32_t MIN_CAPACITY = 8;
+
+	LocalVector<Element> elements;
+	Slot *slots = nullptr;
+	uint32_t capacity = 0; // Of slots, a power of 2.
+
+	_FORCE_INLINE_ uint32_t _hash(const TKey &p_key) const {
+		uint32_t hash = Hasher::hash(p_key);
+
+		if (hash == EMPTY_HASH) {
+			hash = EMPTY_HASH + 1;
+		}
+
+		return hash;
+	}
+
+	_FORCE_INLINE_ uint32_t _get_probe_length(uint32_t p_pos, uint32_t p_hash) const {
+		return (p_pos - p_hash) & (capacity - 1);
+	}
+
+	bool _lookup_pos(const TKey &p_key, uint32_t p_hash, uint32_t &r_pos) const {
+		if (!slots) {
+			return false;
+		}
+
+		uint32_t pos = p_hash & (capacity - 1);
+		uint32_t distance = 0;
+
+		while (true) {
+			const Slot &slot = slots[pos];
+			if (slot.hash == EMPTY_HASH || distance > _get_probe_length(pos, slot.hash)) {
+				return false;
+			}
+
+			if (slot.hash == p_hash && Comparator::compare(elements[slot.index].key, p_key)) {
+				r_pos = pos;
+				return true;
+			}
+
+			pos = (pos + 1) & (capacity - 1);
+			distance++;
+		}
+	}
+
+	// Position of the slot pointing to an element, which must exist.
+	uint32_t _get_element_pos(uint32_t p_index) const {
+		uint32_t pos = _hash(elements[p_index].key) & (capacity - 1);
+		while (slots[pos].index != p_index || slots[pos].hash == EMPTY_HASH) {
+			pos = (pos + 1) & (capacity - 1);
+		}
+		return pos;
+	}
+
+	void _insert_slot(uint32_t p_hash, uint32_t p_index) {
+		Slot slot = { p_hash, p_index };
+		uint32_t pos = p_hash & (capacity - 1);
+		uint32_t distance = 0;
+
+		while (true) {
+			if (slots[pos].hash == EMPTY_HASH) {
+				slots[pos] = slot;
+				return;
+			}
+
+			// Take the place of entries closer to their ideal position.
+			uint32_t existing_probe_len = _get_probe_length(pos, slots[pos].hash);
+			if (existing_probe_len < distance) {
+				SWAP(slot, slots[pos]);
+				distance = existing_probe_len;
+			}
+
+			pos = (pos + 1) & (capacity - 1);
+			distance++;
+		}
+	}
+
+	void _erase_slot(uint32_t p_pos) {
+		uint32_t pos = p_pos;
+		uint32_t next_pos = (pos + 1) & (capacity - 1);
+		while (slots[next_pos].hash != EMPTY_HASH && _get_probe_length(next_pos, slots[next_pos].hash) != 0) {
+			slots[pos] = slots[next_pos];
+			pos = next_pos;
+			next_pos = (pos + 1) & (capacity - 1);
+		}
+		slots[pos].hash = EMPTY_HASH;
+	}
+
+	void _resize_slots(uint32_t p_capacity) {
+		Slot *old_slots = slots;
+		uint32_t old_capacity = capacity;
+
+		capacity = p_capacity;
+		slots = static_cast<Slot *>(Memory::alloc_static(sizeof(Slot) * capacity));
+		for (uint32_t i = 0; i < capacity; i++) {
+			slots[i].hash = EMPTY_HASH;
+		}
+
+		if (old_slots) {
+			for (uint32_t i = 0; i < old_capacity; i++) {
+				if (old_slots[i].hash != EMPTY_HASH) {
+					_insert_slot(old_slots[i].hash, old_slots[i].index);
+				}
+			}
+			Memory::free_static(old_slots);
+		}
+	}
+
+	Element *_insert(const TKey &p_key, const TValue &p_value, uint32_t p_hash) {
+		// Keep the index at most 3/4 full, probes stay short.
+		if ((elements.size() + 1) * 4 > capacity * 3) {
+			_resize_slots(MAX(capacity * 2, MIN_CAPACITY));
+		}
+
+		uint32_t index = elements.size();
+		elements.push_back({ p_key, p_value });
+		_insert_slot(p_hash, index);
+		return &elements[index];
+	}
+
+public:
+	_FORCE_INLINE_ uint32_t size() const { return elements.size(); }
+	_FORCE_INLINE_ bool is_empty() const { return elements.is_empty(); }
+
+	_FORCE_INLINE_ const TKey &get_key(uint32_t p_index) const { return elements[p_index].key; }
+	_FORCE_INLINE_ TValue &get_value(uint32_t p_index) { return elements[p_index].value; }
+	_FORCE_INLINE_ const TValue &get_value(uint32_t p_index) const { return elements[p_index].value; }
+
+	// Returns -1 if the key is not in the map.
+	int64_t find_index(const TKey &p_key) const {
+		uint32_t pos = 0;
+		if (!_lookup_pos(p_key, _hash(p_key), pos)) {
+			return -1;
+		}
+		return slots[pos].index;
+	}
+
+	_FORCE_INLINE_ bool has(const TKey &p_key) const {
+		return find_index(p_key) != -1;
+	}
+
+	TValue *getptr(const TKey &p_key) {
+		int64_t index = find_index(p_key);
+		return index == -1 ? nullptr : &elements[index].value;
+	}
+
+	const TValue *getptr(const TKey &p_key) const {
+		int64_t index = find_index(p_key);
+		return index == -1 ? nullptr : &elements[index].value;
+	}
+
+	// Replaces the value if the key is already in the map.
+	Element *insert(const TKey &p_key, const TValue &p_value) {
+		uint32_t hash = _hash(p_key);
+		uint32_t pos = 0;
+		if (_lookup_pos(p_key, hash, pos)) {
+			Element *e = &elements[slots[pos].index];
+			e->value = p_value;
+			return e;
+		}
+		return _insert(p_key, p_value, hash);
+	}
+
+	const TValue &operator[](const TKey &p_key) const {
+		const TValue *value = getptr(p_key);
+		CRASH_COND(!value);
+		return *value;
+	}
+
+	TValue &operator[](const TKey &p_key) {
+		uint32_t hash = _hash(p_key);
+		uint32_t pos = 0;
+		if (_lookup_pos(p_key, hash, pos)) {
+			return elements[slots[pos].index].value;
+		}
+		return _insert(p_key, TValue(), hash)->value;
+	}
+
+	void erase_index(uint32_t p_index) {
+		ERR_FAIL_UNSIGNED_INDEX(p_index, elements.size());
+
+		_erase_slot(_get_element_pos(p_index));
+
+		uint32_t last = elements.size() - 1;
+		if (p_index != last) {
+			slots[_get_element_pos(last)].index = p_index;
+		}
+		elements.remove_unordered(p_index);
+	}
+
+	bool erase(const TKey &p_key) {
+		int64_t index = find_index(p_key);
+		if (index == -1) {
+			return false;
+		}
+		erase_index(index);
+		return true;
+	}
+
+	// Keeps the memory, for maps that are filled again.
+	void clear() {
+		elements.clear();
+		for (uint32_t i = 0; i < capacity; i++) {
+			slots[i].hash = EMPTY_HASH;
+		}
+	}
+
+	void reserve(uint32_t p_size) {
+		elements.reserve(p_size);
+		uint32_t new_capacity = MAX(next_power_of_2(p_size + p_size / 3 + 1), MIN_CAPACITY);
+		if (new_capacity > capacity) {
+			_resize_slots(new_capacity);
+		}
+	}
+
+	FlatHashMap() {}
+
+	FlatHashMap(const FlatHashMap &p_other) {
+		*this = p_other;
+	}
+
+	FlatHashMap &operator=(const FlatHashMap &p_other) {
+		if (this == &p_other) {
+			return *this;
+		}
+
+		elements = p_other.elements;
+		if (capacity != p_other.capacity) {
+			if (slots) {
+				Memory::free_static(slots);
+			}
+			capacity = p_other.capacity;
+			slots = capacity ? static_cast<Slot *>(Memory::alloc_static(sizeof(Slot) * capacity)) : nullptr;
+		}
+		if (capacity) {
+			copymem(slots, p_other.slots, sizeof(Slot) * capacity);
+		}
+		return *this;
+	}
+
+	~FlatHashMap() {
+		if (slots) {
+			Memory::free_static(slots);
+		}
+	}
+};
+
+#endif // FLAT_HASH_MAP_H
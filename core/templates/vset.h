@@ -126,6 +126,7 @@ public:
 		return _find_exact(p_val);
 	}
 
+	_FORCE_INLINE_ void clear() { _data.clear(); }
 	_FORCE_INLINE_ bool is_empty() const { return _data.is_empty(); }
 
 	_FORCE_INLINE_ int size() const { return _data.size(); }
@@ -34,13 +34,191 @@
 #include "core/object/class_db.h"
 #include "core/object/script_language.h"
 #include "core/templates/hashfuncs.h"
+#include "core/templates/sort_array.h"
 #include "core/templates/vector.h"
 #include "core/variant/variant.h"
 
+// Keeps the first elements inline, in the ArrayPrivate, so small arrays (like
+// the ones returned by physics queries or passed to scripts as arguments) are
+// created with a single allocation. Past that, elements go to a copy-on-write
+// Vector, so copying a large storage (e.g. when assigning between typed and
+// untyped arrays) only shares the buffer, like it did before.
+class ArrayStorage {
+	static const int INLINE_CAPACITY = 4;
+
+	Vector<Variant> heap; // Holds all the elements once they don't fit inline.
+	Variant inline_data[INLINE_CAPACITY];
+	int inline_count = 0;
+	bool use_heap = false;
+
+	void _move_to_heap(int p_size) {
+		heap.resize(p_size);
+		Variant *w = heap.ptrw();
+		for (int i = 0; i < inline_count; i++) {
+			w[i] = inline_data[i];
+			inline_data[i] = Variant();
+		}
+		inline_count = 0;
+		use_heap = true;
+	}
+
+public:
+	_FORCE_INLINE_ int size() const { return use_heap ? heap.size() : inline_count; }
+	_FORCE_INLINE_ bool is_empty() const { return size() == 0; }
+	_FORCE_INLINE_ Variant *ptrw() { return use_heap ? heap.ptrw() : inline_data; }
+	_FORCE_INLINE_ const Variant *ptr() const { return use_heap ? heap.ptr() : inline_data; }
+
+	_FORCE_INLINE_ Variant &operator[](int p_index) {
+		CRASH_BAD_INDEX(p_index, size());
+		return ptrw()[p_index];
+	}
+
+	_FORCE_INLINE_ const Variant &operator[](int p_index) const {
+		CRASH_BAD_INDEX(p_index, size());
+		return ptr()[p_index];
+	}
+
+	_FORCE_INLINE_ const Variant &get(int p_index) const {
+		return operator[](p_index);
+	}
+
+	void clear() {
+		heap.clear();
+		for (int i = 0; i < inline_count; i++) {
+			inline_data[i] = Variant();
+		}
+		inline_count = 0;
+		use_heap = false;
+	}
+
+	Error resize(int p_size) {
+		ERR_FAIL_COND_V(p_size < 0, ERR_INVALID_PARAMETER);
+		if (use_heap) {
+			return heap.resize(p_size);
+		}
+		if (p_size > INLINE_CAPACITY) {
+			_move_to_heap(p_size);
+			return OK;
+		}
+		for (int i = p_size; i < inline_count; i++) {
+			inline_data[i] = Variant();
+		}
+		inline_count = p_size;
+		return OK;
+	}
+
+	Error insert(int p_pos, const Variant &p_value) {
+		ERR_FAIL_INDEX_V(p_pos, size() + 1, ERR_INVALID_PARAMETER);
+		if (!use_heap && inline_count == INLINE_CAPACITY) {
+			// The value may be one of the elements, which move to the heap.
+			Variant value = p_value;
+			_move_to_heap(INLINE_CAPACITY);
+			return heap.insert(p_pos, value);
+		}
+		if (use_heap) {
+			return heap.insert(p_pos, p_value);
+		}
+		Variant value = p_value;
+		for (int i = inline_count; i > p_pos; i--) {
+			inline_data[i] = inline_data[i - 1];
+		}
+		inline_data[p_pos] = value;
+		inline_count++;
+		return OK;
+	}
+
+	_FORCE_INLINE_ void push_back(const Variant &p_value) {
+		if (use_heap) {
+			heap.push_back(p_value);
+		} else if (likely(inline_count < INLINE_CAPACITY)) {
+			inline_data[inline_count++] = p_value;
+		} else {
+			insert(inline_count, p_value);
+		}
+	}
+
+	void append_array(const ArrayStorage &p_other) {
+		int from = size();
+		int other_count = p_other.size(); // Can be this array.
+		resize(from + other_count);
+		Variant *w = ptrw();
+		const Variant *r = p_other.ptr();
+		for (int i = 0; i < other_count; i++) {
+			w[from + i] = r[i];
+		}
+	}
+
+	void remove(int p_index) {
+		ERR_FAIL_INDEX(p_index, size());
+		if (use_heap) {
+			heap.remove(p_index);
+			return;
+		}
+		for (int i = p_index; i < inline_count - 1; i++) {
+			inline_data[i] = inline_data[i + 1];
+		}
+		inline_data[--inline_count] = Variant();
+	}
+
+	int find(const Variant &p_value, int p_from = 0) const {
+		if (p_from < 0) {
+			return -1;
+		}
+		const Variant *r = ptr();
+		for (int i = p_from; i < size(); i++) {
+			if (r[i] == p_value) {
+				return i;
+			}
+		}
+		return -1;
+	}
+
+	void erase(const Variant &p_value) {
+		int index = find(p_value);
+		if (index != -1) {
+			remove(index);
+		}
+	}
+
+	void invert() {
+		int count = size();
+		Variant *w = ptrw();
+		for (int i = 0; i < count / 2; i++) {
+			SWAP(w[i], w[count - i - 1]);
+		}
+	}
+
+	template <class C>
+	void sort_custom() {
+		SortArray<Variant, C> sorter;
+		sorter.sort(ptrw(), size());
+	}
+
+	// Shares the elements when they are on the heap, they are only copied on write.
+	void operator=(const ArrayStorage &p_other) {
+		if (this == &p_other) {
+			return;
+		}
+		clear();
+		if (p_other.use_heap) {
+			heap = p_other.heap;
+			use_heap = true;
+		} else {
+			for (int i = 0; i < p_other.inline_count; i++) {
+				inline_data[i] = p_other.inline_data[i];
+			}
+			inline_count = p_other.inline_count;
+		}
+	}
+
+	ArrayStorage() {}
+	ArrayStorage(const ArrayStorage &p_other) = delete;
+};
+
 class ArrayPrivate {
 public:
 	SafeRefCount refcount;
-	Vector<Variant> array;
+	ArrayStorage array;
 
 	ContainerTypeValidate typed;
 };
@@ -75,7 +253,7 @@ void Array::_unref() const {
 }
 
 Variant &Array::operator[](int p_idx) {
-	return _p->array.write[p_idx];
+	return _p->array[p_idx];
 }
 
 const Variant &Array::operator[](int p_idx) const {
@@ -142,7 +320,7 @@ void Array::_assign(const Array &p_array) {
 	if (_p->typed.type != Variant::OBJECT && _p->typed.type == p_array._p->typed.type) {
 		//same type or untyped, just reference, shuold be fine
 		_ref(p_array);
-	} else if (_p->typed.type == Variant::NIL) { //from typed to untyped, must copy, but this is cheap anyway
+	} else if (_p->typed.type == Variant::NIL) { //from typed to untyped, must copy, but this is cheap as the storage is copy on write
 		_p->array = p_array._p->array;
 	} else if (p_array._p->typed.type == Variant::NIL) { //from untyped to typed, must try to check if they are all valid
 		if (_p->typed.type == Variant::OBJECT) {
@@ -152,20 +330,20 @@ void Array::_assign(const Array &p_array) {
 					return;
 				}
 			}
-			_p->array = p_array._p->array; //then just copy, which is cheap anyway
+			_p->array = p_array._p->array; //then just copy
 
 		} else {
 			//for non objects, we need to check if there is a valid conversion, which needs to happen one by one, so this is the worst case.
-			Vector<Variant> new_array;
+			ArrayStorage new_array;
 			new_array.resize(p_array._p->array.size());
 			for (int i = 0; i < p_array._p->array.size(); i++) {
 				Variant src_val = p_array._p->array[i];
 				if (src_val.get_type() == _p->typed.type) {
-					new_array.write[i] = src_val;
+					new_array[i] = src_val;
 				} else if (Variant::can_convert_strict(src_val.get_type(), _p->typed.type)) {
 					Variant *ptr = &src_val;
 					Callable::CallError ce;
-					Variant::construct(_p->typed.type, new_array.write[i], (const Variant **)&ptr, 1, ce);
+					Variant::construct(_p->typed.type, new_array[i], (const Variant **)&ptr, 1, ce);
 					if (ce.error != Callable::CallError::CALL_OK) {
 						ERR_FAIL_MSG("Unable to convert array index " + itos(i) + " from '" + Variant::get_type_name(src_val.get_type()) + "' to '" + Variant::get_type_name(_p->typed.type) + "'.");
 					}
@@ -408,7 +586,7 @@ void Array::shuffle() {
 }
 
 template <typename Less>
-_FORCE_INLINE_ int bisect(const Vector<Variant> &p_array, const Variant &p_value, bool p_before, const Less &p_less) {
+_FORCE_INLINE_ int bisect(const ArrayStorage &p_array, const Variant &p_value, bool p_before, const Less &p_less) {
 	int lo = 0;
 	int hi = p_array.size();
 	if (p_before) {
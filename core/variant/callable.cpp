@@ -40,7 +40,7 @@ void Callable::call_deferred(const Variant **p_arguments, int p_argcount) const
 	MessageQueue::get_singleton()->push_callable(*this, p_arguments, p_argcount);
 }
 
-void Callable::call(const Variant **p_arguments, int p_argcount, Variant &r_return_value, CallError &r_call_error) const {
+void Callable::call(const Variant **p_arguments, int p_argcount, Variant &r_return_value, CallError &r_call_error, MethodCallCache *p_cache) const {
 	if (is_null()) {
 		r_call_error.error = CallError::CALL_ERROR_INSTANCE_IS_NULL;
 		r_call_error.argument = 0;
@@ -50,7 +50,7 @@ void Callable::call(const Variant **p_arguments, int p_argcount, Variant &r_retu
 		custom->call(p_arguments, p_argcount, r_return_value, r_call_error);
 	} else {
 		Object *obj = ObjectDB::get_instance(ObjectID(object));
-		r_return_value = obj->call(method, p_arguments, p_argcount, r_call_error);
+		r_return_value = obj->call(method, p_arguments, p_argcount, r_call_error, p_cache);
 	}
 }
 
@@ -38,6 +38,7 @@
 class Object;
 class Variant;
 class CallableCustom;
+struct MethodCallCache;
 
 // This is an abstraction of things that can be called.
 // It is used for signals and other cases where efficient calling of functions
@@ -67,7 +68,8 @@ public:
 		int expected = 0;
 	};
 
-	void call(const Variant **p_arguments, int p_argcount, Variant &r_return_value, CallError &r_call_error) const;
+	// p_cache, if given, is the inline cache of the call site for the method of the object.
+	void call(const Variant **p_arguments, int p_argcount, Variant &r_return_value, CallError &r_call_error, MethodCallCache *p_cache = nullptr) const;
 	void call_deferred(const Variant **p_arguments, int p_argcount) const;
 
 	_FORCE_INLINE_ bool is_null() const {
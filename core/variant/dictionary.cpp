@@ -34,24 +34,135 @@
 #include "core/templates/safe_refcount.h"
 #include "core/variant/variant.h"
 
+typedef OrderedHashMap<Variant, Variant, VariantHasher, VariantComparator> DictionaryMap;
+
 struct DictionaryPrivate {
+	// The first elements are kept inline, so small dictionaries (like the results
+	// of physics queries) are created with a single allocation, instead of two per
+	// element. Inline elements never move: when the slots are used up, new elements
+	// go to the map and come after them, so pointers to keys and values stay valid
+	// like with the map alone.
+	static const int INLINE_CAPACITY = 4;
+
 	SafeRefCount refcount;
-	OrderedHashMap<Variant, Variant, VariantHasher, VariantComparator> variant_map;
+	Variant inline_keys[INLINE_CAPACITY];
+	Variant inline_values[INLINE_CAPACITY];
+	uint32_t inline_hashes[INLINE_CAPACITY];
+	int inline_used = 0; // Slots used so far, erased ones included.
+	int inline_count = 0; // Elements in the slots.
+	uint32_t inline_erased = 0; // Bit mask of the erased slots.
+	DictionaryMap variant_map;
+
+	_FORCE_INLINE_ bool is_inline_erased(int p_slot) const {
+		return inline_erased & (1 << p_slot);
+	}
+
+	// Returns -1 if the key is not inline.
+	int find_inline(const Variant &p_key) const {
+		if (inline_count == 0) {
+			return -1;
+		}
+		uint32_t hash = VariantHasher::hash(p_key);
+		for (int i = 0; i < inline_used; i++) {
+			if (inline_hashes[i] == hash && !is_inline_erased(i) && VariantComparator::compare(inline_keys[i], p_key)) {
+				return i;
+			}
+		}
+		return -1;
+	}
+
+	// Returns INLINE_CAPACITY past the last inline element.
+	int next_inline(int p_slot) const {
+		while (p_slot < inline_used && is_inline_erased(p_slot)) {
+			p_slot++;
+		}
+		return p_slot < inline_used ? p_slot : INLINE_CAPACITY;
+	}
+
+	Variant *getptr(const Variant &p_key) {
+		int slot = find_inline(p_key);
+		if (slot != -1) {
+			return &inline_values[slot];
+		}
+		if (variant_map.is_empty()) {
+			return nullptr;
+		}
+		DictionaryMap::Element E = variant_map.find(p_key);
+		return E ? &E.get() : nullptr;
+	}
+
+	Variant &get_or_insert(const Variant &p_key) {
+		Variant *value = getptr(p_key);
+		if (value) {
+			return *value;
+		}
+		if (inline_used < INLINE_CAPACITY && variant_map.is_empty()) {
+			int slot = inline_used++;
+			inline_keys[slot] = p_key;
+			inline_hashes[slot] = VariantHasher::hash(p_key);
+			inline_count++;
+			return inline_values[slot];
+		}
+		return variant_map[p_key];
+	}
+
+	bool erase(const Variant &p_key) {
+		int slot = find_inline(p_key);
+		if (slot == -1) {
+			return variant_map.erase(p_key);
+		}
+
+		inline_keys[slot] = Variant();
+		inline_values[slot] = Variant();
+		inline_erased |= 1 << slot;
+		inline_count--;
+
+		// Trailing slots can be reused, as long as no element comes after them.
+		if (variant_map.is_empty()) {
+			while (inline_used > 0 && is_inline_erased(inline_used - 1)) {
+				inline_used--;
+				inline_erased &= ~(1 << inline_used);
+			}
+		}
+		return true;
+	}
+
+	void clear() {
+		for (int i = 0; i < inline_used; i++) {
+			inline_keys[i] = Variant();
+			inline_values[i] = Variant();
+		}
+		inline_used = 0;
+		inline_count = 0;
+		inline_erased = 0;
+		variant_map.clear();
+	}
 };
 
 void Dictionary::get_key_list(List<Variant> *p_keys) const {
+	for (int i = _p->next_inline(0); i < _p->inline_used; i = _p->next_inline(i + 1)) {
+		p_keys->push_back(_p->inline_keys[i]);
+	}
+
 	if (_p->variant_map.is_empty()) {
 		return;
 	}
 
-	for (OrderedHashMap<Variant, Variant, VariantHasher, VariantComparator>::Element E = _p->variant_map.front(); E; E = E.next()) {
+	for (DictionaryMap::Element E = _p->variant_map.front(); E; E = E.next()) {
 		p_keys->push_back(E.key());
 	}
 }
 
 Variant Dictionary::get_key_at_index(int p_index) const {
 	int index = 0;
-	for (OrderedHashMap<Variant, Variant, VariantHasher, VariantComparator>::Element E = _p->variant_map.front(); E; E = E.next()) {
+	for (int i = _p->next_inline(0); i < _p->inline_used; i = _p->next_inline(i + 1)) {
+		if (index == p_index) {
+			return _p->inline_keys[i];
+		}
+		index++;
+	}
+
+	for (DictionaryMap::Element E = _p->variant_map.front(); E; E = E.next()) {
 		if (index == p_index) {
 			return E.key();
 		}
@@ -63,7 +174,14 @@ Variant Dictionary::get_key_at_index(int p_index) const {
 
 Variant Dictionary::get_value_at_index(int p_index) const {
 	int index = 0;
-	for (OrderedHashMap<Variant, Variant, VariantHasher, VariantComparator>::Element E = _p->variant_map.front(); E; E = E.next()) {
+	for (int i = _p->next_inline(0); i < _p->inline_used; i = _p->next_inline(i + 1)) {
+		if (index == p_index) {
+			return _p->inline_values[i];
+		}
+		index++;
+	}
+
+	for (DictionaryMap::Element E = _p->variant_map.front(); E; E = E.next()) {
 		if (index == p_index) {
 			return E.value();
 		}
@@ -74,38 +192,29 @@ Variant Dictionary::get_value_at_index(int p_index) const {
 }
 
 Variant &Dictionary::operator[](const Variant &p_key) {
-	return _p->variant_map[p_key];
+	return _p->get_or_insert(p_key);
 }
 
 const Variant &Dictionary::operator[](const Variant &p_key) const {
-	return _p->variant_map[p_key];
+	const Variant *value = _p->getptr(p_key);
+	CRASH_COND(!value);
+	return *value;
 }
 
 const Variant *Dictionary::getptr(const Variant &p_key) const {
-	OrderedHashMap<Variant, Variant, VariantHasher, VariantComparator>::ConstElement E = ((const OrderedHashMap<Variant, Variant, VariantHasher, VariantComparator> *)&_p->variant_map)->find(p_key);
-
-	if (!E) {
-		return nullptr;
-	}
-	return &E.get();
+	return _p->getptr(p_key);
 }
 
 Variant *Dictionary::getptr(const Variant &p_key) {
-	OrderedHashMap<Variant, Variant, VariantHasher, VariantComparator>::Element E = _p->variant_map.find(p_key);
-
-	if (!E) {
-		return nullptr;
-	}
-	return &E.get();
+	return _p->getptr(p_key);
 }
 
 Variant Dictionary::get_valid(const Variant &p_key) const {
-	OrderedHashMap<Variant, Variant, VariantHasher, VariantComparator>::ConstElement E = ((const OrderedHashMap<Variant, Variant, VariantHasher, VariantComparator> *)&_p->variant_map)->find(p_key);
-
-	if (!E) {
+	const Variant *result = getptr(p_key);
+	if (!result) {
 		return Variant();
 	}
-	return E.get();
+	return *result;
 }
 
 Variant Dictionary::get(const Variant &p_key, const Variant &p_default) const {
@@ -118,15 +227,15 @@ Variant Dictionary::get(const Variant &p_key, const Variant &p_default) const {
 }
 
 int Dictionary::size() const {
-	return _p->variant_map.size();
+	return _p->inline_count + _p->variant_map.size();
 }
 
 bool Dictionary::is_empty() const {
-	return !_p->variant_map.size();
+	return _p->inline_count == 0 && !_p->variant_map.size();
 }
 
 bool Dictionary::has(const Variant &p_key) const {
-	return _p->variant_map.has(p_key);
+	return _p->getptr(p_key) != nullptr;
 }
 
 bool Dictionary::has_all(const Array &p_keys) const {
@@ -139,7 +248,7 @@ bool Dictionary::has_all(const Array &p_keys) const {
 }
 
 bool Dictionary::erase(const Variant &p_key) {
-	return _p->variant_map.erase(p_key);
+	return _p->erase(p_key);
 }
 
 bool Dictionary::operator==(const Dictionary &p_dictionary) const {
@@ -168,7 +277,7 @@ void Dictionary::_ref(const Dictionary &p_from) const {
 }
 
 void Dictionary::clear() {
-	_p->variant_map.clear();
+	_p->clear();
 }
 
 void Dictionary::_unref() const {
@@ -182,7 +291,12 @@ void Dictionary::_unref() const {
 uint32_t Dictionary::hash() const {
 	uint32_t h = hash_djb2_one_32(Variant::DICTIONARY);
 
-	for (OrderedHashMap<Variant, Variant, VariantHasher, VariantComparator>::Element E = _p->variant_map.front(); E; E = E.next()) {
+	for (int i = _p->next_inline(0); i < _p->inline_used; i = _p->next_inline(i + 1)) {
+		h = hash_djb2_one_32(_p->inline_hashes[i], h);
+		h = hash_djb2_one_32(_p->inline_values[i].hash(), h);
+	}
+
+	for (DictionaryMap::Element E = _p->variant_map.front(); E; E = E.next()) {
 		h = hash_djb2_one_32(E.key().hash(), h);
 		h = hash_djb2_one_32(E.value().hash(), h);
 	}
@@ -192,14 +306,18 @@ uint32_t Dictionary::hash() const {
 
 Array Dictionary::keys() const {
 	Array varr;
-	if (_p->variant_map.is_empty()) {
+	if (is_empty()) {
 		return varr;
 	}
 
 	varr.resize(size());
 
 	int i = 0;
-	for (OrderedHashMap<Variant, Variant, VariantHasher, VariantComparator>::Element E = _p->variant_map.front(); E; E = E.next()) {
+	for (int j = _p->next_inline(0); j < _p->inline_used; j = _p->next_inline(j + 1)) {
+		varr[i] = _p->inline_keys[j];
+		i++;
+	}
+	for (DictionaryMap::Element E = _p->variant_map.front(); E; E = E.next()) {
 		varr[i] = E.key();
 		i++;
 	}
@@ -209,14 +327,18 @@ Array Dictionary::keys() const {
 
 Array Dictionary::values() const {
 	Array varr;
-	if (_p->variant_map.is_empty()) {
+	if (is_empty()) {
 		return varr;
 	}
 
 	varr.resize(size());
 
 	int i = 0;
-	for (OrderedHashMap<Variant, Variant, VariantHasher, VariantComparator>::Element E = _p->variant_map.front(); E; E = E.next()) {
+	for (int j = _p->next_inline(0); j < _p->inline_used; j = _p->next_inline(j + 1)) {
+		varr[i] = _p->inline_values[j];
+		i++;
+	}
+	for (DictionaryMap::Element E = _p->variant_map.front(); E; E = E.next()) {
 		varr[i] = E.get();
 		i++;
 	}
@@ -225,17 +347,31 @@ Array Dictionary::values() const {
 }
 
 const Variant *Dictionary::next(const Variant *p_key) const {
-	if (p_key == nullptr) {
-		// caller wants to get the first element
-		if (_p->variant_map.front()) {
-			return &_p->variant_map.front().key();
+	int slot = 0;
+	if (p_key) {
+		// Usually the key returned by the previous call.
+		if (p_key >= _p->inline_keys && p_key < _p->inline_keys + DictionaryPrivate::INLINE_CAPACITY) {
+			slot = p_key - _p->inline_keys;
+		} else {
+			slot = _p->find_inline(*p_key);
+		}
+
+		if (slot == -1) {
+			DictionaryMap::Element E = _p->variant_map.find(*p_key);
+			if (E && E.next()) {
+				return &E.next().key();
+			}
+			return nullptr;
 		}
-		return nullptr;
+		slot++;
 	}
-	OrderedHashMap<Variant, Variant, VariantHasher, VariantComparator>::Element E = _p->variant_map.find(*p_key);
 
-	if (E && E.next()) {
-		return &E.next().key();
+	slot = _p->next_inline(slot);
+	if (slot < _p->inline_used) {
+		return &_p->inline_keys[slot];
+	}
+	if (_p->variant_map.front()) {
+		return &_p->variant_map.front().key();
 	}
 	return nullptr;
 }
@@ -243,7 +379,11 @@ const Variant *Dictionary::next(const Variant *p_key) const {
 Dictionary Dictionary::duplicate(bool p_deep) const {
 	Dictionary n;
 
-	for (OrderedHashMap<Variant, Variant, VariantHasher, VariantComparator>::Element E = _p->variant_map.front(); E; E = E.next()) {
+	for (int i = _p->next_inline(0); i < _p->inline_used; i = _p->next_inline(i + 1)) {
+		n[_p->inline_keys[i]] = p_deep ? _p->inline_values[i].duplicate(true) : _p->inline_values[i];
+	}
+
+	for (DictionaryMap::Element E = _p->variant_map.front(); E; E = E.next()) {
 		n[E.key()] = p_deep ? E.value().duplicate(true) : E.value();
 	}
 
@@ -255,7 +395,7 @@ void Dictionary::operator=(const Dictionary &p_dictionary) {
 }
 
 const void *Dictionary::id() const {
-	return _p->variant_map.id();
+	return _p;
 }
 
 Dictionary::Dictionary(const Dictionary &p_from) {
@@ -33,38 +33,75 @@
 #include "core/input/input_event.h"
 #include "core/io/resource_loader.h"
 #include "core/os/keyboard.h"
+#include "core/templates/local_vector.h"
 #include "core/string/string_buffer.h"
 
-char32_t VariantParser::StreamFile::get_char() {
-	return f->get_8();
+char32_t VariantParser::Stream::get_char() {
+	if (readahead_pointer < readahead_filled) {
+		return readahead_buffer[readahead_pointer++];
+	}
+
+	readahead_filled = _read_buffer(readahead_buffer, readahead_enabled ? READAHEAD_SIZE : 1);
+	if (readahead_filled == 0) {
+		// You need to try to read again when you have reached the end for EOF to be reported.
+		readahead_pointer = 0;
+		eof = true;
+		return 0;
+	}
+
+	readahead_pointer = 1;
+	return readahead_buffer[0];
+}
+
+bool VariantParser::Stream::is_eof() const {
+	if (readahead_enabled) {
+		return eof;
+	}
+	return _is_eof();
+}
+
+uint32_t VariantParser::StreamFile::_read_buffer(char32_t *p_buffer, uint32_t p_num_chars) {
+	uint8_t temp[READAHEAD_SIZE];
+	ERR_FAIL_COND_V(p_num_chars > READAHEAD_SIZE, 0);
+
+	int num_read = f->get_buffer(temp, p_num_chars);
+	ERR_FAIL_COND_V(num_read < 0, 0);
+
+	for (int i = 0; i < num_read; i++) {
+		p_buffer[i] = temp[i];
+	}
+
+	return num_read;
 }
 
 bool VariantParser::StreamFile::is_utf8() const {
 	return true;
 }
 
-bool VariantParser::StreamFile::is_eof() const {
+bool VariantParser::StreamFile::_is_eof() const {
 	return f->eof_reached();
 }
 
-char32_t VariantParser::StreamString::get_char() {
-	if (pos > s.length()) {
+uint32_t VariantParser::StreamString::_read_buffer(char32_t *p_buffer, uint32_t p_num_chars) {
+	int available = MAX(s.length() - pos, 0);
+	if (available == 0) {
+		// Reading past the end is what reports EOF, so this works the same as files (like StreamFile does).
+		pos = s.length() + 1;
 		return 0;
-	} else if (pos == s.length()) {
-		// You need to try to read again when you have reached the end for EOF to be reported,
-		// so this works the same as files (like StreamFile does)
-		pos++;
-		return 0;
-	} else {
-		return s[pos++];
 	}
+
+	uint32_t num_read = MIN((uint32_t)available, p_num_chars);
+	memcpy(p_buffer, s.ptr() + pos, num_read * sizeof(char32_t));
+	pos += num_read;
+
+	return num_read;
 }
 
 bool VariantParser::StreamString::is_utf8() const {
 	return false;
 }
 
-bool VariantParser::StreamString::is_eof() const {
+bool VariantParser::StreamString::_is_eof() const {
 	return pos > s.length();
 }
 
@@ -202,7 +239,8 @@ Error VariantParser::get_token(Stream *p_stream, Token &r_token, int &line, Stri
 				[[fallthrough]];
 			}
 			case '"': {
-				String str;
+				StringBuffer<> str;
+				bool ascii = true; // Plain ASCII needs no UTF-8 decoding.
 				while (true) {
 					char32_t ch = p_stream->get_char();
 
@@ -276,26 +314,29 @@ Error VariantParser::get_token(Stream *p_stream, Token &r_token, int &line, Stri
 							} break;
 						}
 
+						ascii = ascii && res < 0x80;
 						str += res;
 
 					} else {
 						if (ch == '\n') {
 							line++;
 						}
+						ascii = ascii && ch < 0x80;
 						str += ch;
 					}
 				}
 
-				if (p_stream->is_utf8()) {
-					str.parse_utf8(str.ascii(true).get_data());
+				String s = str.as_string();
+				if (p_stream->is_utf8() && !ascii) {
+					s.parse_utf8(s.ascii(true).get_data());
 				}
 				if (string_name) {
 					r_token.type = TK_STRING_NAME;
-					r_token.value = StringName(str);
+					r_token.value = StringName(s);
 					string_name = false; //reset
 				} else {
 					r_token.type = TK_STRING;
-					r_token.value = str;
+					r_token.value = s;
 				}
 				return OK;
 
@@ -449,6 +490,10 @@ Error VariantParser::_parse_construct(Stream *p_stream, Vector<T> &r_construct,
 		return ERR_PARSE_ERROR;
 	}
 
+	// Packed arrays can hold hundreds of thousands of elements, so accumulate
+	// without copy on write checks and copy to the result once.
+	LocalVector<T> construct;
+
 	bool first = true;
 	while (true) {
 		if (!first) {
@@ -471,10 +516,15 @@ Error VariantParser::_parse_construct(Stream *p_stream, Vector<T> &r_construct,
 			return ERR_PARSE_ERROR;
 		}
 
-		r_construct.push_back(token.value);
+		construct.push_back(token.value);
 		first = false;
 	}
 
+	r_construct.resize(construct.size());
+	if (construct.size()) {
+		memcpy(r_construct.ptrw(), construct.ptr(), construct.size() * sizeof(T));
+	}
+
 	return OK;
 }
 
@@ -876,17 +926,7 @@ Error VariantParser::parse_value(Token &token, Variant &value, Stream *p_stream,
 				return err;
 			}
 
-			Vector<uint8_t> arr;
-			{
-				int len = args.size();
-				arr.resize(len);
-				uint8_t *w = arr.ptrw();
-				for (int i = 0; i < len; i++) {
-					w[i] = args[i];
-				}
-			}
-
-			value = arr;
+			value = args;
 		} else if (id == "PackedInt32Array" || id == "PackedIntArray" || id == "PoolIntArray" || id == "IntArray") {
 			Vector<int32_t> args;
 			Error err = _parse_construct<int32_t>(p_stream, args, line, r_err_str);
@@ -894,17 +934,7 @@ Error VariantParser::parse_value(Token &token, Variant &value, Stream *p_stream,
 				return err;
 			}
 
-			Vector<int32_t> arr;
-			{
-				int32_t len = args.size();
-				arr.resize(len);
-				int32_t *w = arr.ptrw();
-				for (int32_t i = 0; i < len; i++) {
-					w[i] = int32_t(args[i]);
-				}
-			}
-
-			value = arr;
+			value = args;
 		} else if (id == "PackedInt64Array") {
 			Vector<int64_t> args;
 			Error err = _parse_construct<int64_t>(p_stream, args, line, r_err_str);
@@ -912,17 +942,7 @@ Error VariantParser::parse_value(Token &token, Variant &value, Stream *p_stream,
 				return err;
 			}
 
-			Vector<int64_t> arr;
-			{
-				int64_t len = args.size();
-				arr.resize(len);
-				int64_t *w = arr.ptrw();
-				for (int64_t i = 0; i < len; i++) {
-					w[i] = int64_t(args[i]);
-				}
-			}
-
-			value = arr;
+			value = args;
 		} else if (id == "PackedFloat32Array" || id == "PackedRealArray" || id == "PoolRealArray" || id == "FloatArray") {
 			Vector<float> args;
 			Error err = _parse_construct<float>(p_stream, args, line, r_err_str);
@@ -930,17 +950,7 @@ Error VariantParser::parse_value(Token &token, Variant &value, Stream *p_stream,
 				return err;
 			}
 
-			Vector<float> arr;
-			{
-				int len = args.size();
-				arr.resize(len);
-				float *w = arr.ptrw();
-				for (int i = 0; i < len; i++) {
-					w[i] = args[i];
-				}
-			}
-
-			value = arr;
+			value = args;
 		} else if (id == "PackedFloat64Array") {
 			Vector<double> args;
 			Error err = _parse_construct<double>(p_stream, args, line, r_err_str);
@@ -948,17 +958,7 @@ Error VariantParser::parse_value(Token &token, Variant &value, Stream *p_stream,
 				return err;
 			}
 
-			Vector<double> arr;
-			{
-				int len = args.size();
-				arr.resize(len);
-				double *w = arr.ptrw();
-				for (int i = 0; i < len; i++) {
-					w[i] = args[i];
-				}
-			}
-
-			value = arr;
+			value = args;
 		} else if (id == "PackedStringArray" || id == "PoolStringArray" || id == "StringArray") {
 			get_token(p_stream, token, line, r_err_str);
 			if (token.type != TK_PARENTHESIS_OPEN) {
@@ -38,33 +38,59 @@
 class VariantParser {
 public:
 	struct Stream {
-		virtual char32_t get_char() = 0;
-		virtual bool is_utf8() const = 0;
-		virtual bool is_eof() const = 0;
+	protected:
+		enum {
+			READAHEAD_SIZE = 2048
+		};
+
+	private:
+		char32_t readahead_buffer[READAHEAD_SIZE];
+		uint32_t readahead_pointer = 0;
+		uint32_t readahead_filled = 0;
+		bool eof = false;
+
+	protected:
+		virtual uint32_t _read_buffer(char32_t *p_buffer, uint32_t p_num_chars) = 0;
+		virtual bool _is_eof() const = 0;
+
+	public:
+		// Streams read ahead in blocks instead of one character at a time.
+		// Disable when the underlying source is accessed directly while parsing.
+		bool readahead_enabled = true;
 
 		char32_t saved = 0;
 
+		char32_t get_char();
+		virtual bool is_utf8() const = 0;
+		bool is_eof() const;
+
 		Stream() {}
 		virtual ~Stream() {}
 	};
 
 	struct StreamFile : public Stream {
+	protected:
+		virtual uint32_t _read_buffer(char32_t *p_buffer, uint32_t p_num_chars);
+		virtual bool _is_eof() const;
+
+	public:
 		FileAccess *f = nullptr;
 
-		virtual char32_t get_char();
 		virtual bool is_utf8() const;
-		virtual bool is_eof() const;
 
 		StreamFile() {}
 	};
 
 	struct StreamString : public Stream {
+	protected:
+		virtual uint32_t _read_buffer(char32_t *p_buffer, uint32_t p_num_chars);
+		virtual bool _is_eof() const;
+
+	public:
 		String s;
 		int pos = 0;
 
-		virtual char32_t get_char();
 		virtual bool is_utf8() const;
-		virtual bool is_eof() const;
 
 		StreamString() {}
 	};
@@ -235,7 +235,7 @@ public:
 	};
 
 	struct DummyMesh {
-		Vector<DummySurface> surfaces;
+		Vector<RS::SurfaceData> surfaces; // Kept so meshes can be read back, e.g. when importing scenes headless.
 		int blend_shape_count = 0;
 		RS::BlendShapeMode blend_shape_mode = RS::BlendShapeMode::BLEND_SHAPE_MODE_NORMALIZED;
 	};
@@ -243,13 +243,29 @@ public:
 	mutable RID_PtrOwner<DummyTexture> texture_owner;
 	mutable RID_PtrOwner<DummyMesh> mesh_owner;
 
-	RID texture_2d_create(const Ref<Image> &p_image) override { return RID(); }
+	RID texture_2d_create(const Ref<Image> &p_image) override {
+		ERR_FAIL_COND_V(p_image.is_null(), RID());
+		DummyTexture *texture = memnew(DummyTexture);
+		texture->width = p_image->get_width();
+		texture->height = p_image->get_height();
+		texture->format = p_image->get_format();
+		// Keep a reference instead of a copy, the image data is shared with the loader.
+		texture->image = p_image;
+		return texture_owner.make_rid(texture);
+	}
 	RID texture_2d_layered_create(const Vector<Ref<Image>> &p_layers, RS::TextureLayeredType p_layered_type) override { return RID(); }
 	RID texture_3d_create(Image::Format, int p_width, int p_height, int p_depth, bool p_mipmaps, const Vector<Ref<Image>> &p_data) override { return RID(); }
 	RID texture_proxy_create(RID p_base) override { return RID(); }
 
-	void texture_2d_update_immediate(RID p_texture, const Ref<Image> &p_image, int p_layer = 0) override {}
-	void texture_2d_update(RID p_texture, const Ref<Image> &p_image, int p_layer = 0) override {}
+	void texture_2d_update_immediate(RID p_texture, const Ref<Image> &p_image, int p_layer = 0) override {
+		texture_2d_update(p_texture, p_image, p_layer);
+	}
+	void texture_2d_update(RID p_texture, const Ref<Image> &p_image, int p_layer = 0) override {
+		DummyTexture *t = texture_owner.getornull(p_texture);
+		ERR_FAIL_COND(!t);
+		ERR_FAIL_COND(p_image.is_null());
+		t->image = p_image;
+	}
 	void texture_3d_update(RID p_texture, const Vector<Ref<Image>> &p_data) override {}
 	void texture_proxy_update(RID p_proxy, RID p_base) override {}
 
@@ -257,19 +273,41 @@ public:
 	RID texture_2d_layered_placeholder_create(RenderingServer::TextureLayeredType p_layered_type) override { return RID(); }
 	RID texture_3d_placeholder_create() override { return RID(); }
 
-	Ref<Image> texture_2d_get(RID p_texture) const override { return Ref<Image>(); }
+	Ref<Image> texture_2d_get(RID p_texture) const override {
+		DummyTexture *t = texture_owner.getornull(p_texture);
+		ERR_FAIL_COND_V(!t, Ref<Image>());
+		return t->image;
+	}
 	Ref<Image> texture_2d_layer_get(RID p_texture, int p_layer) const override { return Ref<Image>(); }
 	Vector<Ref<Image>> texture_3d_get(RID p_texture) const override { return Vector<Ref<Image>>(); }
 
-	void texture_replace(RID p_texture, RID p_by_texture) override {}
+	void texture_replace(RID p_texture, RID p_by_texture) override {
+		DummyTexture *t = texture_owner.getornull(p_texture);
+		ERR_FAIL_COND(!t);
+		DummyTexture *by_t = texture_owner.getornull(p_by_texture);
+		ERR_FAIL_COND(!by_t);
+		if (t == by_t) {
+			return;
+		}
+		*t = *by_t;
+		free(p_by_texture);
+	}
 	void texture_set_size_override(RID p_texture, int p_width, int p_height) override {}
 // FIXME: Disabled during Vulkan refactoring, should be ported.
 #if 0
 	void texture_bind(RID p_texture, uint32_t p_texture_no) = 0;
 #endif
 
-	void texture_set_path(RID p_texture, const String &p_path) override {}
-	String texture_get_path(RID p_texture) const override { return String(); }
+	void texture_set_path(RID p_texture, const String &p_path) override {
+		DummyTexture *t = texture_owner.getornull(p_texture);
+		ERR_FAIL_COND(!t);
+		t->path = p_path;
+	}
+	String texture_get_path(RID p_texture) const override {
+		DummyTexture *t = texture_owner.getornull(p_texture);
+		ERR_FAIL_COND_V(!t, String());
+		return t->path;
+	}
 
 	void texture_set_detect_3d_callback(RID p_texture, RS::TextureDetectCallback p_callback, void *p_userdata) override {}
 	void texture_set_detect_normal_callback(RID p_texture, RS::TextureDetectCallback p_callback, void *p_userdata) override {}
@@ -438,7 +476,11 @@ public:
 	void reflection_probe_set_lod_threshold(RID p_probe, float p_ratio) override {}
 	float reflection_probe_get_lod_threshold(RID p_probe) const override { return 0.0; }
 
-	void mesh_add_surface(RID p_mesh, const RS::SurfaceData &p_surface) override {}
+	void mesh_add_surface(RID p_mesh, const RS::SurfaceData &p_surface) override {
+		DummyMesh *m = mesh_owner.getornull(p_mesh);
+		ERR_FAIL_COND(!m);
+		m->surfaces.push_back(p_surface);
+	}
 
 #if 0
 	void mesh_add_surface(RID p_mesh, uint32_t p_format, RS::PrimitiveType p_primitive, const Vector<uint8_t> &p_array, int p_vertex_count, const Vector<uint8_t> &p_index_array, int p_index_count, const AABB &p_aabb, const Vector<Vector<uint8_t> > &p_blend_shapes = Vector<Vector<uint8_t> >(), const Vector<AABB> &p_bone_aabbs = Vector<AABB>()) override {
@@ -555,7 +597,12 @@ public:
 	}
 #endif
 
-	RS::SurfaceData mesh_get_surface(RID p_mesh, int p_surface) const override { return RS::SurfaceData(); }
+	RS::SurfaceData mesh_get_surface(RID p_mesh, int p_surface) const override {
+		DummyMesh *m = mesh_owner.getornull(p_mesh);
+		ERR_FAIL_COND_V(!m, RS::SurfaceData());
+		ERR_FAIL_INDEX_V(p_surface, m->surfaces.size(), RS::SurfaceData());
+		return m->surfaces[p_surface];
+	}
 	int mesh_get_surface_count(RID p_mesh) const override {
 		DummyMesh *m = mesh_owner.getornull(p_mesh);
 		ERR_FAIL_COND_V(!m, 0);
@@ -566,7 +613,12 @@ public:
 	AABB mesh_get_custom_aabb(RID p_mesh) const override { return AABB(); }
 
 	AABB mesh_get_aabb(RID p_mesh, RID p_skeleton = RID()) override { return AABB(); }
-	void mesh_clear(RID p_mesh) override {}
+	void mesh_set_shadow_mesh(RID p_mesh, RID p_shadow_mesh) override {}
+	void mesh_clear(RID p_mesh) override {
+		DummyMesh *m = mesh_owner.getornull(p_mesh);
+		ERR_FAIL_COND(!m);
+		m->surfaces.clear();
+	}
 
 	/* MULTIMESH API */
 
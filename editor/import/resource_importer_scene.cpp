@@ -34,6 +34,7 @@
 #include "editor/editor_node.h"
 #include "editor/import/scene_importer_mesh_node_3d.h"
 #include "scene/3d/collision_shape_3d.h"
+#include "scene/3d/hlod_generator.h"
 #include "scene/3d/mesh_instance_3d.h"
 #include "scene/3d/navigation_3d.h"
 #include "scene/3d/physics_body_3d.h"
@@ -1130,6 +1131,12 @@ void ResourceImporterScene::get_import_options(List<ImportOption> *r_options, in
 	r_options->push_back(ImportOption(PropertyInfo(Variant::INT, "meshes/storage", PROPERTY_HINT_ENUM, "Built-In,Files (.mesh),Files (.tres)"), meshes_out ? 1 : 0));
 	r_options->push_back(ImportOption(PropertyInfo(Variant::BOOL, "meshes/generate_lods"), true));
 	r_options->push_back(ImportOption(PropertyInfo(Variant::BOOL, "meshes/create_shadow_meshes"), true));
+	r_options->push_back(ImportOption(PropertyInfo(Variant::BOOL, "meshes/optimize_indices"), true));
+	r_options->push_back(ImportOption(PropertyInfo(Variant::BOOL, "meshes/hlod/enabled"), false));
+	r_options->push_back(ImportOption(PropertyInfo(Variant::FLOAT, "meshes/hlod/cluster_size", PROPERTY_HINT_RANGE, "0.01,4096,0.01"), 32.0));
+	r_options->push_back(ImportOption(PropertyInfo(Variant::FLOAT, "meshes/hlod/distance", PROPERTY_HINT_RANGE, "0,32768,0.01"), 64.0));
+	r_options->push_back(ImportOption(PropertyInfo(Variant::FLOAT, "meshes/hlod/proxy_ratio", PROPERTY_HINT_RANGE, "0.01,1,0.01"), 0.25));
+	r_options->push_back(ImportOption(PropertyInfo(Variant::BOOL, "meshes/hlod/merge_meshes"), true));
 	r_options->push_back(ImportOption(PropertyInfo(Variant::INT, "meshes/light_baking", PROPERTY_HINT_ENUM, "Disabled,Enable,Gen Lightmaps", PROPERTY_USAGE_DEFAULT | PROPERTY_USAGE_UPDATE_ALL_IF_MODIFIED), 0));
 	r_options->push_back(ImportOption(PropertyInfo(Variant::FLOAT, "meshes/lightmap_texel_size", PROPERTY_HINT_RANGE, "0.001,100,0.001"), 0.1));
 	r_options->push_back(ImportOption(PropertyInfo(Variant::BOOL, "skins/use_named_skins"), true));
@@ -1222,7 +1229,57 @@ Ref<Animation> ResourceImporterScene::import_animation_from_other_importer(Edito
 	return importer->import_animation(p_path, p_flags, p_bake_fps);
 }
 
-void ResourceImporterScene::_generate_meshes(Node *p_node, bool p_generate_lods, bool p_create_shadow_meshes) {
+void ResourceImporterScene::_find_meshes_to_generate(Node *p_node, Set<Ref<EditorSceneImporterMesh>> &r_meshes) {
+	EditorSceneImporterMeshNode3D *src_mesh_node = Object::cast_to<EditorSceneImporterMeshNode3D>(p_node);
+	if (src_mesh_node && src_mesh_node->get_mesh().is_valid() && !src_mesh_node->get_mesh()->has_mesh()) {
+		r_meshes.insert(src_mesh_node->get_mesh());
+	}
+
+	for (int i = 0; i < p_node->get_child_count(); i++) {
+		_find_meshes_to_generate(p_node->get_child(i), r_meshes);
+	}
+}
+
+void ResourceImporterScene::_generate_lods(Node *p_node) {
+	// Done for all the meshes at once, so their surfaces are simplified in parallel.
+	Set<Ref<EditorSceneImporterMesh>> mesh_set;
+	_find_meshes_to_generate(p_node, mesh_set);
+
+	Vector<EditorSceneImporterMesh *> meshes;
+	for (Set<Ref<EditorSceneImporterMesh>>::Element *E = mesh_set.front(); E; E = E->next()) {
+		Ref<EditorSceneImporterMesh> mesh = E->get();
+		meshes.push_back(mesh.ptr());
+	}
+
+	uint64_t begin_time = OS::get_singleton()->get_ticks_usec();
+	EditorSceneImporterMesh::generate_lods_multiple(meshes);
+	uint64_t total_time = OS::get_singleton()->get_ticks_usec() - begin_time;
+
+	uint64_t surface_time = 0;
+	for (int i = 0; i < meshes.size(); i++) {
+		const EditorSceneImporterMesh::LODReport &report = meshes[i]->get_lod_report();
+		String name = meshes[i]->get_name() != String() ? meshes[i]->get_name() : itos(i);
+
+		for (int j = 0; j < report.surfaces.size(); j++) {
+			const EditorSceneImporterMesh::LODReport::Surface &surface = report.surfaces[j];
+			if (surface.levels.size() == 0) {
+				continue;
+			}
+			surface_time += surface.usec;
+
+			String levels;
+			for (int k = 0; k < surface.levels.size(); k++) {
+				const EditorSceneImporterMesh::LODReport::Level &level = surface.levels[k];
+				levels += ", " + itos(level.triangles) + " (error " + rtos(level.error) + ", normal error " + rtos(level.normal_error) + ")";
+			}
+			print_verbose("LODs for mesh " + name + ", surface " + itos(j) + ": " + itos(surface.triangles) + levels + " triangles in " + rtos(surface.usec / 1000.0) + " ms.");
+		}
+	}
+
+	print_verbose("Generated LODs for " + itos(meshes.size()) + " meshes in " + rtos(total_time / 1000.0) + " ms (" + rtos(surface_time / 1000.0) + " ms of work).");
+}
+
+void ResourceImporterScene::_generate_meshes(Node *p_node, bool p_create_shadow_meshes, bool p_optimize_indices) {
 	EditorSceneImporterMeshNode3D *src_mesh_node = Object::cast_to<EditorSceneImporterMeshNode3D>(p_node);
 	if (src_mesh_node) {
 		//is mesh
@@ -1234,13 +1291,13 @@ void ResourceImporterScene::_generate_meshes(Node *p_node, bool p_generate_lods,
 		if (src_mesh_node->get_mesh().is_valid()) {
 			Ref<ArrayMesh> mesh;
 			if (!src_mesh_node->get_mesh()->has_mesh()) {
-				//do mesh processing
-				if (p_generate_lods) {
-					src_mesh_node->get_mesh()->generate_lods();
-				}
+				//do mesh processing, LODs were generated before
 				if (p_create_shadow_meshes) {
 					src_mesh_node->get_mesh()->create_shadow_mesh();
 				}
+				if (p_optimize_indices) {
+					src_mesh_node->get_mesh()->optimize_indices();
+				}
 			}
 			mesh = src_mesh_node->get_mesh()->get_mesh();
 
@@ -1257,7 +1314,7 @@ void ResourceImporterScene::_generate_meshes(Node *p_node, bool p_generate_lods,
 	}
 
 	for (int i = 0; i < p_node->get_child_count(); i++) {
-		_generate_meshes(p_node->get_child(i), p_generate_lods, p_create_shadow_meshes);
+		_generate_meshes(p_node->get_child(i), p_create_shadow_meshes, p_optimize_indices);
 	}
 }
 Error ResourceImporterScene::import(const String &p_source_file, const String &p_save_path, const Map<StringName, Variant> &p_options, List<String> *r_platform_variants, List<String> *r_gen_files, Variant *r_metadata) {
@@ -1354,8 +1411,12 @@ Error ResourceImporterScene::import(const String &p_source_file, const String &p
 
 	bool gen_lods = bool(p_options["meshes/generate_lods"]);
 	bool create_shadow_meshes = bool(p_options["meshes/create_shadow_meshes"]);
+	bool optimize_indices = bool(p_options["meshes/optimize_indices"]);
 
-	_generate_meshes(scene, gen_lods, create_shadow_meshes);
+	if (gen_lods) {
+		_generate_lods(scene);
+	}
+	_generate_meshes(scene, create_shadow_meshes, optimize_indices);
 
 	err = OK;
 
@@ -1375,6 +1436,15 @@ Error ResourceImporterScene::import(const String &p_source_file, const String &p
 		_optimize_animations(scene, anim_optimizer_linerr, anim_optimizer_angerr, anim_optimizer_maxang);
 	}
 
+	if (bool(p_options["meshes/hlod/enabled"])) {
+		HLODGenerator::Settings hlod_settings;
+		hlod_settings.cluster_size = p_options["meshes/hlod/cluster_size"];
+		hlod_settings.distance = p_options["meshes/hlod/distance"];
+		hlod_settings.proxy_ratio = p_options["meshes/hlod/proxy_ratio"];
+		hlod_settings.merge_meshes = p_options["meshes/hlod/merge_meshes"];
+		HLODGenerator::generate(scene, hlod_settings);
+	}
+
 	Array animation_clips;
 	{
 		int clip_count = p_options["animation/clips/amount"];
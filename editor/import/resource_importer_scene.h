@@ -39,6 +39,7 @@
 #include "scene/resources/skin.h"
 
 class Material;
+class EditorSceneImporterMesh;
 
 class EditorSceneImporter : public Reference {
 	GDCLASS(EditorSceneImporter, Reference);
@@ -121,7 +122,9 @@ class ResourceImporterScene : public ResourceImporter {
 	};
 
 	void _replace_owner(Node *p_node, Node *p_scene, Node *p_new_owner);
-	void _generate_meshes(Node *p_node, bool p_generate_lods, bool p_create_shadow_meshes);
+	void _find_meshes_to_generate(Node *p_node, Set<Ref<EditorSceneImporterMesh>> &r_meshes);
+	void _generate_lods(Node *p_node);
+	void _generate_meshes(Node *p_node, bool p_create_shadow_meshes, bool p_optimize_indices);
 
 public:
 	static ResourceImporterScene *get_singleton() { return singleton; }
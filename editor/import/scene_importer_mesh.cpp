@@ -30,6 +30,8 @@
 
 #include "scene_importer_mesh.h"
 
+#include "core/os/os.h"
+#include "core/templates/thread_work_pool.h"
 #include "scene/resources/surface_tool.h"
 
 void EditorSceneImporterMesh::add_blend_shape(const String &p_name) {
@@ -136,14 +138,254 @@ Ref<Material> EditorSceneImporterMesh::get_surface_material(int p_surface) const
 	return surfaces[p_surface].material;
 }
 
-void EditorSceneImporterMesh::generate_lods() {
+float EditorSceneImporterMesh::_get_normal_error(const int *p_indices, int p_index_count, const Vector3 *p_vertices, const Vector3 *p_normals) {
+	// Area weighted deviation of the vertex normals from the face normals, regardless of the winding.
+	// Smooth surfaces already deviate at full detail, so only the increase over that is meaningful.
+	float error = 0.0;
+	float total_area = 0.0;
+
+	for (int i = 0; i + 2 < p_index_count; i += 3) {
+		const Vector3 &v0 = p_vertices[p_indices[i + 0]];
+		Vector3 cross = (p_vertices[p_indices[i + 1]] - v0).cross(p_vertices[p_indices[i + 2]] - v0);
+		float area = cross.length();
+		if (area == 0.0) {
+			continue;
+		}
+
+		Vector3 face_normal = cross / area;
+		for (int j = 0; j < 3; j++) {
+			error += area * (1.0 - Math::abs(face_normal.dot(p_normals[p_indices[i + j]]))) / 3.0;
+		}
+		total_area += area;
+	}
+
+	return total_area > 0.0 ? error / total_area : 0.0;
+}
+
+void EditorSceneImporterMesh::_generate_lods_job(uint32_t p_index, LODJob *p_jobs) {
+	// Runs on worker threads, so it must only touch the job data.
+	const float normal_error_weight = 0.1;
+
+	LODJob &job = p_jobs[p_index];
+	uint64_t begin_time = OS::get_singleton()->get_ticks_usec();
+
+	const int *indices_ptr = job.indices.ptr();
+	int index_count = job.indices.size();
+	const Vector3 *vertices_ptr = job.vertices.ptr();
+	uint32_t vertex_count = job.vertices.size();
+	const Vector3 *normals_ptr = job.normals.size() == job.vertices.size() ? job.normals.ptr() : nullptr;
+
+	job.report->triangles = index_count / 3;
+
+	float base_normal_error = normals_ptr ? _get_normal_error(indices_ptr, index_count, vertices_ptr, normals_ptr) : 0.0;
+
+	// Every level is simplified from the full detail indices into the same buffer.
+	LocalVector<int> new_indices;
+	new_indices.resize(index_count);
+
+	int min_indices = 10;
+	int index_target = index_count / 2;
+	float mesh_scale = SurfaceTool::simplify_scale_func((const float *)vertices_ptr, vertex_count, sizeof(Vector3));
+	const float target_error = 1e-3f;
+	float abs_target_error = target_error / mesh_scale;
+	float last_distance = 0.0;
+
+	while (index_target > min_indices) {
+		float error;
+		size_t new_len = SurfaceTool::simplify_func((unsigned int *)new_indices.ptr(), (const unsigned int *)indices_ptr, index_count, (const float *)vertices_ptr, vertex_count, sizeof(Vector3), index_target, abs_target_error, &error);
+		if ((int)new_len > (index_target * 120 / 100)) {
+			break; // 20 percent tolerance
+		}
+
+		abs_target_error = error * mesh_scale;
+		if (Math::is_equal_approx(abs_target_error, 0.0f)) {
+			break;
+		}
+
+		// Simplification only bounds the position error, also account for the shading degrading as normals get averaged.
+		float normal_error = normals_ptr ? MAX(_get_normal_error(new_indices.ptr(), new_len, vertices_ptr, normals_ptr) - base_normal_error, 0.0f) : 0.0;
+
+		Surface::LOD lod;
+		lod.distance = MAX(MAX(error, normal_error * normal_error_weight) * mesh_scale, last_distance);
+		last_distance = lod.distance;
+		lod.indices.resize(new_len);
+		memcpy(lod.indices.ptrw(), new_indices.ptr(), new_len * sizeof(int));
+		job.surface->lods.push_back(lod);
+
+		LODReport::Level level;
+		level.triangles = new_len / 3;
+		level.error = error;
+		level.normal_error = normal_error;
+		job.report->levels.push_back(level);
+
+		index_target /= 2;
+	}
+
+	job.report->usec = OS::get_singleton()->get_ticks_usec() - begin_time;
+}
+
+void EditorSceneImporterMesh::generate_lods_multiple(const Vector<EditorSceneImporterMesh *> &p_meshes) {
 	if (!SurfaceTool::simplify_func) {
 		return;
 	}
 	if (!SurfaceTool::simplify_scale_func) {
 		return;
 	}
-	if (!SurfaceTool::simplify_sloppy_func) {
+	if (p_meshes.size() == 0) {
+		return;
+	}
+
+	LocalVector<LODJob> jobs;
+
+	for (int i = 0; i < p_meshes.size(); i++) {
+		EditorSceneImporterMesh *mesh = p_meshes[i];
+		ERR_CONTINUE(!mesh);
+
+		mesh->lod_report = LODReport();
+		mesh->lod_report.surfaces.resize(mesh->surfaces.size());
+
+		// Make sure nothing is shared, as the jobs write to the surfaces from several threads.
+		Surface *surfaces_ptr = mesh->surfaces.ptrw();
+		LODReport::Surface *reports_ptr = mesh->lod_report.surfaces.ptrw();
+
+		for (int j = 0; j < mesh->surfaces.size(); j++) {
+			if (surfaces_ptr[j].primitive != Mesh::PRIMITIVE_TRIANGLES) {
+				continue;
+			}
+
+			surfaces_ptr[j].lods.clear();
+
+			LODJob job;
+			job.surface = &surfaces_ptr[j];
+			job.report = &reports_ptr[j];
+			job.indices = surfaces_ptr[j].arrays[RS::ARRAY_INDEX];
+			if (job.indices.size() == 0) {
+				continue; //no lods if no indices
+			}
+			job.vertices = surfaces_ptr[j].arrays[RS::ARRAY_VERTEX];
+			job.normals = surfaces_ptr[j].arrays[RS::ARRAY_NORMAL];
+			jobs.push_back(job);
+		}
+	}
+
+	if (jobs.size() == 0) {
+		return;
+	}
+
+	if (jobs.size() == 1) {
+		p_meshes[0]->_generate_lods_job(0, jobs.ptr());
+		return;
+	}
+
+	ThreadWorkPool work_pool;
+	work_pool.init();
+	work_pool.do_work(jobs.size(), p_meshes[0], &EditorSceneImporterMesh::_generate_lods_job, jobs.ptr());
+	work_pool.finish();
+}
+
+void EditorSceneImporterMesh::generate_lods() {
+	Vector<EditorSceneImporterMesh *> meshes;
+	meshes.push_back(this);
+	generate_lods_multiple(meshes);
+}
+
+template <class T>
+static Vector<T> _remap_vertex_array(const Vector<T> &p_array, const LocalVector<uint32_t> &p_remap, int p_vertex_count, int p_new_vertex_count) {
+	// Some arrays hold several elements per vertex (e.g. tangents, bones and weights).
+	ERR_FAIL_COND_V(p_vertex_count == 0 || p_array.size() % p_vertex_count != 0, p_array);
+	int stride = p_array.size() / p_vertex_count;
+
+	Vector<T> ret;
+	ret.resize(p_new_vertex_count * stride);
+
+	const T *src = p_array.ptr();
+	T *dst = ret.ptrw();
+	for (int i = 0; i < p_vertex_count; i++) {
+		if (p_remap[i] == ~0u) {
+			continue; // Not referenced by any triangle.
+		}
+		for (int j = 0; j < stride; j++) {
+			dst[p_remap[i] * stride + j] = src[i * stride + j];
+		}
+	}
+
+	return ret;
+}
+
+void EditorSceneImporterMesh::_remap_vertex_arrays(Array &r_arrays, const LocalVector<uint32_t> &p_remap, int p_vertex_count, int p_new_vertex_count) {
+	for (int i = 0; i < r_arrays.size(); i++) {
+		if (i == RS::ARRAY_INDEX) {
+			continue;
+		}
+
+		switch (r_arrays[i].get_type()) {
+			case Variant::PACKED_VECTOR3_ARRAY: {
+				r_arrays[i] = _remap_vertex_array<Vector3>(r_arrays[i], p_remap, p_vertex_count, p_new_vertex_count);
+			} break;
+			case Variant::PACKED_VECTOR2_ARRAY: {
+				r_arrays[i] = _remap_vertex_array<Vector2>(r_arrays[i], p_remap, p_vertex_count, p_new_vertex_count);
+			} break;
+			case Variant::PACKED_COLOR_ARRAY: {
+				r_arrays[i] = _remap_vertex_array<Color>(r_arrays[i], p_remap, p_vertex_count, p_new_vertex_count);
+			} break;
+			case Variant::PACKED_FLOAT32_ARRAY: {
+				r_arrays[i] = _remap_vertex_array<float>(r_arrays[i], p_remap, p_vertex_count, p_new_vertex_count);
+			} break;
+			case Variant::PACKED_INT32_ARRAY: {
+				r_arrays[i] = _remap_vertex_array<int32_t>(r_arrays[i], p_remap, p_vertex_count, p_new_vertex_count);
+			} break;
+			case Variant::PACKED_BYTE_ARRAY: {
+				r_arrays[i] = _remap_vertex_array<uint8_t>(r_arrays[i], p_remap, p_vertex_count, p_new_vertex_count);
+			} break;
+			default: {
+			}
+		}
+	}
+}
+
+static bool _are_indices_in_range(const Vector<int> &p_indices, int p_vertex_count) {
+	const int *indices = p_indices.ptr();
+	for (int i = 0; i < p_indices.size(); i++) {
+		if (indices[i] < 0 || indices[i] >= p_vertex_count) {
+			return false;
+		}
+	}
+	return true;
+}
+
+void EditorSceneImporterMesh::_analyze_vertex_cache(const Vector<int> &p_indices, int p_vertex_count, float &r_acmr, float &r_atvr) {
+	// Simulates a FIFO post-transform cache, like the ones found in most GPUs.
+	const int cache_size = 16;
+	int cache[cache_size];
+	for (int i = 0; i < cache_size; i++) {
+		cache[i] = -1;
+	}
+	int cache_pos = 0;
+	int transformed = 0;
+
+	const int *indices = p_indices.ptr();
+	for (int i = 0; i < p_indices.size(); i++) {
+		bool hit = false;
+		for (int j = 0; j < cache_size; j++) {
+			if (cache[j] == indices[i]) {
+				hit = true;
+				break;
+			}
+		}
+		if (!hit) {
+			cache[cache_pos] = indices[i];
+			cache_pos = (cache_pos + 1) % cache_size;
+			transformed++;
+		}
+	}
+
+	int triangles = p_indices.size() / 3;
+	r_acmr = triangles ? float(transformed) / triangles : 0;
+	r_atvr = p_vertex_count ? float(transformed) / p_vertex_count : 0;
+}
+
+void EditorSceneImporterMesh::optimize_indices(bool p_overdraw, bool p_vertex_fetch) {
+	if (!SurfaceTool::optimize_vertex_cache_func) {
 		return;
 	}
 
@@ -152,67 +394,80 @@ void EditorSceneImporterMesh::generate_lods() {
 			continue;
 		}
 
-		surfaces.write[i].lods.clear();
-		Vector<Vector3> vertices = surfaces[i].arrays[RS::ARRAY_VERTEX];
-		Vector<int> indices = surfaces[i].arrays[RS::ARRAY_INDEX];
-		if (indices.size() == 0) {
-			continue; //no lods if no indices
+		Surface &surface = surfaces.write[i];
+		Vector<Vector3> vertices = surface.arrays[RS::ARRAY_VERTEX];
+		Vector<int> indices = surface.arrays[RS::ARRAY_INDEX];
+		int vertex_count = vertices.size();
+		int index_count = indices.size();
+		if (vertex_count == 0 || index_count == 0) {
+			continue; // Nothing to reorder.
 		}
-		uint32_t vertex_count = vertices.size();
-		const Vector3 *vertices_ptr = vertices.ptr();
-
-		int min_indices = 10;
-		int index_target = indices.size() / 2;
-		print_line("Total indices: " + itos(indices.size()));
-		float mesh_scale = SurfaceTool::simplify_scale_func((const float *)vertices_ptr, vertex_count, sizeof(Vector3));
-		const float target_error = 1e-3f;
-		float abs_target_error = target_error / mesh_scale;
-		while (index_target > min_indices) {
-			float error;
-			Vector<int> new_indices;
-			new_indices.resize(indices.size());
-			size_t new_len = SurfaceTool::simplify_func((unsigned int *)new_indices.ptrw(), (const unsigned int *)indices.ptr(), indices.size(), (const float *)vertices_ptr, vertex_count, sizeof(Vector3), index_target, abs_target_error, &error);
-			if ((int)new_len > (index_target * 120 / 100)) {
-				// Attribute discontinuities break normals.
-				bool is_sloppy = false;
-				if (is_sloppy) {
-					abs_target_error = target_error / mesh_scale;
-					index_target = new_len;
-					while (index_target > min_indices) {
-						Vector<int> sloppy_new_indices;
-						sloppy_new_indices.resize(indices.size());
-						new_len = SurfaceTool::simplify_sloppy_func((unsigned int *)sloppy_new_indices.ptrw(), (const unsigned int *)indices.ptr(), indices.size(), (const float *)vertices_ptr, vertex_count, sizeof(Vector3), index_target, abs_target_error, &error);
-						if ((int)new_len > (index_target * 120 / 100)) {
-							break; // 20 percent tolerance
-						}
-						sloppy_new_indices.resize(new_len);
-						Surface::LOD lod;
-						lod.distance = error * mesh_scale;
-						abs_target_error = lod.distance;
-						if (Math::is_equal_approx(abs_target_error, 0.0f)) {
-							return;
-						}
-						lod.indices = sloppy_new_indices;
-						print_line("Lod " + itos(surfaces.write[i].lods.size()) + " shoot for " + itos(index_target / 3) + " triangles, got " + itos(new_len / 3) + " triangles. Distance " + rtos(lod.distance) + ". Use simplify sloppy.");
-						surfaces.write[i].lods.push_back(lod);
-						index_target /= 2;
-					}
+
+		// meshoptimizer doesn't check the indices, and neither does the remap below.
+		bool indices_valid = _are_indices_in_range(indices, vertex_count);
+		for (int j = 0; j < surface.lods.size() && indices_valid; j++) {
+			indices_valid = _are_indices_in_range(surface.lods[j].indices, vertex_count);
+		}
+		ERR_CONTINUE_MSG(!indices_valid, "Surface " + itos(i) + " has indices out of its vertex range, not optimizing it.");
+
+		surface.arrays = surface.arrays.duplicate(); // Don't modify the arrays given to add_surface().
+
+		float acmr_before, atvr_before;
+		_analyze_vertex_cache(indices, vertex_count, acmr_before, atvr_before);
+
+		Vector<int> new_indices;
+		new_indices.resize(index_count);
+		SurfaceTool::optimize_vertex_cache_func((unsigned int *)new_indices.ptrw(), (const unsigned int *)indices.ptr(), index_count, vertex_count);
+
+		if (p_overdraw && SurfaceTool::optimize_overdraw_func) {
+			// Trades up to 5% of vertex cache efficiency for less overdraw.
+			indices = new_indices;
+			SurfaceTool::optimize_overdraw_func((unsigned int *)new_indices.ptrw(), (const unsigned int *)indices.ptr(), index_count, (const float *)vertices.ptr(), vertex_count, sizeof(Vector3), 1.05);
+		}
+
+		for (int j = 0; j < surface.lods.size(); j++) {
+			Vector<int> lod_indices = surface.lods[j].indices;
+			SurfaceTool::optimize_vertex_cache_func((unsigned int *)surface.lods.write[j].indices.ptrw(), (const unsigned int *)lod_indices.ptr(), lod_indices.size(), vertex_count);
+		}
+
+		if (p_vertex_fetch && SurfaceTool::optimize_vertex_fetch_remap_func) {
+			// Store vertices in the order they are first used, so fetches are mostly sequential.
+			LocalVector<uint32_t> remap;
+			remap.resize(vertex_count);
+			int new_vertex_count = SurfaceTool::optimize_vertex_fetch_remap_func(remap.ptr(), (const unsigned int *)new_indices.ptr(), index_count, vertex_count);
+
+			int *index_ptr = new_indices.ptrw();
+			for (int j = 0; j < index_count; j++) {
+				index_ptr[j] = remap[index_ptr[j]];
+			}
+			for (int j = 0; j < surface.lods.size(); j++) {
+				int *lod_ptr = surface.lods.write[j].indices.ptrw();
+				for (int k = 0; k < surface.lods[j].indices.size(); k++) {
+					lod_ptr[k] = remap[lod_ptr[k]];
 				}
-				break; // 20 percent tolerance
 			}
-			new_indices.resize(new_len);
-			Surface::LOD lod;
-			lod.distance = error * mesh_scale;
-			abs_target_error = lod.distance;
-			if (Math::is_equal_approx(abs_target_error, 0.0f)) {
-				return;
+
+			_remap_vertex_arrays(surface.arrays, remap, vertex_count, new_vertex_count);
+			for (int j = 0; j < surface.blend_shape_data.size(); j++) {
+				Array bs_arrays = surface.blend_shape_data[j].arrays.duplicate();
+				_remap_vertex_arrays(bs_arrays, remap, vertex_count, new_vertex_count);
+				surface.blend_shape_data.write[j].arrays = bs_arrays;
 			}
-			lod.indices = new_indices;
-			print_line("Lod " + itos(surfaces.write[i].lods.size()) + " shoot for " + itos(index_target / 3) + " triangles, got " + itos(new_len / 3) + " triangles. Distance " + rtos(lod.distance));
-			surfaces.write[i].lods.push_back(lod);
-			index_target /= 2;
+			vertex_count = new_vertex_count;
 		}
+
+		surface.arrays[RS::ARRAY_INDEX] = new_indices;
+
+		float acmr_after, atvr_after;
+		_analyze_vertex_cache(new_indices, vertex_count, acmr_after, atvr_after);
+		print_verbose("Surface " + itos(i) + (surface.name != String() ? " (" + surface.name + ")" : String()) + ": ACMR " + rtos(acmr_before) + " -> " + rtos(acmr_after) + ", ATVR " + rtos(atvr_before) + " -> " + rtos(atvr_after) + ".");
+	}
+
+	if (shadow_mesh.is_valid()) {
+		shadow_mesh->optimize_indices(p_overdraw, p_vertex_fetch);
 	}
+
+	mesh.unref();
 }
 
 bool EditorSceneImporterMesh::has_mesh() const {
@@ -32,6 +32,7 @@
 #define EDITOR_SCENE_IMPORTER_MESH_H
 
 #include "core/io/resource.h"
+#include "core/templates/local_vector.h"
 #include "scene/resources/mesh.h"
 // The following classes are used by importers instead of ArrayMesh and MeshInstance3D
 // so the data is not registered (hence, quality loss), importing happens faster and
@@ -40,6 +41,22 @@
 class EditorSceneImporterMesh : public Resource {
 	GDCLASS(EditorSceneImporterMesh, Resource)
 
+public:
+	struct LODReport {
+		struct Level {
+			int triangles = 0;
+			float error = 0.0; // Geometric error, relative to the mesh size.
+			float normal_error = 0.0; // Increase of the normal deviation over the full detail surface.
+		};
+		struct Surface {
+			int triangles = 0;
+			Vector<Level> levels;
+			uint64_t usec = 0;
+		};
+		Vector<Surface> surfaces;
+	};
+
+private:
 	struct Surface {
 		Mesh::PrimitiveType primitive;
 		Array arrays;
@@ -63,6 +80,23 @@ class EditorSceneImporterMesh : public Resource {
 
 	Ref<EditorSceneImporterMesh> shadow_mesh;
 
+	LODReport lod_report;
+
+	// Each surface is simplified on its own, so the surfaces of all the meshes are processed in a single parallel loop.
+	struct LODJob {
+		Surface *surface;
+		LODReport::Surface *report;
+		Vector<Vector3> vertices;
+		Vector<Vector3> normals;
+		Vector<int> indices;
+	};
+
+	static float _get_normal_error(const int *p_indices, int p_index_count, const Vector3 *p_vertices, const Vector3 *p_normals);
+	void _generate_lods_job(uint32_t p_index, LODJob *p_jobs); // Doesn't use the instance, ThreadWorkPool just needs one.
+
+	static void _analyze_vertex_cache(const Vector<int> &p_indices, int p_vertex_count, float &r_acmr, float &r_atvr);
+	static void _remap_vertex_arrays(Array &r_arrays, const LocalVector<uint32_t> &p_remap, int p_vertex_count, int p_new_vertex_count);
+
 protected:
 	void _set_data(const Dictionary &p_data);
 	Dictionary _get_data() const;
@@ -90,6 +124,9 @@ public:
 	Ref<Material> get_surface_material(int p_surface) const;
 
 	void generate_lods();
+	static void generate_lods_multiple(const Vector<EditorSceneImporterMesh *> &p_meshes);
+	const LODReport &get_lod_report() const { return lod_report; }
+	void optimize_indices(bool p_overdraw = true, bool p_vertex_fetch = true);
 
 	void create_shadow_mesh();
 	Ref<EditorSceneImporterMesh> get_shadow_mesh() const;
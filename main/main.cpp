@@ -44,6 +44,7 @@
 #include "core/io/resource_loader.h"
 #include "core/object/message_queue.h"
 #include "core/os/dir_access.h"
+#include "core/os/frame_arena.h"
 #include "core/os/os.h"
 #include "core/register_core_types.h"
 #include "core/string/translation.h"
@@ -2518,6 +2519,9 @@ bool Main::iteration() {
 		EngineDebugger::get_singleton()->iteration(frame_time, process_ticks, physics_process_ticks, physics_step);
 	}
 
+	// Nothing allocated from the frame arena of the main thread outlives the frame.
+	FrameArena::reset();
+
 	frames++;
 	Engine::get_singleton()->_process_frames++;
 
@@ -30,6 +30,7 @@
 
 #include "performance.h"
 
+#include "core/io/resource_loader.h"
 #include "core/object/message_queue.h"
 #include "core/os/os.h"
 #include "scene/main/node.h"
@@ -77,6 +78,9 @@ void Performance::_bind_methods() {
 	BIND_ENUM_CONSTANT(PHYSICS_3D_COLLISION_PAIRS);
 	BIND_ENUM_CONSTANT(PHYSICS_3D_ISLAND_COUNT);
 	BIND_ENUM_CONSTANT(AUDIO_OUTPUT_LATENCY);
+	BIND_ENUM_CONSTANT(RESOURCE_LOADER_THREADED_QUEUED);
+	BIND_ENUM_CONSTANT(RESOURCE_LOADER_THREADED_ACTIVE);
+	BIND_ENUM_CONSTANT(RESOURCE_LOADER_THREADED_WAIT_TIME);
 
 	BIND_ENUM_CONSTANT(MONITOR_MAX);
 }
@@ -120,6 +124,9 @@ String Performance::get_monitor_name(Monitor p_monitor) const {
 		"physics_3d/collision_pairs",
 		"physics_3d/islands",
 		"audio/output_latency",
+		"resource_loader/threaded_queued",
+		"resource_loader/threaded_active",
+		"resource_loader/threaded_wait_time",
 
 	};
 
@@ -182,6 +189,12 @@ float Performance::get_monitor(Monitor p_monitor) const {
 			return PhysicsServer3D::get_singleton()->get_process_info(PhysicsServer3D::INFO_ISLAND_COUNT);
 		case AUDIO_OUTPUT_LATENCY:
 			return AudioServer::get_singleton()->get_output_latency();
+		case RESOURCE_LOADER_THREADED_QUEUED:
+			return ResourceLoader::load_threaded_get_queued_count();
+		case RESOURCE_LOADER_THREADED_ACTIVE:
+			return ResourceLoader::load_threaded_get_active_count();
+		case RESOURCE_LOADER_THREADED_WAIT_TIME:
+			return ResourceLoader::load_threaded_get_average_wait_time();
 
 		default: {
 		}
@@ -221,6 +234,9 @@ Performance::MonitorType Performance::get_monitor_type(Monitor p_monitor) const
 		MONITOR_TYPE_QUANTITY,
 		MONITOR_TYPE_QUANTITY,
 		MONITOR_TYPE_TIME,
+		MONITOR_TYPE_QUANTITY,
+		MONITOR_TYPE_QUANTITY,
+		MONITOR_TYPE_TIME,
 
 	};
 
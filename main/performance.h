@@ -91,6 +91,9 @@ public:
 		PHYSICS_3D_ISLAND_COUNT,
 		//physics
 		AUDIO_OUTPUT_LATENCY,
+		RESOURCE_LOADER_THREADED_QUEUED,
+		RESOURCE_LOADER_THREADED_ACTIVE,
+		RESOURCE_LOADER_THREADED_WAIT_TIME,
 		MONITOR_MAX
 	};
 
@@ -166,7 +166,7 @@ protected:
 	bool _set(const StringName &p_name, const Variant &p_value);
 	void _get_property_list(List<PropertyInfo> *p_properties) const;
 
-	Variant call(const StringName &p_method, const Variant **p_args, int p_argcount, Callable::CallError &r_error) override;
+	Variant call(const StringName &p_method, const Variant **p_args, int p_argcount, Callable::CallError &r_error, MethodCallCache *p_cache = nullptr) override;
 
 	static void _bind_methods();
 
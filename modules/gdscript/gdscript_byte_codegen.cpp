@@ -151,6 +151,7 @@ GDScriptFunction *GDScriptByteCodeGenerator::write_end() {
 			function->global_names.write[E->get()] = E->key();
 		}
 		function->_global_names_count = function->global_names.size();
+		function->_method_caches_ptr = memnew_arr(MethodCallCache, function->_global_names_count);
 
 	} else {
 		function->_global_names_ptr = nullptr;
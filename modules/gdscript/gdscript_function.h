@@ -327,6 +327,7 @@ private:
 	int _constant_count = 0;
 	const StringName *_global_names_ptr = nullptr;
 	int _global_names_count = 0;
+	MethodCallCache *_method_caches_ptr = nullptr; // One per global name, for calls by that name.
 	const int *_default_arg_ptr = nullptr;
 	int _default_arg_count = 0;
 	int _operator_funcs_count = 0;
@@ -64,14 +64,14 @@ void JavaClassWrapper::_bind_methods() {
 
 #if !defined(ANDROID_ENABLED)
 
-Variant JavaClass::call(const StringName &, const Variant **, int, Callable::CallError &) {
+Variant JavaClass::call(const StringName &, const Variant **, int, Callable::CallError &, MethodCallCache *) {
 	return Variant();
 }
 
 JavaClass::JavaClass() {
 }
 
-Variant JavaObject::call(const StringName &, const Variant **, int, Callable::CallError &) {
+Variant JavaObject::call(const StringName &, const Variant **, int, Callable::CallError &, MethodCallCache *) {
 	return Variant();
 }
 
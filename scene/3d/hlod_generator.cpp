@@ -0,0 +1,259 @@
+/*************************************************************************/
+/*  hlod_generator.cpp                                                   */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "hlod_generator.h"
+
+#include "core/math/vector3i.h"
+#include "core/templates/map.h"
+#include "scene/3d/mesh_instance_3d.h"
+#include "scene/resources/surface_tool.h"
+
+bool HLODGenerator::_is_mesh_instance_eligible(MeshInstance3D *p_mesh_instance) {
+	Ref<Mesh> mesh = p_mesh_instance->get_mesh();
+	if (mesh.is_null() || mesh->get_surface_count() == 0 || mesh->get_blend_shape_count() > 0) {
+		return false;
+	}
+	if (p_mesh_instance->get_skin().is_valid() || p_mesh_instance->get_skeleton_path() != NodePath()) {
+		return false;
+	}
+	// Leave instances that already have their own LOD setup alone.
+	if (p_mesh_instance->get_lod_min_distance() > 0 || p_mesh_instance->get_lod_max_distance() > 0 || p_mesh_instance->get_lod_parent() != NodePath()) {
+		return false;
+	}
+	if (!p_mesh_instance->is_visible()) {
+		return false;
+	}
+
+	for (int i = 0; i < mesh->get_surface_count(); i++) {
+		if (mesh->surface_get_primitive_type(i) != Mesh::PRIMITIVE_TRIANGLES) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void HLODGenerator::_find_mesh_instances(Node *p_node, Node *p_root, Vector<MeshInstance3D *> &r_mesh_instances) {
+	MeshInstance3D *mi = Object::cast_to<MeshInstance3D>(p_node);
+	if (mi && p_node != p_root && _is_mesh_instance_eligible(mi)) {
+		r_mesh_instances.push_back(mi);
+	}
+
+	for (int i = 0; i < p_node->get_child_count(); i++) {
+		_find_mesh_instances(p_node->get_child(i), p_root, r_mesh_instances);
+	}
+}
+
+Transform HLODGenerator::_get_relative_transform(Node3D *p_node, Node *p_root) {
+	// The scene may not be inside the tree (e.g. while importing), so global transforms can't be used.
+	Transform xform;
+	Node *n = p_node;
+	while (n && n != p_root) {
+		Node3D *n3d = Object::cast_to<Node3D>(n);
+		if (n3d) {
+			xform = n3d->get_transform() * xform;
+		}
+		n = n->get_parent();
+	}
+	return xform;
+}
+
+Vector<HLODGenerator::Cluster> HLODGenerator::build_clusters(const Vector<AABB> &p_aabbs, const Settings &p_settings) {
+	Vector<Cluster> clusters;
+	ERR_FAIL_COND_V(p_settings.cluster_size <= 0, clusters);
+
+	Map<Vector3i, Cluster> cells;
+
+	for (int i = 0; i < p_aabbs.size(); i++) {
+		const AABB &aabb = p_aabbs[i];
+		Vector3 center = (aabb.position + aabb.size * 0.5) / p_settings.cluster_size;
+		Vector3i cell(Math::floor(center.x), Math::floor(center.y), Math::floor(center.z));
+
+		Map<Vector3i, Cluster>::Element *E = cells.find(cell);
+		if (!E) {
+			E = cells.insert(cell, Cluster());
+			E->get().aabb = aabb;
+		} else {
+			E->get().aabb.merge_with(aabb);
+		}
+		E->get().instances.push_back(i);
+	}
+
+	for (Map<Vector3i, Cluster>::Element *E = cells.front(); E; E = E->next()) {
+		if (E->get().instances.size() >= MAX(p_settings.min_instances, 1)) {
+			clusters.push_back(E->get());
+		}
+	}
+
+	return clusters;
+}
+
+HLODGenerator::Stats HLODGenerator::get_cluster_stats(const Vector<Cluster> &p_clusters, int p_instance_count, const Settings &p_settings) {
+	Stats stats;
+	stats.clusters = p_clusters.size();
+	stats.instances_before = p_instance_count;
+
+	int clustered = 0;
+	for (int i = 0; i < p_clusters.size(); i++) {
+		clustered += p_clusters[i].instances.size();
+	}
+
+	// Each cluster draws one proxy far away, and either one merged instance or its originals up close.
+	stats.instances_near = p_instance_count - clustered + (p_settings.merge_meshes ? p_clusters.size() : clustered);
+	stats.instances_far = p_instance_count - clustered + p_clusters.size();
+
+	return stats;
+}
+
+HLODGenerator::Stats HLODGenerator::generate(Node *p_root, const Settings &p_settings) {
+	ERR_FAIL_NULL_V(p_root, Stats());
+
+	Vector<MeshInstance3D *> mesh_instances;
+	_find_mesh_instances(p_root, p_root, mesh_instances);
+
+	Vector<Transform> xforms;
+	Vector<AABB> aabbs;
+	xforms.resize(mesh_instances.size());
+	aabbs.resize(mesh_instances.size());
+
+	for (int i = 0; i < mesh_instances.size(); i++) {
+		xforms.write[i] = _get_relative_transform(mesh_instances[i], p_root);
+		aabbs.write[i] = xforms[i].xform(mesh_instances[i]->get_mesh()->get_aabb());
+	}
+
+	Vector<Cluster> clusters = build_clusters(aabbs, p_settings);
+
+	for (int i = 0; i < clusters.size(); i++) {
+		const Cluster &cluster = clusters[i];
+		Transform cluster_xform;
+		cluster_xform.origin = cluster.aabb.position + cluster.aabb.size * 0.5;
+		Transform cluster_xform_inv = cluster_xform.affine_inverse();
+
+		// Merge all the surfaces of the cluster, per material.
+		Map<Ref<Material>, Ref<SurfaceTool>> surface_tools;
+
+		for (int j = 0; j < cluster.instances.size(); j++) {
+			int idx = cluster.instances[j];
+			MeshInstance3D *mi = mesh_instances[idx];
+			Ref<Mesh> mesh = mi->get_mesh();
+
+			for (int k = 0; k < mesh->get_surface_count(); k++) {
+				Ref<Mesh> source = mesh;
+				int source_surface = k;
+
+				if (mesh->surface_get_array_index_len(k) == 0) {
+					// SurfaceTool can't append non indexed surfaces to indexed ones, so index it.
+					Ref<SurfaceTool> st;
+					st.instance();
+					st->create_from(mesh, k);
+					st->index();
+					source = st->commit();
+					source_surface = 0;
+				}
+
+				Ref<Material> material = mi->get_active_material(k);
+				Map<Ref<Material>, Ref<SurfaceTool>>::Element *E = surface_tools.find(material);
+				if (!E) {
+					Ref<SurfaceTool> st;
+					st.instance();
+					E = surface_tools.insert(material, st);
+				}
+
+				E->get()->append_from(source, source_surface, cluster_xform_inv * xforms[idx]);
+			}
+		}
+
+		Ref<ArrayMesh> merged_mesh;
+		merged_mesh.instance();
+		Ref<ArrayMesh> proxy_mesh;
+		proxy_mesh.instance();
+
+		for (Map<Ref<Material>, Ref<SurfaceTool>>::Element *E = surface_tools.front(); E; E = E->next()) {
+			Ref<SurfaceTool> st = E->get();
+
+			Array arrays = st->commit_to_arrays();
+			Vector<int> indices = arrays[RS::ARRAY_INDEX];
+
+			if (p_settings.merge_meshes) {
+				merged_mesh->add_surface_from_arrays(Mesh::PRIMITIVE_TRIANGLES, arrays);
+				merged_mesh->surface_set_material(merged_mesh->get_surface_count() - 1, E->key());
+			}
+
+			if (SurfaceTool::simplify_func && p_settings.proxy_ratio < 1.0) {
+				int target_index_count = MAX(int(indices.size() * p_settings.proxy_ratio) / 3 * 3, 3);
+				Vector<int> lod = st->generate_lod(1.0, target_index_count);
+				if (lod.size()) {
+					arrays[RS::ARRAY_INDEX] = lod;
+				}
+			}
+
+			proxy_mesh->add_surface_from_arrays(Mesh::PRIMITIVE_TRIANGLES, arrays);
+			proxy_mesh->surface_set_material(proxy_mesh->get_surface_count() - 1, E->key());
+		}
+
+		MeshInstance3D *proxy = memnew(MeshInstance3D);
+		proxy->set_name("HLOD" + itos(i));
+		proxy->set_transform(cluster_xform);
+		proxy->set_mesh(proxy_mesh);
+		proxy->set_lod_min_distance(p_settings.distance);
+		p_root->add_child(proxy, true);
+		proxy->set_owner(p_root);
+
+		if (p_settings.merge_meshes) {
+			MeshInstance3D *merged = memnew(MeshInstance3D);
+			merged->set_name("HLOD" + itos(i) + "Detail");
+			merged->set_transform(cluster_xform);
+			merged->set_mesh(merged_mesh);
+			merged->set_lod_max_distance(p_settings.distance);
+			p_root->add_child(merged, true);
+			merged->set_owner(p_root);
+			merged->set_lod_parent(merged->get_path_to(proxy));
+		}
+
+		for (int j = 0; j < cluster.instances.size(); j++) {
+			MeshInstance3D *mi = mesh_instances[cluster.instances[j]];
+
+			if (p_settings.merge_meshes) {
+				if (mi->get_child_count() == 0) {
+					mi->get_parent()->remove_child(mi);
+					memdelete(mi);
+				} else {
+					// Keep the node for its children (e.g. collisions), it's drawn by the merged mesh.
+					mi->set_mesh(Ref<Mesh>());
+				}
+			} else {
+				mi->set_lod_max_distance(p_settings.distance);
+				mi->set_lod_parent(mi->get_path_to(proxy));
+			}
+		}
+	}
+
+	return get_cluster_stats(clusters, mesh_instances.size(), p_settings);
+}
@@ -0,0 +1,85 @@
+/*************************************************************************/
+/*  hlod_generator.h                                                     */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef HLOD_GENERATOR_H
+#define HLOD_GENERATOR_H
+
+#include "core/math/aabb.h"
+#include "core/math/transform.h"
+#include "core/templates/vector.h"
+
+class Node;
+class Node3D;
+class MeshInstance3D;
+
+// Groups static MeshInstance3Ds spatially into clusters, and gives each
+// cluster a simplified proxy mesh (merged per material) that replaces the
+// whole cluster at a distance. The swap is done by the renderer through the
+// draw range of the instances and GeometryInstance3D.lod_parent, so it costs
+// nothing at runtime besides drawing fewer instances far away.
+class HLODGenerator {
+public:
+	struct Settings {
+		float cluster_size = 32.0; // Edge length of the grid cells used to cluster instances.
+		float distance = 64.0; // Distance at which a cluster is swapped with its proxy.
+		float proxy_ratio = 0.25; // Fraction of the triangles kept in the proxy.
+		bool merge_meshes = true; // Also merge the full detail meshes of a cluster per material.
+		int min_instances = 2; // Clusters with less instances are left untouched.
+	};
+
+	struct Cluster {
+		AABB aabb;
+		Vector<int> instances;
+	};
+
+	struct Stats {
+		int clusters = 0;
+		int instances_before = 0; // Mesh instances considered for clustering.
+		int instances_near = 0; // Mesh instances drawn when close to the clusters.
+		int instances_far = 0; // Mesh instances drawn when far from the clusters.
+	};
+
+private:
+	static bool _is_mesh_instance_eligible(MeshInstance3D *p_mesh_instance);
+	static void _find_mesh_instances(Node *p_node, Node *p_root, Vector<MeshInstance3D *> &r_mesh_instances);
+	static Transform _get_relative_transform(Node3D *p_node, Node *p_root);
+
+public:
+	// Assigns each AABB to a grid cell by its center. Only cells with at least
+	// min_instances AABBs become clusters, sorted by cell.
+	static Vector<Cluster> build_clusters(const Vector<AABB> &p_aabbs, const Settings &p_settings);
+	static Stats get_cluster_stats(const Vector<Cluster> &p_clusters, int p_instance_count, const Settings &p_settings);
+
+	// Adds the proxies as children of p_root, and merges or links the
+	// clustered instances to them. The nodes are owned by p_root.
+	static Stats generate(Node *p_root, const Settings &p_settings);
+};
+
+#endif // HLOD_GENERATOR_H
@@ -0,0 +1,102 @@
+/*************************************************************************/
+/*  occluder_instance_3d.cpp                                             */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "occluder_instance_3d.h"
+
+void OccluderInstance3D::_update_occluder() {
+	aabb = AABB();
+	for (int i = 0; i < vertices.size(); i++) {
+		if (i == 0) {
+			aabb.position = vertices[i];
+		} else {
+			aabb.expand_to(vertices[i]);
+		}
+	}
+
+	// Vertices and indices are set one after the other, only send complete meshes.
+	bool valid = indices.size() % 3 == 0;
+	for (int i = 0; valid && i < indices.size(); i++) {
+		valid = indices[i] >= 0 && indices[i] < vertices.size();
+	}
+
+	if (valid) {
+		RS::get_singleton()->occluder_set_mesh(occluder, vertices, indices);
+	} else {
+		RS::get_singleton()->occluder_set_mesh(occluder, PackedVector3Array(), PackedInt32Array());
+	}
+
+	update_gizmo();
+}
+
+void OccluderInstance3D::set_vertices(const PackedVector3Array &p_vertices) {
+	vertices = p_vertices;
+	_update_occluder();
+}
+
+PackedVector3Array OccluderInstance3D::get_vertices() const {
+	return vertices;
+}
+
+void OccluderInstance3D::set_indices(const PackedInt32Array &p_indices) {
+	indices = p_indices;
+	_update_occluder();
+}
+
+PackedInt32Array OccluderInstance3D::get_indices() const {
+	return indices;
+}
+
+AABB OccluderInstance3D::get_aabb() const {
+	return aabb;
+}
+
+Vector<Face3> OccluderInstance3D::get_faces(uint32_t p_usage_flags) const {
+	return Vector<Face3>();
+}
+
+void OccluderInstance3D::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("set_vertices", "vertices"), &OccluderInstance3D::set_vertices);
+	ClassDB::bind_method(D_METHOD("get_vertices"), &OccluderInstance3D::get_vertices);
+
+	ClassDB::bind_method(D_METHOD("set_indices", "indices"), &OccluderInstance3D::set_indices);
+	ClassDB::bind_method(D_METHOD("get_indices"), &OccluderInstance3D::get_indices);
+
+	ADD_PROPERTY(PropertyInfo(Variant::PACKED_VECTOR3_ARRAY, "vertices"), "set_vertices", "get_vertices");
+	ADD_PROPERTY(PropertyInfo(Variant::PACKED_INT32_ARRAY, "indices"), "set_indices", "get_indices");
+}
+
+OccluderInstance3D::OccluderInstance3D() {
+	occluder = RS::get_singleton()->occluder_create();
+	RS::get_singleton()->instance_set_base(get_instance(), occluder);
+}
+
+OccluderInstance3D::~OccluderInstance3D() {
+	RS::get_singleton()->free(occluder);
+}
@@ -188,7 +188,43 @@ float GeometryInstance3D::get_lod_max_hysteresis() const {
 	return lod_max_hysteresis;
 }
 
+void GeometryInstance3D::_attach_lod_parent() {
+	Node *n = get_node_or_null(lod_parent);
+	if (n) {
+		GeometryInstance3D *parent = Object::cast_to<GeometryInstance3D>(n);
+		if (parent && parent != this) {
+			RS::get_singleton()->instance_geometry_set_as_instance_lod(get_instance(), parent->get_instance());
+		}
+	}
+}
+
+void GeometryInstance3D::set_lod_parent(const NodePath &p_path) {
+	if (is_inside_tree()) {
+		RS::get_singleton()->instance_geometry_set_as_instance_lod(get_instance(), RID());
+	}
+
+	lod_parent = p_path;
+
+	if (is_inside_tree() && lod_parent != NodePath()) {
+		_attach_lod_parent();
+	}
+}
+
+NodePath GeometryInstance3D::get_lod_parent() const {
+	return lod_parent;
+}
+
 void GeometryInstance3D::_notification(int p_what) {
+	// Also on ready, as the LOD parent may be a sibling that entered the tree later.
+	if (p_what == NOTIFICATION_ENTER_TREE || p_what == NOTIFICATION_READY) {
+		if (lod_parent != NodePath()) {
+			_attach_lod_parent();
+		}
+	}
+
+	if (p_what == NOTIFICATION_EXIT_TREE) {
+		RS::get_singleton()->instance_geometry_set_as_instance_lod(get_instance(), RID());
+	}
 }
 
 const StringName *GeometryInstance3D::_instance_uniform_get_remap(const StringName p_name) const {
@@ -362,6 +398,9 @@ void GeometryInstance3D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_lod_min_distance", "mode"), &GeometryInstance3D::set_lod_min_distance);
 	ClassDB::bind_method(D_METHOD("get_lod_min_distance"), &GeometryInstance3D::get_lod_min_distance);
 
+	ClassDB::bind_method(D_METHOD("set_lod_parent", "path"), &GeometryInstance3D::set_lod_parent);
+	ClassDB::bind_method(D_METHOD("get_lod_parent"), &GeometryInstance3D::get_lod_parent);
+
 	ClassDB::bind_method(D_METHOD("set_extra_cull_margin", "margin"), &GeometryInstance3D::set_extra_cull_margin);
 	ClassDB::bind_method(D_METHOD("get_extra_cull_margin"), &GeometryInstance3D::get_extra_cull_margin);
 
@@ -388,10 +427,11 @@ void GeometryInstance3D::_bind_methods() {
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "gi_lightmap_scale", PROPERTY_HINT_ENUM, "1x,2x,4x,8x"), "set_lightmap_scale", "get_lightmap_scale");
 
 	ADD_GROUP("LOD", "lod_");
-	ADD_PROPERTY(PropertyInfo(Variant::INT, "lod_min_distance", PROPERTY_HINT_RANGE, "0,32768,0.01"), "set_lod_min_distance", "get_lod_min_distance");
-	ADD_PROPERTY(PropertyInfo(Variant::INT, "lod_min_hysteresis", PROPERTY_HINT_RANGE, "0,32768,0.01"), "set_lod_min_hysteresis", "get_lod_min_hysteresis");
-	ADD_PROPERTY(PropertyInfo(Variant::INT, "lod_max_distance", PROPERTY_HINT_RANGE, "0,32768,0.01"), "set_lod_max_distance", "get_lod_max_distance");
-	ADD_PROPERTY(PropertyInfo(Variant::INT, "lod_max_hysteresis", PROPERTY_HINT_RANGE, "0,32768,0.01"), "set_lod_max_hysteresis", "get_lod_max_hysteresis");
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "lod_min_distance", PROPERTY_HINT_RANGE, "0,32768,0.01"), "set_lod_min_distance", "get_lod_min_distance");
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "lod_min_hysteresis", PROPERTY_HINT_RANGE, "0,32768,0.01"), "set_lod_min_hysteresis", "get_lod_min_hysteresis");
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "lod_max_distance", PROPERTY_HINT_RANGE, "0,32768,0.01"), "set_lod_max_distance", "get_lod_max_distance");
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "lod_max_hysteresis", PROPERTY_HINT_RANGE, "0,32768,0.01"), "set_lod_max_hysteresis", "get_lod_max_hysteresis");
+	ADD_PROPERTY(PropertyInfo(Variant::NODE_PATH, "lod_parent", PROPERTY_HINT_NODE_PATH_VALID_TYPES, "GeometryInstance3D"), "set_lod_parent", "get_lod_parent");
 
 	//ADD_SIGNAL( MethodInfo("visibility_changed"));
 
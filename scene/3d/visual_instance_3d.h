@@ -111,6 +111,7 @@ private:
 	float lod_max_distance;
 	float lod_min_hysteresis;
 	float lod_max_hysteresis;
+	NodePath lod_parent;
 
 	float lod_bias;
 
@@ -122,6 +123,7 @@ private:
 	GIMode gi_mode;
 
 	const StringName *_instance_uniform_get_remap(const StringName p_name) const;
+	void _attach_lod_parent();
 
 protected:
 	bool _set(const StringName &p_name, const Variant &p_value);
@@ -147,6 +149,9 @@ public:
 	void set_lod_max_hysteresis(float p_dist);
 	float get_lod_max_hysteresis() const;
 
+	void set_lod_parent(const NodePath &p_path);
+	NodePath get_lod_parent() const;
+
 	void set_material_override(const Ref<Material> &p_material);
 	Ref<Material> get_material_override() const;
 
@@ -238,7 +238,7 @@ void SceneTree::call_group_flags(uint32_t p_call_flags, const StringName &p_grou
 	_update_group_order(g);
 
 	Vector<Node *> nodes_copy = g.nodes;
-	Node **nodes = nodes_copy.ptrw();
+	Node *const *nodes = nodes_copy.ptr(); // Not ptrw(), which would copy the data on each call.
 	int node_count = nodes_copy.size();
 
 	call_lock++;
@@ -289,7 +289,7 @@ void SceneTree::notify_group_flags(uint32_t p_call_flags, const StringName &p_gr
 	_update_group_order(g);
 
 	Vector<Node *> nodes_copy = g.nodes;
-	Node **nodes = nodes_copy.ptrw();
+	Node *const *nodes = nodes_copy.ptr(); // Not ptrw(), which would copy the data on each call.
 	int node_count = nodes_copy.size();
 
 	call_lock++;
@@ -340,7 +340,7 @@ void SceneTree::set_group_flags(uint32_t p_call_flags, const StringName &p_group
 	_update_group_order(g);
 
 	Vector<Node *> nodes_copy = g.nodes;
-	Node **nodes = nodes_copy.ptrw();
+	Node *const *nodes = nodes_copy.ptr(); // Not ptrw(), which would copy the data on each call.
 	int node_count = nodes_copy.size();
 
 	call_lock++;
@@ -790,11 +790,11 @@ void SceneTree::_notify_group_pause(const StringName &p_group, int p_notificatio
 	_update_group_order(g, p_notification == Node::NOTIFICATION_PROCESS || p_notification == Node::NOTIFICATION_INTERNAL_PROCESS || p_notification == Node::NOTIFICATION_PHYSICS_PROCESS || p_notification == Node::NOTIFICATION_INTERNAL_PHYSICS_PROCESS);
 
 	//copy, so copy on write happens in case something is removed from process while being called
-	//performance is not lost because only if something is added/removed the vector is copied.
+	//performance is not lost because only if something is added/removed the vector is copied (as long as it is read with ptr()).
 	Vector<Node *> nodes_copy = g.nodes;
 
 	int node_count = nodes_copy.size();
-	Node **nodes = nodes_copy.ptrw();
+	Node *const *nodes = nodes_copy.ptr();
 
 	call_lock++;
 
@@ -843,11 +843,11 @@ void SceneTree::_call_input_pause(const StringName &p_group, const StringName &p
 	_update_group_order(g);
 
 	//copy, so copy on write happens in case something is removed from process while being called
-	//performance is not lost because only if something is added/removed the vector is copied.
+	//performance is not lost because only if something is added/removed the vector is copied (as long as it is read with ptr()).
 	Vector<Node *> nodes_copy = g.nodes;
 
 	int node_count = nodes_copy.size();
-	Node **nodes = nodes_copy.ptrw();
+	Node *const *nodes = nodes_copy.ptr();
 
 	Variant arg = p_input;
 	const Variant *v[1] = { &arg };
@@ -162,21 +162,15 @@ Error ResourceLoaderText::_parse_ext_resource(VariantParser::Stream *p_stream, R
 
 		if (ext_resources[id].cache.is_valid()) {
 			r_res = ext_resources[id].cache;
-		} else if (use_sub_threads) {
-			RES res = ResourceLoader::load_threaded_get(path);
-			if (res.is_null()) {
-				if (ResourceLoader::get_abort_on_missing_resources()) {
-					error = ERR_FILE_CORRUPT;
-					error_text = "[ext_resource] referenced nonexistent resource at: " + path;
-					_printerr();
-					return error;
-				} else {
-					ResourceLoader::notify_dependency_error(local_path, path, type);
-				}
-			} else {
-				ext_resources[id].cache = res;
-				r_res = res;
+		} else if (ext_resources[id].pending) {
+			Error err = _join_ext_resource(id);
+			if (err != OK) {
+				return err;
 			}
+			r_res = ext_resources[id].cache;
+		} else if (use_sub_threads) {
+			//the threaded request failed and was already notified
+			r_res = RES();
 		} else {
 			error = ERR_FILE_CORRUPT;
 			error_text = "[ext_resource] referenced non-loaded resource at: " + path;
@@ -196,6 +190,31 @@ Error ResourceLoaderText::_parse_ext_resource(VariantParser::Stream *p_stream, R
 	return OK;
 }
 
+Error ResourceLoaderText::_join_ext_resource(int p_id) {
+	ExtResource &er = ext_resources[p_id];
+	er.pending = false;
+
+	RES res = ResourceLoader::load_threaded_get(er.path);
+	if (res.is_null()) {
+		if (ResourceLoader::get_abort_on_missing_resources()) {
+			error = ERR_FILE_CORRUPT;
+			error_text = "[ext_resource] referenced nonexistent resource at: " + er.path;
+			_printerr();
+			return error;
+		} else {
+			ResourceLoader::notify_dependency_error(local_path, er.path, er.type);
+		}
+	} else {
+#ifdef TOOLS_ENABLED
+		//remember ID for saving
+		res->set_id_for_path(local_path, p_id);
+#endif
+		er.cache = res;
+	}
+
+	return OK;
+}
+
 Ref<PackedScene> ResourceLoaderText::_parse_node_tag(VariantParser::ResourceParser &parser) {
 	Ref<PackedScene> packed_scene;
 	packed_scene.instance();
@@ -440,9 +459,12 @@ Error ResourceLoaderText::load() {
 		er.type = type;
 
 		if (use_sub_threads) {
-			Error err = ResourceLoader::load_threaded_request(path, type, use_sub_threads, local_path);
+			Error err = ResourceLoader::load_threaded_request(path, type, use_sub_threads, 0, local_path);
 
-			if (err != OK) {
+			if (err == OK) {
+				//loads concurrently with the sub resources, joined on first use
+				er.pending = true;
+			} else {
 				if (ResourceLoader::get_abort_on_missing_resources()) {
 					error = ERR_FILE_CORRUPT;
 					error_text = "[ext_resource] referenced broken resource at: " + path;
@@ -577,6 +599,17 @@ Error ResourceLoaderText::load() {
 		}
 	}
 
+	//every dependency loading in a thread must be done before the main resource or scene is assembled,
+	//including the ones not referenced by any property, so their tasks are not left behind
+	for (Map<int, ExtResource>::Element *E = ext_resources.front(); E; E = E->next()) {
+		if (E->get().pending) {
+			error = _join_ext_resource(E->key());
+			if (error != OK) {
+				return error;
+			}
+		}
+	}
+
 	while (true) {
 		if (next_tag.name != "resource") {
 			break;
@@ -762,6 +795,8 @@ void ResourceLoaderText::get_dependencies(FileAccess *p_f, List<String> *p_depen
 }
 
 Error ResourceLoaderText::rename_dependencies(FileAccess *p_f, const String &p_path, const Map<String, String> &p_map) {
+	//the file position is used to copy everything after the ext_resource tags, so it must not read ahead
+	stream.readahead_enabled = false;
 	open(p_f, true);
 	ERR_FAIL_COND_V(error != OK, error);
 	ignore_resource_parsing = true;
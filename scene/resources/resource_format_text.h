@@ -51,6 +51,7 @@ class ResourceLoaderText {
 		RES cache;
 		String path;
 		String type;
+		bool pending = false;
 	};
 
 	bool is_scene;
@@ -84,6 +85,7 @@ class ResourceLoaderText {
 
 	Error _parse_sub_resource(VariantParser::Stream *p_stream, Ref<Resource> &r_res, int &line, String &r_err_str);
 	Error _parse_ext_resource(VariantParser::Stream *p_stream, Ref<Resource> &r_res, int &line, String &r_err_str);
+	Error _join_ext_resource(int p_id);
 
 	// for converter
 	class DummyResource : public Resource {
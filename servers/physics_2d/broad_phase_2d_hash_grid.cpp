@@ -35,7 +35,7 @@
 #define LARGE_ELEMENT_FI 1.01239812
 
 void BroadPhase2DHashGrid::_pair_attempt(Element *p_elem, Element *p_with) {
-	Map<Element *, PairData *>::Element *E = p_elem->paired.find(p_with);
+	PairData **E = p_elem->paired.getptr(p_with);
 
 	ERR_FAIL_COND(p_elem->_static && p_with->_static);
 
@@ -44,49 +44,52 @@ void BroadPhase2DHashGrid::_pair_attempt(Element *p_elem, Element *p_with) {
 		p_elem->paired[p_with] = pd;
 		p_with->paired[p_elem] = pd;
 	} else {
-		E->get()->rc++;
+		(*E)->rc++;
 	}
 }
 
 void BroadPhase2DHashGrid::_unpair_attempt(Element *p_elem, Element *p_with) {
-	Map<Element *, PairData *>::Element *E = p_elem->paired.find(p_with);
+	PairData **E = p_elem->paired.getptr(p_with);
 
 	ERR_FAIL_COND(!E); //this should really be paired..
 
-	E->get()->rc--;
+	PairData *pd = *E;
+	pd->rc--;
 
-	if (E->get()->rc == 0) {
-		if (E->get()->colliding) {
+	if (pd->rc == 0) {
+		if (pd->colliding) {
 			//uncollide
 			if (unpair_callback) {
-				unpair_callback(p_elem->owner, p_elem->subindex, p_with->owner, p_with->subindex, E->get()->ud, unpair_userdata);
+				unpair_callback(p_elem->owner, p_elem->subindex, p_with->owner, p_with->subindex, pd->ud, unpair_userdata);
 			}
 		}
 
-		memdelete(E->get());
-		p_elem->paired.erase(E);
+		memdelete(pd);
+		p_elem->paired.erase(p_with);
 		p_with->paired.erase(p_elem);
 	}
 }
 
 void BroadPhase2DHashGrid::_check_motion(Element *p_elem) {
-	for (Map<Element *, PairData *>::Element *E = p_elem->paired.front(); E; E = E->next()) {
-		bool physical_collision = p_elem->aabb.intersects(E->key()->aabb);
-		bool logical_collision = p_elem->owner->test_collision_mask(E->key()->owner);
+	for (uint32_t i = 0; i < p_elem->paired.size(); i++) {
+		Element *other = p_elem->paired.get_key(i);
+		PairData *pd = p_elem->paired.get_value(i);
+		bool physical_collision = p_elem->aabb.intersects(other->aabb);
+		bool logical_collision = p_elem->owner->test_collision_mask(other->owner);
 
 		if (physical_collision) {
-			if (!E->get()->colliding || (logical_collision && !E->get()->ud && pair_callback)) {
-				E->get()->ud = pair_callback(p_elem->owner, p_elem->subindex, E->key()->owner, E->key()->subindex, pair_userdata);
-			} else if (E->get()->colliding && !logical_collision && E->get()->ud && unpair_callback) {
-				unpair_callback(p_elem->owner, p_elem->subindex, E->key()->owner, E->key()->subindex, E->get()->ud, unpair_userdata);
-				E->get()->ud = nullptr;
+			if (!pd->colliding || (logical_collision && !pd->ud && pair_callback)) {
+				pd->ud = pair_callback(p_elem->owner, p_elem->subindex, other->owner, other->subindex, pair_userdata);
+			} else if (pd->colliding && !logical_collision && pd->ud && unpair_callback) {
+				unpair_callback(p_elem->owner, p_elem->subindex, other->owner, other->subindex, pd->ud, unpair_userdata);
+				pd->ud = nullptr;
 			}
-			E->get()->colliding = true;
+			pd->colliding = true;
 		} else { // No physcial_collision
-			if (E->get()->colliding && unpair_callback) {
-				unpair_callback(p_elem->owner, p_elem->subindex, E->key()->owner, E->key()->subindex, E->get()->ud, unpair_userdata);
+			if (pd->colliding && unpair_callback) {
+				unpair_callback(p_elem->owner, p_elem->subindex, other->owner, other->subindex, pd->ud, unpair_userdata);
 			}
-			E->get()->colliding = false;
+			pd->colliding = false;
 		}
 	}
 }
@@ -154,19 +157,21 @@ void BroadPhase2DHashGrid::_enter_grid(Element *p_elem, const Rect2 &p_rect, boo
 			}
 
 			if (entered) {
-				for (Map<Element *, RC>::Element *E = pb->object_set.front(); E; E = E->next()) {
-					if (E->key()->owner == p_elem->owner) {
+				for (uint32_t k = 0; k < pb->object_set.size(); k++) {
+					Element *other = pb->object_set.get_key(k);
+					if (other->owner == p_elem->owner) {
 						continue;
 					}
-					_pair_attempt(p_elem, E->key());
+					_pair_attempt(p_elem, other);
 				}
 
 				if (!p_static) {
-					for (Map<Element *, RC>::Element *E = pb->static_object_set.front(); E; E = E->next()) {
-						if (E->key()->owner == p_elem->owner) {
+					for (uint32_t k = 0; k < pb->static_object_set.size(); k++) {
+						Element *other = pb->static_object_set.get_key(k);
+						if (other->owner == p_elem->owner) {
 							continue;
 						}
-						_pair_attempt(p_elem, E->key());
+						_pair_attempt(p_elem, other);
 					}
 				}
 			}
@@ -175,18 +180,19 @@ void BroadPhase2DHashGrid::_enter_grid(Element *p_elem, const Rect2 &p_rect, boo
 
 	//pair separatedly with large elements
 
-	for (Map<Element *, RC>::Element *E = large_elements.front(); E; E = E->next()) {
-		if (E->key() == p_elem) {
+	for (uint32_t k = 0; k < large_elements.size(); k++) {
+		Element *other = large_elements.get_key(k);
+		if (other == p_elem) {
 			continue; // do not pair against itself
 		}
-		if (E->key()->owner == p_elem->owner) {
+		if (other->owner == p_elem->owner) {
 			continue;
 		}
-		if (E->key()->_static && p_static) {
+		if (other->_static && p_static) {
 			continue;
 		}
 
-		_pair_attempt(E->key(), p_elem);
+		_pair_attempt(other, p_elem);
 	}
 }
 
@@ -194,11 +200,9 @@ void BroadPhase2DHashGrid::_exit_grid(Element *p_elem, const Rect2 &p_rect, bool
 	Vector2 sz = (p_rect.size / cell_size * LARGE_ELEMENT_FI);
 	if (sz.width * sz.height > large_object_min_surface) {
 		//unpair all elements, instead of checking all, just check what is already paired, so we at least save from checking static vs static
-		Map<Element *, PairData *>::Element *E = p_elem->paired.front();
-		while (E) {
-			Map<Element *, PairData *>::Element *next = E->next();
-			_unpair_attempt(p_elem, E->key());
-			E = next;
+		// Backwards, unpairing erases the element and moves the last one (already checked) into its place.
+		for (int64_t i = int64_t(p_elem->paired.size()) - 1; i >= 0; i--) {
+			_unpair_attempt(p_elem, p_elem->paired.get_key(i));
 		}
 
 		if (large_elements[p_elem].dec() == 0) {
@@ -244,19 +248,21 @@ void BroadPhase2DHashGrid::_exit_grid(Element *p_elem, const Rect2 &p_rect, bool
 			}
 
 			if (exited) {
-				for (Map<Element *, RC>::Element *E = pb->object_set.front(); E; E = E->next()) {
-					if (E->key()->owner == p_elem->owner) {
+				for (uint32_t k = 0; k < pb->object_set.size(); k++) {
+					Element *other = pb->object_set.get_key(k);
+					if (other->owner == p_elem->owner) {
 						continue;
 					}
-					_unpair_attempt(p_elem, E->key());
+					_unpair_attempt(p_elem, other);
 				}
 
 				if (!p_static) {
-					for (Map<Element *, RC>::Element *E = pb->static_object_set.front(); E; E = E->next()) {
-						if (E->key()->owner == p_elem->owner) {
+					for (uint32_t k = 0; k < pb->static_object_set.size(); k++) {
+						Element *other = pb->static_object_set.get_key(k);
+						if (other->owner == p_elem->owner) {
 							continue;
 						}
-						_unpair_attempt(p_elem, E->key());
+						_unpair_attempt(p_elem, other);
 					}
 				}
 			}
@@ -284,19 +290,20 @@ void BroadPhase2DHashGrid::_exit_grid(Element *p_elem, const Rect2 &p_rect, bool
 		}
 	}
 
-	for (Map<Element *, RC>::Element *E = large_elements.front(); E; E = E->next()) {
-		if (E->key() == p_elem) {
+	for (uint32_t k = 0; k < large_elements.size(); k++) {
+		Element *other = large_elements.get_key(k);
+		if (other == p_elem) {
 			continue; // do not pair against itself
 		}
-		if (E->key()->owner == p_elem->owner) {
+		if (other->owner == p_elem->owner) {
 			continue;
 		}
-		if (E->key()->_static && p_static) {
+		if (other->_static && p_static) {
 			continue;
 		}
 
 		//unpair from large elements
-		_unpair_attempt(p_elem, E->key());
+		_unpair_attempt(p_elem, other);
 	}
 }
 
@@ -407,48 +414,50 @@ void BroadPhase2DHashGrid::_cull(const Point2i p_cell, const Rect2 &p_aabb, cons
 		return;
 	}
 
-	for (Map<Element *, RC>::Element *E = pb->object_set.front(); E; E = E->next()) {
+	for (uint32_t k = 0; k < pb->object_set.size(); k++) {
+		Element *other = pb->object_set.get_key(k);
 		if (index >= p_max_results) {
 			break;
 		}
-		if (E->key()->pass == pass) {
+		if (other->pass == pass) {
 			continue;
 		}
 
-		E->key()->pass = pass;
+		other->pass = pass;
 
-		if (use_aabb && !p_aabb.intersects(E->key()->aabb)) {
+		if (use_aabb && !p_aabb.intersects(other->aabb)) {
 			continue;
 		}
 
-		if (use_segment && !E->key()->aabb.intersects_segment(p_from, p_to)) {
+		if (use_segment && !other->aabb.intersects_segment(p_from, p_to)) {
 			continue;
 		}
 
-		p_results[index] = E->key()->owner;
-		p_result_indices[index] = E->key()->subindex;
+		p_results[index] = other->owner;
+		p_result_indices[index] = other->subindex;
 		index++;
 	}
 
-	for (Map<Element *, RC>::Element *E = pb->static_object_set.front(); E; E = E->next()) {
+	for (uint32_t k = 0; k < pb->static_object_set.size(); k++) {
+		Element *other = pb->static_object_set.get_key(k);
 		if (index >= p_max_results) {
 			break;
 		}
-		if (E->key()->pass == pass) {
+		if (other->pass == pass) {
 			continue;
 		}
 
-		if (use_aabb && !p_aabb.intersects(E->key()->aabb)) {
+		if (use_aabb && !p_aabb.intersects(other->aabb)) {
 			continue;
 		}
 
-		if (use_segment && !E->key()->aabb.intersects_segment(p_from, p_to)) {
+		if (use_segment && !other->aabb.intersects_segment(p_from, p_to)) {
 			continue;
 		}
 
-		E->key()->pass = pass;
-		p_results[index] = E->key()->owner;
-		p_result_indices[index] = E->key()->subindex;
+		other->pass = pass;
+		p_results[index] = other->owner;
+		p_result_indices[index] = other->subindex;
 		index++;
 	}
 }
@@ -530,27 +539,28 @@ int BroadPhase2DHashGrid::cull_segment(const Vector2 &p_from, const Vector2 &p_t
 		}
 	}
 
-	for (Map<Element *, RC>::Element *E = large_elements.front(); E; E = E->next()) {
+	for (uint32_t k = 0; k < large_elements.size(); k++) {
+		Element *other = large_elements.get_key(k);
 		if (cullcount >= p_max_results) {
 			break;
 		}
-		if (E->key()->pass == pass) {
+		if (other->pass == pass) {
 			continue;
 		}
 
-		E->key()->pass = pass;
+		other->pass = pass;
 
 		/*
-		if (use_aabb && !p_aabb.intersects(E->key()->aabb))
+		if (use_aabb && !p_aabb.intersects(other->aabb))
 			continue;
 		*/
 
-		if (!E->key()->aabb.intersects_segment(p_from, p_to)) {
+		if (!other->aabb.intersects_segment(p_from, p_to)) {
 			continue;
 		}
 
-		p_results[cullcount] = E->key()->owner;
-		p_result_indices[cullcount] = E->key()->subindex;
+		p_results[cullcount] = other->owner;
+		p_result_indices[cullcount] = other->subindex;
 		cullcount++;
 	}
 
@@ -570,27 +580,28 @@ int BroadPhase2DHashGrid::cull_aabb(const Rect2 &p_aabb, CollisionObject2DSW **p
 		}
 	}
 
-	for (Map<Element *, RC>::Element *E = large_elements.front(); E; E = E->next()) {
+	for (uint32_t k = 0; k < large_elements.size(); k++) {
+		Element *other = large_elements.get_key(k);
 		if (cullcount >= p_max_results) {
 			break;
 		}
-		if (E->key()->pass == pass) {
+		if (other->pass == pass) {
 			continue;
 		}
 
-		E->key()->pass = pass;
+		other->pass = pass;
 
-		if (!p_aabb.intersects(E->key()->aabb)) {
+		if (!p_aabb.intersects(other->aabb)) {
 			continue;
 		}
 
 		/*
-		if (!E->key()->aabb.intersects_segment(p_from,p_to))
+		if (!other->aabb.intersects_segment(p_from,p_to))
 			continue;
 		*/
 
-		p_results[cullcount] = E->key()->owner;
-		p_result_indices[cullcount] = E->key()->subindex;
+		p_results[cullcount] = other->owner;
+		p_result_indices[cullcount] = other->subindex;
 		cullcount++;
 	}
 	return cullcount;
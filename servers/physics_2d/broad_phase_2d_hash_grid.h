@@ -32,6 +32,7 @@
 #define BROAD_PHASE_2D_HASH_GRID_H
 
 #include "broad_phase_2d_sw.h"
+#include "core/templates/flat_hash_map.h"
 #include "core/templates/map.h"
 
 class BroadPhase2DHashGrid : public BroadPhase2DSW {
@@ -53,7 +54,7 @@ class BroadPhase2DHashGrid : public BroadPhase2DSW {
 		Rect2 aabb;
 		int subindex;
 		uint64_t pass;
-		Map<Element *, PairData *> paired;
+		FlatHashMap<Element *, PairData *> paired;
 	};
 
 	struct RC {
@@ -74,7 +75,7 @@ class BroadPhase2DHashGrid : public BroadPhase2DSW {
 	};
 
 	Map<ID, Element> element_map;
-	Map<Element *, RC> large_elements;
+	FlatHashMap<Element *, RC> large_elements;
 
 	ID current;
 
@@ -148,8 +149,8 @@ class BroadPhase2DHashGrid : public BroadPhase2DSW {
 
 	struct PosBin {
 		PosKey key;
-		Map<Element *, RC> object_set;
-		Map<Element *, RC> static_object_set;
+		FlatHashMap<Element *, RC> object_set;
+		FlatHashMap<Element *, RC> static_object_set;
 		PosBin *next;
 	};
 
@@ -30,6 +30,7 @@
 
 #include "physics_server_2d_wrap_mt.h"
 
+#include "core/os/frame_arena.h"
 #include "core/os/os.h"
 
 void PhysicsServer2DWrapMT::thread_exit() {
@@ -38,6 +39,7 @@ void PhysicsServer2DWrapMT::thread_exit() {
 
 void PhysicsServer2DWrapMT::thread_step(real_t p_delta) {
 	physics_2d_server->step(p_delta);
+	FrameArena::reset();
 	step_sem.post();
 }
 
@@ -55,8 +57,8 @@ void PhysicsServer2DWrapMT::thread_loop() {
 	exit = false;
 	step_thread_up = true;
 	while (!exit) {
-		// flush commands one by one, until exit is requested
-		command_queue.wait_and_flush_one();
+		// flush commands as they come in, until exit is requested
+		command_queue.wait_and_flush();
 	}
 
 	command_queue.flush_all(); // flush all
@@ -190,8 +190,9 @@ void Step2DSW::step(Space2DSW *p_space, real_t p_delta, int p_iterations) {
 	const SelfList<Area2DSW>::List &aml = p_space->get_moved_area_list();
 
 	while (aml.first()) {
-		for (const Set<Constraint2DSW *>::Element *E = aml.first()->self()->get_constraints().front(); E; E = E->next()) {
-			Constraint2DSW *c = E->get();
+		const VSet<Constraint2DSW *> &constraints = aml.first()->self()->get_constraints();
+		for (int i = 0; i < constraints.size(); i++) {
+			Constraint2DSW *c = constraints[i];
 			if (c->get_island_step() == _step) {
 				continue;
 			}
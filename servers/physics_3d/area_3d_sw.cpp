@@ -213,21 +213,21 @@ void Area3DSW::call_queries() {
 			return;
 		}
 
-		for (Map<BodyKey, BodyState>::Element *E = monitored_bodies.front(); E;) {
-			if (E->get().state == 0) { // Nothing happened
-				E = E->next();
+		for (uint32_t i = 0; i < monitored_bodies.size();) {
+			int state = monitored_bodies.get_value(i).state;
+			if (state == 0) { // Nothing happened
+				i++;
 				continue;
 			}
 
-			res[0] = E->get().state > 0 ? PhysicsServer3D::AREA_BODY_ADDED : PhysicsServer3D::AREA_BODY_REMOVED;
-			res[1] = E->key().rid;
-			res[2] = E->key().instance_id;
-			res[3] = E->key().body_shape;
-			res[4] = E->key().area_shape;
+			const BodyKey &key = monitored_bodies.get_key(i);
+			res[0] = state > 0 ? PhysicsServer3D::AREA_BODY_ADDED : PhysicsServer3D::AREA_BODY_REMOVED;
+			res[1] = key.rid;
+			res[2] = key.instance_id;
+			res[3] = key.body_shape;
+			res[4] = key.area_shape;
 
-			Map<BodyKey, BodyState>::Element *next = E->next();
-			monitored_bodies.erase(E);
-			E = next;
+			monitored_bodies.erase_index(i); // Moves the last one to i, which is checked next.
 
 			Callable::CallError ce;
 			obj->call(monitor_callback_method, (const Variant **)resptr, 5, ce);
@@ -248,21 +248,21 @@ void Area3DSW::call_queries() {
 			return;
 		}
 
-		for (Map<BodyKey, BodyState>::Element *E = monitored_areas.front(); E;) {
-			if (E->get().state == 0) { // Nothing happened
-				E = E->next();
+		for (uint32_t i = 0; i < monitored_areas.size();) {
+			int state = monitored_areas.get_value(i).state;
+			if (state == 0) { // Nothing happened
+				i++;
 				continue;
 			}
 
-			res[0] = E->get().state > 0 ? PhysicsServer3D::AREA_BODY_ADDED : PhysicsServer3D::AREA_BODY_REMOVED;
-			res[1] = E->key().rid;
-			res[2] = E->key().instance_id;
-			res[3] = E->key().body_shape;
-			res[4] = E->key().area_shape;
+			const BodyKey &key = monitored_areas.get_key(i);
+			res[0] = state > 0 ? PhysicsServer3D::AREA_BODY_ADDED : PhysicsServer3D::AREA_BODY_REMOVED;
+			res[1] = key.rid;
+			res[2] = key.instance_id;
+			res[3] = key.body_shape;
+			res[4] = key.area_shape;
 
-			Map<BodyKey, BodyState>::Element *next = E->next();
-			monitored_areas.erase(E);
-			E = next;
+			monitored_areas.erase_index(i); // Moves the last one to i, which is checked next.
 
 			Callable::CallError ce;
 			obj->call(area_monitor_callback_method, (const Variant **)resptr, 5, ce);
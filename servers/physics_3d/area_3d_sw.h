@@ -32,7 +32,9 @@
 #define AREA_SW_H
 
 #include "collision_object_3d_sw.h"
+#include "core/templates/flat_hash_map.h"
 #include "core/templates/self_list.h"
+#include "core/templates/vset.h"
 #include "servers/physics_server_3d.h"
 //#include "servers/physics_3d/query_sw.h"
 
@@ -79,11 +81,23 @@ class Area3DSW : public CollisionObject3DSW {
 			}
 		}
 
+		_FORCE_INLINE_ bool operator==(const BodyKey &p_key) const {
+			return rid == p_key.rid && body_shape == p_key.body_shape && area_shape == p_key.area_shape;
+		}
+
 		_FORCE_INLINE_ BodyKey() {}
 		BodyKey(Body3DSW *p_body, uint32_t p_body_shape, uint32_t p_area_shape);
 		BodyKey(Area3DSW *p_body, uint32_t p_body_shape, uint32_t p_area_shape);
 	};
 
+	struct BodyKeyHasher {
+		static _FORCE_INLINE_ uint32_t hash(const BodyKey &p_key) {
+			uint32_t h = hash_one_uint64(p_key.rid.get_id());
+			h = hash_djb2_one_32(p_key.body_shape, h);
+			return hash_djb2_one_32(p_key.area_shape, h);
+		}
+	};
+
 	struct BodyState {
 		int state;
 		_FORCE_INLINE_ void inc() { state++; }
@@ -91,13 +105,13 @@ class Area3DSW : public CollisionObject3DSW {
 		_FORCE_INLINE_ BodyState() { state = 0; }
 	};
 
-	Map<BodyKey, BodyState> monitored_bodies;
-	Map<BodyKey, BodyState> monitored_areas;
+	FlatHashMap<BodyKey, BodyState, BodyKeyHasher> monitored_bodies;
+	FlatHashMap<BodyKey, BodyState, BodyKeyHasher> monitored_areas;
 
 	//virtual void shape_changed_notify(ShapeSW *p_shape);
 	//virtual void shape_deleted_notify(ShapeSW *p_shape);
 
-	Set<Constraint3DSW *> constraints;
+	VSet<Constraint3DSW *> constraints;
 
 	virtual void _shapes_changed();
 	void _queue_monitor_update();
@@ -150,7 +164,7 @@ public:
 
 	_FORCE_INLINE_ void add_constraint(Constraint3DSW *p_constraint) { constraints.insert(p_constraint); }
 	_FORCE_INLINE_ void remove_constraint(Constraint3DSW *p_constraint) { constraints.erase(p_constraint); }
-	_FORCE_INLINE_ const Set<Constraint3DSW *> &get_constraints() const { return constraints; }
+	_FORCE_INLINE_ const VSet<Constraint3DSW *> &get_constraints() const { return constraints; }
 	_FORCE_INLINE_ void clear_constraints() { constraints.clear(); }
 
 	void set_monitorable(bool p_monitorable);
@@ -659,13 +659,13 @@ void BodySW::simulate_motion(const Transform& p_xform,real_t p_step) {
 */
 
 void Body3DSW::wakeup_neighbours() {
-	for (Map<Constraint3DSW *, int>::Element *E = constraint_map.front(); E; E = E->next()) {
-		const Constraint3DSW *c = E->key();
+	for (uint32_t j = 0; j < constraint_map.size(); j++) {
+		const Constraint3DSW *c = constraint_map.get_key(j);
 		Body3DSW **n = c->get_body_ptr();
 		int bc = c->get_body_count();
 
 		for (int i = 0; i < bc; i++) {
-			if (i == E->get()) {
+			if (i == constraint_map.get_value(j)) {
 				continue;
 			}
 			Body3DSW *b = n[i];
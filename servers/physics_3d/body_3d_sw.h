@@ -33,6 +33,7 @@
 
 #include "area_3d_sw.h"
 #include "collision_object_3d_sw.h"
+#include "core/templates/flat_hash_map.h"
 #include "core/templates/vset.h"
 
 class Constraint3DSW;
@@ -95,7 +96,7 @@ class Body3DSW : public CollisionObject3DSW {
 	virtual void _shapes_changed();
 	Transform new_transform;
 
-	Map<Constraint3DSW *, int> constraint_map;
+	FlatHashMap<Constraint3DSW *, int> constraint_map;
 
 	struct AreaCMP {
 		Area3DSW *area;
@@ -197,7 +198,7 @@ public:
 
 	_FORCE_INLINE_ void add_constraint(Constraint3DSW *p_constraint, int p_pos) { constraint_map[p_constraint] = p_pos; }
 	_FORCE_INLINE_ void remove_constraint(Constraint3DSW *p_constraint) { constraint_map.erase(p_constraint); }
-	const Map<Constraint3DSW *, int> &get_constraint_map() const { return constraint_map; }
+	const FlatHashMap<Constraint3DSW *, int> &get_constraint_map() const { return constraint_map; }
 	_FORCE_INLINE_ void clear_constraint_map() { constraint_map.clear(); }
 
 	_FORCE_INLINE_ void set_omit_force_integration(bool p_omit_force_integration) { omit_force_integration = p_omit_force_integration; }
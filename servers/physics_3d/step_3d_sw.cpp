@@ -38,8 +38,9 @@ void Step3DSW::_populate_island(Body3DSW *p_body, Body3DSW **p_island, Constrain
 	p_body->set_island_next(*p_island);
 	*p_island = p_body;
 
-	for (Map<Constraint3DSW *, int>::Element *E = p_body->get_constraint_map().front(); E; E = E->next()) {
-		Constraint3DSW *c = (Constraint3DSW *)E->key();
+	const FlatHashMap<Constraint3DSW *, int> &constraint_map = p_body->get_constraint_map();
+	for (uint32_t j = 0; j < constraint_map.size(); j++) {
+		Constraint3DSW *c = constraint_map.get_key(j);
 		if (c->get_island_step() == _step) {
 			continue; //already processed
 		}
@@ -48,7 +49,7 @@ void Step3DSW::_populate_island(Body3DSW *p_body, Body3DSW **p_island, Constrain
 		*p_constraint_island = c;
 
 		for (int i = 0; i < c->get_body_count(); i++) {
-			if (i == E->get()) {
+			if (i == constraint_map.get_value(j)) {
 				continue;
 			}
 			Body3DSW *b = c->get_body_ptr()[i];
@@ -201,8 +202,9 @@ void Step3DSW::step(Space3DSW *p_space, real_t p_delta, int p_iterations) {
 	const SelfList<Area3DSW>::List &aml = p_space->get_moved_area_list();
 
 	while (aml.first()) {
-		for (const Set<Constraint3DSW *>::Element *E = aml.first()->self()->get_constraints().front(); E; E = E->next()) {
-			Constraint3DSW *c = E->get();
+		const VSet<Constraint3DSW *> &constraints = aml.first()->self()->get_constraints();
+		for (int i = 0; i < constraints.size(); i++) {
+			Constraint3DSW *c = constraints[i];
 			if (c->get_island_step() == _step) {
 				continue;
 			}
@@ -31,7 +31,9 @@
 #include "physics_server_2d.h"
 
 #include "core/config/project_settings.h"
+#include "core/os/frame_arena.h"
 #include "core/string/print_string.h"
+#include "core/templates/local_vector.h"
 
 PhysicsServer2D *PhysicsServer2D::singleton = nullptr;
 
@@ -290,9 +292,12 @@ Dictionary PhysicsDirectSpaceState2D::_intersect_ray(const Vector2 &p_from, cons
 Array PhysicsDirectSpaceState2D::_intersect_shape(const Ref<PhysicsShapeQueryParameters2D> &p_shape_query, int p_max_results) {
 	ERR_FAIL_COND_V(!p_shape_query.is_valid(), Array());
 
-	Vector<ShapeResult> sr;
+	ERR_FAIL_COND_V(p_max_results < 0, Array());
+
+	FrameArenaScope frame_arena_scope;
+	LocalVector<ShapeResult, uint32_t, false, FrameArena> sr;
 	sr.resize(p_max_results);
-	int rc = intersect_shape(p_shape_query->shape, p_shape_query->transform, p_shape_query->motion, p_shape_query->margin, sr.ptrw(), sr.size(), p_shape_query->exclude, p_shape_query->collision_mask, p_shape_query->collide_with_bodies, p_shape_query->collide_with_areas);
+	int rc = intersect_shape(p_shape_query->shape, p_shape_query->transform, p_shape_query->motion, p_shape_query->margin, sr.ptr(), sr.size(), p_shape_query->exclude, p_shape_query->collision_mask, p_shape_query->collide_with_bodies, p_shape_query->collide_with_areas);
 	Array ret;
 	ret.resize(rc);
 	for (int i = 0; i < rc; i++) {
@@ -329,14 +334,17 @@ Array PhysicsDirectSpaceState2D::_intersect_point_impl(const Vector2 &p_point, i
 		exclude.insert(p_exclude[i]);
 	}
 
-	Vector<ShapeResult> ret;
+	ERR_FAIL_COND_V(p_max_results < 0, Array());
+
+	FrameArenaScope frame_arena_scope;
+	LocalVector<ShapeResult, uint32_t, false, FrameArena> ret;
 	ret.resize(p_max_results);
 
 	int rc;
 	if (p_filter_by_canvas) {
-		rc = intersect_point(p_point, ret.ptrw(), ret.size(), exclude, p_layers, p_collide_with_bodies, p_collide_with_areas);
+		rc = intersect_point(p_point, ret.ptr(), ret.size(), exclude, p_layers, p_collide_with_bodies, p_collide_with_areas);
 	} else {
-		rc = intersect_point_on_canvas(p_point, p_canvas_instance_id, ret.ptrw(), ret.size(), exclude, p_layers, p_collide_with_bodies, p_collide_with_areas);
+		rc = intersect_point_on_canvas(p_point, p_canvas_instance_id, ret.ptr(), ret.size(), exclude, p_layers, p_collide_with_bodies, p_collide_with_areas);
 	}
 
 	if (rc == 0) {
@@ -368,10 +376,13 @@ Array PhysicsDirectSpaceState2D::_intersect_point_on_canvas(const Vector2 &p_poi
 Array PhysicsDirectSpaceState2D::_collide_shape(const Ref<PhysicsShapeQueryParameters2D> &p_shape_query, int p_max_results) {
 	ERR_FAIL_COND_V(!p_shape_query.is_valid(), Array());
 
-	Vector<Vector2> ret;
+	ERR_FAIL_COND_V(p_max_results < 0, Array());
+
+	FrameArenaScope frame_arena_scope;
+	LocalVector<Vector2, uint32_t, false, FrameArena> ret;
 	ret.resize(p_max_results * 2);
 	int rc = 0;
-	bool res = collide_shape(p_shape_query->shape, p_shape_query->transform, p_shape_query->motion, p_shape_query->margin, ret.ptrw(), p_max_results, rc, p_shape_query->exclude, p_shape_query->collision_mask, p_shape_query->collide_with_bodies, p_shape_query->collide_with_areas);
+	bool res = collide_shape(p_shape_query->shape, p_shape_query->transform, p_shape_query->motion, p_shape_query->margin, ret.ptr(), p_max_results, rc, p_shape_query->exclude, p_shape_query->collision_mask, p_shape_query->collide_with_bodies, p_shape_query->collide_with_areas);
 	if (!res) {
 		return Array();
 	}
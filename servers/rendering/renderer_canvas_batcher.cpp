@@ -0,0 +1,228 @@
+/*************************************************************************/
+/*  renderer_canvas_batcher.cpp                                          */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "renderer_canvas_batcher.h"
+
+uint32_t RendererCanvasBatcher::get_item_lights(const Item *p_item, const Light *p_lights, uint32_t p_max_lights, uint32_t *r_lights) {
+	for (int i = 0; i < 4; i++) {
+		r_lights[i] = 0;
+	}
+
+	uint32_t light_count = 0;
+	const Light *light = p_lights;
+
+	while (light) {
+		if (light->render_index_cache >= 0 && p_item->light_mask & light->item_mask && p_item->z_final >= light->z_min && p_item->z_final <= light->z_max && p_item->global_rect_cache.intersects_transformed(light->xform_cache, light->rect_cache)) {
+			uint32_t light_index = light->render_index_cache;
+			r_lights[light_count >> 2] |= light_index << ((light_count & 3) * 8);
+
+			light_count++;
+
+			if (light_count == p_max_lights) {
+				break;
+			}
+		}
+		light = light->next_ptr;
+	}
+
+	return light_count;
+}
+
+void RendererCanvasBatcher::get_rect_draw_rects(const Item::CommandRect *p_rect, Rect2 &r_src_rect, Rect2 &r_dst_rect) {
+	r_dst_rect = Rect2(p_rect->rect.position, p_rect->rect.size);
+
+	if (r_dst_rect.size.width < 0) {
+		r_dst_rect.position.x += r_dst_rect.size.width;
+		r_dst_rect.size.width *= -1;
+	}
+	if (r_dst_rect.size.height < 0) {
+		r_dst_rect.position.y += r_dst_rect.size.height;
+		r_dst_rect.size.height *= -1;
+	}
+
+	if (p_rect->texture == RID()) {
+		r_src_rect = Rect2(0, 0, 1, 1);
+		return;
+	}
+
+	r_src_rect = (p_rect->flags & RendererCanvasRender::CANVAS_RECT_REGION) ? p_rect->source : Rect2(0, 0, 1, 1);
+
+	if (p_rect->flags & RendererCanvasRender::CANVAS_RECT_FLIP_H) {
+		r_src_rect.size.x *= -1;
+	}
+
+	if (p_rect->flags & RendererCanvasRender::CANVAS_RECT_FLIP_V) {
+		r_src_rect.size.y *= -1;
+	}
+
+	if (p_rect->flags & RendererCanvasRender::CANVAS_RECT_TRANSPOSE) {
+		r_dst_rect.size.x *= -1; // Encoding in the dst_rect.z uniform
+	}
+}
+
+void RendererCanvasBatcher::_flush_run() {
+	if (!in_run) {
+		return;
+	}
+	in_run = false;
+
+	if (run.instance_count < MIN_BATCH_INSTANCES) {
+		// Not worth it, let the renderer draw it on its own.
+		instances.resize(run.instance_offset);
+		return;
+	}
+
+	batches.push_back(run);
+}
+
+void RendererCanvasBatcher::build(Item *const *p_items, int p_item_count, const Transform2D &p_canvas_transform_inverse, const Light *p_lights, uint32_t p_max_instances) {
+	clear();
+	item_lights.resize(p_item_count);
+
+	for (int i = 0; i < p_item_count; i++) {
+		const Item *ci = p_items[i];
+
+		ItemLights &lights = item_lights[i];
+		lights.count = get_item_lights(ci, p_lights, MAX_LIGHTS_PER_ITEM, lights.lights);
+
+		if (!ci->commands) {
+			continue; // Draws nothing, so it can't break a run.
+		}
+
+		ItemState state;
+		state.material = ci->material;
+		state.canvas_group = ci->canvas_group != nullptr;
+		state.clip = ci->final_clip_owner;
+		state.filter = ci->texture_filter;
+		state.repeat = ci->texture_repeat;
+		state.light_count = lights.count;
+		for (int j = 0; j < 4; j++) {
+			state.lights[j] = lights.lights[j];
+		}
+
+		if (in_run && state != run_state) {
+			_flush_run();
+		}
+
+		Transform2D base_transform = p_canvas_transform_inverse * ci->final_transform;
+		Transform2D world = base_transform;
+		Color base_color = ci->final_modulate;
+
+		const Item::Command *c = ci->commands;
+		while (c) {
+			switch (c->type) {
+				case Item::Command::TYPE_RECT: {
+					const Item::CommandRect *rect = static_cast<const Item::CommandRect *>(c);
+
+					if (in_run && rect->texture != run_texture) {
+						_flush_run();
+					}
+
+					if ((rect->flags & RendererCanvasRender::CANVAS_RECT_CLIP_UV) || instances.size() >= p_max_instances) {
+						// Clipped UVs read the source rect per pixel, keep those on the regular path.
+						_flush_run();
+						break;
+					}
+
+					if (!in_run) {
+						in_run = true;
+						run.command = c;
+						run.instance_offset = instances.size();
+						run.instance_count = 0;
+						run_state = state;
+						run_texture = rect->texture;
+					}
+
+					Rect2 src_rect;
+					Rect2 dst_rect;
+					get_rect_draw_rects(rect, src_rect, dst_rect);
+
+					instances.resize(instances.size() + 1);
+					InstanceData &instance = instances[instances.size() - 1];
+
+					instance.world[0] = world.elements[0][0];
+					instance.world[1] = world.elements[0][1];
+					instance.world[2] = world.elements[1][0];
+					instance.world[3] = world.elements[1][1];
+					instance.world[4] = world.elements[2][0];
+					instance.world[5] = world.elements[2][1];
+
+					instance.flags = (rect->texture != RID() && (rect->flags & RendererCanvasRender::CANVAS_RECT_REGION)) ? INSTANCE_FLAGS_REGION_IN_PIXELS : 0;
+					instance.pad = 0;
+
+					instance.modulation[0] = rect->modulate.r * base_color.r;
+					instance.modulation[1] = rect->modulate.g * base_color.g;
+					instance.modulation[2] = rect->modulate.b * base_color.b;
+					instance.modulation[3] = rect->modulate.a * base_color.a;
+
+					instance.src_rect[0] = src_rect.position.x;
+					instance.src_rect[1] = src_rect.position.y;
+					instance.src_rect[2] = src_rect.size.width;
+					instance.src_rect[3] = src_rect.size.height;
+
+					instance.dst_rect[0] = dst_rect.position.x;
+					instance.dst_rect[1] = dst_rect.position.y;
+					instance.dst_rect[2] = dst_rect.size.width;
+					instance.dst_rect[3] = dst_rect.size.height;
+
+					run.instance_count++;
+				} break;
+				case Item::Command::TYPE_TRANSFORM: {
+					// Does not draw, the transform is baked into the following instances.
+					const Item::CommandTransform *transform = static_cast<const Item::CommandTransform *>(c);
+					world = base_transform * transform->xform;
+				} break;
+				default: {
+					_flush_run();
+				} break;
+			}
+
+			c = c->next;
+		}
+	}
+
+	_flush_run();
+}
+
+void RendererCanvasBatcher::clear() {
+	batches.clear();
+	instances.clear();
+	item_lights.clear();
+	in_run = false;
+}
+
+uint32_t RendererCanvasBatcher::get_built_item_lights(uint32_t p_item_index, uint32_t *r_lights) const {
+	ERR_FAIL_UNSIGNED_INDEX_V(p_item_index, item_lights.size(), 0);
+	const ItemLights &lights = item_lights[p_item_index];
+	for (int i = 0; i < 4; i++) {
+		r_lights[i] = lights.lights[i];
+	}
+	return lights.count;
+}
@@ -0,0 +1,122 @@
+/*************************************************************************/
+/*  renderer_canvas_batcher.h                                            */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef RENDERER_CANVAS_BATCHER_H
+#define RENDERER_CANVAS_BATCHER_H
+
+#include "core/templates/local_vector.h"
+#include "servers/rendering/renderer_canvas_render.h"
+
+// Groups runs of consecutive rect commands that can be drawn with the same
+// state (clip, material, texture, filter, repeat and affecting lights) into
+// instanced batches. Runs never reorder commands, so z-order is preserved.
+// This is done entirely on the CPU; the renderer uploads the instance data
+// and draws each batch with a single instanced call.
+class RendererCanvasBatcher {
+public:
+	typedef RendererCanvasRender::Item Item;
+	typedef RendererCanvasRender::Light Light;
+
+	enum {
+		MIN_BATCH_INSTANCES = 2,
+		MAX_LIGHTS_PER_ITEM = 16,
+	};
+
+	enum {
+		INSTANCE_FLAGS_REGION_IN_PIXELS = (1 << 0), // src_rect must be multiplied by the texture pixel size.
+	};
+
+	// Must match BatchInstance in canvas_uniforms_inc.glsl (std430).
+	struct InstanceData {
+		float world[6];
+		uint32_t flags;
+		uint32_t pad;
+		float modulation[4];
+		float dst_rect[4];
+		float src_rect[4];
+	};
+
+	struct Batch {
+		const Item::Command *command; // First rect of the run.
+		uint32_t instance_offset;
+		uint32_t instance_count;
+	};
+
+private:
+	struct ItemState {
+		RID material;
+		bool canvas_group;
+		const Item *clip;
+		RS::CanvasItemTextureFilter filter;
+		RS::CanvasItemTextureRepeat repeat;
+		uint32_t light_count;
+		uint32_t lights[4];
+
+		bool operator==(const ItemState &p_state) const {
+			return material == p_state.material && canvas_group == p_state.canvas_group && clip == p_state.clip && filter == p_state.filter && repeat == p_state.repeat && light_count == p_state.light_count && lights[0] == p_state.lights[0] && lights[1] == p_state.lights[1] && lights[2] == p_state.lights[2] && lights[3] == p_state.lights[3];
+		}
+		bool operator!=(const ItemState &p_state) const { return !(*this == p_state); }
+	};
+
+	struct ItemLights {
+		uint32_t count;
+		uint32_t lights[4];
+	};
+
+	LocalVector<Batch> batches;
+	LocalVector<InstanceData> instances;
+	LocalVector<ItemLights> item_lights;
+
+	bool in_run = false;
+	Batch run;
+	ItemState run_state;
+	RID run_texture;
+
+	void _flush_run();
+
+public:
+	// Returns how many lights affect the item, packing their render indices as bytes into r_lights.
+	static uint32_t get_item_lights(const Item *p_item, const Light *p_lights, uint32_t p_max_lights, uint32_t *r_lights);
+	// Computes the rects sent to the shader. When the rect uses a region, r_src_rect is in pixels.
+	static void get_rect_draw_rects(const Item::CommandRect *p_rect, Rect2 &r_src_rect, Rect2 &r_dst_rect);
+
+	void build(Item *const *p_items, int p_item_count, const Transform2D &p_canvas_transform_inverse, const Light *p_lights, uint32_t p_max_instances);
+	void clear();
+
+	// The lights found by the last build() for the item at p_item_index, so the renderer does not look them up again.
+	uint32_t get_built_item_lights(uint32_t p_item_index, uint32_t *r_lights) const;
+
+	const LocalVector<Batch> &get_batches() const { return batches; }
+	const LocalVector<InstanceData> &get_instances() const { return instances; }
+	uint32_t get_batch_count() const { return batches.size(); }
+	uint32_t get_batched_instance_count() const { return instances.size(); }
+};
+
+#endif // RENDERER_CANVAS_BATCHER_H
@@ -37,9 +37,36 @@
 
 static const int z_range = RS::CANVAS_ITEM_Z_MAX - RS::CANVAS_ITEM_Z_MIN + 1;
 
+// Bounds of items that must be processed even when off-screen (back buffer copies, canvas groups...).
+static const Rect2 unbounded_rect = Rect2(-1e20, -1e20, 2e20, 2e20);
+
+static _FORCE_INLINE_ AABB _rect_to_aabb(const Rect2 &p_rect) {
+	return AABB(Vector3(p_rect.position.x, p_rect.position.y, 0), Vector3(p_rect.size.x, p_rect.size.y, 0));
+}
+
+// Bounds of an item in its parent's space, as stored in the parent's BVH.
+static _FORCE_INLINE_ AABB _item_get_parent_aabb(const RendererCanvasCull::Item *p_item) {
+	if (p_item->visible && !p_item->subtree_empty && !p_item->subtree_dirty) {
+		return _rect_to_aabb(p_item->xform.xform(p_item->subtree_rect));
+	}
+	return AABB(Vector3(p_item->xform.elements[2].x, p_item->xform.elements[2].y, 0), Vector3());
+}
+
 void RendererCanvasCull::_render_canvas_item_tree(RID p_to_render_target, Canvas::ChildItem *p_child_items, int p_child_item_count, Item *p_canvas_item, const Transform2D &p_transform, const Rect2 &p_clip_rect, const Color &p_modulate, RendererCanvasRender::Light *p_lights, RendererCanvasRender::Light *p_directional_lights, RenderingServer::CanvasItemTextureFilter p_default_filter, RenderingServer::CanvasItemTextureRepeat p_default_repeat, bool p_snap_2d_vertices_to_pixel) {
 	RENDER_TIMESTAMP("Cull CanvasItem Tree");
 
+	RendererCanvasRender::Item *list = _cull_canvas_item_tree(p_child_items, p_child_item_count, p_canvas_item, p_transform, p_clip_rect);
+
+	RENDER_TIMESTAMP("Render Canvas Items");
+
+	bool sdf_flag;
+	RSG::canvas_render->canvas_render_items(p_to_render_target, list, p_modulate, p_lights, p_directional_lights, p_transform, p_default_filter, p_default_repeat, p_snap_2d_vertices_to_pixel, sdf_flag);
+	if (sdf_flag) {
+		sdf_used = true;
+	}
+}
+
+RendererCanvasRender::Item *RendererCanvasCull::_cull_canvas_item_tree(Canvas::ChildItem *p_child_items, int p_child_item_count, Item *p_canvas_item, const Transform2D &p_transform, const Rect2 &p_clip_rect) {
 	memset(z_list, 0, z_range * sizeof(RendererCanvasRender::Item *));
 	memset(z_last_list, 0, z_range * sizeof(RendererCanvasRender::Item *));
 
@@ -66,13 +93,7 @@ void RendererCanvasCull::_render_canvas_item_tree(RID p_to_render_target, Canvas
 		}
 	}
 
-	RENDER_TIMESTAMP("Render Canvas Items");
-
-	bool sdf_flag;
-	RSG::canvas_render->canvas_render_items(p_to_render_target, list, p_modulate, p_lights, p_directional_lights, p_transform, p_default_filter, p_default_repeat, p_snap_2d_vertices_to_pixel, sdf_flag);
-	if (sdf_flag) {
-		sdf_used = true;
-	}
+	return list;
 }
 
 void _collect_ysort_children(RendererCanvasCull::Item *p_canvas_item, Transform2D p_transform, RendererCanvasCull::Item *p_material_owner, RendererCanvasCull::Item **r_items, int &r_index) {
@@ -104,6 +125,142 @@ void _mark_ysort_dirty(RendererCanvasCull::Item *ysort_owner, RID_PtrOwner<Rende
 	} while (ysort_owner && ysort_owner->sort_y);
 }
 
+RendererCanvasCull::Item *RendererCanvasCull::_get_parent_item(const Item *p_item) {
+	return canvas_item_owner.owns(p_item->parent) ? canvas_item_owner.getornull(p_item->parent) : nullptr;
+}
+
+void RendererCanvasCull::_item_bounds_changed(Item *p_item) {
+	// The bounds of p_item in its parent space changed, so all parents must update theirs.
+	Item *parent = _get_parent_item(p_item);
+	while (parent) {
+		if (parent->children_bvh && !p_item->parent_bvh_dirty) {
+			p_item->parent_bvh_dirty = true;
+			parent->children_bvh_dirty.push_back(p_item);
+		}
+
+		if (parent->subtree_dirty) {
+			return; // Parents above are already dirty.
+		}
+		parent->subtree_dirty = true;
+
+		p_item = parent;
+		parent = _get_parent_item(p_item);
+	}
+}
+
+void RendererCanvasCull::_item_mark_subtree_dirty(Item *p_item) {
+	if (p_item->subtree_dirty) {
+		return;
+	}
+	p_item->subtree_dirty = true;
+	_item_bounds_changed(p_item);
+}
+
+void RendererCanvasCull::_item_attach_to_parent(Item *p_parent, Item *p_item) {
+	if (p_parent->children_bvh) {
+		p_item->parent_bvh_id = p_parent->children_bvh->insert(_item_get_parent_aabb(p_item), p_item);
+		p_item->parent_bvh_dirty = false;
+	}
+	_item_bounds_changed(p_item);
+}
+
+void RendererCanvasCull::_item_detach_from_parent(Item *p_parent, Item *p_item) {
+	if (p_parent->children_bvh) {
+		p_parent->children_bvh->remove(p_item->parent_bvh_id);
+		if (p_item->parent_bvh_dirty) {
+			p_parent->children_bvh_dirty.erase(p_item);
+		}
+	}
+	p_item->parent_bvh_id = DynamicBVH::ID();
+	p_item->parent_bvh_dirty = false;
+
+	// Slots of the remaining children changed.
+	p_parent->children_order_dirty = true;
+	_item_mark_subtree_dirty(p_parent);
+}
+
+void RendererCanvasCull::_item_free_children_bvh(Item *p_item) {
+	if (!p_item->children_bvh) {
+		return;
+	}
+
+	for (int i = 0; i < p_item->child_items.size(); i++) {
+		p_item->child_items[i]->parent_bvh_id = DynamicBVH::ID();
+		p_item->child_items[i]->parent_bvh_dirty = false;
+	}
+	p_item->children_bvh_dirty.clear();
+
+	memdelete(p_item->children_bvh);
+	p_item->children_bvh = nullptr;
+}
+
+void RendererCanvasCull::_item_update_subtree(Item *p_item) {
+	p_item->subtree_dirty = false;
+
+	int child_item_count = p_item->child_items.size();
+	Item **child_items = p_item->child_items.ptrw();
+
+	// Y-sorted children are flattened into the parent when culling, so they can't be queried from a BVH.
+	bool use_bvh = !p_item->sort_y && child_item_count >= CHILDREN_BVH_THRESHOLD;
+	if (use_bvh && !p_item->children_bvh) {
+		p_item->children_bvh = memnew(DynamicBVH);
+		for (int i = 0; i < child_item_count; i++) {
+			if (child_items[i]->subtree_dirty) {
+				_item_update_subtree(child_items[i]);
+			}
+			child_items[i]->parent_bvh_id = p_item->children_bvh->insert(_item_get_parent_aabb(child_items[i]), child_items[i]);
+		}
+	} else if (!use_bvh && p_item->children_bvh) {
+		_item_free_children_bvh(p_item);
+	}
+
+	Rect2 subtree_rect;
+	bool subtree_empty = true;
+
+	if (p_item->copy_back_buffer || p_item->vp_render || p_item->canvas_group || p_item->update_when_visible) {
+		subtree_rect = unbounded_rect;
+		subtree_empty = false;
+	} else if (p_item->commands || p_item->custom_rect) {
+		subtree_rect = p_item->get_rect();
+		subtree_empty = false;
+	}
+
+	if (p_item->children_bvh) {
+		for (uint32_t i = 0; i < p_item->children_bvh_dirty.size(); i++) {
+			Item *child = p_item->children_bvh_dirty[i];
+			child->parent_bvh_dirty = false;
+			if (child->subtree_dirty) {
+				_item_update_subtree(child);
+			}
+
+			p_item->children_bvh->update(child->parent_bvh_id, _item_get_parent_aabb(child));
+		}
+		p_item->children_bvh_dirty.clear();
+
+		AABB bounds = p_item->children_bvh->get_bounds();
+		Rect2 children_rect = Rect2(bounds.position.x, bounds.position.y, bounds.size.x, bounds.size.y);
+		subtree_rect = subtree_empty ? children_rect : subtree_rect.merge(children_rect);
+		subtree_empty = false;
+	} else {
+		for (int i = 0; i < child_item_count; i++) {
+			Item *child = child_items[i];
+			if (child->subtree_dirty) {
+				_item_update_subtree(child);
+			}
+			if (!child->visible || child->subtree_empty) {
+				continue;
+			}
+
+			Rect2 child_rect = child->xform.xform(child->subtree_rect);
+			subtree_rect = subtree_empty ? child_rect : subtree_rect.merge(child_rect);
+			subtree_empty = false;
+		}
+	}
+
+	p_item->subtree_rect = subtree_rect;
+	p_item->subtree_empty = subtree_empty;
+}
+
 void RendererCanvasCull::_cull_canvas_item(Item *p_canvas_item, const Transform2D &p_transform, const Rect2 &p_clip_rect, const Color &p_modulate, int p_z, RendererCanvasRender::Item **z_list, RendererCanvasRender::Item **z_last_list, Item *p_canvas_clip, Item *p_material_owner) {
 	Item *ci = p_canvas_item;
 
@@ -111,18 +268,35 @@ void RendererCanvasCull::_cull_canvas_item(Item *p_canvas_item, const Transform2
 		return;
 	}
 
+	cull_stats.items_visited++;
+
 	if (ci->children_order_dirty) {
 		ci->child_items.sort_custom<ItemIndexSort>();
+		for (int i = 0; i < ci->child_items.size(); i++) {
+			ci->child_items[i]->child_slot = i;
+		}
 		ci->children_order_dirty = false;
 	}
 
-	Rect2 rect = ci->get_rect();
 	Transform2D xform = ci->xform;
 	if (snapping_2d_transforms_to_pixel) {
 		xform.elements[2] = xform.elements[2].floor();
 	}
 	xform = p_transform * xform;
 
+	// Skip the whole subtree if nothing in it can be on screen. Snapped children can move by a pixel.
+	if (ci->subtree_dirty) {
+		_item_update_subtree(ci);
+	}
+	if (ci->subtree_empty) {
+		return;
+	}
+	Rect2 screen_rect = Rect2(Point2(), p_clip_rect.size).grow(snapping_2d_transforms_to_pixel ? 2 : 0);
+	if (!screen_rect.intersects(xform.xform(ci->subtree_rect), true)) {
+		return;
+	}
+
+	Rect2 rect = ci->get_rect();
 	Rect2 global_rect = xform.xform(rect);
 	global_rect.position += p_clip_rect.position;
 
@@ -170,6 +344,28 @@ void RendererCanvasCull::_cull_canvas_item(Item *p_canvas_item, const Transform2
 		sorter.sort(child_items, child_item_count);
 	}
 
+	LocalVector<Item *> visible_children;
+	if (ci->children_bvh && xform.basis_determinant() != 0) {
+		struct CullChildren {
+			LocalVector<Item *> *items;
+			_FORCE_INLINE_ bool operator()(void *p_data) {
+				items->push_back((Item *)p_data);
+				return false;
+			}
+		};
+
+		CullChildren cull_children;
+		cull_children.items = &visible_children;
+		ci->children_bvh->aabb_query(_rect_to_aabb(xform.affine_inverse().xform(screen_rect)), cull_children);
+
+		// Draw in child order, not in BVH order.
+		SortArray<Item *, ItemSlotSort> sorter;
+		sorter.sort(visible_children.ptr(), visible_children.size());
+
+		child_item_count = visible_children.size();
+		child_items = visible_children.ptr();
+	}
+
 	if (ci->z_relative) {
 		p_z = CLAMP(p_z + ci->z_index, RS::CANVAS_ITEM_Z_MIN, RS::CANVAS_ITEM_Z_MAX);
 	} else {
@@ -288,6 +484,8 @@ void RendererCanvasCull::_cull_canvas_item(Item *p_canvas_item, const Transform2
 		ci->z_final = p_z;
 
 		ci->next = nullptr;
+
+		cull_stats.items_drawn++;
 	}
 
 	for (int i = 0; i < child_item_count; i++) {
@@ -356,6 +554,18 @@ bool RendererCanvasCull::was_sdf_used() {
 	return sdf_used;
 }
 
+RendererCanvasRender::Item *RendererCanvasCull::cull_canvas(RID p_canvas, const Transform2D &p_transform, const Rect2 &p_clip_rect) {
+	Canvas *canvas = canvas_owner.getornull(p_canvas);
+	ERR_FAIL_COND_V(!canvas, nullptr);
+
+	if (canvas->children_order_dirty) {
+		canvas->child_items.sort();
+		canvas->children_order_dirty = false;
+	}
+
+	return _cull_canvas_item_tree(canvas->child_items.ptrw(), canvas->child_items.size(), nullptr, p_transform, p_clip_rect);
+}
+
 RID RendererCanvasCull::canvas_create() {
 	Canvas *canvas = memnew(Canvas);
 	ERR_FAIL_COND_V(!canvas, RID());
@@ -411,6 +621,7 @@ void RendererCanvasCull::canvas_item_set_parent(RID p_item, RID p_parent) {
 		} else if (canvas_item_owner.owns(canvas_item->parent)) {
 			Item *item_owner = canvas_item_owner.getornull(canvas_item->parent);
 			item_owner->child_items.erase(canvas_item);
+			_item_detach_from_parent(item_owner, canvas_item);
 
 			if (item_owner->sort_y) {
 				_mark_ysort_dirty(item_owner, canvas_item_owner);
@@ -442,6 +653,11 @@ void RendererCanvasCull::canvas_item_set_parent(RID p_item, RID p_parent) {
 	}
 
 	canvas_item->parent = p_parent;
+
+	Item *item_owner = _get_parent_item(canvas_item);
+	if (item_owner) {
+		_item_attach_to_parent(item_owner, canvas_item);
+	}
 }
 
 void RendererCanvasCull::canvas_item_set_visible(RID p_item, bool p_visible) {
@@ -451,6 +667,7 @@ void RendererCanvasCull::canvas_item_set_visible(RID p_item, bool p_visible) {
 	canvas_item->visible = p_visible;
 
 	_mark_ysort_dirty(canvas_item, canvas_item_owner);
+	_item_bounds_changed(canvas_item);
 }
 
 void RendererCanvasCull::canvas_item_set_light_mask(RID p_item, int p_mask) {
@@ -465,6 +682,8 @@ void RendererCanvasCull::canvas_item_set_transform(RID p_item, const Transform2D
 	ERR_FAIL_COND(!canvas_item);
 
 	canvas_item->xform = p_transform;
+
+	_item_bounds_changed(canvas_item);
 }
 
 void RendererCanvasCull::canvas_item_set_clip(RID p_item, bool p_clip) {
@@ -487,6 +706,8 @@ void RendererCanvasCull::canvas_item_set_custom_rect(RID p_item, bool p_custom_r
 
 	canvas_item->custom_rect = p_custom_rect;
 	canvas_item->rect = p_rect;
+
+	_item_mark_subtree_dirty(canvas_item);
 }
 
 void RendererCanvasCull::canvas_item_set_modulate(RID p_item, const Color &p_color) {
@@ -515,11 +736,14 @@ void RendererCanvasCull::canvas_item_set_update_when_visible(RID p_item, bool p_
 	ERR_FAIL_COND(!canvas_item);
 
 	canvas_item->update_when_visible = p_update;
+
+	_item_mark_subtree_dirty(canvas_item);
 }
 
 void RendererCanvasCull::canvas_item_add_line(RID p_item, const Point2 &p_from, const Point2 &p_to, const Color &p_color, float p_width) {
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
+	_item_mark_subtree_dirty(canvas_item);
 
 	Item::CommandPrimitive *line = canvas_item->alloc_command<Item::CommandPrimitive>();
 	ERR_FAIL_COND(!line);
@@ -544,6 +768,7 @@ void RendererCanvasCull::canvas_item_add_polyline(RID p_item, const Vector<Point
 	ERR_FAIL_COND(p_points.size() < 2);
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
+	_item_mark_subtree_dirty(canvas_item);
 
 	Color color = Color(1, 1, 1, 1);
 
@@ -683,6 +908,7 @@ void RendererCanvasCull::canvas_item_add_multiline(RID p_item, const Vector<Poin
 	ERR_FAIL_COND(p_points.size() < 2);
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
+	_item_mark_subtree_dirty(canvas_item);
 
 	Item::CommandPolygon *pline = canvas_item->alloc_command<Item::CommandPolygon>();
 	ERR_FAIL_COND(!pline);
@@ -699,6 +925,7 @@ void RendererCanvasCull::canvas_item_add_multiline(RID p_item, const Vector<Poin
 void RendererCanvasCull::canvas_item_add_rect(RID p_item, const Rect2 &p_rect, const Color &p_color) {
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
+	_item_mark_subtree_dirty(canvas_item);
 
 	Item::CommandRect *rect = canvas_item->alloc_command<Item::CommandRect>();
 	ERR_FAIL_COND(!rect);
@@ -709,6 +936,7 @@ void RendererCanvasCull::canvas_item_add_rect(RID p_item, const Rect2 &p_rect, c
 void RendererCanvasCull::canvas_item_add_circle(RID p_item, const Point2 &p_pos, float p_radius, const Color &p_color) {
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
+	_item_mark_subtree_dirty(canvas_item);
 
 	Item::CommandPolygon *circle = canvas_item->alloc_command<Item::CommandPolygon>();
 	ERR_FAIL_COND(!circle);
@@ -743,6 +971,7 @@ void RendererCanvasCull::canvas_item_add_circle(RID p_item, const Point2 &p_pos,
 void RendererCanvasCull::canvas_item_add_texture_rect(RID p_item, const Rect2 &p_rect, RID p_texture, bool p_tile, const Color &p_modulate, bool p_transpose) {
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
+	_item_mark_subtree_dirty(canvas_item);
 
 	Item::CommandRect *rect = canvas_item->alloc_command<Item::CommandRect>();
 	ERR_FAIL_COND(!rect);
@@ -774,6 +1003,7 @@ void RendererCanvasCull::canvas_item_add_texture_rect(RID p_item, const Rect2 &p
 void RendererCanvasCull::canvas_item_add_texture_rect_region(RID p_item, const Rect2 &p_rect, RID p_texture, const Rect2 &p_src_rect, const Color &p_modulate, bool p_transpose, bool p_clip_uv) {
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
+	_item_mark_subtree_dirty(canvas_item);
 
 	Item::CommandRect *rect = canvas_item->alloc_command<Item::CommandRect>();
 	ERR_FAIL_COND(!rect);
@@ -815,6 +1045,7 @@ void RendererCanvasCull::canvas_item_add_texture_rect_region(RID p_item, const R
 void RendererCanvasCull::canvas_item_add_nine_patch(RID p_item, const Rect2 &p_rect, const Rect2 &p_source, RID p_texture, const Vector2 &p_topleft, const Vector2 &p_bottomright, RS::NinePatchAxisMode p_x_axis_mode, RS::NinePatchAxisMode p_y_axis_mode, bool p_draw_center, const Color &p_modulate) {
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
+	_item_mark_subtree_dirty(canvas_item);
 
 	Item::CommandNinePatch *style = canvas_item->alloc_command<Item::CommandNinePatch>();
 	ERR_FAIL_COND(!style);
@@ -839,6 +1070,7 @@ void RendererCanvasCull::canvas_item_add_primitive(RID p_item, const Vector<Poin
 
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
+	_item_mark_subtree_dirty(canvas_item);
 
 	Item::CommandPrimitive *prim = canvas_item->alloc_command<Item::CommandPrimitive>();
 	ERR_FAIL_COND(!prim);
@@ -865,6 +1097,7 @@ void RendererCanvasCull::canvas_item_add_primitive(RID p_item, const Vector<Poin
 void RendererCanvasCull::canvas_item_add_polygon(RID p_item, const Vector<Point2> &p_points, const Vector<Color> &p_colors, const Vector<Point2> &p_uvs, RID p_texture) {
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
+	_item_mark_subtree_dirty(canvas_item);
 #ifdef DEBUG_ENABLED
 	int pointcount = p_points.size();
 	ERR_FAIL_COND(pointcount < 3);
@@ -886,6 +1119,7 @@ void RendererCanvasCull::canvas_item_add_polygon(RID p_item, const Vector<Point2
 void RendererCanvasCull::canvas_item_add_triangle_array(RID p_item, const Vector<int> &p_indices, const Vector<Point2> &p_points, const Vector<Color> &p_colors, const Vector<Point2> &p_uvs, const Vector<int> &p_bones, const Vector<float> &p_weights, RID p_texture, int p_count) {
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
+	_item_mark_subtree_dirty(canvas_item);
 
 	int vertex_count = p_points.size();
 	ERR_FAIL_COND(vertex_count == 0);
@@ -909,6 +1143,7 @@ void RendererCanvasCull::canvas_item_add_triangle_array(RID p_item, const Vector
 void RendererCanvasCull::canvas_item_add_set_transform(RID p_item, const Transform2D &p_transform) {
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
+	_item_mark_subtree_dirty(canvas_item);
 
 	Item::CommandTransform *tr = canvas_item->alloc_command<Item::CommandTransform>();
 	ERR_FAIL_COND(!tr);
@@ -918,6 +1153,7 @@ void RendererCanvasCull::canvas_item_add_set_transform(RID p_item, const Transfo
 void RendererCanvasCull::canvas_item_add_mesh(RID p_item, const RID &p_mesh, const Transform2D &p_transform, const Color &p_modulate, RID p_texture) {
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
+	_item_mark_subtree_dirty(canvas_item);
 
 	Item::CommandMesh *m = canvas_item->alloc_command<Item::CommandMesh>();
 	ERR_FAIL_COND(!m);
@@ -932,6 +1168,7 @@ void RendererCanvasCull::canvas_item_add_mesh(RID p_item, const RID &p_mesh, con
 void RendererCanvasCull::canvas_item_add_particles(RID p_item, RID p_particles, RID p_texture) {
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
+	_item_mark_subtree_dirty(canvas_item);
 
 	Item::CommandParticles *part = canvas_item->alloc_command<Item::CommandParticles>();
 	ERR_FAIL_COND(!part);
@@ -946,6 +1183,7 @@ void RendererCanvasCull::canvas_item_add_particles(RID p_item, RID p_particles,
 void RendererCanvasCull::canvas_item_add_multimesh(RID p_item, RID p_mesh, RID p_texture) {
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
+	_item_mark_subtree_dirty(canvas_item);
 
 	Item::CommandMultiMesh *mm = canvas_item->alloc_command<Item::CommandMultiMesh>();
 	ERR_FAIL_COND(!mm);
@@ -957,6 +1195,7 @@ void RendererCanvasCull::canvas_item_add_multimesh(RID p_item, RID p_mesh, RID p
 void RendererCanvasCull::canvas_item_add_clip_ignore(RID p_item, bool p_ignore) {
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
+	_item_mark_subtree_dirty(canvas_item);
 
 	Item::CommandClipIgnore *ci = canvas_item->alloc_command<Item::CommandClipIgnore>();
 	ERR_FAIL_COND(!ci);
@@ -966,6 +1205,7 @@ void RendererCanvasCull::canvas_item_add_clip_ignore(RID p_item, bool p_ignore)
 void RendererCanvasCull::canvas_item_set_sort_children_by_y(RID p_item, bool p_enable) {
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
+	_item_mark_subtree_dirty(canvas_item);
 
 	canvas_item->sort_y = p_enable;
 
@@ -998,6 +1238,7 @@ void RendererCanvasCull::canvas_item_attach_skeleton(RID p_item, RID p_skeleton)
 void RendererCanvasCull::canvas_item_set_copy_to_backbuffer(RID p_item, bool p_enable, const Rect2 &p_rect) {
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
+	_item_mark_subtree_dirty(canvas_item);
 	if (p_enable && (canvas_item->copy_back_buffer == nullptr)) {
 		canvas_item->copy_back_buffer = memnew(RendererCanvasRender::Item::CopyBackBuffer);
 	}
@@ -1017,6 +1258,8 @@ void RendererCanvasCull::canvas_item_clear(RID p_item) {
 	ERR_FAIL_COND(!canvas_item);
 
 	canvas_item->clear();
+
+	_item_mark_subtree_dirty(canvas_item);
 }
 
 void RendererCanvasCull::canvas_item_set_draw_index(RID p_item, int p_index) {
@@ -1055,6 +1298,7 @@ void RendererCanvasCull::canvas_item_set_use_parent_material(RID p_item, bool p_
 void RendererCanvasCull::canvas_item_set_canvas_group_mode(RID p_item, RS::CanvasGroupMode p_mode, float p_clear_margin, bool p_fit_empty, float p_fit_margin, bool p_blur_mipmaps) {
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
+	_item_mark_subtree_dirty(canvas_item);
 
 	if (p_mode == RS::CANVAS_GROUP_MODE_DISABLED) {
 		if (canvas_item->canvas_group != nullptr) {
@@ -1465,6 +1709,7 @@ bool RendererCanvasCull::free(RID p_rid) {
 			} else if (canvas_item_owner.owns(canvas_item->parent)) {
 				Item *item_owner = canvas_item_owner.getornull(canvas_item->parent);
 				item_owner->child_items.erase(canvas_item);
+				_item_detach_from_parent(item_owner, canvas_item);
 
 				if (item_owner->sort_y) {
 					_mark_ysort_dirty(item_owner, canvas_item_owner);
@@ -1472,6 +1717,7 @@ bool RendererCanvasCull::free(RID p_rid) {
 			}
 		}
 
+		_item_free_children_bvh(canvas_item);
 		for (int i = 0; i < canvas_item->child_items.size(); i++) {
 			canvas_item->child_items[i]->parent = RID();
 		}
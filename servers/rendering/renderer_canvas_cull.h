@@ -31,11 +31,17 @@
 #ifndef RENDERING_SERVER_CANVAS_CULL_H
 #define RENDERING_SERVER_CANVAS_CULL_H
 
+#include "core/math/dynamic_bvh.h"
 #include "renderer_compositor.h"
 #include "renderer_viewport.h"
 
 class RendererCanvasCull {
 public:
+	enum {
+		// Items with at least this many children keep them in a BVH, so only the visible ones are visited.
+		CHILDREN_BVH_THRESHOLD = 64
+	};
+
 	struct Item : public RendererCanvasRender::Item {
 		RID parent; // canvas it belongs to
 		List<Item *>::Element *E;
@@ -54,6 +60,18 @@ public:
 		int ysort_index;
 
 		Vector<Item *> child_items;
+		int child_slot;
+
+		// Bounds of this item and all its children, in local space. Updated lazily before culling,
+		// changes mark the parent chain dirty.
+		Rect2 subtree_rect;
+		bool subtree_empty;
+		bool subtree_dirty;
+
+		DynamicBVH *children_bvh;
+		LocalVector<Item *> children_bvh_dirty;
+		DynamicBVH::ID parent_bvh_id;
+		bool parent_bvh_dirty;
 
 		Item() {
 			children_order_dirty = true;
@@ -69,6 +87,17 @@ public:
 			ysort_xform = Transform2D();
 			ysort_pos = Vector2();
 			ysort_index = 0;
+			child_slot = 0;
+			subtree_empty = true;
+			subtree_dirty = true;
+			children_bvh = nullptr;
+			parent_bvh_dirty = false;
+		}
+	};
+
+	struct ItemSlotSort {
+		_FORCE_INLINE_ bool operator()(const Item *p_left, const Item *p_right) const {
+			return p_left->child_slot < p_right->child_slot;
 		}
 	};
 
@@ -156,7 +185,23 @@ public:
 	bool sdf_used = false;
 	bool snapping_2d_transforms_to_pixel = false;
 
+	struct CullStats {
+		uint32_t items_visited = 0;
+		uint32_t items_drawn = 0;
+	};
+
+	CullStats cull_stats;
+
 private:
+	_FORCE_INLINE_ Item *_get_parent_item(const Item *p_item);
+	void _item_bounds_changed(Item *p_item);
+	void _item_mark_subtree_dirty(Item *p_item);
+	void _item_attach_to_parent(Item *p_parent, Item *p_item);
+	void _item_detach_from_parent(Item *p_parent, Item *p_item);
+	void _item_free_children_bvh(Item *p_item);
+	void _item_update_subtree(Item *p_item);
+
+	RendererCanvasRender::Item *_cull_canvas_item_tree(Canvas::ChildItem *p_child_items, int p_child_item_count, Item *p_canvas_item, const Transform2D &p_transform, const Rect2 &p_clip_rect);
 	void _render_canvas_item_tree(RID p_to_render_target, Canvas::ChildItem *p_child_items, int p_child_item_count, Item *p_canvas_item, const Transform2D &p_transform, const Rect2 &p_clip_rect, const Color &p_modulate, RendererCanvasRender::Light *p_lights, RendererCanvasRender::Light *p_directional_lights, RS::CanvasItemTextureFilter p_default_filter, RS::CanvasItemTextureRepeat p_default_repeat, bool p_snap_2d_vertices_to_pixel);
 	void _cull_canvas_item(Item *p_canvas_item, const Transform2D &p_transform, const Rect2 &p_clip_rect, const Color &p_modulate, int p_z, RendererCanvasRender::Item **z_list, RendererCanvasRender::Item **z_last_list, Item *p_canvas_clip, Item *p_material_owner);
 
@@ -168,6 +213,9 @@ public:
 
 	bool was_sdf_used();
 
+	// Culls without rendering, returns the items that would be drawn in order.
+	RendererCanvasRender::Item *cull_canvas(RID p_canvas, const Transform2D &p_transform, const Rect2 &p_clip_rect);
+
 	RID canvas_create();
 	void canvas_set_item_mirroring(RID p_canvas, RID p_item, const Point2 &p_mirroring);
 	void canvas_set_modulate(RID p_canvas, const Color &p_color);
@@ -390,7 +390,7 @@ void RendererCanvasRenderRD::_bind_canvas_texture(RD::DrawListID p_draw_list, RI
 	r_last_texture = p_texture;
 }
 
-void RendererCanvasRenderRD::_render_item(RD::DrawListID p_draw_list, const Item *p_item, RD::FramebufferFormatID p_framebuffer_format, const Transform2D &p_canvas_transform_inverse, Item *&current_clip, Light *p_lights, PipelineVariants *p_pipeline_variants) {
+void RendererCanvasRenderRD::_render_item(RD::DrawListID p_draw_list, const Item *p_item, RD::FramebufferFormatID p_framebuffer_format, const Transform2D &p_canvas_transform_inverse, Item *&current_clip, uint32_t p_item_index, PipelineVariants *p_pipeline_variants, uint32_t &r_batch_index, uint32_t &r_batch_skip) {
 	//create an empty push constant
 
 	RS::CanvasItemTextureFilter current_filter = default_filter;
@@ -420,38 +420,15 @@ void RendererCanvasRenderRD::_render_item(RD::DrawListID p_draw_list, const Item
 	push_constant.color_texture_pixel_size[0] = 0;
 	push_constant.color_texture_pixel_size[1] = 0;
 
-	push_constant.pad[0] = 0;
-	push_constant.pad[1] = 0;
-
-	push_constant.lights[0] = 0;
-	push_constant.lights[1] = 0;
-	push_constant.lights[2] = 0;
-	push_constant.lights[3] = 0;
+	push_constant.batch_offset = 0;
+	push_constant.pad = 0;
 
 	uint32_t base_flags = 0;
 
-	uint16_t light_count = 0;
+	uint32_t light_count = batcher.get_built_item_lights(p_item_index, push_constant.lights);
 	PipelineLightMode light_mode;
 
-	{
-		Light *light = p_lights;
-
-		while (light) {
-			if (light->render_index_cache >= 0 && p_item->light_mask & light->item_mask && p_item->z_final >= light->z_min && p_item->z_final <= light->z_max && p_item->global_rect_cache.intersects_transformed(light->xform_cache, light->rect_cache)) {
-				uint32_t light_index = light->render_index_cache;
-				push_constant.lights[light_count >> 2] |= light_index << ((light_count & 3) * 8);
-
-				light_count++;
-
-				if (light_count == MAX_LIGHTS_PER_ITEM) {
-					break;
-				}
-			}
-			light = light->next_ptr;
-		}
-
-		base_flags |= light_count << FLAGS_LIGHT_COUNT_SHIFT;
-	}
+	base_flags |= light_count << FLAGS_LIGHT_COUNT_SHIFT;
 
 	light_mode = (light_count > 0 || using_directional_lights) ? PIPELINE_LIGHT_MODE_ENABLED : PIPELINE_LIGHT_MODE_DISABLED;
 
@@ -470,6 +447,12 @@ void RendererCanvasRenderRD::_render_item(RD::DrawListID p_draw_list, const Item
 			case Item::Command::TYPE_RECT: {
 				const Item::CommandRect *rect = static_cast<const Item::CommandRect *>(c);
 
+				if (r_batch_skip > 0) {
+					//already drawn as part of a batch
+					r_batch_skip--;
+					break;
+				}
+
 				//bind pipeline
 				{
 					RID pipeline = pipeline_variants->variants[light_mode][PIPELINE_VARIANT_QUAD].get_render_pipeline(RD::INVALID_ID, p_framebuffer_format);
@@ -480,51 +463,36 @@ void RendererCanvasRenderRD::_render_item(RD::DrawListID p_draw_list, const Item
 
 				_bind_canvas_texture(p_draw_list, rect->texture, current_filter, current_repeat, last_texture, push_constant, texpixel_size);
 
-				Rect2 src_rect;
-				Rect2 dst_rect;
+				const LocalVector<RendererCanvasBatcher::Batch> &batches = batcher.get_batches();
+				if (r_batch_index < batches.size() && batches[r_batch_index].command == c) {
+					//draw this rect and the ones following it in a single instanced call
+					const RendererCanvasBatcher::Batch &batch = batches[r_batch_index];
+					r_batch_index++;
+					r_batch_skip = batch.instance_count - 1;
 
-				if (rect->texture != RID()) {
-					src_rect = (rect->flags & CANVAS_RECT_REGION) ? Rect2(rect->source.position * texpixel_size, rect->source.size * texpixel_size) : Rect2(0, 0, 1, 1);
-					dst_rect = Rect2(rect->rect.position, rect->rect.size);
+					push_constant.flags |= FLAGS_USING_BATCH;
+					push_constant.batch_offset = batch.instance_offset;
 
-					if (dst_rect.size.width < 0) {
-						dst_rect.position.x += dst_rect.size.width;
-						dst_rect.size.width *= -1;
-					}
-					if (dst_rect.size.height < 0) {
-						dst_rect.position.y += dst_rect.size.height;
-						dst_rect.size.height *= -1;
-					}
+					RD::get_singleton()->draw_list_set_push_constant(p_draw_list, &push_constant, sizeof(PushConstant));
+					RD::get_singleton()->draw_list_bind_index_array(p_draw_list, shader.quad_index_array);
+					RD::get_singleton()->draw_list_draw(p_draw_list, true, batch.instance_count);
+					break;
+				}
 
-					if (rect->flags & CANVAS_RECT_FLIP_H) {
-						src_rect.size.x *= -1;
-					}
+				Rect2 src_rect;
+				Rect2 dst_rect;
 
-					if (rect->flags & CANVAS_RECT_FLIP_V) {
-						src_rect.size.y *= -1;
-					}
+				RendererCanvasBatcher::get_rect_draw_rects(rect, src_rect, dst_rect);
 
-					if (rect->flags & CANVAS_RECT_TRANSPOSE) {
-						dst_rect.size.x *= -1; // Encoding in the dst_rect.z uniform
+				if (rect->texture != RID()) {
+					if (rect->flags & CANVAS_RECT_REGION) {
+						src_rect.position *= texpixel_size;
+						src_rect.size *= texpixel_size;
 					}
 
 					if (rect->flags & CANVAS_RECT_CLIP_UV) {
 						push_constant.flags |= FLAGS_CLIP_RECT_UV;
 					}
-
-				} else {
-					dst_rect = Rect2(rect->rect.position, rect->rect.size);
-
-					if (dst_rect.size.width < 0) {
-						dst_rect.position.x += dst_rect.size.width;
-						dst_rect.size.width *= -1;
-					}
-					if (dst_rect.size.height < 0) {
-						dst_rect.position.y += dst_rect.size.height;
-						dst_rect.size.height *= -1;
-					}
-
-					src_rect = Rect2(0, 0, 1, 1);
 				}
 
 				push_constant.modulation[0] = rect->modulate.r * base_color.r;
@@ -1116,6 +1084,14 @@ RID RendererCanvasRenderRD::_create_base_uniform_set(RID p_to_render_target, boo
 		uniforms.push_back(u);
 	}
 
+	{
+		RD::Uniform u;
+		u.uniform_type = RD::UNIFORM_TYPE_STORAGE_BUFFER;
+		u.binding = 10;
+		u.ids.push_back(state.batch_instance_buffer);
+		uniforms.push_back(u);
+	}
+
 	RID uniform_set = RD::get_singleton()->uniform_set_create(uniforms, shader.default_version_rd_shader, BASE_UNIFORM_SET);
 	if (p_backbuffer) {
 		storage->render_target_set_backbuffer_uniform_set(p_to_render_target, uniform_set);
@@ -1160,6 +1136,14 @@ void RendererCanvasRenderRD::_render_items(RID p_to_render_target, int p_item_co
 
 	RD::FramebufferFormatID fb_format = RD::get_singleton()->framebuffer_get_format(framebuffer);
 
+	//group consecutive rects, instance data must be uploaded before the draw list begins
+	batcher.build(items, p_item_count, canvas_transform_inverse, p_lights, MAX_BATCH_INSTANCES);
+	if (batcher.get_batched_instance_count()) {
+		RD::get_singleton()->buffer_update(state.batch_instance_buffer, 0, sizeof(RendererCanvasBatcher::InstanceData) * batcher.get_batched_instance_count(), batcher.get_instances().ptr());
+	}
+	uint32_t batch_index = 0;
+	uint32_t batch_skip = 0;
+
 	RD::DrawListID draw_list = RD::get_singleton()->draw_list_begin(framebuffer, clear ? RD::INITIAL_ACTION_CLEAR : RD::INITIAL_ACTION_KEEP, RD::FINAL_ACTION_READ, RD::INITIAL_ACTION_KEEP, RD::FINAL_ACTION_DISCARD, clear_colors);
 
 	RD::get_singleton()->draw_list_bind_uniform_set(draw_list, fb_uniform_set, BASE_UNIFORM_SET);
@@ -1210,7 +1194,7 @@ void RendererCanvasRenderRD::_render_items(RID p_to_render_target, int p_item_co
 			}
 		}
 
-		_render_item(draw_list, ci, fb_format, canvas_transform_inverse, current_clip, p_lights, pipeline_variants);
+		_render_item(draw_list, ci, fb_format, canvas_transform_inverse, current_clip, i, pipeline_variants, batch_index, batch_skip);
 
 		prev_material = material;
 	}
@@ -2539,7 +2523,7 @@ RendererCanvasRenderRD::RendererCanvasRenderRD(RendererStorageRD *p_storage) {
 		actions.base_uniform_string = "material.";
 		actions.default_filter = ShaderLanguage::FILTER_LINEAR;
 		actions.default_repeat = ShaderLanguage::REPEAT_DISABLE;
-		actions.base_varying_index = 4;
+		actions.base_varying_index = 5;
 
 		actions.global_buffer_array_variable = "global_variables.data";
 
@@ -2619,6 +2603,7 @@ RendererCanvasRenderRD::RendererCanvasRenderRD(RendererStorageRD *p_storage) {
 
 		state.canvas_state_buffer = RD::get_singleton()->uniform_buffer_create(sizeof(State::Buffer));
 		state.lights_uniform_buffer = RD::get_singleton()->uniform_buffer_create(sizeof(LightUniform) * state.max_lights_per_render);
+		state.batch_instance_buffer = RD::get_singleton()->storage_buffer_create(sizeof(RendererCanvasBatcher::InstanceData) * MAX_BATCH_INSTANCES);
 
 		RD::SamplerState shadow_sampler_state;
 		shadow_sampler_state.mag_filter = RD::SAMPLER_FILTER_LINEAR;
@@ -2769,6 +2754,7 @@ RendererCanvasRenderRD::~RendererCanvasRenderRD() {
 
 		memdelete_arr(state.light_uniforms);
 		RD::get_singleton()->free(state.lights_uniform_buffer);
+		RD::get_singleton()->free(state.batch_instance_buffer);
 		RD::get_singleton()->free(shader.default_skeleton_uniform_buffer);
 		RD::get_singleton()->free(shader.default_skeleton_texture_buffer);
 	}
@@ -31,6 +31,7 @@
 #ifndef RENDERING_SERVER_CANVAS_RENDER_RD_H
 #define RENDERING_SERVER_CANVAS_RENDER_RD_H
 
+#include "servers/rendering/renderer_canvas_batcher.h"
 #include "servers/rendering/renderer_canvas_render.h"
 #include "servers/rendering/renderer_compositor.h"
 #include "servers/rendering/renderer_rd/pipeline_cache_rd.h"
@@ -79,6 +80,7 @@ class RendererCanvasRenderRD : public RendererCanvasRender {
 
 		FLAGS_NINEPACH_DRAW_CENTER = (1 << 12),
 		FLAGS_USING_PARTICLES = (1 << 13),
+		FLAGS_USING_BATCH = (1 << 14),
 
 		FLAGS_USE_SKELETON = (1 << 15),
 		FLAGS_NINEPATCH_H_MODE_SHIFT = 16,
@@ -107,7 +109,8 @@ class RendererCanvasRenderRD : public RendererCanvasRender {
 		MAX_RENDER_ITEMS = 256 * 1024,
 		MAX_LIGHT_TEXTURES = 1024,
 		MAX_LIGHTS_PER_ITEM = 16,
-		DEFAULT_MAX_LIGHTS_PER_RENDER = 256
+		DEFAULT_MAX_LIGHTS_PER_RENDER = 256,
+		MAX_BATCH_INSTANCES = 16384
 	};
 
 	/****************/
@@ -377,6 +380,8 @@ class RendererCanvasRenderRD : public RendererCanvasRender {
 
 		RID default_transforms_uniform_set;
 
+		RID batch_instance_buffer;
+
 		uint32_t max_lights_per_render;
 		uint32_t max_lights_per_item;
 
@@ -395,7 +400,8 @@ class RendererCanvasRenderRD : public RendererCanvasRender {
 				float ninepatch_margins[4];
 				float dst_rect[4];
 				float src_rect[4];
-				float pad[2];
+				uint32_t batch_offset;
+				uint32_t pad;
 			};
 			//primitive
 			struct {
@@ -415,6 +421,8 @@ class RendererCanvasRenderRD : public RendererCanvasRender {
 
 	Item *items[MAX_RENDER_ITEMS];
 
+	RendererCanvasBatcher batcher;
+
 	bool using_directional_lights = false;
 	RID default_canvas_texture;
 
@@ -427,7 +435,7 @@ class RendererCanvasRenderRD : public RendererCanvasRender {
 	RID _create_base_uniform_set(RID p_to_render_target, bool p_backbuffer);
 
 	inline void _bind_canvas_texture(RD::DrawListID p_draw_list, RID p_texture, RS::CanvasItemTextureFilter p_base_filter, RS::CanvasItemTextureRepeat p_base_repeat, RID &r_last_texture, PushConstant &push_constant, Size2 &r_texpixel_size); //recursive, so regular inline used instead.
-	void _render_item(RenderingDevice::DrawListID p_draw_list, const Item *p_item, RenderingDevice::FramebufferFormatID p_framebuffer_format, const Transform2D &p_canvas_transform_inverse, Item *&current_clip, Light *p_lights, PipelineVariants *p_pipeline_variants);
+	void _render_item(RenderingDevice::DrawListID p_draw_list, const Item *p_item, RenderingDevice::FramebufferFormatID p_framebuffer_format, const Transform2D &p_canvas_transform_inverse, Item *&current_clip, uint32_t p_item_index, PipelineVariants *p_pipeline_variants, uint32_t &r_batch_index, uint32_t &r_batch_skip);
 	void _render_items(RID p_to_render_target, int p_item_count, const Transform2D &p_canvas_transform_inverse, Light *p_lights, bool p_to_backbuffer = false);
 
 	_FORCE_INLINE_ void _update_transform_2d_to_mat2x4(const Transform2D &p_transform, float *p_mat2x4);
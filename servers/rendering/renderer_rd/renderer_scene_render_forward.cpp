@@ -39,6 +39,7 @@ void RendererSceneRenderForward::ShaderData::set_code(const String &p_code) {
 
 	code = p_code;
 	valid = false;
+	async_compiling = false;
 	ubo_size = 0;
 	uniforms.clear();
 	uses_screen_texture = false;
@@ -49,10 +50,10 @@ void RendererSceneRenderForward::ShaderData::set_code(const String &p_code) {
 
 	ShaderCompilerRD::GeneratedCode gen_code;
 
-	int blend_mode = BLEND_MODE_MIX;
+	blend_mode = BLEND_MODE_MIX;
 	int depth_testi = DEPTH_TEST_ENABLED;
-	int alpha_antialiasing_mode = ALPHA_ANTIALIASING_OFF;
-	int cull = CULL_BACK;
+	alpha_antialiasing_mode = ALPHA_ANTIALIASING_OFF;
+	cull = CULL_BACK;
 
 	uses_point_size = false;
 	uses_alpha = false;
@@ -61,7 +62,7 @@ void RendererSceneRenderForward::ShaderData::set_code(const String &p_code) {
 	uses_discard = false;
 	uses_roughness = false;
 	uses_normal = false;
-	bool wireframe = false;
+	wireframe = false;
 
 	unshaded = false;
 	uses_vertex = false;
@@ -150,12 +151,43 @@ void RendererSceneRenderForward::ShaderData::set_code(const String &p_code) {
 	print_line("\n**light_code:\n" + gen_code.light);
 #endif
 	scene_singleton->shader.scene_shader.version_set_code(version, gen_code.uniforms, gen_code.vertex_global, gen_code.vertex, gen_code.fragment_global, gen_code.light, gen_code.fragment, gen_code.defines);
-	ERR_FAIL_COND(!scene_singleton->shader.scene_shader.version_is_valid(version));
 
 	ubo_size = gen_code.uniform_total_size;
 	ubo_offsets = gen_code.uniform_offsets;
 	texture_uniforms = gen_code.texture_uniforms;
 
+	if (scene_singleton->async_shader_compile && scene_singleton->shader.scene_shader.version_compile_async(version)) {
+		async_compiling = true; //stays invalid (drawn with the default material) until update_async_compile() finishes it
+		return;
+	}
+
+	ERR_FAIL_COND(!scene_singleton->shader.scene_shader.version_is_valid(version));
+
+	_setup_pipelines();
+}
+
+bool RendererSceneRenderForward::ShaderData::update_async_compile() {
+	if (!async_compiling) {
+		return false;
+	}
+
+	RendererSceneRenderForward *scene_singleton = (RendererSceneRenderForward *)RendererSceneRenderForward::singleton;
+	if (scene_singleton->shader.scene_shader.version_is_compiling(version)) {
+		return true;
+	}
+
+	async_compiling = false;
+
+	// The SPIR-V is cached by now, so this only creates the shaders.
+	ERR_FAIL_COND_V(!scene_singleton->shader.scene_shader.version_is_valid(version), false);
+
+	_setup_pipelines();
+	return false;
+}
+
+void RendererSceneRenderForward::ShaderData::_setup_pipelines() {
+	RendererSceneRenderForward *scene_singleton = (RendererSceneRenderForward *)RendererSceneRenderForward::singleton;
+
 	//blend modes
 
 	// if any form of Alpha Antialiasing is enabled, set the blend mode to alpha to coverage
@@ -483,6 +515,12 @@ void RendererSceneRenderForward::MaterialData::update_parameters(const Map<Strin
 		return;
 	}
 
+	if (!shader_data->valid) {
+		// Don't make the shader compile here while it compiles in the background (or failed to compile),
+		// the material is queued again for an update once it's ready.
+		return;
+	}
+
 	Vector<RD::Uniform> uniforms;
 
 	{
@@ -3436,6 +3474,7 @@ RendererSceneRenderForward::RendererSceneRenderForward(RendererStorageRD *p_stor
 	}
 
 	render_list_thread_threshold = GLOBAL_GET("rendering/forward_renderer/threaded_render_minimum_instances");
+	async_shader_compile = GLOBAL_GET("rendering/forward_renderer/async_shader_compile");
 }
 
 RendererSceneRenderForward::~RendererSceneRenderForward() {
@@ -157,9 +157,18 @@ class RendererSceneRenderForward : public RendererSceneRenderRD {
 		bool writes_modelview_or_projection;
 		bool uses_world_coordinates;
 
+		// Render modes used to create the pipelines, which is delayed while compiling in the background.
+		int blend_mode = BLEND_MODE_MIX;
+		int alpha_antialiasing_mode = ALPHA_ANTIALIASING_OFF;
+		int cull = CULL_BACK;
+		bool wireframe = false;
+		bool async_compiling = false;
+
 		uint64_t last_pass = 0;
 		uint32_t index = 0;
 
+		void _setup_pipelines();
+
 		virtual void set_code(const String &p_Code);
 		virtual void set_default_texture_param(const StringName &p_name, RID p_texture);
 		virtual void get_param_list(List<PropertyInfo> *p_param_list) const;
@@ -170,6 +179,7 @@ class RendererSceneRenderForward : public RendererSceneRenderRD {
 		virtual bool casts_shadows() const;
 		virtual Variant get_default_parameter(const StringName &p_parameter) const;
 		virtual RS::ShaderNativeSourceCode get_native_source_code() const;
+		virtual bool update_async_compile();
 
 		ShaderData();
 		virtual ~ShaderData();
@@ -464,6 +474,7 @@ class RendererSceneRenderForward : public RendererSceneRenderRD {
 	void _render_list_with_threads(RenderListParameters *p_params, RID p_framebuffer, RD::InitialAction p_initial_color_action, RD::FinalAction p_final_color_action, RD::InitialAction p_initial_depth_action, RD::FinalAction p_final_depth_action, const Vector<Color> &p_clear_color_values = Vector<Color>(), float p_clear_depth = 1.0, uint32_t p_clear_stencil = 0, const Rect2 &p_region = Rect2(), const Vector<RID> &p_storage_textures = Vector<RID>());
 
 	uint32_t render_list_thread_threshold = 500;
+	bool async_shader_compile = false;
 
 	void _fill_render_list(const PagedArray<GeometryInstance *> &p_instances, PassMode p_pass_mode, const CameraMatrix &p_cam_projection, const Transform &p_cam_transform, bool p_using_sdfgi = false, bool p_using_opaque_gi = false);
 
@@ -1434,6 +1434,9 @@ void RendererStorageRD::shader_set_code(RID p_shader, const String &p_code) {
 
 	if (shader->data) {
 		shader->data->set_code(p_code);
+		if (shader->data->update_async_compile()) {
+			shader_async_compiles.insert(p_shader); //materials use the fallback until it's compiled
+		}
 	}
 
 	for (Set<Material *>::Element *E = shader->owners.front(); E; E = E->next()) {
@@ -1443,6 +1446,27 @@ void RendererStorageRD::shader_set_code(RID p_shader, const String &p_code) {
 	}
 }
 
+void RendererStorageRD::_update_async_shaders() {
+	Set<RID>::Element *E = shader_async_compiles.front();
+	while (E) {
+		Set<RID>::Element *N = E->next();
+
+		Shader *shader = shader_owner.getornull(E->get());
+		if (!shader || !shader->data) {
+			shader_async_compiles.erase(E); //freed or changed type
+		} else if (!shader->data->update_async_compile()) {
+			for (Set<Material *>::Element *F = shader->owners.front(); F; F = F->next()) {
+				Material *material = F->get();
+				material->dependency.changed_notify(DEPENDENCY_CHANGED_MATERIAL);
+				_material_queue_update(material, true, true);
+			}
+			shader_async_compiles.erase(E);
+		}
+
+		E = N;
+	}
+}
+
 String RendererStorageRD::shader_get_code(RID p_shader) const {
 	Shader *shader = shader_owner.getornull(p_shader);
 	ERR_FAIL_COND_V(!shader, String());
@@ -8096,6 +8120,7 @@ void RendererStorageRD::_update_global_variables() {
 
 void RendererStorageRD::update_dirty_resources() {
 	_update_global_variables(); //must do before materials, so it can queue them for update
+	_update_async_shaders(); //also queues materials
 	_update_queued_materials();
 	_update_dirty_multimeshes();
 	_update_dirty_skeletons();
@@ -143,6 +143,8 @@ public:
 		virtual bool casts_shadows() const = 0;
 		virtual Variant get_default_parameter(const StringName &p_parameter) const = 0;
 		virtual RS::ShaderNativeSourceCode get_native_source_code() const { return RS::ShaderNativeSourceCode(); }
+		// Returns true while the shader is being compiled in the background, finishing the setup once done.
+		virtual bool update_async_compile() { return false; }
 
 		virtual ~ShaderData() {}
 	};
@@ -369,6 +371,9 @@ private:
 	ShaderDataRequestFunction shader_data_request_func[SHADER_TYPE_MAX];
 	mutable RID_Owner<Shader> shader_owner;
 
+	Set<RID> shader_async_compiles;
+	void _update_async_shaders();
+
 	/* Material */
 
 	struct Material {
@@ -1249,7 +1249,111 @@ ShaderLanguage::DataType ShaderCompilerRD::_get_variable_type(const StringName &
 	return RS::global_variable_type_get_shader_datatype(gvt);
 }
 
+uint64_t ShaderCompilerRD::_get_cache_key(RS::ShaderMode p_mode, const String &p_code, const IdentifierActions *p_actions) {
+	uint64_t key = hash_djb2_one_64(p_mode, p_code.hash64());
+	for (const Map<StringName, bool *>::Element *E = p_actions->usage_flag_pointers.front(); E; E = E->next()) {
+		key = hash_djb2_one_64(E->key().hash(), key);
+	}
+	for (const Map<StringName, bool *>::Element *E = p_actions->write_flag_pointers.front(); E; E = E->next()) {
+		key = hash_djb2_one_64(E->key().hash(), key);
+	}
+	return key;
+}
+
+bool ShaderCompilerRD::_is_cache_entry_valid(const CacheEntry &p_entry) const {
+	// Global uniforms are type checked against the project globals, which may have changed since.
+	for (const Map<StringName, SL::ShaderNode::Uniform>::Element *E = p_entry.uniforms.front(); E; E = E->next()) {
+		if (E->get().scope == SL::ShaderNode::Uniform::SCOPE_GLOBAL && _get_variable_type(E->key()) != E->get().type) {
+			return false;
+		}
+	}
+	return true;
+}
+
+void ShaderCompilerRD::_apply_cache_entry(const CacheEntry &p_entry, IdentifierActions *p_actions, GeneratedCode &r_gen_code) {
+	// Same order as _dump_node_code(), so the last render mode setting a value wins.
+	for (int i = 0; i < p_entry.render_modes.size(); i++) {
+		if (p_actions->render_mode_flags.has(p_entry.render_modes[i])) {
+			*p_actions->render_mode_flags[p_entry.render_modes[i]] = true;
+		}
+
+		if (p_actions->render_mode_values.has(p_entry.render_modes[i])) {
+			Pair<int *, int> &p = p_actions->render_mode_values[p_entry.render_modes[i]];
+			*p.first = p.second;
+		}
+	}
+
+	for (int i = 0; i < p_entry.usage_flags.size(); i++) {
+		*p_actions->usage_flag_pointers[p_entry.usage_flags[i]] = true;
+	}
+
+	for (int i = 0; i < p_entry.write_flags.size(); i++) {
+		*p_actions->write_flag_pointers[p_entry.write_flags[i]] = true;
+	}
+
+	for (const Map<StringName, SL::ShaderNode::Uniform>::Element *E = p_entry.uniforms.front(); E; E = E->next()) {
+		p_actions->uniforms->insert(E->key(), E->get());
+	}
+
+	r_gen_code = p_entry.gen_code;
+}
+
 Error ShaderCompilerRD::compile(RS::ShaderMode p_mode, const String &p_code, IdentifierActions *p_actions, const String &p_path, GeneratedCode &r_gen_code) {
+	uint64_t key = _get_cache_key(p_mode, p_code, p_actions);
+
+	const CacheEntry *cached = cache.getptr(key);
+	if (cached && cached->mode == p_mode && cached->code == p_code && _is_cache_entry_valid(*cached)) {
+		cache_hits++;
+		_apply_cache_entry(*cached, p_actions, r_gen_code);
+		return OK;
+	}
+
+	cache_misses++;
+
+	// Compile against local flags and uniforms, which are stored and then applied like a cache hit.
+	CacheEntry entry;
+	entry.mode = p_mode;
+	entry.code = p_code;
+
+	Map<StringName, bool> usage_flags;
+	Map<StringName, bool> write_flags;
+
+	IdentifierActions actions_to_cache;
+	for (const Map<StringName, bool *>::Element *E = p_actions->usage_flag_pointers.front(); E; E = E->next()) {
+		actions_to_cache.usage_flag_pointers[E->key()] = &usage_flags.insert(E->key(), false)->get();
+	}
+	for (const Map<StringName, bool *>::Element *E = p_actions->write_flag_pointers.front(); E; E = E->next()) {
+		actions_to_cache.write_flag_pointers[E->key()] = &write_flags.insert(E->key(), false)->get();
+	}
+	actions_to_cache.uniforms = &entry.uniforms;
+
+	Error err = _compile(p_mode, p_code, &actions_to_cache, p_path, entry.gen_code);
+	if (err != OK) {
+		return err;
+	}
+
+	entry.render_modes = parser.get_shader()->render_modes;
+	for (Map<StringName, bool>::Element *E = usage_flags.front(); E; E = E->next()) {
+		if (E->get()) {
+			entry.usage_flags.push_back(E->key());
+		}
+	}
+	for (Map<StringName, bool>::Element *E = write_flags.front(); E; E = E->next()) {
+		if (E->get()) {
+			entry.write_flags.push_back(E->key());
+		}
+	}
+
+	_apply_cache_entry(*cache.insert(key, entry), p_actions, r_gen_code);
+
+	return OK;
+}
+
+void ShaderCompilerRD::clear_cache() {
+	cache.clear();
+}
+
+Error ShaderCompilerRD::_compile(RS::ShaderMode p_mode, const String &p_code, IdentifierActions *p_actions, const String &p_path, GeneratedCode &r_gen_code) {
 	Error err = parser.compile(p_code, ShaderTypes::get_singleton()->get_functions(p_mode), ShaderTypes::get_singleton()->get_modes(p_mode), ShaderTypes::get_singleton()->get_types(), _get_variable_type);
 
 	if (err != OK) {
@@ -1310,7 +1414,8 @@ void ShaderCompilerRD::initialize(DefaultIdentifierActions p_actions) {
 	texture_functions.insert("texelFetch");
 }
 
-ShaderCompilerRD::ShaderCompilerRD() {
+ShaderCompilerRD::ShaderCompilerRD() :
+		cache(CACHE_SIZE) {
 #if 0
 
 	/** SPATIAL SHADER **/
@@ -31,6 +31,7 @@
 #ifndef SHADER_COMPILER_RD_H
 #define SHADER_COMPILER_RD_H
 
+#include "core/templates/lru.h"
 #include "core/templates/pair.h"
 #include "servers/rendering/shader_language.h"
 #include "servers/rendering/shader_types.h"
@@ -95,6 +96,33 @@ public:
 private:
 	ShaderLanguage parser;
 
+	// Setting the same code again (e.g. reloading or duplicating a shader)
+	// skips parsing and code generation. Entries are keyed by the shader mode,
+	// code and the flag names requested in the actions, and store the side
+	// effects on the actions so they can be replayed.
+	struct CacheEntry {
+		RS::ShaderMode mode;
+		String code;
+		GeneratedCode gen_code;
+		Map<StringName, ShaderLanguage::ShaderNode::Uniform> uniforms;
+		Vector<StringName> render_modes;
+		Vector<StringName> usage_flags;
+		Vector<StringName> write_flags;
+	};
+
+	enum {
+		CACHE_SIZE = 128
+	};
+
+	LRUCache<uint64_t, CacheEntry> cache;
+	uint32_t cache_hits = 0;
+	uint32_t cache_misses = 0;
+
+	static uint64_t _get_cache_key(RS::ShaderMode p_mode, const String &p_code, const IdentifierActions *p_actions);
+	bool _is_cache_entry_valid(const CacheEntry &p_entry) const;
+	static void _apply_cache_entry(const CacheEntry &p_entry, IdentifierActions *p_actions, GeneratedCode &r_gen_code);
+	Error _compile(RS::ShaderMode p_mode, const String &p_code, IdentifierActions *p_actions, const String &p_path, GeneratedCode &r_gen_code);
+
 	String _get_sampler_name(ShaderLanguage::TextureFilter p_filter, ShaderLanguage::TextureRepeat p_repeat);
 
 	void _dump_function_deps(const ShaderLanguage::ShaderNode *p_node, const StringName &p_for_func, const Map<StringName, String> &p_func_code, String &r_to_add, Set<StringName> &added);
@@ -123,6 +151,11 @@ public:
 	Error compile(RS::ShaderMode p_mode, const String &p_code, IdentifierActions *p_actions, const String &p_path, GeneratedCode &r_gen_code);
 
 	void initialize(DefaultIdentifierActions p_actions);
+
+	void clear_cache();
+	uint32_t get_cache_hits() const { return cache_hits; }
+	uint32_t get_cache_misses() const { return cache_misses; }
+
 	ShaderCompilerRD();
 };
 
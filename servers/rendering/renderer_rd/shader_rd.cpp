@@ -183,6 +183,7 @@ RID ShaderRD::version_create() {
 	version.valid = false;
 	version.initialize_needed = true;
 	version.variants = nullptr;
+	version.async_compile = nullptr;
 	return version_owner.make_rid(version);
 }
 
@@ -198,6 +199,31 @@ void ShaderRD::_clear_version(Version *p_version) {
 	}
 }
 
+Vector<uint8_t> ShaderRD::_compile_stage(RD::ShaderStage p_stage, const String &p_source, String *r_error) {
+	uint64_t key = hash_djb2_one_64(p_stage, p_source.hash64());
+
+	{
+		MutexLock lock(spir_v_cache_mutex);
+		const SpirVCacheEntry *entry = spir_v_cache.getptr(key);
+		if (entry && entry->source == p_source) {
+			return entry->spir_v;
+		}
+	}
+
+	Vector<uint8_t> spir_v = RD::get_singleton()->shader_compile_from_source(p_stage, p_source, RD::SHADER_LANGUAGE_GLSL, r_error);
+
+	if (spir_v.size()) {
+		SpirVCacheEntry entry;
+		entry.source = p_source;
+		entry.spir_v = spir_v;
+
+		MutexLock lock(spir_v_cache_mutex);
+		spir_v_cache.insert(key, entry);
+	}
+
+	return spir_v;
+}
+
 void ShaderRD::_compile_variant(uint32_t p_variant, Version *p_version) {
 	if (!variants_enabled[p_variant]) {
 		return; //variant is disabled, return
@@ -240,7 +266,7 @@ void ShaderRD::_compile_variant(uint32_t p_variant, Version *p_version) {
 
 		current_source = builder.as_string();
 		RD::ShaderStageData stage;
-		stage.spir_v = RD::get_singleton()->shader_compile_from_source(RD::SHADER_STAGE_VERTEX, current_source, RD::SHADER_LANGUAGE_GLSL, &error);
+		stage.spir_v = _compile_stage(RD::SHADER_STAGE_VERTEX, current_source, &error);
 		if (stage.spir_v.size() == 0) {
 			build_ok = false;
 		} else {
@@ -284,7 +310,7 @@ void ShaderRD::_compile_variant(uint32_t p_variant, Version *p_version) {
 
 		current_source = builder.as_string();
 		RD::ShaderStageData stage;
-		stage.spir_v = RD::get_singleton()->shader_compile_from_source(RD::SHADER_STAGE_FRAGMENT, current_source, RD::SHADER_LANGUAGE_GLSL, &error);
+		stage.spir_v = _compile_stage(RD::SHADER_STAGE_FRAGMENT, current_source, &error);
 		if (stage.spir_v.size() == 0) {
 			build_ok = false;
 		} else {
@@ -324,7 +350,7 @@ void ShaderRD::_compile_variant(uint32_t p_variant, Version *p_version) {
 
 		current_source = builder.as_string();
 		RD::ShaderStageData stage;
-		stage.spir_v = RD::get_singleton()->shader_compile_from_source(RD::SHADER_STAGE_COMPUTE, current_source, RD::SHADER_LANGUAGE_GLSL, &error);
+		stage.spir_v = _compile_stage(RD::SHADER_STAGE_COMPUTE, current_source, &error);
 		if (stage.spir_v.size() == 0) {
 			build_ok = false;
 		} else {
@@ -344,6 +370,10 @@ void ShaderRD::_compile_variant(uint32_t p_variant, Version *p_version) {
 		return;
 	}
 
+	if (!p_version->variants) {
+		return; //background compilation, only fills the SPIR-V cache
+	}
+
 	RID shader = RD::get_singleton()->shader_create(stages);
 	{
 		MutexLock lock(variant_set_mutex);
@@ -534,6 +564,7 @@ void ShaderRD::version_set_code(RID p_version, const String &p_uniforms, const S
 		version->custom_defines.push_back(p_custom_defines[i].utf8());
 	}
 
+	_orphan_async_compile(version); //the snapshot being compiled is stale now
 	version->dirty = true;
 	if (version->initialize_needed) {
 		_compile_version(version);
@@ -555,6 +586,7 @@ void ShaderRD::version_set_compute_code(RID p_version, const String &p_uniforms,
 		version->custom_defines.push_back(p_custom_defines[i].utf8());
 	}
 
+	_orphan_async_compile(version); //the snapshot being compiled is stale now
 	version->dirty = true;
 	if (version->initialize_needed) {
 		_compile_version(version);
@@ -567,15 +599,119 @@ bool ShaderRD::version_is_valid(RID p_version) {
 	ERR_FAIL_COND_V(!version, false);
 
 	if (version->dirty) {
+		if (version->async_compile) {
+			return false; //compiling in the background, see version_is_compiling()
+		}
 		_compile_version(version);
 	}
 
 	return version->valid;
 }
 
+void ShaderRD::_async_thread_func(void *p_ud) {
+	ShaderRD *shader = (ShaderRD *)p_ud;
+
+	while (true) {
+		shader->async_semaphore.wait();
+
+		AsyncCompile *async = nullptr;
+		{
+			MutexLock lock(shader->async_mutex);
+			if (shader->async_exit) {
+				break;
+			}
+			if (shader->async_queue.size() == 0) {
+				continue;
+			}
+			async = shader->async_queue.front()->get();
+			shader->async_queue.pop_front();
+
+			if (async->orphaned) {
+				memdelete(async);
+				continue;
+			}
+		}
+
+		for (int i = 0; i < shader->variant_defines.size(); i++) {
+			shader->_compile_variant(i, &async->version);
+		}
+
+		MutexLock lock(shader->async_mutex);
+		if (async->orphaned) {
+			memdelete(async);
+		} else {
+			async->done = true;
+		}
+	}
+}
+
+void ShaderRD::_orphan_async_compile(Version *p_version) {
+	if (!p_version->async_compile) {
+		return;
+	}
+
+	MutexLock lock(async_mutex);
+	if (p_version->async_compile->done) {
+		memdelete(p_version->async_compile);
+	} else {
+		p_version->async_compile->orphaned = true; //deleted by the thread
+	}
+	p_version->async_compile = nullptr;
+}
+
+bool ShaderRD::version_compile_async(RID p_version) {
+	Version *version = version_owner.getornull(p_version);
+	ERR_FAIL_COND_V(!version, false);
+
+	if (!version->dirty) {
+		return false;
+	}
+
+	if (version->async_compile) {
+		return true; //already queued with the current code, setting the code orphans it
+	}
+
+	AsyncCompile *async = memnew(AsyncCompile);
+	async->version = *version;
+	async->version.variants = nullptr;
+	async->version.async_compile = nullptr;
+	version->async_compile = async;
+
+	{
+		MutexLock lock(async_mutex);
+		async_queue.push_back(async);
+	}
+
+	if (!async_thread) {
+		async_thread = Thread::create(_async_thread_func, this);
+	}
+	async_semaphore.post();
+
+	return true;
+}
+
+bool ShaderRD::version_is_compiling(RID p_version) {
+	Version *version = version_owner.getornull(p_version);
+	ERR_FAIL_COND_V(!version, false);
+
+	if (!version->async_compile) {
+		return false;
+	}
+
+	MutexLock lock(async_mutex);
+	if (!version->async_compile->done) {
+		return true;
+	}
+
+	memdelete(version->async_compile);
+	version->async_compile = nullptr;
+	return false;
+}
+
 bool ShaderRD::version_free(RID p_version) {
 	if (version_owner.owns(p_version)) {
 		Version *version = version_owner.getornull(p_version);
+		_orphan_async_compile(version);
 		_clear_version(version);
 		version_owner.free(p_version);
 	} else {
@@ -606,6 +742,8 @@ void ShaderRD::initialize(const Vector<String> &p_variant_defines, const String
 		variant_defines.push_back(p_variant_defines[i].utf8());
 		variants_enabled.push_back(true);
 	}
+
+	spir_v_cache.set_capacity(variant_defines.size() * (is_compute ? 1 : 2) * SPIR_V_CACHE_VERSIONS);
 }
 
 ShaderRD::~ShaderRD() {
@@ -618,4 +756,20 @@ ShaderRD::~ShaderRD() {
 			remaining.pop_front();
 		}
 	}
+
+	if (async_thread) {
+		{
+			MutexLock lock(async_mutex);
+			async_exit = true;
+		}
+		async_semaphore.post();
+		Thread::wait_to_finish(async_thread);
+		memdelete(async_thread);
+		async_thread = nullptr;
+	}
+
+	while (async_queue.size()) {
+		memdelete(async_queue.front()->get()); //all orphaned, versions were freed above
+		async_queue.pop_front();
+	}
 }
@@ -32,10 +32,15 @@
 #define SHADER_RD_H
 
 #include "core/os/mutex.h"
+#include "core/os/semaphore.h"
+#include "core/os/thread.h"
 #include "core/templates/hash_map.h"
+#include "core/templates/list.h"
+#include "core/templates/lru.h"
 #include "core/templates/map.h"
 #include "core/templates/rid_owner.h"
 #include "core/variant/variant.h"
+#include "servers/rendering/rendering_device.h"
 #include "servers/rendering_server.h"
 
 #include <stdio.h>
@@ -49,6 +54,8 @@ class ShaderRD {
 	Vector<CharString> variant_defines;
 	Vector<bool> variants_enabled;
 
+	struct AsyncCompile;
+
 	struct Version {
 		CharString uniforms;
 		CharString vertex_globals;
@@ -61,6 +68,7 @@ class ShaderRD {
 		Vector<CharString> custom_defines;
 
 		RID *variants; //same size as version defines
+		AsyncCompile *async_compile; //pending background compilation, if any
 
 		bool valid;
 		bool dirty;
@@ -69,6 +77,40 @@ class ShaderRD {
 
 	Mutex variant_set_mutex;
 
+	// SPIR-V is cached by the hash of the full stage source, so recompiling
+	// a version with the same code (or code compiled in the background) only
+	// has to create the shaders. The source is kept to rule out hash collisions.
+	struct SpirVCacheEntry {
+		String source;
+		Vector<uint8_t> spir_v;
+	};
+
+	enum {
+		SPIR_V_CACHE_VERSIONS = 16, //cache size, in full versions
+	};
+
+	LRUCache<uint64_t, SpirVCacheEntry> spir_v_cache;
+	Mutex spir_v_cache_mutex;
+
+	Vector<uint8_t> _compile_stage(RD::ShaderStage p_stage, const String &p_source, String *r_error);
+
+	// Versions queued with version_compile_async() are compiled to SPIR-V
+	// from a snapshot of their code in a background thread, filling the cache.
+	struct AsyncCompile {
+		Version version; //code snapshot, variants is always null
+		bool done = false;
+		bool orphaned = false; //version was freed or its code changed, the compile result is discarded
+	};
+
+	List<AsyncCompile *> async_queue;
+	Mutex async_mutex;
+	Semaphore async_semaphore;
+	Thread *async_thread = nullptr;
+	bool async_exit = false;
+
+	static void _async_thread_func(void *p_ud);
+	void _orphan_async_compile(Version *p_version);
+
 	void _compile_variant(uint32_t p_variant, Version *p_version);
 
 	void _clear_version(Version *p_version);
@@ -117,6 +159,9 @@ public:
 		ERR_FAIL_COND_V(!version, RID());
 
 		if (version->dirty) {
+			if (version->async_compile) {
+				return RID(); //compiling in the background, see version_is_compiling()
+			}
 			_compile_version(version);
 		}
 
@@ -129,6 +174,12 @@ public:
 
 	bool version_is_valid(RID p_version);
 
+	// Queues the compilation of a dirty version in the background. Returns false if there is nothing to compile.
+	// Poll version_is_compiling() and, once it returns false, version_is_valid() creates the shaders from the cache.
+	// Until then the version is invalid, version_is_valid() and version_get_shader() don't compile it on the calling thread.
+	bool version_compile_async(RID p_version);
+	bool version_is_compiling(RID p_version);
+
 	bool version_free(RID p_version);
 
 	void set_variant_enabled(int p_variant, bool p_enabled);
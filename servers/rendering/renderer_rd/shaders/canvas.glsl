@@ -26,6 +26,9 @@ layout(location = 3) out vec2 pixel_size_interp;
 
 #endif
 
+//world basis of the drawn rect, batched rects don't share the one in draw_data
+layout(location = 4) flat out vec4 world_basis_interp;
+
 #ifdef USE_MATERIAL_UNIFORMS
 layout(set = 1, binding = 0, std140) uniform MaterialUniforms{
 	/* clang-format off */
@@ -40,6 +43,9 @@ VERTEX_SHADER_GLOBALS
 
 void main() {
 	vec4 instance_custom = vec4(0.0);
+	vec2 world_x = draw_data.world_x;
+	vec2 world_y = draw_data.world_y;
+	vec2 world_ofs = draw_data.world_ofs;
 #ifdef USE_PRIMITIVE
 
 	//weird bug,
@@ -77,14 +83,30 @@ void main() {
 	vec2 vertex_base_arr[4] = vec2[](vec2(0.0, 0.0), vec2(0.0, 1.0), vec2(1.0, 1.0), vec2(1.0, 0.0));
 	vec2 vertex_base = vertex_base_arr[gl_VertexIndex];
 
-	vec2 uv = draw_data.src_rect.xy + abs(draw_data.src_rect.zw) * ((draw_data.flags & FLAGS_TRANSPOSE_RECT) != 0 ? vertex_base.yx : vertex_base.xy);
+	vec4 src_rect = draw_data.src_rect;
+	vec4 dst_rect = draw_data.dst_rect;
 	vec4 color = draw_data.modulation;
-	vec2 vertex = draw_data.dst_rect.xy + abs(draw_data.dst_rect.zw) * mix(vertex_base, vec2(1.0, 1.0) - vertex_base, lessThan(draw_data.src_rect.zw, vec2(0.0, 0.0)));
+
+	if (bool(draw_data.flags & FLAGS_USING_BATCH)) {
+		uint instance = draw_data.batch_offset + uint(gl_InstanceIndex);
+		world_x = batch_instances.data[instance].world_x;
+		world_y = batch_instances.data[instance].world_y;
+		world_ofs = batch_instances.data[instance].world_ofs;
+		color = batch_instances.data[instance].modulation;
+		dst_rect = batch_instances.data[instance].dst_rect;
+		src_rect = batch_instances.data[instance].src_rect;
+		if (bool(batch_instances.data[instance].flags & BATCH_INSTANCE_FLAGS_REGION_IN_PIXELS)) {
+			src_rect *= draw_data.color_texture_pixel_size.xyxy;
+		}
+	}
+
+	vec2 uv = src_rect.xy + abs(src_rect.zw) * ((draw_data.flags & FLAGS_TRANSPOSE_RECT) != 0 ? vertex_base.yx : vertex_base.xy);
+	vec2 vertex = dst_rect.xy + abs(dst_rect.zw) * mix(vertex_base, vec2(1.0, 1.0) - vertex_base, lessThan(src_rect.zw, vec2(0.0, 0.0)));
 	uvec4 bones = uvec4(0, 0, 0, 0);
 
 #endif
 
-	mat4 world_matrix = mat4(vec4(draw_data.world_x, 0.0, 0.0), vec4(draw_data.world_y, 0.0, 0.0), vec4(0.0, 0.0, 1.0, 0.0), vec4(draw_data.world_ofs, 0.0, 1.0));
+	mat4 world_matrix = mat4(vec4(world_x, 0.0, 0.0), vec4(world_y, 0.0, 0.0), vec4(0.0, 0.0, 1.0, 0.0), vec4(world_ofs, 0.0, 1.0));
 
 #if 0
 	if (draw_data.flags & FLAGS_INSTANCING_ENABLED) {
@@ -200,6 +222,7 @@ VERTEX_SHADER_CODE
 
 	vertex_interp = vertex;
 	uv_interp = uv;
+	world_basis_interp = vec4(world_x, world_y);
 
 	gl_Position = canvas_data.screen_transform * vec4(vertex, 0.0, 1.0);
 
@@ -226,6 +249,8 @@ layout(location = 3) in vec2 pixel_size_interp;
 
 #endif
 
+layout(location = 4) flat in vec4 world_basis_interp;
+
 layout(location = 0) out vec4 frag_color;
 
 #ifdef USE_MATERIAL_UNIFORMS
@@ -517,7 +542,7 @@ FRAGMENT_SHADER_CODE
 
 	if (normal_used) {
 		//convert by item transform
-		normal.xy = mat2(normalize(draw_data.world_x), normalize(draw_data.world_y)) * normal.xy;
+		normal.xy = mat2(normalize(world_basis_interp.xy), normalize(world_basis_interp.zw)) * normal.xy;
 		//convert by canvas transform
 		normal = normalize((canvas_data.canvas_normal_transform * vec4(normal, 0.0)).xyz);
 	}
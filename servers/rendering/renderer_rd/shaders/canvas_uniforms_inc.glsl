@@ -17,6 +17,7 @@
 #define FLAGS_USING_LIGHT_MASK (1 << 11)
 #define FLAGS_NINEPACH_DRAW_CENTER (1 << 12)
 #define FLAGS_USING_PARTICLES (1 << 13)
+#define FLAGS_USING_BATCH (1 << 14)
 
 #define FLAGS_NINEPATCH_H_MODE_SHIFT 16
 #define FLAGS_NINEPATCH_V_MODE_SHIFT 18
@@ -56,7 +57,8 @@ layout(push_constant, binding = 0, std430) uniform DrawData {
 	vec4 ninepatch_margins;
 	vec4 dst_rect; //for built-in rect and UV
 	vec4 src_rect;
-	vec2 pad;
+	uint batch_offset;
+	uint pad;
 
 #endif
 	vec2 color_texture_pixel_size;
@@ -143,6 +145,26 @@ layout(set = 0, binding = 9, std430) restrict readonly buffer GlobalVariableData
 }
 global_variables;
 
+#define BATCH_INSTANCE_FLAGS_REGION_IN_PIXELS (1 << 0)
+
+struct BatchInstance {
+	vec2 world_x;
+	vec2 world_y;
+	vec2 world_ofs;
+	uint flags;
+	uint pad;
+	vec4 modulation;
+	vec4 dst_rect;
+	vec4 src_rect;
+};
+
+// Per rect data of batched draws, indexed by draw_data.batch_offset + gl_InstanceIndex
+
+layout(set = 0, binding = 10, std430) restrict readonly buffer BatchInstances {
+	BatchInstance data[];
+}
+batch_instances;
+
 /* SET1: Is reserved for the material */
 
 //
@@ -48,6 +48,9 @@ public:
 	virtual void camera_set_use_vertical_aspect(RID p_camera, bool p_enable) = 0;
 	virtual bool is_camera(RID p_camera) const = 0;
 
+	virtual RID occluder_create() = 0;
+	virtual void occluder_set_mesh(RID p_occluder, const PackedVector3Array &p_vertices, const PackedInt32Array &p_indices) = 0;
+
 	virtual RID scenario_create() = 0;
 
 	virtual void scenario_set_debug(RID p_scenario, RS::ScenarioDebugMode p_debug_mode) = 0;
@@ -195,6 +198,9 @@ public:
 	virtual void render_camera(RID p_render_buffers, Ref<XRInterface> &p_interface, XRInterface::Eyes p_eye, RID p_camera, RID p_scenario, Size2 p_viewport_size, float p_lod_threshold, RID p_shadow_atlas) = 0;
 
 	virtual void update() = 0;
+	virtual uint32_t get_dirty_instances_in_frame() const = 0;
+	virtual uint32_t get_shadow_passes_in_frame() const = 0;
+	virtual uint64_t get_shadow_cull_usec_in_frame() const = 0;
 	virtual void render_probes() = 0;
 
 	virtual bool free(RID p_rid) = 0;
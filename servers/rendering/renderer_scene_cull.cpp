@@ -31,6 +31,7 @@
 #include "renderer_scene_cull.h"
 
 #include "core/config/project_settings.h"
+#include "core/os/frame_arena.h"
 #include "core/os/os.h"
 #include "rendering_server_default.h"
 #include "rendering_server_globals.h"
@@ -107,6 +108,40 @@ bool RendererSceneCull::is_camera(RID p_camera) const {
 	return camera_owner.owns(p_camera);
 }
 
+/* OCCLUDER API */
+
+RID RendererSceneCull::occluder_create() {
+	Occluder *occluder = memnew(Occluder);
+	return occluder_owner.make_rid(occluder);
+}
+
+void RendererSceneCull::occluder_set_mesh(RID p_occluder, const PackedVector3Array &p_vertices, const PackedInt32Array &p_indices) {
+	Occluder *occluder = occluder_owner.getornull(p_occluder);
+	ERR_FAIL_COND(!occluder);
+	ERR_FAIL_COND_MSG(p_indices.size() % 3 != 0, "Occluder indices must be a multiple of 3.");
+
+	int vertex_count = p_vertices.size();
+	const int32_t *indices = p_indices.ptr();
+	for (int i = 0; i < p_indices.size(); i++) {
+		ERR_FAIL_INDEX_MSG(indices[i], vertex_count, "Occluder index out of range of the vertices.");
+	}
+
+	occluder->vertices = p_vertices;
+	occluder->indices = p_indices;
+
+	occluder->aabb = AABB();
+	const Vector3 *vertices = p_vertices.ptr();
+	for (int i = 0; i < vertex_count; i++) {
+		if (i == 0) {
+			occluder->aabb.position = vertices[i];
+		} else {
+			occluder->aabb.expand_to(vertices[i]);
+		}
+	}
+
+	occluder->dependency.changed_notify(RendererStorage::DEPENDENCY_CHANGED_AABB);
+}
+
 /* SCENARIO API */
 
 void RendererSceneCull::_instance_pair(Instance *p_A, Instance *p_B) {
@@ -475,6 +510,13 @@ void RendererSceneCull::instance_set_base(RID p_instance, RID p_base) {
 				}
 				scene_render->free(lightmap_data->instance);
 			} break;
+			case RS::INSTANCE_OCCLUDER: {
+				InstanceOccluderData *occluder = static_cast<InstanceOccluderData *>(instance->base_data);
+				if (scenario && occluder->O) {
+					scenario->occluders.erase(occluder->O);
+					occluder->O = nullptr;
+				}
+			} break;
 			case RS::INSTANCE_GI_PROBE: {
 				InstanceGIProbeData *gi_probe = static_cast<InstanceGIProbeData *>(instance->base_data);
 #ifdef DEBUG_ENABLED
@@ -510,7 +552,11 @@ void RendererSceneCull::instance_set_base(RID p_instance, RID p_base) {
 	instance->base = RID();
 
 	if (p_base.is_valid()) {
-		instance->base_type = RSG::storage->get_base_type(p_base);
+		if (occluder_owner.owns(p_base)) {
+			instance->base_type = RS::INSTANCE_OCCLUDER;
+		} else {
+			instance->base_type = RSG::storage->get_base_type(p_base);
+		}
 		ERR_FAIL_COND(instance->base_type == RS::INSTANCE_NONE);
 
 		switch (instance->base_type) {
@@ -585,6 +631,14 @@ void RendererSceneCull::instance_set_base(RID p_instance, RID p_base) {
 				gi_probe->probe_instance = scene_render->gi_probe_instance_create(p_base);
 
 			} break;
+			case RS::INSTANCE_OCCLUDER: {
+				InstanceOccluderData *occluder = memnew(InstanceOccluderData);
+				instance->base_data = occluder;
+
+				if (scenario) {
+					occluder->O = scenario->occluders.push_back(instance);
+				}
+			} break;
 			default: {
 			}
 		}
@@ -596,7 +650,7 @@ void RendererSceneCull::instance_set_base(RID p_instance, RID p_base) {
 		}
 
 		//forcefully update the dependency now, so if for some reason it gets removed, we can immediately clear it
-		RSG::storage->base_update_dependency(p_base, &instance->dependency_tracker);
+		_instance_base_update_dependency(instance);
 	}
 
 	_instance_queue_update(instance, true, true);
@@ -652,6 +706,13 @@ void RendererSceneCull::instance_set_scenario(RID p_instance, RID p_scenario) {
 					gi_probe_update_list.remove(&gi_probe->update_element);
 				}
 			} break;
+			case RS::INSTANCE_OCCLUDER: {
+				InstanceOccluderData *occluder = static_cast<InstanceOccluderData *>(instance->base_data);
+				if (occluder->O) {
+					instance->scenario->occluders.erase(occluder->O);
+					occluder->O = nullptr;
+				}
+			} break;
 			default: {
 			}
 		}
@@ -681,6 +742,10 @@ void RendererSceneCull::instance_set_scenario(RID p_instance, RID p_scenario) {
 					gi_probe_update_list.add(&gi_probe->update_element);
 				}
 			} break;
+			case RS::INSTANCE_OCCLUDER: {
+				InstanceOccluderData *occluder = static_cast<InstanceOccluderData *>(instance->base_data);
+				occluder->O = scenario->occluders.push_back(instance);
+			} break;
 			default: {
 			}
 		}
@@ -1043,10 +1108,81 @@ void RendererSceneCull::instance_geometry_set_material_override(RID p_instance,
 	}
 }
 
+void RendererSceneCull::_instance_update_draw_range_flag(Instance *p_instance) {
+	if (!p_instance->scenario || p_instance->array_index < 0) {
+		return;
+	}
+
+	InstanceData &idata = p_instance->scenario->instance_data[p_instance->array_index];
+
+	if (p_instance->lod_begin > 0 || p_instance->lod_end > 0) {
+		idata.flags |= InstanceData::FLAG_USES_DRAW_RANGE;
+	} else {
+		idata.flags &= ~uint32_t(InstanceData::FLAG_USES_DRAW_RANGE);
+	}
+}
+
+uint32_t RendererSceneCull::_scenario_get_draw_range_view(Scenario *p_scenario, RID p_owner) {
+	uint64_t frame = RSG::rasterizer->get_frame_number();
+
+	uint32_t oldest = 0;
+	for (uint32_t i = 0; i < p_scenario->draw_range_views.size(); i++) {
+		Scenario::DrawRangeView &view = p_scenario->draw_range_views[i];
+		if (view.owner == p_owner) {
+			view.last_frame = frame;
+			return 1u << i;
+		}
+		if (view.last_frame < p_scenario->draw_range_views[oldest].last_frame) {
+			oldest = i;
+		}
+	}
+
+	Scenario::DrawRangeView view;
+	view.owner = p_owner;
+	view.last_frame = frame;
+
+	if (p_scenario->draw_range_views.size() < Scenario::MAX_DRAW_RANGE_VIEWS) {
+		p_scenario->draw_range_views.push_back(view);
+		return 1u << (p_scenario->draw_range_views.size() - 1);
+	}
+
+	//take over the least recently used one, its state only decides the margins for a frame
+	p_scenario->draw_range_views[oldest] = view;
+	return 1u << oldest;
+}
+
 void RendererSceneCull::instance_geometry_set_draw_range(RID p_instance, float p_min, float p_max, float p_min_margin, float p_max_margin) {
+	Instance *instance = instance_owner.getornull(p_instance);
+	ERR_FAIL_COND(!instance);
+
+	instance->lod_begin = MAX(p_min, 0);
+	instance->lod_end = MAX(p_max, 0);
+	instance->lod_begin_hysteresis = p_min_margin;
+	instance->lod_end_hysteresis = p_max_margin;
+
+	_instance_update_draw_range_flag(instance);
 }
 
 void RendererSceneCull::instance_geometry_set_as_instance_lod(RID p_instance, RID p_as_lod_of_instance) {
+	Instance *instance = instance_owner.getornull(p_instance);
+	ERR_FAIL_COND(!instance);
+
+	Instance *lod_parent = nullptr;
+	if (p_as_lod_of_instance.is_valid()) {
+		lod_parent = instance_owner.getornull(p_as_lod_of_instance);
+		ERR_FAIL_COND(!lod_parent);
+		ERR_FAIL_COND_MSG(lod_parent == instance, "An instance can't be a LOD of itself.");
+	}
+
+	if (instance->lod_parent) {
+		instance->lod_parent->lod_children.erase(instance);
+	}
+
+	instance->lod_parent = lod_parent;
+
+	if (lod_parent) {
+		lod_parent->lod_children.insert(instance);
+	}
 }
 
 void RendererSceneCull::instance_geometry_set_lightmap(RID p_instance, RID p_lightmap, const Rect2 &p_lightmap_uv_scale, int p_slice_index) {
@@ -1149,6 +1285,41 @@ void RendererSceneCull::instance_geometry_get_shader_parameter_list(RID p_instan
 	}
 }
 
+void RendererSceneCull::_update_instance_bounds(Instance *p_instance) {
+	if (p_instance->update_aabb) {
+		_update_instance_aabb(p_instance);
+		p_instance->update_aabb = false;
+	}
+
+	if (p_instance->aabb.has_no_surface()) {
+		return;
+	}
+
+	p_instance->transformed_aabb = p_instance->transform.xform(p_instance->aabb);
+
+	//quantize to improve moving object performance
+	AABB bvh_aabb = p_instance->transformed_aabb;
+
+	if (p_instance->indexer_id.is_valid() && bvh_aabb != p_instance->prev_transformed_aabb) {
+		//assume motion, see if bounds need to be quantized
+		AABB motion_aabb = bvh_aabb.merge(p_instance->prev_transformed_aabb);
+		float motion_longest_axis = motion_aabb.get_longest_axis_size();
+		float longest_axis = p_instance->transformed_aabb.get_longest_axis_size();
+
+		if (motion_longest_axis < longest_axis * 2) {
+			//moved but not a lot, use motion aabb quantizing
+			float quantize_size = Math::pow(2.0, Math::ceil(Math::log(motion_longest_axis) / Math::log(2.0))) * 0.5; //one fifth
+			bvh_aabb.quantize(quantize_size);
+		}
+	}
+
+	p_instance->bvh_aabb = bvh_aabb;
+}
+
+void RendererSceneCull::_update_instance_bounds_threaded(uint32_t p_index, void *p_userdata) {
+	_update_instance_bounds(dirty_instance_batch[p_index]);
+}
+
 void RendererSceneCull::_update_instance(Instance *p_instance) {
 	p_instance->version++;
 
@@ -1224,10 +1395,6 @@ void RendererSceneCull::_update_instance(Instance *p_instance) {
 		}
 	}
 
-	AABB new_aabb;
-	new_aabb = p_instance->transform.xform(p_instance->aabb);
-	p_instance->transformed_aabb = new_aabb;
-
 	if ((1 << p_instance->base_type) & RS::INSTANCE_GEOMETRY_MASK) {
 		InstanceGeometryData *geom = static_cast<InstanceGeometryData *>(p_instance->base_data);
 		//make sure lights are updated if it casts shadow
@@ -1259,21 +1426,7 @@ void RendererSceneCull::_update_instance(Instance *p_instance) {
 		return;
 	}
 
-	//quantize to improve moving object performance
-	AABB bvh_aabb = p_instance->transformed_aabb;
-
-	if (p_instance->indexer_id.is_valid() && bvh_aabb != p_instance->prev_transformed_aabb) {
-		//assume motion, see if bounds need to be quantized
-		AABB motion_aabb = bvh_aabb.merge(p_instance->prev_transformed_aabb);
-		float motion_longest_axis = motion_aabb.get_longest_axis_size();
-		float longest_axis = p_instance->transformed_aabb.get_longest_axis_size();
-
-		if (motion_longest_axis < longest_axis * 2) {
-			//moved but not a lot, use motion aabb quantizing
-			float quantize_size = Math::pow(2.0, Math::ceil(Math::log(motion_longest_axis) / Math::log(2.0))) * 0.5; //one fifth
-			bvh_aabb.quantize(quantize_size);
-		}
-	}
+	const AABB &bvh_aabb = p_instance->bvh_aabb;
 
 	if (!p_instance->indexer_id.is_valid()) {
 		if ((1 << p_instance->base_type) & RS::INSTANCE_GEOMETRY_MASK) {
@@ -1334,6 +1487,9 @@ void RendererSceneCull::_update_instance(Instance *p_instance) {
 		if (p_instance->mesh_instance.is_valid()) {
 			idata.flags |= InstanceData::FLAG_USES_MESH_INSTANCE;
 		}
+		if (p_instance->lod_begin > 0 || p_instance->lod_end > 0) {
+			idata.flags |= InstanceData::FLAG_USES_DRAW_RANGE;
+		}
 
 		p_instance->scenario->instance_data.push_back(idata);
 		p_instance->scenario->instance_aabbs.push_back(InstanceBounds(p_instance->transformed_aabb));
@@ -1503,6 +1659,10 @@ void RendererSceneCull::_update_instance_aabb(Instance *p_instance) {
 		case RenderingServer::INSTANCE_LIGHTMAP: {
 			new_aabb = RSG::storage->lightmap_get_aabb(p_instance->base);
 
+		} break;
+		case RenderingServer::INSTANCE_OCCLUDER: {
+			new_aabb = occluder_owner.getornull(p_instance->base)->aabb;
+
 		} break;
 		default: {
 		}
@@ -1891,13 +2051,11 @@ void RendererSceneCull::_light_instance_setup_directional_shadow(int p_shadow_in
 	}
 }
 
-bool RendererSceneCull::_light_instance_update_shadow(Instance *p_instance, const Transform p_cam_transform, const CameraMatrix &p_cam_projection, bool p_cam_orthogonal, bool p_cam_vaspect, RID p_shadow_atlas, Scenario *p_scenario, float p_screen_lod_threshold) {
-	InstanceLightData *light = static_cast<InstanceLightData *>(p_instance->base_data);
-
+void RendererSceneCull::_light_instance_add_shadow_passes(Instance *p_instance) {
 	Transform light_transform = p_instance->transform;
 	light_transform.orthonormalize(); //scale does not count on lights
 
-	bool animated_material_found = false;
+	real_t radius = RSG::storage->light_get_param(p_instance->base, RS::LIGHT_PARAM_RANGE);
 
 	switch (RSG::storage->light_get_type(p_instance->base)) {
 		case RS::LIGHT_DIRECTIONAL: {
@@ -1907,74 +2065,24 @@ bool RendererSceneCull::_light_instance_update_shadow(Instance *p_instance, cons
 
 			if (shadow_mode == RS::LIGHT_OMNI_SHADOW_DUAL_PARABOLOID || !scene_render->light_instances_can_render_shadow_cube()) {
 				for (int i = 0; i < 2; i++) {
-					//using this one ensures that raster deferred will have it
-					RENDER_TIMESTAMP("Culling Shadow Paraboloid" + itos(i));
-
-					real_t radius = RSG::storage->light_get_param(p_instance->base, RS::LIGHT_PARAM_RANGE);
+					ShadowCullPass *pass = _shadow_cull_pass_add(p_instance, i);
+					pass->transform = light_transform;
+					pass->radius = radius;
 
 					real_t z = i == 0 ? -1 : 1;
-					Vector<Plane> planes;
-					planes.resize(6);
-					planes.write[0] = light_transform.xform(Plane(Vector3(0, 0, z), radius));
-					planes.write[1] = light_transform.xform(Plane(Vector3(1, 0, z).normalized(), radius));
-					planes.write[2] = light_transform.xform(Plane(Vector3(-1, 0, z).normalized(), radius));
-					planes.write[3] = light_transform.xform(Plane(Vector3(0, 1, z).normalized(), radius));
-					planes.write[4] = light_transform.xform(Plane(Vector3(0, -1, z).normalized(), radius));
-					planes.write[5] = light_transform.xform(Plane(Vector3(0, 0, -z), 0));
-
-					geometry_instances_to_shadow_render.clear();
-					instance_shadow_cull_result.clear();
-
-					Vector<Vector3> points = Geometry3D::compute_convex_mesh_points(&planes[0], planes.size());
-
-					struct CullConvex {
-						PagedArray<Instance *> *result;
-						_FORCE_INLINE_ bool operator()(void *p_data) {
-							Instance *p_instance = (Instance *)p_data;
-							result->push_back(p_instance);
-							return false;
-						}
-					};
-
-					CullConvex cull_convex;
-					cull_convex.result = &instance_shadow_cull_result;
-
-					p_scenario->indexers[Scenario::INDEXER_GEOMETRY].convex_query(planes.ptr(), planes.size(), points.ptr(), points.size(), cull_convex);
-
-					Plane near_plane(light_transform.origin, light_transform.basis.get_axis(2) * z);
-
-					for (int j = 0; j < (int)instance_shadow_cull_result.size(); j++) {
-						Instance *instance = instance_shadow_cull_result[j];
-						if (!instance->visible || !((1 << instance->base_type) & RS::INSTANCE_GEOMETRY_MASK) || !static_cast<InstanceGeometryData *>(instance->base_data)->can_cast_shadows) {
-							continue;
-						} else {
-							if (static_cast<InstanceGeometryData *>(instance->base_data)->material_is_animated) {
-								animated_material_found = true;
-							}
-
-							if (instance->mesh_instance.is_valid()) {
-								RSG::storage->mesh_instance_check_for_update(instance->mesh_instance);
-							}
-						}
-
-						geometry_instances_to_shadow_render.push_back(static_cast<InstanceGeometryData *>(instance->base_data)->geometry_instance);
-					}
-
-					RSG::storage->update_mesh_instances();
-
-					scene_render->light_instance_set_shadow_transform(light->instance, CameraMatrix(), light_transform, radius, 0, i, 0);
-					scene_render->render_shadow(light->instance, p_shadow_atlas, i, geometry_instances_to_shadow_render);
+					pass->planes.resize(6);
+					pass->planes.write[0] = light_transform.xform(Plane(Vector3(0, 0, z), radius));
+					pass->planes.write[1] = light_transform.xform(Plane(Vector3(1, 0, z).normalized(), radius));
+					pass->planes.write[2] = light_transform.xform(Plane(Vector3(-1, 0, z).normalized(), radius));
+					pass->planes.write[3] = light_transform.xform(Plane(Vector3(0, 1, z).normalized(), radius));
+					pass->planes.write[4] = light_transform.xform(Plane(Vector3(0, -1, z).normalized(), radius));
+					pass->planes.write[5] = light_transform.xform(Plane(Vector3(0, 0, -z), 0));
 				}
 			} else { //shadow cube
-
-				real_t radius = RSG::storage->light_get_param(p_instance->base, RS::LIGHT_PARAM_RANGE);
 				CameraMatrix cm;
 				cm.set_perspective(90, 1, 0.01, radius);
 
 				for (int i = 0; i < 6; i++) {
-					RENDER_TIMESTAMP("Culling Shadow Cube side" + itos(i));
-					//using this one ensures that raster deferred will have it
-
 					static const Vector3 view_normals[6] = {
 						Vector3(+1, 0, 0),
 						Vector3(-1, 0, 0),
@@ -1992,114 +2100,146 @@ bool RendererSceneCull::_light_instance_update_shadow(Instance *p_instance, cons
 						Vector3(0, -1, 0)
 					};
 
-					Transform xform = light_transform * Transform().looking_at(view_normals[i], view_up[i]);
+					ShadowCullPass *pass = _shadow_cull_pass_add(p_instance, i);
+					pass->projection = cm;
+					pass->transform = light_transform * Transform().looking_at(view_normals[i], view_up[i]);
+					pass->radius = radius;
+					pass->planes = cm.get_projection_planes(pass->transform);
+					//restore the regular DP matrix after the last side
+					pass->restore_dp_transform = i == 5;
+				}
+			}
 
-					Vector<Plane> planes = cm.get_projection_planes(xform);
+		} break;
+		case RS::LIGHT_SPOT: {
+			real_t angle = RSG::storage->light_get_param(p_instance->base, RS::LIGHT_PARAM_SPOT_ANGLE);
 
-					geometry_instances_to_shadow_render.clear();
-					instance_shadow_cull_result.clear();
+			ShadowCullPass *pass = _shadow_cull_pass_add(p_instance, 0);
+			pass->projection.set_perspective(angle * 2.0, 1.0, 0.01, radius);
+			pass->transform = light_transform;
+			pass->radius = radius;
+			pass->planes = pass->projection.get_projection_planes(light_transform);
 
-					Vector<Vector3> points = Geometry3D::compute_convex_mesh_points(&planes[0], planes.size());
+		} break;
+	}
+}
 
-					struct CullConvex {
-						PagedArray<Instance *> *result;
-						_FORCE_INLINE_ bool operator()(void *p_data) {
-							Instance *p_instance = (Instance *)p_data;
-							result->push_back(p_instance);
-							return false;
-						}
-					};
+RendererSceneCull::ShadowCullPass *RendererSceneCull::_shadow_cull_pass_add(Instance *p_light, int p_pass) {
+	if (shadow_cull_pass_count == shadow_cull_passes.size()) {
+		ShadowCullPass *pass = memnew(ShadowCullPass);
+		pass->casters.set_page_pool(&geometry_instance_cull_page_pool);
+		shadow_cull_passes.push_back(pass);
+	}
 
-					CullConvex cull_convex;
-					cull_convex.result = &instance_shadow_cull_result;
+	ShadowCullPass *pass = shadow_cull_passes[shadow_cull_pass_count++];
+	pass->light = p_light;
+	pass->pass = p_pass;
+	pass->projection = CameraMatrix();
+	pass->restore_dp_transform = false;
+	pass->animated_material_found = false;
+	pass->casters.clear();
+	pass->mesh_instances.clear();
+	return pass;
+}
 
-					p_scenario->indexers[Scenario::INDEXER_GEOMETRY].convex_query(planes.ptr(), planes.size(), points.ptr(), points.size(), cull_convex);
+void RendererSceneCull::_shadow_cull_pass(ShadowCullPass *p_pass) {
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
 
-					Plane near_plane(xform.origin, -xform.basis.get_axis(2));
+	Vector<Vector3> points = Geometry3D::compute_convex_mesh_points(&p_pass->planes[0], p_pass->planes.size());
 
-					for (int j = 0; j < (int)instance_shadow_cull_result.size(); j++) {
-						Instance *instance = instance_shadow_cull_result[j];
-						if (!instance->visible || !((1 << instance->base_type) & RS::INSTANCE_GEOMETRY_MASK) || !static_cast<InstanceGeometryData *>(instance->base_data)->can_cast_shadows) {
-							continue;
-						} else {
-							if (static_cast<InstanceGeometryData *>(instance->base_data)->material_is_animated) {
-								animated_material_found = true;
-							}
-							if (instance->mesh_instance.is_valid()) {
-								RSG::storage->mesh_instance_check_for_update(instance->mesh_instance);
-							}
-						}
+	struct CullConvex {
+		ShadowCullPass *pass;
+		uint32_t draw_range_view;
+		_FORCE_INLINE_ bool operator()(void *p_data) {
+			Instance *instance = (Instance *)p_data;
+			if (!instance->visible || !((1 << instance->base_type) & RS::INSTANCE_GEOMETRY_MASK)) {
+				return false;
+			}
 
-						geometry_instances_to_shadow_render.push_back(static_cast<InstanceGeometryData *>(instance->base_data)->geometry_instance);
-					}
+			InstanceGeometryData *geom = static_cast<InstanceGeometryData *>(instance->base_data);
+			if (!geom->can_cast_shadows) {
+				return false;
+			}
 
-					RSG::storage->update_mesh_instances();
-					scene_render->light_instance_set_shadow_transform(light->instance, cm, xform, radius, 0, i, 0);
-					scene_render->render_shadow(light->instance, p_shadow_atlas, i, geometry_instances_to_shadow_render);
-				}
+			uint32_t flags = instance->scenario->instance_data[instance->array_index].flags;
+			if ((flags & InstanceData::FLAG_USES_DRAW_RANGE) && !(instance->in_draw_range_views & draw_range_view)) {
+				return false; //swapped out by its draw range as seen from the camera
+			}
 
-				//restore the regular DP matrix
-				scene_render->light_instance_set_shadow_transform(light->instance, CameraMatrix(), light_transform, radius, 0, 0, 0);
+			if (geom->material_is_animated) {
+				pass->animated_material_found = true;
 			}
 
-		} break;
-		case RS::LIGHT_SPOT: {
-			RENDER_TIMESTAMP("Culling Spot Light");
+			if (instance->mesh_instance.is_valid()) {
+				//storage is not thread safe, checked for update once all passes are culled
+				pass->mesh_instances.push_back(instance->mesh_instance);
+			}
 
-			real_t radius = RSG::storage->light_get_param(p_instance->base, RS::LIGHT_PARAM_RANGE);
-			real_t angle = RSG::storage->light_get_param(p_instance->base, RS::LIGHT_PARAM_SPOT_ANGLE);
+			pass->casters.push_back(geom->geometry_instance);
+			return false;
+		}
+	};
 
-			CameraMatrix cm;
-			cm.set_perspective(angle * 2.0, 1.0, 0.01, radius);
+	CullConvex cull_convex;
+	cull_convex.pass = p_pass;
+	cull_convex.draw_range_view = shadow_cull_draw_range_view;
 
-			Vector<Plane> planes = cm.get_projection_planes(light_transform);
+	shadow_cull_scenario->indexers[Scenario::INDEXER_GEOMETRY].convex_query(p_pass->planes.ptr(), p_pass->planes.size(), points.ptr(), points.size(), cull_convex);
 
-			geometry_instances_to_shadow_render.clear();
-			instance_shadow_cull_result.clear();
+	p_pass->cull_usec = OS::get_singleton()->get_ticks_usec() - begin;
+}
 
-			Vector<Vector3> points = Geometry3D::compute_convex_mesh_points(&planes[0], planes.size());
+void RendererSceneCull::_shadow_cull_pass_threaded(uint32_t p_index, void *p_userdata) {
+	_shadow_cull_pass(shadow_cull_passes[p_index]);
+}
 
-			struct CullConvex {
-				PagedArray<Instance *> *result;
-				_FORCE_INLINE_ bool operator()(void *p_data) {
-					Instance *p_instance = (Instance *)p_data;
-					result->push_back(p_instance);
-					return false;
-				}
-			};
+void RendererSceneCull::_render_shadow_passes(RID p_shadow_atlas) {
+	if (shadow_cull_pass_count == 0) {
+		return;
+	}
 
-			CullConvex cull_convex;
-			cull_convex.result = &instance_shadow_cull_result;
+	RENDER_TIMESTAMP("Culling Shadows");
 
-			p_scenario->indexers[Scenario::INDEXER_GEOMETRY].convex_query(planes.ptr(), planes.size(), points.ptr(), points.size(), cull_convex);
+	if (shadow_cull_pass_count > 1) {
+		RendererThreadPool::singleton->thread_work_pool.do_work(shadow_cull_pass_count, this, &RendererSceneCull::_shadow_cull_pass_threaded, nullptr);
+	} else {
+		_shadow_cull_pass(shadow_cull_passes[0]);
+	}
 
-			Plane near_plane(light_transform.origin, -light_transform.basis.get_axis(2));
+	for (uint32_t i = 0; i < shadow_cull_pass_count; i++) {
+		const ShadowCullPass *pass = shadow_cull_passes[i];
+		for (uint32_t j = 0; j < pass->mesh_instances.size(); j++) {
+			RSG::storage->mesh_instance_check_for_update(pass->mesh_instances[j]);
+		}
+	}
 
-			for (int j = 0; j < (int)instance_shadow_cull_result.size(); j++) {
-				Instance *instance = instance_shadow_cull_result[j];
-				if (!instance->visible || !((1 << instance->base_type) & RS::INSTANCE_GEOMETRY_MASK) || !static_cast<InstanceGeometryData *>(instance->base_data)->can_cast_shadows) {
-					continue;
-				} else {
-					if (static_cast<InstanceGeometryData *>(instance->base_data)->material_is_animated) {
-						animated_material_found = true;
-					}
+	RSG::storage->update_mesh_instances();
 
-					if (instance->mesh_instance.is_valid()) {
-						RSG::storage->mesh_instance_check_for_update(instance->mesh_instance);
-					}
-				}
-				geometry_instances_to_shadow_render.push_back(static_cast<InstanceGeometryData *>(instance->base_data)->geometry_instance);
-			}
+	for (uint32_t i = 0; i < shadow_cull_pass_count; i++) {
+		ShadowCullPass *pass = shadow_cull_passes[i];
+		InstanceLightData *light = static_cast<InstanceLightData *>(pass->light->base_data);
 
-			RSG::storage->update_mesh_instances();
+		RENDER_TIMESTAMP("Rendering Shadow Pass " + itos(i));
 
-			scene_render->light_instance_set_shadow_transform(light->instance, cm, light_transform, radius, 0, 0, 0);
-			scene_render->render_shadow(light->instance, p_shadow_atlas, 0, geometry_instances_to_shadow_render);
+		if (pass->animated_material_found) {
+			light->shadow_dirty = true;
+		}
 
-		} break;
+		scene_render->light_instance_set_shadow_transform(light->instance, pass->projection, pass->transform, pass->radius, 0, pass->pass, 0);
+		scene_render->render_shadow(light->instance, p_shadow_atlas, pass->pass, pass->casters);
+
+		if (pass->restore_dp_transform) {
+			Transform light_transform = pass->light->transform;
+			light_transform.orthonormalize();
+			scene_render->light_instance_set_shadow_transform(light->instance, CameraMatrix(), light_transform, pass->radius, 0, 0, 0);
+		}
+
+		shadow_cull_usec_updated += pass->cull_usec;
+		pass->casters.clear();
 	}
 
-	return animated_material_found;
+	shadow_passes_updated += shadow_cull_pass_count;
+	shadow_cull_pass_count = 0;
 }
 
 void RendererSceneCull::render_camera(RID p_render_buffers, RID p_camera, RID p_scenario, Size2 p_viewport_size, float p_screen_lod_threshold, RID p_shadow_atlas) {
@@ -2236,6 +2376,23 @@ void RendererSceneCull::render_camera(RID p_render_buffers, Ref<XRInterface> &p_
 	_render_scene(p_render_buffers, cam_transform, camera_matrix, false, environment, camera->effects, p_scenario, p_shadow_atlas, RID(), -1, p_screen_lod_threshold);
 };
 
+bool RendererSceneCull::_instance_is_in_draw_range(const Instance *p_instance, const Vector3 &p_camera_pos, bool p_was_in_range) const {
+	// LODs of another instance measure from it, so the whole group swaps at once.
+	const Instance *reference = p_instance->lod_parent ? p_instance->lod_parent : p_instance;
+	float distance = (reference->transformed_aabb.position + reference->transformed_aabb.size * 0.5).distance_to(p_camera_pos);
+
+	// The margins widen the range of what is drawn and narrow it for what is not, so it does not flicker at the boundary.
+	float margin_sign = p_was_in_range ? -1.0 : 1.0;
+
+	if (p_instance->lod_begin > 0 && distance < p_instance->lod_begin + margin_sign * p_instance->lod_begin_hysteresis) {
+		return false;
+	}
+	if (p_instance->lod_end > 0 && distance >= p_instance->lod_end - margin_sign * p_instance->lod_end_hysteresis) {
+		return false;
+	}
+	return true;
+}
+
 void RendererSceneCull::_frustum_cull_threaded(uint32_t p_thread, FrustumCullData *cull_data) {
 	uint32_t cull_total = cull_data->scenario->instance_data.size();
 	uint32_t total_threads = RendererThreadPool::singleton->thread_work_pool.get_thread_count();
@@ -2257,6 +2414,29 @@ void RendererSceneCull::_frustum_cull(FrustumCullData &cull_data, FrustumCullRes
 	for (uint64_t i = p_from; i < p_to; i++) {
 		bool mesh_visible = false;
 
+		bool in_draw_range = true;
+		if (cull_data.scenario->instance_data[i].flags & InstanceData::FLAG_USES_DRAW_RANGE) {
+			InstanceData &idata = cull_data.scenario->instance_data[i];
+			bool was_in_draw_range = idata.instance->in_draw_range_views & cull_data.draw_range_view;
+			in_draw_range = _instance_is_in_draw_range(idata.instance, cull_data.cam_transform.origin, was_in_draw_range);
+
+			if (in_draw_range != was_in_draw_range) {
+				idata.instance->in_draw_range_views ^= cull_data.draw_range_view;
+
+				//reflection probes render their own shadows every time
+				if ((idata.flags & InstanceData::FLAG_CAST_SHADOWS) && !cull_data.render_reflection_probe) {
+					//positional shadows are cached, redraw the ones it stops or starts casting into
+					InstanceGeometryData *geom = static_cast<InstanceGeometryData *>(idata.instance->base_data);
+					cull_data.cull->lock.lock();
+					for (Set<Instance *>::Element *E = geom->lights.front(); E; E = E->next()) {
+						InstanceLightData *light = static_cast<InstanceLightData *>(E->get()->base_data);
+						light->shadow_dirty = true;
+					}
+					cull_data.cull->lock.unlock();
+				}
+			}
+		}
+
 		if (cull_data.scenario->instance_aabbs[i].in_frustum(cull_data.cull->frustum)) {
 			InstanceData &idata = cull_data.scenario->instance_data[i];
 			uint32_t base_type = idata.flags & InstanceData::FLAG_BASE_TYPE_MASK;
@@ -2304,6 +2484,10 @@ void RendererSceneCull::_frustum_cull(FrustumCullData &cull_data, FrustumCullRes
 
 			} else if (base_type == RS::INSTANCE_LIGHTMAP) {
 				cull_result.gi_probes.push_back(RID::from_uint64(idata.instance_data_rid));
+			} else if (((1 << base_type) & RS::INSTANCE_GEOMETRY_MASK) && !in_draw_range) {
+				//outside of its draw range (e.g. swapped with a HLOD proxy), what replaces it casts the shadows as well
+			} else if (((1 << base_type) & RS::INSTANCE_GEOMETRY_MASK) && !(idata.flags & InstanceData::FLAG_CAST_SHADOWS_ONLY) && cull_data.occlusion_cull && cull_data.occlusion_cull->is_occluded(idata.instance->transformed_aabb)) {
+				//hidden behind occluders, still processed below for shadows and SDFGI
 			} else if (((1 << base_type) & RS::INSTANCE_GEOMETRY_MASK) && !(idata.flags & InstanceData::FLAG_CAST_SHADOWS_ONLY)) {
 				bool keep = true;
 
@@ -2415,7 +2599,7 @@ void RendererSceneCull::_frustum_cull(FrustumCullData &cull_data, FrustumCullRes
 					InstanceData &idata = cull_data.scenario->instance_data[i];
 					uint32_t base_type = idata.flags & InstanceData::FLAG_BASE_TYPE_MASK;
 
-					if (((1 << base_type) & RS::INSTANCE_GEOMETRY_MASK) && idata.flags & InstanceData::FLAG_CAST_SHADOWS) {
+					if (((1 << base_type) & RS::INSTANCE_GEOMETRY_MASK) && idata.flags & InstanceData::FLAG_CAST_SHADOWS && in_draw_range) {
 						cull_result.directional_shadows[j].cascade_geometry_instances[k].push_back(idata.instance_geometry);
 						mesh_visible = true;
 					}
@@ -2437,7 +2621,7 @@ void RendererSceneCull::_frustum_cull(FrustumCullData &cull_data, FrustumCullRes
 							cull_result.sdfgi_cascade_lights[sdfgi_last_light_cascade].push_back(instance_light->instance);
 						}
 					}
-				} else if ((1 << base_type) & RS::INSTANCE_GEOMETRY_MASK) {
+				} else if (((1 << base_type) & RS::INSTANCE_GEOMETRY_MASK) && in_draw_range) {
 					if (idata.flags & InstanceData::FLAG_USES_BAKED_LIGHT) {
 						cull_result.sdfgi_region_geometry_instances[j].push_back(idata.instance_geometry);
 						mesh_visible = true;
@@ -2460,6 +2644,7 @@ void RendererSceneCull::_prepare_scene(const Transform p_cam_transform, const Ca
 	Instance *render_reflection_probe = instance_owner.getornull(p_reflection_probe); //if null, not rendering to it
 
 	Scenario *scenario = scenario_owner.getornull(p_scenario);
+	uint32_t draw_range_view = _scenario_get_draw_range_view(scenario, render_reflection_probe ? p_reflection_probe : p_render_buffers);
 
 	render_pass++;
 
@@ -2481,12 +2666,13 @@ void RendererSceneCull::_prepare_scene(const Transform p_cam_transform, const Ca
 
 	cull.frustum = Frustum(planes);
 
+	FrameArenaScope frame_arena_scope;
 	Vector<RID> directional_lights;
 	// directional lights
 	{
 		cull.shadow_count = 0;
 
-		Vector<Instance *> lights_with_shadow;
+		LocalVector<Instance *, uint32_t, false, FrameArena> lights_with_shadow;
 
 		for (List<Instance *>::Element *E = scenario->directional_lights.front(); E; E = E->next()) {
 			if (!E->get()->visible) {
@@ -2512,7 +2698,7 @@ void RendererSceneCull::_prepare_scene(const Transform p_cam_transform, const Ca
 
 		scene_render->set_directional_shadow_count(lights_with_shadow.size());
 
-		for (int i = 0; i < lights_with_shadow.size(); i++) {
+		for (uint32_t i = 0; i < lights_with_shadow.size(); i++) {
 			_light_instance_setup_directional_shadow(i, lights_with_shadow[i], p_cam_transform, p_cam_projection, p_cam_orthogonal, p_cam_vaspect);
 		}
 	}
@@ -2544,6 +2730,31 @@ void RendererSceneCull::_prepare_scene(const Transform p_cam_transform, const Ca
 
 	frustum_cull_result.clear();
 
+	bool use_occlusion_cull = false;
+	if (use_occlusion_culling && !render_reflection_probe && !scenario->occluders.is_empty()) {
+		RENDER_TIMESTAMP("Occlusion Culling");
+
+		int buffer_height = MAX(int(occlusion_buffer_width / p_cam_projection.get_aspect()), 1);
+		occlusion_cull.set_size(Size2i(occlusion_buffer_width, buffer_height));
+		occlusion_cull.begin(p_cam_transform, p_cam_projection);
+
+		for (List<Instance *>::Element *E = scenario->occluders.front(); E; E = E->next()) {
+			Instance *instance = E->get();
+			if (!instance->visible || !instance->indexer_id.is_valid() || !(instance->layer_mask & p_visible_layers)) {
+				continue;
+			}
+			if (!scenario->instance_aabbs[instance->array_index].in_frustum(cull.frustum)) {
+				continue;
+			}
+
+			Occluder *occluder = occluder_owner.getornull(instance->base);
+			occlusion_cull.add_occluder(occluder->vertices, occluder->indices, instance->transform);
+		}
+
+		occlusion_cull.rasterize(&RendererThreadPool::singleton->thread_work_pool);
+		use_occlusion_cull = occlusion_cull.get_triangle_count() > 0;
+	}
+
 	{
 		uint64_t cull_from = 0;
 		uint64_t cull_to = scenario->instance_data.size();
@@ -2557,6 +2768,8 @@ void RendererSceneCull::_prepare_scene(const Transform p_cam_transform, const Ca
 		cull_data.cam_transform = p_cam_transform;
 		cull_data.visible_layers = p_visible_layers;
 		cull_data.render_reflection_probe = render_reflection_probe;
+		cull_data.draw_range_view = draw_range_view;
+		cull_data.occlusion_cull = use_occlusion_cull ? &occlusion_cull : nullptr;
 //#define DEBUG_CULL_TIME
 #ifdef DEBUG_CULL_TIME
 		uint64_t time_from = OS::get_singleton()->get_ticks_usec();
@@ -2739,12 +2952,15 @@ void RendererSceneCull::_prepare_scene(const Transform p_cam_transform, const Ca
 			bool redraw = scene_render->shadow_atlas_update_light(p_shadow_atlas, light->instance, coverage, light->last_version);
 
 			if (redraw) {
-				//must redraw!
-				RENDER_TIMESTAMP(">Rendering Light " + itos(i));
-				light->shadow_dirty = _light_instance_update_shadow(ins, p_cam_transform, p_cam_projection, p_cam_orthogonal, p_cam_vaspect, p_shadow_atlas, scenario, p_screen_lod_threshold);
-				RENDER_TIMESTAMP("<Rendering Light " + itos(i));
+				//must redraw! culled for all lights at once below
+				light->shadow_dirty = false;
+				_light_instance_add_shadow_passes(ins);
 			}
 		}
+
+		shadow_cull_scenario = scenario;
+		shadow_cull_draw_range_view = draw_range_view;
+		_render_shadow_passes(p_shadow_atlas);
 	}
 
 	//append the directional lights to the lights culled
@@ -3180,227 +3396,274 @@ void RendererSceneCull::_update_instance_shader_parameters_from_material(Map<Str
 	}
 }
 
-void RendererSceneCull::_update_dirty_instance(Instance *p_instance) {
-	if (p_instance->update_aabb) {
-		_update_instance_aabb(p_instance);
+void RendererSceneCull::_instance_base_update_dependency(Instance *p_instance) {
+	if (p_instance->base_type == RS::INSTANCE_OCCLUDER) {
+		//occluders are owned by the scene, not the storage
+		Occluder *occluder = occluder_owner.getornull(p_instance->base);
+		p_instance->dependency_tracker.update_dependency(&occluder->dependency);
+	} else {
+		RSG::storage->base_update_dependency(p_instance->base, &p_instance->dependency_tracker);
 	}
+}
 
-	if (p_instance->update_dependencies) {
-		p_instance->dependency_tracker.update_begin();
+void RendererSceneCull::_update_instance_dependencies(Instance *p_instance) {
+	p_instance->update_dependencies = false;
 
-		if (p_instance->base.is_valid()) {
-			RSG::storage->base_update_dependency(p_instance->base, &p_instance->dependency_tracker);
-		}
+	p_instance->dependency_tracker.update_begin();
 
-		if (p_instance->material_override.is_valid()) {
-			RSG::storage->material_update_dependency(p_instance->material_override, &p_instance->dependency_tracker);
-		}
+	if (p_instance->base.is_valid()) {
+		_instance_base_update_dependency(p_instance);
+	}
+
+	if (p_instance->material_override.is_valid()) {
+		RSG::storage->material_update_dependency(p_instance->material_override, &p_instance->dependency_tracker);
+	}
 
-		if (p_instance->base_type == RS::INSTANCE_MESH) {
-			//remove materials no longer used and un-own them
+	if (p_instance->base_type == RS::INSTANCE_MESH) {
+		//remove materials no longer used and un-own them
 
-			int new_mat_count = RSG::storage->mesh_get_surface_count(p_instance->base);
-			p_instance->materials.resize(new_mat_count);
+		int new_mat_count = RSG::storage->mesh_get_surface_count(p_instance->base);
+		p_instance->materials.resize(new_mat_count);
 
-			_instance_update_mesh_instance(p_instance);
-		}
+		_instance_update_mesh_instance(p_instance);
+	}
 
-		if ((1 << p_instance->base_type) & RS::INSTANCE_GEOMETRY_MASK) {
-			InstanceGeometryData *geom = static_cast<InstanceGeometryData *>(p_instance->base_data);
+	if ((1 << p_instance->base_type) & RS::INSTANCE_GEOMETRY_MASK) {
+		InstanceGeometryData *geom = static_cast<InstanceGeometryData *>(p_instance->base_data);
+
+		bool can_cast_shadows = true;
+		bool is_animated = false;
+		Map<StringName, Instance::InstanceShaderParameter> isparams;
 
-			bool can_cast_shadows = true;
-			bool is_animated = false;
-			Map<StringName, Instance::InstanceShaderParameter> isparams;
+		if (p_instance->cast_shadows == RS::SHADOW_CASTING_SETTING_OFF) {
+			can_cast_shadows = false;
+		}
 
-			if (p_instance->cast_shadows == RS::SHADOW_CASTING_SETTING_OFF) {
+		if (p_instance->material_override.is_valid()) {
+			if (!RSG::storage->material_casts_shadows(p_instance->material_override)) {
 				can_cast_shadows = false;
 			}
+			is_animated = RSG::storage->material_is_animated(p_instance->material_override);
+			_update_instance_shader_parameters_from_material(isparams, p_instance->instance_shader_parameters, p_instance->material_override);
+		} else {
+			if (p_instance->base_type == RS::INSTANCE_MESH) {
+				RID mesh = p_instance->base;
 
-			if (p_instance->material_override.is_valid()) {
-				if (!RSG::storage->material_casts_shadows(p_instance->material_override)) {
-					can_cast_shadows = false;
-				}
-				is_animated = RSG::storage->material_is_animated(p_instance->material_override);
-				_update_instance_shader_parameters_from_material(isparams, p_instance->instance_shader_parameters, p_instance->material_override);
-			} else {
-				if (p_instance->base_type == RS::INSTANCE_MESH) {
-					RID mesh = p_instance->base;
-
-					if (mesh.is_valid()) {
-						bool cast_shadows = false;
+				if (mesh.is_valid()) {
+					bool cast_shadows = false;
 
-						for (int i = 0; i < p_instance->materials.size(); i++) {
-							RID mat = p_instance->materials[i].is_valid() ? p_instance->materials[i] : RSG::storage->mesh_surface_get_material(mesh, i);
+					for (int i = 0; i < p_instance->materials.size(); i++) {
+						RID mat = p_instance->materials[i].is_valid() ? p_instance->materials[i] : RSG::storage->mesh_surface_get_material(mesh, i);
 
-							if (!mat.is_valid()) {
+						if (!mat.is_valid()) {
+							cast_shadows = true;
+						} else {
+							if (RSG::storage->material_casts_shadows(mat)) {
 								cast_shadows = true;
-							} else {
-								if (RSG::storage->material_casts_shadows(mat)) {
-									cast_shadows = true;
-								}
-
-								if (RSG::storage->material_is_animated(mat)) {
-									is_animated = true;
-								}
-
-								_update_instance_shader_parameters_from_material(isparams, p_instance->instance_shader_parameters, mat);
+							}
 
-								RSG::storage->material_update_dependency(mat, &p_instance->dependency_tracker);
+							if (RSG::storage->material_is_animated(mat)) {
+								is_animated = true;
 							}
-						}
 
-						if (!cast_shadows) {
-							can_cast_shadows = false;
+							_update_instance_shader_parameters_from_material(isparams, p_instance->instance_shader_parameters, mat);
+
+							RSG::storage->material_update_dependency(mat, &p_instance->dependency_tracker);
 						}
 					}
 
-				} else if (p_instance->base_type == RS::INSTANCE_MULTIMESH) {
-					RID mesh = RSG::storage->multimesh_get_mesh(p_instance->base);
-					if (mesh.is_valid()) {
-						bool cast_shadows = false;
-
-						int sc = RSG::storage->mesh_get_surface_count(mesh);
-						for (int i = 0; i < sc; i++) {
-							RID mat = RSG::storage->mesh_surface_get_material(mesh, i);
+					if (!cast_shadows) {
+						can_cast_shadows = false;
+					}
+				}
 
-							if (!mat.is_valid()) {
-								cast_shadows = true;
+			} else if (p_instance->base_type == RS::INSTANCE_MULTIMESH) {
+				RID mesh = RSG::storage->multimesh_get_mesh(p_instance->base);
+				if (mesh.is_valid()) {
+					bool cast_shadows = false;
 
-							} else {
-								if (RSG::storage->material_casts_shadows(mat)) {
-									cast_shadows = true;
-								}
-								if (RSG::storage->material_is_animated(mat)) {
-									is_animated = true;
-								}
+					int sc = RSG::storage->mesh_get_surface_count(mesh);
+					for (int i = 0; i < sc; i++) {
+						RID mat = RSG::storage->mesh_surface_get_material(mesh, i);
 
-								_update_instance_shader_parameters_from_material(isparams, p_instance->instance_shader_parameters, mat);
+						if (!mat.is_valid()) {
+							cast_shadows = true;
 
-								RSG::storage->material_update_dependency(mat, &p_instance->dependency_tracker);
+						} else {
+							if (RSG::storage->material_casts_shadows(mat)) {
+								cast_shadows = true;
+							}
+							if (RSG::storage->material_is_animated(mat)) {
+								is_animated = true;
 							}
-						}
 
-						if (!cast_shadows) {
-							can_cast_shadows = false;
-						}
+							_update_instance_shader_parameters_from_material(isparams, p_instance->instance_shader_parameters, mat);
 
-						RSG::storage->base_update_dependency(mesh, &p_instance->dependency_tracker);
+							RSG::storage->material_update_dependency(mat, &p_instance->dependency_tracker);
+						}
 					}
-				} else if (p_instance->base_type == RS::INSTANCE_IMMEDIATE) {
-					RID mat = RSG::storage->immediate_get_material(p_instance->base);
 
-					if (!(!mat.is_valid() || RSG::storage->material_casts_shadows(mat))) {
+					if (!cast_shadows) {
 						can_cast_shadows = false;
 					}
 
-					if (mat.is_valid() && RSG::storage->material_is_animated(mat)) {
-						is_animated = true;
-					}
+					RSG::storage->base_update_dependency(mesh, &p_instance->dependency_tracker);
+				}
+			} else if (p_instance->base_type == RS::INSTANCE_IMMEDIATE) {
+				RID mat = RSG::storage->immediate_get_material(p_instance->base);
 
-					if (mat.is_valid()) {
-						_update_instance_shader_parameters_from_material(isparams, p_instance->instance_shader_parameters, mat);
-					}
+				if (!(!mat.is_valid() || RSG::storage->material_casts_shadows(mat))) {
+					can_cast_shadows = false;
+				}
 
-					if (mat.is_valid()) {
-						RSG::storage->material_update_dependency(mat, &p_instance->dependency_tracker);
-					}
+				if (mat.is_valid() && RSG::storage->material_is_animated(mat)) {
+					is_animated = true;
+				}
 
-				} else if (p_instance->base_type == RS::INSTANCE_PARTICLES) {
-					bool cast_shadows = false;
+				if (mat.is_valid()) {
+					_update_instance_shader_parameters_from_material(isparams, p_instance->instance_shader_parameters, mat);
+				}
 
-					int dp = RSG::storage->particles_get_draw_passes(p_instance->base);
+				if (mat.is_valid()) {
+					RSG::storage->material_update_dependency(mat, &p_instance->dependency_tracker);
+				}
 
-					for (int i = 0; i < dp; i++) {
-						RID mesh = RSG::storage->particles_get_draw_pass_mesh(p_instance->base, i);
-						if (!mesh.is_valid()) {
-							continue;
-						}
+			} else if (p_instance->base_type == RS::INSTANCE_PARTICLES) {
+				bool cast_shadows = false;
 
-						int sc = RSG::storage->mesh_get_surface_count(mesh);
-						for (int j = 0; j < sc; j++) {
-							RID mat = RSG::storage->mesh_surface_get_material(mesh, j);
+				int dp = RSG::storage->particles_get_draw_passes(p_instance->base);
 
-							if (!mat.is_valid()) {
-								cast_shadows = true;
-							} else {
-								if (RSG::storage->material_casts_shadows(mat)) {
-									cast_shadows = true;
-								}
+				for (int i = 0; i < dp; i++) {
+					RID mesh = RSG::storage->particles_get_draw_pass_mesh(p_instance->base, i);
+					if (!mesh.is_valid()) {
+						continue;
+					}
 
-								if (RSG::storage->material_is_animated(mat)) {
-									is_animated = true;
-								}
+					int sc = RSG::storage->mesh_get_surface_count(mesh);
+					for (int j = 0; j < sc; j++) {
+						RID mat = RSG::storage->mesh_surface_get_material(mesh, j);
 
-								_update_instance_shader_parameters_from_material(isparams, p_instance->instance_shader_parameters, mat);
+						if (!mat.is_valid()) {
+							cast_shadows = true;
+						} else {
+							if (RSG::storage->material_casts_shadows(mat)) {
+								cast_shadows = true;
+							}
 
-								RSG::storage->material_update_dependency(mat, &p_instance->dependency_tracker);
+							if (RSG::storage->material_is_animated(mat)) {
+								is_animated = true;
 							}
-						}
-					}
 
-					if (!cast_shadows) {
-						can_cast_shadows = false;
+							_update_instance_shader_parameters_from_material(isparams, p_instance->instance_shader_parameters, mat);
+
+							RSG::storage->material_update_dependency(mat, &p_instance->dependency_tracker);
+						}
 					}
 				}
-			}
 
-			if (can_cast_shadows != geom->can_cast_shadows) {
-				//ability to cast shadows change, let lights now
-				for (Set<Instance *>::Element *E = geom->lights.front(); E; E = E->next()) {
-					InstanceLightData *light = static_cast<InstanceLightData *>(E->get()->base_data);
-					light->shadow_dirty = true;
+				if (!cast_shadows) {
+					can_cast_shadows = false;
 				}
+			}
+		}
 
-				geom->can_cast_shadows = can_cast_shadows;
+		if (can_cast_shadows != geom->can_cast_shadows) {
+			//ability to cast shadows change, let lights now
+			for (Set<Instance *>::Element *E = geom->lights.front(); E; E = E->next()) {
+				InstanceLightData *light = static_cast<InstanceLightData *>(E->get()->base_data);
+				light->shadow_dirty = true;
 			}
 
-			geom->material_is_animated = is_animated;
-			p_instance->instance_shader_parameters = isparams;
+			geom->can_cast_shadows = can_cast_shadows;
+		}
 
-			if (p_instance->instance_allocated_shader_parameters != (p_instance->instance_shader_parameters.size() > 0)) {
-				p_instance->instance_allocated_shader_parameters = (p_instance->instance_shader_parameters.size() > 0);
-				if (p_instance->instance_allocated_shader_parameters) {
-					p_instance->instance_allocated_shader_parameters_offset = RSG::storage->global_variables_instance_allocate(p_instance->self);
-					scene_render->geometry_instance_set_instance_shader_parameters_offset(geom->geometry_instance, p_instance->instance_allocated_shader_parameters_offset);
+		geom->material_is_animated = is_animated;
+		p_instance->instance_shader_parameters = isparams;
 
-					for (Map<StringName, Instance::InstanceShaderParameter>::Element *E = p_instance->instance_shader_parameters.front(); E; E = E->next()) {
-						if (E->get().value.get_type() != Variant::NIL) {
-							RSG::storage->global_variables_instance_update(p_instance->self, E->get().index, E->get().value);
-						}
+		if (p_instance->instance_allocated_shader_parameters != (p_instance->instance_shader_parameters.size() > 0)) {
+			p_instance->instance_allocated_shader_parameters = (p_instance->instance_shader_parameters.size() > 0);
+			if (p_instance->instance_allocated_shader_parameters) {
+				p_instance->instance_allocated_shader_parameters_offset = RSG::storage->global_variables_instance_allocate(p_instance->self);
+				scene_render->geometry_instance_set_instance_shader_parameters_offset(geom->geometry_instance, p_instance->instance_allocated_shader_parameters_offset);
+
+				for (Map<StringName, Instance::InstanceShaderParameter>::Element *E = p_instance->instance_shader_parameters.front(); E; E = E->next()) {
+					if (E->get().value.get_type() != Variant::NIL) {
+						RSG::storage->global_variables_instance_update(p_instance->self, E->get().index, E->get().value);
 					}
-				} else {
-					RSG::storage->global_variables_instance_free(p_instance->self);
-					p_instance->instance_allocated_shader_parameters_offset = -1;
-					scene_render->geometry_instance_set_instance_shader_parameters_offset(geom->geometry_instance, -1);
 				}
+			} else {
+				RSG::storage->global_variables_instance_free(p_instance->self);
+				p_instance->instance_allocated_shader_parameters_offset = -1;
+				scene_render->geometry_instance_set_instance_shader_parameters_offset(geom->geometry_instance, -1);
 			}
 		}
+	}
 
-		if (p_instance->skeleton.is_valid()) {
-			RSG::storage->skeleton_update_dependency(p_instance->skeleton, &p_instance->dependency_tracker);
-		}
+	if (p_instance->skeleton.is_valid()) {
+		RSG::storage->skeleton_update_dependency(p_instance->skeleton, &p_instance->dependency_tracker);
+	}
 
-		p_instance->dependency_tracker.update_end();
+	p_instance->dependency_tracker.update_end();
 
-		if ((1 << p_instance->base_type) & RS::INSTANCE_GEOMETRY_MASK) {
-			InstanceGeometryData *geom = static_cast<InstanceGeometryData *>(p_instance->base_data);
-			scene_render->geometry_instance_set_surface_materials(geom->geometry_instance, p_instance->materials);
-		}
+	if ((1 << p_instance->base_type) & RS::INSTANCE_GEOMETRY_MASK) {
+		InstanceGeometryData *geom = static_cast<InstanceGeometryData *>(p_instance->base_data);
+		scene_render->geometry_instance_set_surface_materials(geom->geometry_instance, p_instance->materials);
 	}
+}
 
+void RendererSceneCull::_update_dirty_instance(Instance *p_instance) {
 	_instance_update_list.remove(&p_instance->update_item);
 
-	_update_instance(p_instance);
+	if (p_instance->update_dependencies) {
+		_update_instance_dependencies(p_instance);
+	}
 
-	p_instance->update_aabb = false;
-	p_instance->update_dependencies = false;
+	_update_instance_bounds(p_instance);
+	_update_instance(p_instance);
 }
 
 void RendererSceneCull::update_dirty_instances() {
 	RSG::storage->update_dirty_resources();
 
 	while (_instance_update_list.first()) {
-		_update_dirty_instance(_instance_update_list.first()->self());
+		// Take the whole list first, so instances queued again while updating go to the next batch
+		// instead of appearing twice in this one.
+		dirty_instance_batch.clear();
+		while (_instance_update_list.first()) {
+			Instance *instance = _instance_update_list.first()->self();
+			_instance_update_list.remove(&instance->update_item);
+			dirty_instance_batch.push_back(instance);
+		}
+
+		// Dependencies and non-mesh bases modify the storage (multimeshes update their AABB lazily),
+		// so they are updated on this thread.
+		for (uint32_t i = 0; i < dirty_instance_batch.size(); i++) {
+			Instance *instance = dirty_instance_batch[i];
+			if (instance->update_dependencies) {
+				_update_instance_dependencies(instance);
+			}
+			if (instance->update_aabb && instance->base_type != RS::INSTANCE_MESH) {
+				_update_instance_aabb(instance);
+				instance->update_aabb = false;
+			}
+		}
+
+		// Mesh AABBs (skinned ones are the expensive part) and transformed bounds only read
+		// shared data, and write to their own instance.
+		if (dirty_instance_batch.size() > thread_cull_threshold) {
+			RendererThreadPool::singleton->thread_work_pool.do_work(dirty_instance_batch.size(), this, &RendererSceneCull::_update_instance_bounds_threaded, nullptr);
+		} else {
+			for (uint32_t i = 0; i < dirty_instance_batch.size(); i++) {
+				_update_instance_bounds(dirty_instance_batch[i]);
+			}
+		}
+
+		// BVH and pairing updates are merged in queue order, so results don't depend on thread timing.
+		for (uint32_t i = 0; i < dirty_instance_batch.size(); i++) {
+			_update_instance(dirty_instance_batch[i]);
+		}
+
+		dirty_instances_updated += dirty_instance_batch.size();
 	}
 }
 
@@ -3413,6 +3676,12 @@ void RendererSceneCull::update() {
 	}
 	scene_render->update();
 	update_dirty_instances();
+	dirty_instances_in_frame = dirty_instances_updated;
+	dirty_instances_updated = 0;
+	shadow_passes_in_frame = shadow_passes_updated;
+	shadow_passes_updated = 0;
+	shadow_cull_usec_in_frame = shadow_cull_usec_updated;
+	shadow_cull_usec_updated = 0;
 	render_particle_colliders();
 }
 
@@ -3427,6 +3696,13 @@ bool RendererSceneCull::free(RID p_rid) {
 		camera_owner.free(p_rid);
 		memdelete(camera);
 
+	} else if (occluder_owner.owns(p_rid)) {
+		Occluder *occluder = occluder_owner.getornull(p_rid);
+		occluder->dependency.deleted_notify(p_rid);
+
+		occluder_owner.free(p_rid);
+		memdelete(occluder);
+
 	} else if (scenario_owner.owns(p_rid)) {
 		Scenario *scenario = scenario_owner.getornull(p_rid);
 
@@ -3453,6 +3729,11 @@ bool RendererSceneCull::free(RID p_rid) {
 		instance_set_base(p_rid, RID());
 		instance_geometry_set_material_override(p_rid, RID());
 		instance_attach_skeleton(p_rid, RID());
+		instance_geometry_set_as_instance_lod(p_rid, RID());
+
+		while (instance->lod_children.front()) {
+			instance_geometry_set_as_instance_lod(instance->lod_children.front()->get()->self, RID());
+		}
 
 		if (instance->instance_allocated_shader_parameters) {
 			//free the used shader parameters
@@ -3491,9 +3772,6 @@ RendererSceneCull::RendererSceneCull() {
 	singleton = this;
 
 	instance_cull_result.set_page_pool(&instance_cull_page_pool);
-	instance_shadow_cull_result.set_page_pool(&instance_cull_page_pool);
-
-	geometry_instances_to_shadow_render.set_page_pool(&geometry_instance_cull_page_pool);
 
 	frustum_cull_result.init(&rid_cull_page_pool, &geometry_instance_cull_page_pool, &instance_cull_page_pool);
 	frustum_cull_result_threads.resize(RendererThreadPool::singleton->thread_work_pool.get_thread_count());
@@ -3504,13 +3782,19 @@ RendererSceneCull::RendererSceneCull() {
 	indexer_update_iterations = GLOBAL_GET("rendering/spatial_indexer/update_iterations_per_frame");
 	thread_cull_threshold = GLOBAL_GET("rendering/spatial_indexer/threaded_cull_minimum_instances");
 	thread_cull_threshold = MAX(thread_cull_threshold, (uint32_t)RendererThreadPool::singleton->thread_work_pool.get_thread_count()); //make sure there is at least one thread per CPU
+
+	use_occlusion_culling = GLOBAL_GET("rendering/occlusion_culling/use_occlusion_culling");
+	occlusion_buffer_width = GLOBAL_GET("rendering/occlusion_culling/buffer_width");
 }
 
 RendererSceneCull::~RendererSceneCull() {
 	instance_cull_result.reset();
-	instance_shadow_cull_result.reset();
 
-	geometry_instances_to_shadow_render.reset();
+	for (uint32_t i = 0; i < shadow_cull_passes.size(); i++) {
+		shadow_cull_passes[i]->casters.reset();
+		memdelete(shadow_cull_passes[i]);
+	}
+	shadow_cull_passes.clear();
 
 	frustum_cull_result.reset();
 	for (uint32_t i = 0; i < frustum_cull_result_threads.size(); i++) {
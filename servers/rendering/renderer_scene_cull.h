@@ -45,6 +45,7 @@
 #include "core/templates/rid_owner.h"
 #include "core/templates/self_list.h"
 #include "servers/rendering/renderer_scene.h"
+#include "servers/rendering/renderer_scene_occlusion_cull.h"
 #include "servers/rendering/renderer_scene_render.h"
 #include "servers/xr/xr_interface.h"
 class RendererSceneCull : public RendererScene {
@@ -106,6 +107,21 @@ public:
 	virtual void camera_set_use_vertical_aspect(RID p_camera, bool p_enable);
 	virtual bool is_camera(RID p_camera) const;
 
+	/* OCCLUDER API */
+
+	struct Occluder {
+		Vector<Vector3> vertices;
+		Vector<int32_t> indices;
+		AABB aabb;
+
+		RendererStorage::Dependency dependency;
+	};
+
+	mutable RID_PtrOwner<Occluder> occluder_owner;
+
+	virtual RID occluder_create();
+	virtual void occluder_set_mesh(RID p_occluder, const PackedVector3Array &p_vertices, const PackedInt32Array &p_indices);
+
 	/* SCENARIO API */
 
 	struct Instance;
@@ -245,6 +261,7 @@ public:
 			FLAG_USES_BAKED_LIGHT = (1 << 16),
 			FLAG_USES_MESH_INSTANCE = (1 << 17),
 			FLAG_REFLECTION_PROBE_DIRTY = (1 << 18),
+			FLAG_USES_DRAW_RANGE = (1 << 19),
 		};
 
 		uint32_t flags = 0;
@@ -273,6 +290,7 @@ public:
 		RID self;
 
 		List<Instance *> directional_lights;
+		List<Instance *> occluders;
 		RID environment;
 		RID fallback_environment;
 		RID camera_effects;
@@ -286,6 +304,19 @@ public:
 		PagedArray<InstanceBounds> instance_aabbs;
 		PagedArray<InstanceData> instance_data;
 
+		// Cameras (by their render buffers) and reflection probes keep their own draw range state,
+		// so they don't flip the hysteresis and shadows of each other. Each uses a bit of Instance::in_draw_range_views.
+		enum {
+			MAX_DRAW_RANGE_VIEWS = 32
+		};
+
+		struct DrawRangeView {
+			RID owner;
+			uint64_t last_frame = 0;
+		};
+
+		LocalVector<DrawRangeView> draw_range_views;
+
 		Scenario() {
 			indexers[INDEXER_GEOMETRY].set_index(INDEXER_GEOMETRY);
 			indexers[INDEXER_VOLUMES].set_index(INDEXER_VOLUMES);
@@ -364,6 +395,7 @@ public:
 		AABB aabb;
 		AABB transformed_aabb;
 		AABB prev_transformed_aabb;
+		AABB bvh_aabb; //transformed_aabb, quantized while moving
 
 		struct InstanceShaderParameter {
 			int32_t index = -1;
@@ -399,7 +431,9 @@ public:
 		float lod_end;
 		float lod_begin_hysteresis;
 		float lod_end_hysteresis;
-		RID lod_instance;
+		Instance *lod_parent; //distance for the draw range is measured from this instance, if set
+		Set<Instance *> lod_children;
+		uint32_t in_draw_range_views; //result of the last draw range check of each Scenario::draw_range_views, the hysteresis margins depend on it
 
 		Vector<Color> lightmap_target_sh; //target is used for incrementally changing the SH over time, this avoids pops in some corner cases and when going interior <-> exterior
 
@@ -480,6 +514,8 @@ public:
 			lod_end = 0;
 			lod_begin_hysteresis = 0;
 			lod_end_hysteresis = 0;
+			lod_parent = nullptr;
+			in_draw_range_views = 0;
 
 			last_frame_pass = 0;
 			version = 1;
@@ -630,6 +666,10 @@ public:
 		}
 	};
 
+	struct InstanceOccluderData : public InstanceBaseData {
+		List<Instance *>::Element *O = nullptr; // element in scenario occluder list
+	};
+
 	uint64_t pair_pass = 1;
 
 	struct PairInstances {
@@ -695,8 +735,32 @@ public:
 	PagedArrayPool<RID> rid_cull_page_pool;
 
 	PagedArray<Instance *> instance_cull_result;
-	PagedArray<Instance *> instance_shadow_cull_result;
-	PagedArray<RendererSceneRender::GeometryInstance *> geometry_instances_to_shadow_render;
+
+	// One omni side/half or spot light shadow to redraw. All passes of a frame are culled in parallel, then rendered in order.
+	struct ShadowCullPass {
+		Instance *light = nullptr;
+		int pass = 0;
+		CameraMatrix projection;
+		Transform transform;
+		real_t radius = 0;
+		bool restore_dp_transform = false;
+		Vector<Plane> planes;
+
+		PagedArray<RendererSceneRender::GeometryInstance *> casters;
+		LocalVector<RID> mesh_instances;
+		bool animated_material_found = false;
+		uint64_t cull_usec = 0;
+	};
+
+	LocalVector<ShadowCullPass *> shadow_cull_passes; // Grows as needed, never shrinks.
+	uint32_t shadow_cull_pass_count = 0;
+	Scenario *shadow_cull_scenario = nullptr;
+	uint32_t shadow_cull_draw_range_view = 0; //bit of the camera the shadows are culled for
+
+	uint32_t shadow_passes_updated = 0;
+	uint32_t shadow_passes_in_frame = 0;
+	uint64_t shadow_cull_usec_updated = 0;
+	uint64_t shadow_cull_usec_in_frame = 0;
 
 	struct FrustumCullResult {
 		PagedArray<RendererSceneRender::GeometryInstance *> geometry_instances;
@@ -818,6 +882,14 @@ public:
 
 	uint32_t thread_cull_threshold = 200;
 
+	LocalVector<Instance *> dirty_instance_batch;
+	uint32_t dirty_instances_updated = 0;
+	uint32_t dirty_instances_in_frame = 0;
+
+	RendererSceneOcclusionCull occlusion_cull;
+	bool use_occlusion_culling = false;
+	int occlusion_buffer_width = 256;
+
 	RID_PtrOwner<Instance> instance_owner;
 
 	uint32_t geometry_instance_pair_mask; // used in traditional forward, unnecesary on clustered
@@ -862,14 +934,25 @@ public:
 	virtual Variant instance_geometry_get_shader_parameter_default_value(RID p_instance, const StringName &p_parameter) const;
 
 	_FORCE_INLINE_ void _update_instance(Instance *p_instance);
+	_FORCE_INLINE_ bool _instance_is_in_draw_range(const Instance *p_instance, const Vector3 &p_camera_pos, bool p_was_in_range) const;
+	void _instance_update_draw_range_flag(Instance *p_instance);
+	uint32_t _scenario_get_draw_range_view(Scenario *p_scenario, RID p_owner);
 	_FORCE_INLINE_ void _update_instance_aabb(Instance *p_instance);
+	_FORCE_INLINE_ void _update_instance_bounds(Instance *p_instance);
+	void _update_instance_bounds_threaded(uint32_t p_index, void *p_userdata);
+	_FORCE_INLINE_ void _update_instance_dependencies(Instance *p_instance);
 	_FORCE_INLINE_ void _update_dirty_instance(Instance *p_instance);
+	void _instance_base_update_dependency(Instance *p_instance);
 	_FORCE_INLINE_ void _update_instance_lightmap_captures(Instance *p_instance);
 	void _unpair_instance(Instance *p_instance);
 
 	void _light_instance_setup_directional_shadow(int p_shadow_index, Instance *p_instance, const Transform p_cam_transform, const CameraMatrix &p_cam_projection, bool p_cam_orthogonal, bool p_cam_vaspect);
 
-	_FORCE_INLINE_ bool _light_instance_update_shadow(Instance *p_instance, const Transform p_cam_transform, const CameraMatrix &p_cam_projection, bool p_cam_orthogonal, bool p_cam_vaspect, RID p_shadow_atlas, Scenario *p_scenario, float p_scren_lod_threshold);
+	void _light_instance_add_shadow_passes(Instance *p_instance);
+	ShadowCullPass *_shadow_cull_pass_add(Instance *p_light, int p_pass);
+	void _shadow_cull_pass(ShadowCullPass *p_pass);
+	void _shadow_cull_pass_threaded(uint32_t p_index, void *p_userdata);
+	void _render_shadow_passes(RID p_shadow_atlas);
 
 	RID _render_get_environment(RID p_camera, RID p_scenario);
 
@@ -918,6 +1001,8 @@ public:
 		Transform cam_transform;
 		uint32_t visible_layers;
 		Instance *render_reflection_probe;
+		uint32_t draw_range_view; //bit in Instance::in_draw_range_views
+		RendererSceneOcclusionCull *occlusion_cull = nullptr;
 	};
 
 	void _frustum_cull_threaded(uint32_t p_thread, FrustumCullData *cull_data);
@@ -1036,6 +1121,9 @@ public:
 	PASS1(set_debug_draw_mode, RS::ViewportDebugDraw)
 
 	virtual void update();
+	virtual uint32_t get_dirty_instances_in_frame() const { return dirty_instances_in_frame; }
+	virtual uint32_t get_shadow_passes_in_frame() const { return shadow_passes_in_frame; }
+	virtual uint64_t get_shadow_cull_usec_in_frame() const { return shadow_cull_usec_in_frame; }
 
 	bool free(RID p_rid);
 
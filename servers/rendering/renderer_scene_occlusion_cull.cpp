@@ -0,0 +1,262 @@
+/*************************************************************************/
+/*  renderer_scene_occlusion_cull.cpp                                    */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "renderer_scene_occlusion_cull.h"
+
+#include <float.h>
+
+Vector3 RendererSceneOcclusionCull::_to_screen(const Plane &p_clip) const {
+	real_t inv_w = 1.0 / p_clip.d;
+	return Vector3(
+			(p_clip.normal.x * inv_w * 0.5 + 0.5) * size.width,
+			(0.5 - p_clip.normal.y * inv_w * 0.5) * size.height,
+			p_clip.normal.z * inv_w);
+}
+
+void RendererSceneOcclusionCull::_add_triangle(const Plane &p_a, const Plane &p_b, const Plane &p_c) {
+	Vector3 v[3] = { _to_screen(p_a), _to_screen(p_b), _to_screen(p_c) };
+
+	real_t area = (v[1].x - v[0].x) * (v[2].y - v[0].y) - (v[1].y - v[0].y) * (v[2].x - v[0].x);
+	if (Math::abs(area) < CMP_EPSILON) {
+		return;
+	}
+	if (area < 0) {
+		// Occluders are double sided.
+		SWAP(v[1], v[2]);
+		area = -area;
+	}
+
+	Triangle t;
+	t.min_x = MAX(int(Math::floor(MIN(v[0].x, MIN(v[1].x, v[2].x)))), 0);
+	t.max_x = MIN(int(Math::ceil(MAX(v[0].x, MAX(v[1].x, v[2].x)))), size.width - 1);
+	t.min_y = MAX(int(Math::floor(MIN(v[0].y, MIN(v[1].y, v[2].y)))), 0);
+	t.max_y = MIN(int(Math::ceil(MAX(v[0].y, MAX(v[1].y, v[2].y)))), size.height - 1);
+	if (t.min_x > t.max_x || t.min_y > t.max_y) {
+		return;
+	}
+
+	for (int i = 0; i < 3; i++) {
+		// Edge opposite to vertex i, positive inside.
+		const Vector3 &from = v[(i + 1) % 3];
+		const Vector3 &to = v[(i + 2) % 3];
+		t.edges[i] = Vector3(from.y - to.y, to.x - from.x, from.x * to.y - from.y * to.x);
+	}
+
+	real_t inv_area = 1.0 / area;
+	t.depth = (t.edges[0] * v[0].z + t.edges[1] * v[1].z + t.edges[2] * v[2].z) * inv_area;
+
+	triangles.push_back(t);
+}
+
+void RendererSceneOcclusionCull::_rasterize_tile_row(uint32_t p_tile_row, void *p_userdata) {
+	int from_y = p_tile_row * TILE_SIZE;
+	int to_y = MIN(from_y + TILE_SIZE, size.height);
+
+	float *rows = depth.ptr();
+	for (int i = from_y * size.width; i < to_y * size.width; i++) {
+		rows[i] = FLT_MAX;
+	}
+
+	for (uint32_t i = 0; i < triangles.size(); i++) {
+		const Triangle &t = triangles[i];
+		if (t.max_y < from_y || t.min_y >= to_y) {
+			continue;
+		}
+
+		for (int y = MAX(t.min_y, from_y); y <= MIN(t.max_y, to_y - 1); y++) {
+			float *row = rows + y * size.width;
+			float py = y + 0.5;
+			float e0_row = t.edges[0].y * py + t.edges[0].z;
+			float e1_row = t.edges[1].y * py + t.edges[1].z;
+			float e2_row = t.edges[2].y * py + t.edges[2].z;
+			float z_row = t.depth.y * py + t.depth.z;
+
+			// Branchless so the compiler can vectorize the span.
+			for (int x = t.min_x; x <= t.max_x; x++) {
+				float px = x + 0.5;
+				float e0 = t.edges[0].x * px + e0_row;
+				float e1 = t.edges[1].x * px + e1_row;
+				float e2 = t.edges[2].x * px + e2_row;
+				float z = t.depth.x * px + z_row;
+				bool write = e0 >= 0 && e1 >= 0 && e2 >= 0 && z < row[x];
+				row[x] = write ? z : row[x];
+			}
+		}
+	}
+
+	for (uint32_t tx = 0; tx < tiles_x; tx++) {
+		int from_x = tx * TILE_SIZE;
+		int to_x = MIN(from_x + TILE_SIZE, size.width);
+		float max_depth = -FLT_MAX;
+		for (int y = from_y; y < to_y; y++) {
+			const float *row = rows + y * size.width;
+			for (int x = from_x; x < to_x; x++) {
+				max_depth = MAX(max_depth, row[x]);
+			}
+		}
+		tile_max_depth[p_tile_row * tiles_x + tx] = max_depth;
+	}
+}
+
+void RendererSceneOcclusionCull::set_size(const Size2i &p_size) {
+	ERR_FAIL_COND(p_size.width <= 0 || p_size.height <= 0);
+	if (size == p_size) {
+		return;
+	}
+
+	size = p_size;
+	tiles_x = (size.width + TILE_SIZE - 1) / TILE_SIZE;
+	tiles_y = (size.height + TILE_SIZE - 1) / TILE_SIZE;
+	depth.resize(size.width * size.height);
+	tile_max_depth.resize(tiles_x * tiles_y);
+	rasterized = false;
+}
+
+void RendererSceneOcclusionCull::begin(const Transform &p_cam_transform, const CameraMatrix &p_cam_projection) {
+	view_projection = p_cam_projection * CameraMatrix(p_cam_transform.affine_inverse());
+	triangles.clear();
+	rasterized = false;
+}
+
+void RendererSceneOcclusionCull::add_occluder(const Vector<Vector3> &p_vertices, const Vector<int32_t> &p_indices, const Transform &p_transform) {
+	ERR_FAIL_COND(size == Size2i());
+
+	CameraMatrix mvp = view_projection * CameraMatrix(p_transform);
+
+	int vertex_count = p_vertices.size();
+	const Vector3 *vertices = p_vertices.ptr();
+	clip_vertices.resize(vertex_count);
+	for (int i = 0; i < vertex_count; i++) {
+		clip_vertices[i] = mvp.xform4(Plane(vertices[i], 1.0));
+	}
+
+	int index_count = p_indices.size() - p_indices.size() % 3;
+	const int32_t *indices = p_indices.ptr();
+	for (int i = 0; i < index_count; i += 3) {
+		if (uint32_t(indices[i]) >= uint32_t(vertex_count) || uint32_t(indices[i + 1]) >= uint32_t(vertex_count) || uint32_t(indices[i + 2]) >= uint32_t(vertex_count)) {
+			continue;
+		}
+
+		// Clip against the near plane (z >= -w), which leaves up to four vertices.
+		Plane polygon[4];
+		int polygon_size = 0;
+		for (int j = 0; j < 3; j++) {
+			const Plane &a = clip_vertices[indices[i + j]];
+			const Plane &b = clip_vertices[indices[i + (j + 1) % 3]];
+			real_t da = a.normal.z + a.d;
+			real_t db = b.normal.z + b.d;
+			if (da >= 0) {
+				polygon[polygon_size++] = a;
+			}
+			if ((da >= 0) != (db >= 0)) {
+				real_t f = da / (da - db);
+				polygon[polygon_size++] = Plane(a.normal.lerp(b.normal, f), Math::lerp(a.d, b.d, f));
+			}
+		}
+
+		for (int j = 2; j < polygon_size; j++) {
+			if (polygon[0].d > 0 && polygon[j - 1].d > 0 && polygon[j].d > 0) {
+				_add_triangle(polygon[0], polygon[j - 1], polygon[j]);
+			}
+		}
+	}
+}
+
+void RendererSceneOcclusionCull::rasterize(ThreadWorkPool *p_work_pool) {
+	if (triangles.is_empty()) {
+		rasterized = false;
+		return;
+	}
+
+	if (p_work_pool && p_work_pool->get_thread_count() > 1) {
+		p_work_pool->do_work(tiles_y, this, &RendererSceneOcclusionCull::_rasterize_tile_row, nullptr);
+	} else {
+		for (uint32_t i = 0; i < tiles_y; i++) {
+			_rasterize_tile_row(i, nullptr);
+		}
+	}
+
+	rasterized = true;
+}
+
+bool RendererSceneOcclusionCull::is_occluded(const AABB &p_aabb) const {
+	if (!rasterized) {
+		return false;
+	}
+
+	Vector2 min = Vector2(FLT_MAX, FLT_MAX);
+	Vector2 max = Vector2(-FLT_MAX, -FLT_MAX);
+	real_t min_depth = FLT_MAX;
+	for (int i = 0; i < 8; i++) {
+		Plane clip = view_projection.xform4(Plane(p_aabb.get_endpoint(i), 1.0));
+		if (clip.normal.z + clip.d < 0 || clip.d <= 0) {
+			// Crosses the near plane, assume visible.
+			return false;
+		}
+		Vector3 screen = _to_screen(clip);
+		min.x = MIN(min.x, screen.x);
+		min.y = MIN(min.y, screen.y);
+		max.x = MAX(max.x, screen.x);
+		max.y = MAX(max.y, screen.y);
+		min_depth = MIN(min_depth, screen.z);
+	}
+
+	int from_x = MAX(int(Math::floor(min.x)), 0);
+	int from_y = MAX(int(Math::floor(min.y)), 0);
+	int to_x = MIN(int(Math::ceil(max.x)), size.width);
+	int to_y = MIN(int(Math::ceil(max.y)), size.height);
+	if (from_x >= to_x || from_y >= to_y) {
+		// Off screen, that is for frustum culling to decide.
+		return false;
+	}
+
+	const float *rows = depth.ptr();
+	for (int ty = from_y / TILE_SIZE; ty <= (to_y - 1) / TILE_SIZE; ty++) {
+		for (int tx = from_x / TILE_SIZE; tx <= (to_x - 1) / TILE_SIZE; tx++) {
+			if (tile_max_depth[ty * tiles_x + tx] < min_depth) {
+				// Every occluder in the tile is in front.
+				continue;
+			}
+
+			int tile_to_y = MIN((ty + 1) * TILE_SIZE, to_y);
+			int tile_to_x = MIN((tx + 1) * TILE_SIZE, to_x);
+			for (int y = MAX(ty * TILE_SIZE, from_y); y < tile_to_y; y++) {
+				const float *row = rows + y * size.width;
+				for (int x = MAX(tx * TILE_SIZE, from_x); x < tile_to_x; x++) {
+					if (row[x] >= min_depth) {
+						return false;
+					}
+				}
+			}
+		}
+	}
+
+	return true;
+}
@@ -0,0 +1,84 @@
+/*************************************************************************/
+/*  renderer_scene_occlusion_cull.h                                      */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef RENDERER_SCENE_OCCLUSION_CULL_H
+#define RENDERER_SCENE_OCCLUSION_CULL_H
+
+#include "core/math/camera_matrix.h"
+#include "core/templates/local_vector.h"
+#include "core/templates/thread_work_pool.h"
+
+// Low resolution software depth buffer. Occluder triangles are rasterized
+// into it on the CPU, then instance bounds are tested against it to skip
+// what is hidden behind them before it reaches the scene renderer.
+class RendererSceneOcclusionCull {
+	enum {
+		TILE_SIZE = 8
+	};
+
+	struct Triangle {
+		// Edge functions and depth plane, as a * x + b * y + c in pixels.
+		Vector3 edges[3];
+		Vector3 depth;
+		int min_x;
+		int max_x;
+		int min_y;
+		int max_y;
+	};
+
+	Size2i size;
+	uint32_t tiles_x = 0;
+	uint32_t tiles_y = 0;
+
+	LocalVector<float> depth;
+	LocalVector<float> tile_max_depth;
+	LocalVector<Triangle> triangles;
+	LocalVector<Plane> clip_vertices;
+
+	CameraMatrix view_projection;
+	bool rasterized = false;
+
+	_FORCE_INLINE_ Vector3 _to_screen(const Plane &p_clip) const;
+	void _add_triangle(const Plane &p_a, const Plane &p_b, const Plane &p_c);
+	void _rasterize_tile_row(uint32_t p_tile_row, void *p_userdata);
+
+public:
+	void set_size(const Size2i &p_size);
+	Size2i get_size() const { return size; }
+
+	void begin(const Transform &p_cam_transform, const CameraMatrix &p_cam_projection);
+	void add_occluder(const Vector<Vector3> &p_vertices, const Vector<int32_t> &p_indices, const Transform &p_transform);
+	void rasterize(ThreadWorkPool *p_work_pool = nullptr);
+
+	uint32_t get_triangle_count() const { return triangles.size(); }
+	bool is_occluded(const AABB &p_aabb) const;
+};
+
+#endif // RENDERER_SCENE_OCCLUSION_CULL_H
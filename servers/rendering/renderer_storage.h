@@ -64,6 +64,9 @@ protected:
 		Map<DependencyTracker *, uint32_t> instances;
 	};
 
+	// Occluders are owned by the scene cull, but notify their instances like storage resources do.
+	friend class RendererSceneCull;
+
 public:
 	struct DependencyTracker {
 		void *userdata = nullptr;
@@ -235,6 +235,15 @@ void RenderingServerDefault::finish() {
 /* STATUS INFORMATION */
 
 int RenderingServerDefault::get_render_info(RenderInfo p_info) {
+	if (p_info == INFO_DIRTY_INSTANCES_IN_FRAME) {
+		return RSG::scene->get_dirty_instances_in_frame();
+	}
+	if (p_info == INFO_SHADOW_PASSES_IN_FRAME) {
+		return RSG::scene->get_shadow_passes_in_frame();
+	}
+	if (p_info == INFO_SHADOW_CULL_TIME_IN_FRAME) {
+		return RSG::scene->get_shadow_cull_usec_in_frame();
+	}
 	return RSG::storage->get_render_info(p_info);
 }
 
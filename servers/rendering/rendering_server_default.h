@@ -498,6 +498,11 @@ public:
 //from now on, calls forwarded to this singleton
 #define BINDBASE RSG::scene
 
+	/* OCCLUDER API */
+
+	BIND0R(RID, occluder_create)
+	BIND3(occluder_set_mesh, RID, const PackedVector3Array &, const PackedInt32Array &)
+
 	/* CAMERA API */
 
 	BIND0R(RID, camera_create)
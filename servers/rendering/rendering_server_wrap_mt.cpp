@@ -30,6 +30,7 @@
 
 #include "rendering_server_wrap_mt.h"
 #include "core/config/project_settings.h"
+#include "core/os/frame_arena.h"
 #include "core/os/os.h"
 #include "servers/display_server.h"
 
@@ -40,6 +41,7 @@ void RenderingServerWrapMT::thread_exit() {
 void RenderingServerWrapMT::thread_draw(bool p_swap_buffers, double frame_step) {
 	if (!atomic_decrement(&draw_pending)) {
 		rendering_server->draw(p_swap_buffers, frame_step);
+		FrameArena::reset();
 	}
 }
 
@@ -63,8 +65,8 @@ void RenderingServerWrapMT::thread_loop() {
 	exit = false;
 	draw_thread_up = true;
 	while (!exit) {
-		// flush commands one by one, until exit is requested
-		command_queue.wait_and_flush_one();
+		// flush commands as they come in, until exit is requested
+		command_queue.wait_and_flush();
 	}
 
 	command_queue.flush_all(); // flush all
@@ -125,6 +127,7 @@ void RenderingServerWrapMT::finish() {
 	lightmap_free_cached_ids();
 	particles_free_cached_ids();
 	particles_collision_free_cached_ids();
+	occluder_free_cached_ids();
 	camera_free_cached_ids();
 	viewport_free_cached_ids();
 	environment_free_cached_ids();
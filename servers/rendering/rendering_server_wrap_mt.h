@@ -395,6 +395,11 @@ public:
 	FUNC1(particles_collision_height_field_update, RID)
 	FUNC2(particles_collision_set_height_field_resolution, RID, ParticlesCollisionHeightfieldResolution)
 
+	/* OCCLUDER API */
+
+	FUNCRID(occluder)
+	FUNC3(occluder_set_mesh, RID, const PackedVector3Array &, const PackedInt32Array &)
+
 	/* CAMERA API */
 
 	FUNCRID(camera)
@@ -0,0 +1,192 @@
+/*************************************************************************/
+/*  test_array.h                                                         */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_ARRAY_H
+#define TEST_ARRAY_H
+
+#include "core/os/memory.h"
+#include "core/variant/array.h"
+#include "core/variant/variant.h"
+
+#include "tests/test_macros.h"
+
+namespace TestArray {
+
+TEST_CASE("[Array] Growing past the inline elements") {
+	Array array;
+	for (int i = 0; i < 100; i++) {
+		array.push_back(itos(i));
+	}
+	CHECK(array.size() == 100);
+
+	int wrong = 0;
+	for (int i = 0; i < 100; i++) {
+		wrong += String(array[i]) != itos(i);
+	}
+	CHECK(wrong == 0);
+
+	array.resize(3);
+	CHECK(array.size() == 3);
+	CHECK(array.back() == Variant("2"));
+
+	array.clear();
+	CHECK(array.is_empty());
+	array.push_back(1);
+	CHECK(array[0] == Variant(1));
+}
+
+TEST_CASE("[Array] Insert, remove and find") {
+	Array array;
+	array.push_back(1);
+	array.push_back(3);
+	array.insert(1, 2);
+	array.push_front(0);
+	CHECK(array.size() == 4);
+	for (int i = 0; i < 4; i++) {
+		CHECK(array[i] == Variant(i));
+	}
+
+	// Elements added from the array itself, while it grows.
+	array.push_back(array[0]);
+	array.insert(0, array[3]);
+	CHECK(array.size() == 6);
+	CHECK(array[0] == Variant(3));
+	CHECK(array[5] == Variant(0));
+
+	CHECK(array.find(2) == 3);
+	CHECK(array.find(3, 1) == 4);
+	CHECK(array.rfind(3) == 4);
+	CHECK(array.count(0) == 2);
+	CHECK(array.find(42) == -1);
+
+	array.erase(3);
+	CHECK(array[0] == Variant(0));
+	array.remove(0);
+	CHECK(array.pop_front() == Variant(1));
+	CHECK(array.pop_back() == Variant(0));
+	CHECK(array.size() == 2);
+	CHECK(array[0] == Variant(2));
+	CHECK(array[1] == Variant(3));
+}
+
+TEST_CASE("[Array] Sort, invert and append") {
+	Array array;
+	array.push_back(3);
+	array.push_back(1);
+	array.push_back(2);
+	array.sort();
+	CHECK(array[0] == Variant(1));
+	CHECK(array[2] == Variant(3));
+	CHECK(array.bsearch(2) == 1);
+
+	array.invert();
+	CHECK(array[0] == Variant(3));
+	CHECK(array[2] == Variant(1));
+
+	array.append_array(array);
+	CHECK(array.size() == 6);
+	CHECK(array[3] == Variant(3));
+	CHECK(array[5] == Variant(1));
+}
+
+TEST_CASE("[Array] References and copies") {
+	Array array;
+	array.push_back("a");
+	Array reference = array;
+	reference.push_back("b");
+	CHECK(array.size() == 2);
+	CHECK(array == reference);
+
+	Array copy = array.duplicate();
+	copy.push_back("c");
+	CHECK(array.size() == 2);
+	CHECK(copy.size() == 3);
+	CHECK(copy[1] == Variant("b"));
+	CHECK(array.hash() != copy.hash());
+	copy.resize(2);
+	CHECK(array.hash() == copy.hash());
+}
+
+TEST_CASE("[Array] Assigning a typed array to an untyped one") {
+	Array typed;
+	typed.set_typed(Variant::INT, StringName(), Variant());
+	for (int i = 0; i < 100; i++) {
+		typed.push_back(i);
+	}
+
+	Array untyped;
+	untyped.push_back("replaced");
+#ifdef DEBUG_ENABLED
+	uint64_t from = Memory::get_alloc_total();
+#endif
+	untyped = typed;
+#ifdef DEBUG_ENABLED
+	CHECK_MESSAGE(Memory::get_alloc_total() == from, "The elements should be shared until written, not copied.");
+#endif
+	CHECK(untyped.size() == 100);
+	CHECK(untyped[99] == Variant(99));
+	CHECK(untyped != typed);
+
+	// The untyped array is a copy, which takes any type and doesn't change the typed one.
+	untyped.push_back("str");
+	untyped[0] = "first";
+	CHECK(untyped.size() == 101);
+	CHECK(untyped[100] == Variant("str"));
+	CHECK(typed.size() == 100);
+	CHECK(typed[0] == Variant(0));
+
+	// Small arrays are copied too.
+	Array small_typed;
+	small_typed.set_typed(Variant::INT, StringName(), Variant());
+	small_typed.push_back(1);
+	Array small_untyped;
+	small_untyped = small_typed;
+	small_untyped.push_back("str");
+	CHECK(small_untyped.size() == 2);
+	CHECK(small_typed.size() == 1);
+}
+
+#ifdef DEBUG_ENABLED
+TEST_CASE("[Array] Small arrays are a single allocation") {
+	uint64_t from = Memory::get_alloc_total();
+	{
+		Array array;
+		array.push_back(1);
+		array.push_back(2);
+		array.push_back(3);
+		array.push_back(4);
+	}
+	CHECK(Memory::get_alloc_total() - from == 1);
+}
+#endif
+
+} // namespace TestArray
+
+#endif // TEST_ARRAY_H
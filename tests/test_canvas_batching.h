@@ -0,0 +1,211 @@
+/*************************************************************************/
+/*  test_canvas_batching.h                                               */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_CANVAS_BATCHING_H
+#define TEST_CANVAS_BATCHING_H
+
+#include "servers/rendering/renderer_canvas_batcher.h"
+
+#include "thirdparty/doctest/doctest.h"
+
+namespace TestCanvasBatching {
+
+typedef RendererCanvasRender::Item Item;
+
+// A row of `p_count` items of 10x10 pixels, each drawing a single rect with the given texture.
+static void create_row(LocalVector<Item *> &r_items, int p_count, RID p_texture = RID()) {
+	for (int i = 0; i < p_count; i++) {
+		Item *item = memnew(Item);
+		item->final_transform = Transform2D(0, Vector2(r_items.size() * 20, 0));
+		item->global_rect_cache = Rect2(item->final_transform.get_origin(), Size2(10, 10));
+		Item::CommandRect *rect = item->alloc_command<Item::CommandRect>();
+		rect->rect = Rect2(0, 0, 10, 10);
+		rect->modulate = Color(1, 1, 1);
+		rect->texture = p_texture;
+		r_items.push_back(item);
+	}
+}
+
+static void free_items(LocalVector<Item *> &r_items) {
+	for (uint32_t i = 0; i < r_items.size(); i++) {
+		memdelete(r_items[i]);
+	}
+	r_items.clear();
+}
+
+static void build(RendererCanvasBatcher &r_batcher, const LocalVector<Item *> &p_items, const RendererCanvasRender::Light *p_lights = nullptr, uint32_t p_max_instances = 16384) {
+	r_batcher.build(p_items.ptr(), p_items.size(), Transform2D(), p_lights, p_max_instances);
+}
+
+TEST_CASE("[CanvasBatching] Compatible rects are merged into a single batch") {
+	LocalVector<Item *> items;
+	create_row(items, 1000, RID::from_uint64(1));
+
+	RendererCanvasBatcher batcher;
+	build(batcher, items);
+
+	CHECK_MESSAGE(batcher.get_batch_count() == 1, "Rects sharing texture and state should produce one batch.");
+	CHECK(batcher.get_batched_instance_count() == 1000);
+	CHECK(batcher.get_batches()[0].command == items[0]->commands);
+	CHECK(batcher.get_batches()[0].instance_count == 1000);
+
+	const RendererCanvasBatcher::InstanceData &last = batcher.get_instances()[999];
+	CHECK(last.world[4] == doctest::Approx(999 * 20));
+	CHECK(last.dst_rect[2] == doctest::Approx(10));
+
+	free_items(items);
+}
+
+TEST_CASE("[CanvasBatching] Texture changes split batches and single rects are not batched") {
+	LocalVector<Item *> items;
+	create_row(items, 10, RID::from_uint64(1));
+	create_row(items, 1, RID::from_uint64(2));
+	create_row(items, 10, RID::from_uint64(1));
+
+	RendererCanvasBatcher batcher;
+	build(batcher, items);
+
+	CHECK(batcher.get_batch_count() == 2);
+	CHECK(batcher.get_batched_instance_count() == 20);
+	CHECK(batcher.get_batches()[0].command == items[0]->commands);
+	CHECK(batcher.get_batches()[1].command == items[11]->commands);
+	CHECK(batcher.get_batches()[1].instance_offset == 10);
+
+	free_items(items);
+}
+
+TEST_CASE("[CanvasBatching] Clip, material and other commands keep draw order") {
+	LocalVector<Item *> items;
+	create_row(items, 20);
+
+	Item clip_owner;
+	for (uint32_t i = 5; i < 10; i++) {
+		items[i]->final_clip_owner = &clip_owner;
+	}
+	items[12]->material = RID::from_uint64(3);
+	// A non rect command ends the run, as it must be drawn between the rects.
+	Item::CommandClipIgnore *ignore = items[15]->alloc_command<Item::CommandClipIgnore>();
+	ignore->ignore = true;
+
+	RendererCanvasBatcher batcher;
+	build(batcher, items);
+
+	// [0, 5), [5, 10), [10, 12), 12 alone, [13, 16) ending with the ignore command, [16, 20).
+	CHECK(batcher.get_batch_count() == 5);
+	CHECK(batcher.get_batched_instance_count() == 19);
+
+	const LocalVector<RendererCanvasBatcher::Batch> &batches = batcher.get_batches();
+	CHECK(batches[2].command == items[10]->commands);
+	CHECK(batches[3].command == items[13]->commands);
+	CHECK(batches[3].instance_count == 3);
+	CHECK(batches[4].command == items[16]->commands);
+
+	free_items(items);
+}
+
+TEST_CASE("[CanvasBatching] Items lit by different lights are not merged") {
+	LocalVector<Item *> items;
+	create_row(items, 20);
+
+	RendererCanvasRender::Light light;
+	light.render_index_cache = 3;
+	light.item_mask = 2;
+	light.z_min = -100;
+	light.z_max = 100;
+	light.rect_cache = Rect2(0, 0, 1000, 1000);
+	light.xform_cache = Transform2D();
+	light.next_ptr = nullptr;
+
+	for (uint32_t i = 10; i < 20; i++) {
+		items[i]->light_mask = 2;
+	}
+
+	RendererCanvasBatcher batcher;
+	build(batcher, items, &light);
+
+	CHECK(batcher.get_batch_count() == 2);
+	CHECK(batcher.get_batches()[1].command == items[10]->commands);
+
+	// The renderer reuses the lights found while batching.
+	uint32_t lights[4];
+	CHECK(batcher.get_built_item_lights(0, lights) == 0);
+	CHECK(batcher.get_built_item_lights(15, lights) == 1);
+	CHECK(lights[0] == 3);
+
+	free_items(items);
+}
+
+TEST_CASE("[CanvasBatching] Instance data") {
+	LocalVector<Item *> items;
+	create_row(items, 2, RID::from_uint64(1));
+
+	Item::CommandRect *rect = static_cast<Item::CommandRect *>(items[0]->commands);
+	rect->flags = RendererCanvasRender::CANVAS_RECT_REGION | RendererCanvasRender::CANVAS_RECT_FLIP_H;
+	rect->source = Rect2(16, 0, 16, 16);
+	items[0]->final_modulate = Color(0.5, 0.5, 0.5, 1);
+
+	// Transform commands are baked into the instances that follow them.
+	Item::CommandTransform *transform = items[1]->alloc_command<Item::CommandTransform>();
+	transform->xform = Transform2D(0, Vector2(0, 100));
+	items[1]->alloc_command<Item::CommandRect>()->texture = RID::from_uint64(1);
+
+	RendererCanvasBatcher batcher;
+	build(batcher, items);
+
+	REQUIRE(batcher.get_batched_instance_count() == 3);
+	const RendererCanvasBatcher::InstanceData *instances = batcher.get_instances().ptr();
+
+	CHECK(instances[0].flags == RendererCanvasBatcher::INSTANCE_FLAGS_REGION_IN_PIXELS);
+	CHECK(instances[0].src_rect[0] == doctest::Approx(16));
+	CHECK(instances[0].src_rect[2] == doctest::Approx(-16));
+	CHECK(instances[0].modulation[0] == doctest::Approx(0.5));
+	CHECK(instances[1].flags == 0);
+	CHECK(instances[1].src_rect[2] == doctest::Approx(1));
+	CHECK(instances[2].world[5] == doctest::Approx(100));
+
+	free_items(items);
+}
+
+TEST_CASE("[CanvasBatching] Instance budget") {
+	LocalVector<Item *> items;
+	create_row(items, 100);
+
+	RendererCanvasBatcher batcher;
+	build(batcher, items, nullptr, 64);
+
+	CHECK_MESSAGE(batcher.get_batched_instance_count() == 64, "Rects past the budget should be drawn without batching.");
+	CHECK(batcher.get_batch_count() == 1);
+
+	free_items(items);
+}
+
+} // namespace TestCanvasBatching
+
+#endif // TEST_CANVAS_BATCHING_H
@@ -0,0 +1,197 @@
+/*************************************************************************/
+/*  test_canvas_cull.h                                                   */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_CANVAS_CULL_H
+#define TEST_CANVAS_CULL_H
+
+#include "servers/rendering/renderer_canvas_cull.h"
+
+#include "thirdparty/doctest/doctest.h"
+
+namespace TestCanvasCull {
+
+static int count_items(RendererCanvasRender::Item *p_list) {
+	int count = 0;
+	for (RendererCanvasRender::Item *item = p_list; item; item = item->next) {
+		count++;
+	}
+	return count;
+}
+
+// A grid of `p_size` x `p_size` items of 10x10 pixels, 20 pixels apart, under a single parent.
+static RID create_grid(RendererCanvasCull &r_cull, RID p_canvas, int p_size, Vector<RID> &r_items) {
+	RID root = r_cull.canvas_item_create();
+	r_cull.canvas_item_set_parent(root, p_canvas);
+
+	for (int i = 0; i < p_size; i++) {
+		for (int j = 0; j < p_size; j++) {
+			RID item = r_cull.canvas_item_create();
+			r_cull.canvas_item_set_parent(item, root);
+			r_cull.canvas_item_set_draw_index(item, r_items.size());
+			r_cull.canvas_item_set_transform(item, Transform2D(0, Vector2(i * 20, j * 20)));
+			r_cull.canvas_item_add_rect(item, Rect2(0, 0, 10, 10), Color(1, 1, 1));
+			r_items.push_back(item);
+		}
+	}
+	return root;
+}
+
+static void free_all(RendererCanvasCull &r_cull, RID p_canvas, RID p_root, const Vector<RID> &p_items) {
+	// Free the parent first, so children don't have to be erased from it one by one.
+	r_cull.free(p_root);
+	for (int i = 0; i < p_items.size(); i++) {
+		r_cull.free(p_items[i]);
+	}
+	r_cull.free(p_canvas);
+}
+
+TEST_CASE("[CanvasCull] Only visible items of a large canvas are visited") {
+	RendererCanvasCull cull;
+	RID canvas = cull.canvas_create();
+	Vector<RID> items;
+	RID root = create_grid(cull, canvas, 200, items);
+
+	// 10x10 items are on screen.
+	cull.cull_stats = RendererCanvasCull::CullStats();
+	RendererCanvasRender::Item *list = cull.cull_canvas(canvas, Transform2D(), Rect2(0, 0, 195, 195));
+	CHECK(count_items(list) == 100);
+	CHECK(cull.cull_stats.items_drawn == 100);
+	MESSAGE("Visited ", cull.cull_stats.items_visited, " of ", items.size() + 1, " canvas items for the first frame.");
+	CHECK_MESSAGE(cull.cull_stats.items_visited <= 101, "Off-screen items should not be visited.");
+
+	// Scroll the camera, the same amount of items should be visited.
+	cull.cull_stats = RendererCanvasCull::CullStats();
+	list = cull.cull_canvas(canvas, Transform2D(0, Vector2(-3000, -3000)), Rect2(0, 0, 195, 195));
+	CHECK(count_items(list) == 100);
+	CHECK(cull.cull_stats.items_visited <= 101);
+
+	free_all(cull, canvas, root, items);
+}
+
+TEST_CASE("[CanvasCull] Culled items are drawn in child order") {
+	RendererCanvasCull cull;
+	RID canvas = cull.canvas_create();
+	Vector<RID> items;
+	RID root = create_grid(cull, canvas, 20, items);
+
+	RendererCanvasRender::Item *list = cull.cull_canvas(canvas, Transform2D(), Rect2(0, 0, 95, 95));
+	REQUIRE(count_items(list) == 25);
+
+	bool ordered = true;
+	const RendererCanvasCull::Item *previous = nullptr;
+	for (RendererCanvasRender::Item *item = list; item; item = item->next) {
+		const RendererCanvasCull::Item *canvas_item = static_cast<RendererCanvasCull::Item *>(item);
+		if (previous && previous->index > canvas_item->index) {
+			ordered = false;
+		}
+		previous = canvas_item;
+	}
+	CHECK_MESSAGE(ordered, "Items should be drawn in the order of their draw index.");
+
+	free_all(cull, canvas, root, items);
+}
+
+TEST_CASE("[CanvasCull] Bounds follow changes to items") {
+	RendererCanvasCull cull;
+	RID canvas = cull.canvas_create();
+	Vector<RID> items;
+	RID root = create_grid(cull, canvas, 100, items);
+	const Rect2 clip = Rect2(0, 0, 95, 95);
+
+	CHECK(count_items(cull.cull_canvas(canvas, Transform2D(), clip)) == 25);
+
+	// Move a far away item on screen.
+	cull.canvas_item_set_transform(items[items.size() - 1], Transform2D(0, Vector2(85, 85)));
+	CHECK(count_items(cull.cull_canvas(canvas, Transform2D(), clip)) == 26);
+
+	// Hide it again.
+	cull.canvas_item_set_visible(items[items.size() - 1], false);
+	CHECK(count_items(cull.cull_canvas(canvas, Transform2D(), clip)) == 25);
+
+	// Grow a far away item until it reaches the screen.
+	cull.canvas_item_add_rect(items[items.size() - 2], Rect2(-2000, -2000, 2000, 2000), Color(1, 1, 1));
+	CHECK(count_items(cull.cull_canvas(canvas, Transform2D(), clip)) == 26);
+
+	// Clearing it takes it off screen.
+	cull.canvas_item_clear(items[items.size() - 2]);
+	CHECK(count_items(cull.cull_canvas(canvas, Transform2D(), clip)) == 25);
+
+	// Children added under an on-screen item are drawn, removed ones are not.
+	RID child = cull.canvas_item_create();
+	cull.canvas_item_set_parent(child, items[0]);
+	cull.canvas_item_add_rect(child, Rect2(0, 0, 10, 10), Color(1, 1, 1));
+	CHECK(count_items(cull.cull_canvas(canvas, Transform2D(), clip)) == 26);
+	cull.free(child);
+	CHECK(count_items(cull.cull_canvas(canvas, Transform2D(), clip)) == 25);
+
+	// Moving the parent moves everything.
+	cull.canvas_item_set_transform(root, Transform2D(0, Vector2(-1000, -1000)));
+	CHECK(count_items(cull.cull_canvas(canvas, Transform2D(), clip)) == 25);
+	cull.canvas_item_set_transform(root, Transform2D(0, Vector2(5000, 0)));
+	CHECK(count_items(cull.cull_canvas(canvas, Transform2D(), clip)) == 0);
+
+	free_all(cull, canvas, root, items);
+}
+
+TEST_CASE("[CanvasCull] Nested off-screen subtrees are skipped") {
+	RendererCanvasCull cull;
+	RID canvas = cull.canvas_create();
+
+	// A chain of groups, each with a few leaves, spread along the x axis.
+	Vector<RID> items;
+	RID parent = cull.canvas_item_create();
+	cull.canvas_item_set_parent(parent, canvas);
+	RID root = parent;
+	for (int i = 0; i < 50; i++) {
+		RID group = cull.canvas_item_create();
+		cull.canvas_item_set_parent(group, parent);
+		cull.canvas_item_set_transform(group, Transform2D(0, Vector2(100, 0)));
+		items.push_back(group);
+		for (int j = 0; j < 4; j++) {
+			RID leaf = cull.canvas_item_create();
+			cull.canvas_item_set_parent(leaf, group);
+			cull.canvas_item_set_transform(leaf, Transform2D(0, Vector2(j * 20, 0)));
+			cull.canvas_item_add_rect(leaf, Rect2(0, 0, 10, 10), Color(1, 1, 1));
+			items.push_back(leaf);
+		}
+		parent = group;
+	}
+
+	cull.cull_stats = RendererCanvasCull::CullStats();
+	RendererCanvasRender::Item *list = cull.cull_canvas(canvas, Transform2D(), Rect2(0, 0, 150, 100));
+	CHECK(count_items(list) == 3);
+	CHECK_MESSAGE(cull.cull_stats.items_visited < 20, "Groups past the screen should not be entered.");
+
+	free_all(cull, canvas, root, items);
+}
+
+} // namespace TestCanvasCull
+
+#endif // TEST_CANVAS_CULL_H
@@ -280,45 +280,57 @@ TEST_CASE("[CommandQueue] Test Queue Basics") {
 			ProjectSettings::get_singleton()->property_get_revert(COMMAND_QUEUE_SETTING));
 }
 
-TEST_CASE("[CommandQueue] Test Waiting at Queue Full") {
+TEST_CASE("[CommandQueue] Test Queue Growing When Full") {
 	const char *COMMAND_QUEUE_SETTING = "memory/limits/command_queue/multithreading_queue_size_kb";
 	ProjectSettings::get_singleton()->set_setting(COMMAND_QUEUE_SETTING, 1);
 	SharedThreadState sts;
 	sts.init_threads();
 
-	int msgs_to_add = 24; // a queue of size 1kB fundamentally cannot fit 24 matrices.
+	int msgs_to_add = 24; // a block of size 1kB fundamentally cannot fit 24 matrices.
 	for (int i = 0; i < msgs_to_add; i++) {
 		sts.add_msg_to_write(SharedThreadState::TEST_MSG_FUNC1_TRANSFORM);
 	}
 	sts.writer_threadwork.main_start_work();
-	// If we call main_wait_for_done, we will deadlock. So instead...
+	// The queue grows instead of waiting for the reader.
+	sts.writer_threadwork.main_wait_for_done();
+	CHECK_MESSAGE(sts.during_writing == false,
+			"Writer thread should not be blocked on writing.");
+	CHECK_MESSAGE(sts.func1_count == 0,
+			"Control: no messages read before reader has run.");
+
 	sts.message_count_to_read = 1;
 	sts.reader_threadwork.main_start_work();
 	sts.reader_threadwork.main_wait_for_done();
 	CHECK_MESSAGE(sts.func1_count == 1,
 			"Reader should have read one message");
-	CHECK_MESSAGE(sts.during_writing,
-			"Writer thread should still be blocked on writing.");
-	sts.message_count_to_read = msgs_to_add - 3;
-	sts.reader_threadwork.main_start_work();
-	sts.reader_threadwork.main_wait_for_done();
-	CHECK_MESSAGE(sts.func1_count >= msgs_to_add - 3,
-			"Reader should have read most messages");
-	sts.writer_threadwork.main_wait_for_done();
-	CHECK_MESSAGE(sts.during_writing == false,
-			"Writer thread should no longer be blocked on writing.");
-	sts.message_count_to_read = 2;
+
+	sts.message_count_to_read = msgs_to_add - 2;
 	sts.reader_threadwork.main_start_work();
 	sts.reader_threadwork.main_wait_for_done();
+	CHECK_MESSAGE(sts.func1_count == msgs_to_add - 1,
+			"Reader should have read messages across blocks");
+
 	sts.message_count_to_read = -1;
 	sts.reader_threadwork.main_start_work();
 	sts.reader_threadwork.main_wait_for_done();
 	CHECK_MESSAGE(sts.func1_count == msgs_to_add,
 			"Reader should have read all messages");
 
+	// Blocks are recycled, keep going with commands bigger than a block.
+	for (int i = 0; i < msgs_to_add; i++) {
+		sts.add_msg_to_write(SharedThreadState::TEST_MSG_FUNC3_TRANSFORMx6);
+	}
+	sts.writer_threadwork.main_start_work();
+	sts.writer_threadwork.main_wait_for_done();
+	sts.message_count_to_read = -1;
+	sts.reader_threadwork.main_start_work();
+	sts.reader_threadwork.main_wait_for_done();
+	CHECK_MESSAGE(sts.func1_count == msgs_to_add * 2,
+			"Reader should have read all the big messages");
+
 	sts.destroy_threads();
 
-	CHECK_MESSAGE(sts.func1_count == msgs_to_add,
+	CHECK_MESSAGE(sts.func1_count == msgs_to_add * 2,
 			"Reader should have read no additional messages after join");
 	ProjectSettings::get_singleton()->set_setting(COMMAND_QUEUE_SETTING,
 			ProjectSettings::get_singleton()->property_get_revert(COMMAND_QUEUE_SETTING));
@@ -474,6 +486,69 @@ TEST_CASE("[Stress][CommandQueue] Stress test command queue") {
 	ProjectSettings::get_singleton()->set_setting(COMMAND_QUEUE_SETTING,
 			ProjectSettings::get_singleton()->property_get_revert(COMMAND_QUEUE_SETTING));
 }
+
+class ThroughputState {
+public:
+	CommandQueueMT command_queue = CommandQueueMT(true);
+	uint64_t sum = 0;
+	bool exit = false;
+
+	void add(uint32_t p_value) {
+		sum += p_value;
+	}
+	void add_transform(Transform p_transform, uint32_t p_value) {
+		sum += p_value;
+	}
+	void stop() {
+		exit = true;
+	}
+
+	// Same loop as the server wrappers.
+	static void consumer_loop(void *p_userdata) {
+		ThroughputState *state = static_cast<ThroughputState *>(p_userdata);
+		while (!state->exit) {
+			state->command_queue.wait_and_flush();
+		}
+		state->command_queue.flush_all();
+	}
+};
+
+TEST_CASE("[Stress][CommandQueue] Command queue throughput") {
+	const int command_count = 1000000;
+	const int sync_count = 10000;
+
+	ThroughputState state;
+	Thread *consumer = Thread::create(&ThroughputState::consumer_loop, &state);
+
+	uint64_t from = OS::get_singleton()->get_ticks_usec();
+	uint64_t expected = 0;
+	Transform transform;
+	for (int i = 0; i < command_count; i++) {
+		if (i & 1) {
+			state.command_queue.push(&state, &ThroughputState::add, (uint32_t)i);
+		} else {
+			state.command_queue.push(&state, &ThroughputState::add_transform, transform, (uint32_t)i);
+		}
+		expected += i;
+	}
+	// Waits for the consumer to catch up.
+	state.command_queue.push_and_sync(&state, &ThroughputState::add, (uint32_t)0);
+	uint64_t push_usec = OS::get_singleton()->get_ticks_usec() - from;
+	CHECK(state.sum == expected);
+
+	from = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < sync_count; i++) {
+		state.command_queue.push_and_sync(&state, &ThroughputState::add, (uint32_t)1);
+	}
+	uint64_t sync_usec = OS::get_singleton()->get_ticks_usec() - from;
+	CHECK(state.sum == expected + sync_count);
+
+	state.command_queue.push(&state, &ThroughputState::stop);
+	Thread::wait_to_finish(consumer);
+	memdelete(consumer);
+
+	MESSAGE(command_count, " commands pushed and run in ", push_usec, " usec, ", sync_count, " synced commands in ", sync_usec, " usec.");
+}
 } // namespace TestCommandQueue
 
 #endif // !defined(NO_THREADS)
@@ -0,0 +1,415 @@
+/*************************************************************************/
+/*  test_container_benchmark.h                                           */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_CONTAINER_BENCHMARK_H
+#define TEST_CONTAINER_BENCHMARK_H
+
+#include "core/math/random_pcg.h"
+#include "core/os/os.h"
+#include "core/templates/flat_hash_map.h"
+#include "core/templates/hash_map.h"
+#include "core/templates/local_vector.h"
+#include "core/templates/map.h"
+#include "core/templates/oa_hash_map.h"
+#include "core/templates/set.h"
+#include "core/templates/vset.h"
+#include "core/variant/array.h"
+#include "core/variant/dictionary.h"
+
+#include "tests/test_macros.h"
+
+// Compares the associative containers on the operations the engine uses them
+// for: filling, looking up existing and missing keys, iterating and erasing,
+// both for a few big maps and for many small ones (like the per body and per
+// cell maps of the physics servers), and the sets on small pointer sets.
+// Also times creating, iterating and copying the Variant containers, with the
+// heap allocations they make in debug builds.
+//
+// Run with: godot --test container-benchmark [--elements N] [--rounds N]
+
+namespace TestContainerBenchmark {
+
+struct Settings {
+	int elements = 100000; // In the big map.
+	int small_elements = 4; // In each small map.
+	int rounds = 5;
+};
+
+// Same interface on top of each map.
+struct MapAdapter {
+	static const char *get_name() { return "Map"; }
+	Map<uint32_t, uint32_t> map;
+	void insert(uint32_t p_key, uint32_t p_value) { map.insert(p_key, p_value); }
+	bool has(uint32_t p_key) const { return map.has(p_key); }
+	void erase(uint32_t p_key) { map.erase(p_key); }
+	uint64_t sum() const {
+		uint64_t sum = 0;
+		for (const Map<uint32_t, uint32_t>::Element *E = map.front(); E; E = E->next()) {
+			sum += E->get();
+		}
+		return sum;
+	}
+};
+
+struct HashMapAdapter {
+	static const char *get_name() { return "HashMap"; }
+	HashMap<uint32_t, uint32_t> map;
+	void insert(uint32_t p_key, uint32_t p_value) { map.set(p_key, p_value); }
+	bool has(uint32_t p_key) const { return map.has(p_key); }
+	void erase(uint32_t p_key) { map.erase(p_key); }
+	uint64_t sum() const {
+		uint64_t sum = 0;
+		const uint32_t *key = nullptr;
+		while ((key = map.next(key))) {
+			sum += map[*key];
+		}
+		return sum;
+	}
+};
+
+struct OAHashMapAdapter {
+	static const char *get_name() { return "OAHashMap"; }
+	OAHashMap<uint32_t, uint32_t> map;
+	void insert(uint32_t p_key, uint32_t p_value) { map.set(p_key, p_value); }
+	bool has(uint32_t p_key) const { return map.has(p_key); }
+	void erase(uint32_t p_key) { map.remove(p_key); }
+	uint64_t sum() const {
+		uint64_t sum = 0;
+		for (OAHashMap<uint32_t, uint32_t>::Iterator it = map.iter(); it.valid; it = map.next_iter(it)) {
+			sum += *it.value;
+		}
+		return sum;
+	}
+};
+
+struct FlatHashMapAdapter {
+	static const char *get_name() { return "FlatHashMap"; }
+	FlatHashMap<uint32_t, uint32_t> map;
+	void insert(uint32_t p_key, uint32_t p_value) { map.insert(p_key, p_value); }
+	bool has(uint32_t p_key) const { return map.has(p_key); }
+	void erase(uint32_t p_key) { map.erase(p_key); }
+	uint64_t sum() const {
+		uint64_t sum = 0;
+		for (uint32_t i = 0; i < map.size(); i++) {
+			sum += map.get_value(i);
+		}
+		return sum;
+	}
+};
+
+struct MapResults {
+	uint64_t insert_usec = 0;
+	uint64_t lookup_usec = 0; // Half the keys looked up are missing.
+	uint64_t iterate_usec = 0;
+	uint64_t erase_usec = 0;
+	uint64_t small_usec = 0; // Filling, querying and freeing the small maps.
+	uint64_t checksum = 0; // Must be the same for all maps.
+};
+
+static LocalVector<uint32_t> make_keys(int p_count, uint64_t p_seed) {
+	RandomPCG rng(p_seed);
+	LocalVector<uint32_t> keys;
+	keys.resize(p_count);
+	for (int i = 0; i < p_count; i++) {
+		keys[i] = rng.rand();
+	}
+	return keys;
+}
+
+template <class T>
+static MapResults run_map(const Settings &p_settings) {
+	MapResults results;
+	LocalVector<uint32_t> keys = make_keys(p_settings.elements, 1);
+	LocalVector<uint32_t> missing = make_keys(p_settings.elements, 2);
+
+	for (int round = 0; round < p_settings.rounds; round++) {
+		T *adapter = memnew(T);
+
+		uint64_t from = OS::get_singleton()->get_ticks_usec();
+		for (uint32_t i = 0; i < keys.size(); i++) {
+			adapter->insert(keys[i], i);
+		}
+		results.insert_usec += OS::get_singleton()->get_ticks_usec() - from;
+
+		uint64_t found = 0;
+		from = OS::get_singleton()->get_ticks_usec();
+		for (uint32_t i = 0; i < keys.size(); i++) {
+			found += adapter->has(keys[i]);
+			found += adapter->has(missing[i]);
+		}
+		results.lookup_usec += OS::get_singleton()->get_ticks_usec() - from;
+
+		from = OS::get_singleton()->get_ticks_usec();
+		uint64_t sum = adapter->sum();
+		results.iterate_usec += OS::get_singleton()->get_ticks_usec() - from;
+
+		from = OS::get_singleton()->get_ticks_usec();
+		for (uint32_t i = 0; i < keys.size(); i++) {
+			adapter->erase(keys[i]);
+		}
+		results.erase_usec += OS::get_singleton()->get_ticks_usec() - from;
+
+		memdelete(adapter);
+		results.checksum = found + sum;
+	}
+
+	const int small_maps = MAX(p_settings.elements / p_settings.small_elements, 1);
+	uint64_t found = 0;
+	uint64_t from = OS::get_singleton()->get_ticks_usec();
+	for (int round = 0; round < p_settings.rounds; round++) {
+		T *adapters = memnew_arr(T, small_maps);
+		for (int i = 0; i < small_maps; i++) {
+			for (int j = 0; j < p_settings.small_elements; j++) {
+				adapters[i].insert(keys[i * p_settings.small_elements + j], j);
+			}
+		}
+		for (int i = 0; i < small_maps; i++) {
+			for (int j = 0; j < p_settings.small_elements; j++) {
+				found += adapters[i].has(keys[i * p_settings.small_elements + j]);
+			}
+			found += adapters[i].has(missing[i]);
+		}
+		memdelete_arr(adapters);
+	}
+	results.small_usec = OS::get_singleton()->get_ticks_usec() - from;
+	results.checksum += found;
+
+	results.insert_usec /= p_settings.rounds;
+	results.lookup_usec /= p_settings.rounds;
+	results.iterate_usec /= p_settings.rounds;
+	results.erase_usec /= p_settings.rounds;
+	results.small_usec /= p_settings.rounds;
+	return results;
+}
+
+struct SetResults {
+	uint64_t set_usec = 0;
+	uint64_t vset_usec = 0;
+	uint64_t checksum = 0;
+	uint64_t vset_checksum = 0;
+};
+
+// Small pointer sets that get inserted to, checked and erased from, like the constraints of an area.
+static SetResults run_sets(const Settings &p_settings) {
+	SetResults results;
+	LocalVector<uint32_t> keys = make_keys(p_settings.elements, 3);
+	const int set_size = 16;
+	const int sets = MAX(p_settings.elements / set_size, 1);
+
+	uint64_t from = OS::get_singleton()->get_ticks_usec();
+	for (int round = 0; round < p_settings.rounds; round++) {
+		for (int i = 0; i < sets; i++) {
+			Set<const uint32_t *> set;
+			for (int j = 0; j < set_size; j++) {
+				set.insert(&keys[i * set_size + j]);
+			}
+			for (int j = 0; j < set_size; j++) {
+				results.checksum += set.has(&keys[(i * set_size + j * 7) % keys.size()]);
+			}
+			for (int j = 0; j < set_size; j += 2) {
+				set.erase(&keys[i * set_size + j]);
+			}
+			results.checksum += set.size();
+		}
+	}
+	results.set_usec = (OS::get_singleton()->get_ticks_usec() - from) / p_settings.rounds;
+
+	from = OS::get_singleton()->get_ticks_usec();
+	for (int round = 0; round < p_settings.rounds; round++) {
+		for (int i = 0; i < sets; i++) {
+			VSet<const uint32_t *> set;
+			for (int j = 0; j < set_size; j++) {
+				set.insert(&keys[i * set_size + j]);
+			}
+			for (int j = 0; j < set_size; j++) {
+				results.vset_checksum += set.has(&keys[(i * set_size + j * 7) % keys.size()]);
+			}
+			for (int j = 0; j < set_size; j += 2) {
+				set.erase(&keys[i * set_size + j]);
+			}
+			results.vset_checksum += set.size();
+		}
+	}
+	results.vset_usec = (OS::get_singleton()->get_ticks_usec() - from) / p_settings.rounds;
+
+	return results;
+}
+
+struct VariantResults {
+	uint64_t small_array_usec = 0; // Creating and freeing the small containers.
+	uint64_t small_dictionary_usec = 0;
+	uint64_t small_array_allocs = 0; // Per container.
+	uint64_t small_dictionary_allocs = 0;
+	uint64_t array_iterate_usec = 0;
+	uint64_t dictionary_iterate_usec = 0;
+	uint64_t reference_usec = 0; // Copying by reference, then writing to the copy.
+	uint64_t duplicate_usec = 0;
+	uint64_t checksum = 0;
+};
+
+static VariantResults run_variant_containers(const Settings &p_settings) {
+	VariantResults results;
+	const int small_containers = MAX(p_settings.elements / p_settings.small_elements, 1);
+
+	uint64_t allocs_from = Memory::get_alloc_total();
+	uint64_t from = OS::get_singleton()->get_ticks_usec();
+	for (int round = 0; round < p_settings.rounds; round++) {
+		for (int i = 0; i < small_containers; i++) {
+			Array array;
+			for (int j = 0; j < p_settings.small_elements; j++) {
+				array.push_back(i + j);
+			}
+			results.checksum += int(array[array.size() - 1]);
+		}
+	}
+	results.small_array_usec = (OS::get_singleton()->get_ticks_usec() - from) / p_settings.rounds;
+	results.small_array_allocs = (Memory::get_alloc_total() - allocs_from) / (small_containers * p_settings.rounds);
+
+	allocs_from = Memory::get_alloc_total();
+	from = OS::get_singleton()->get_ticks_usec();
+	for (int round = 0; round < p_settings.rounds; round++) {
+		for (int i = 0; i < small_containers; i++) {
+			Dictionary dictionary;
+			for (int j = 0; j < p_settings.small_elements; j++) {
+				dictionary[j] = i + j;
+			}
+			results.checksum += int(dictionary[p_settings.small_elements - 1]);
+		}
+	}
+	results.small_dictionary_usec = (OS::get_singleton()->get_ticks_usec() - from) / p_settings.rounds;
+	results.small_dictionary_allocs = (Memory::get_alloc_total() - allocs_from) / (small_containers * p_settings.rounds);
+
+	Array array;
+	Dictionary dictionary;
+	for (int i = 0; i < p_settings.elements; i++) {
+		array.push_back(i);
+		dictionary[i] = i;
+	}
+
+	from = OS::get_singleton()->get_ticks_usec();
+	for (int round = 0; round < p_settings.rounds; round++) {
+		for (int i = 0; i < array.size(); i++) {
+			results.checksum += int(array[i]);
+		}
+	}
+	results.array_iterate_usec = (OS::get_singleton()->get_ticks_usec() - from) / p_settings.rounds;
+
+	from = OS::get_singleton()->get_ticks_usec();
+	for (int round = 0; round < p_settings.rounds; round++) {
+		const Variant *key = nullptr;
+		while ((key = dictionary.next(key))) {
+			results.checksum += int(*dictionary.getptr(*key));
+		}
+	}
+	results.dictionary_iterate_usec = (OS::get_singleton()->get_ticks_usec() - from) / p_settings.rounds;
+
+	from = OS::get_singleton()->get_ticks_usec();
+	for (int round = 0; round < p_settings.rounds; round++) {
+		Array reference = array;
+		reference[0] = round;
+		results.checksum += int(array[0]);
+	}
+	results.reference_usec = (OS::get_singleton()->get_ticks_usec() - from) / p_settings.rounds;
+
+	from = OS::get_singleton()->get_ticks_usec();
+	for (int round = 0; round < p_settings.rounds; round++) {
+		Array copy = array.duplicate();
+		copy[0] = round;
+		results.checksum += int(copy[0]);
+	}
+	results.duplicate_usec = (OS::get_singleton()->get_ticks_usec() - from) / p_settings.rounds;
+
+	return results;
+}
+
+template <class T>
+static void print_map_results(const MapResults &p_results) {
+	print_line(vformat("  %-12s insert %6d  lookup %6d  iterate %6d  erase %6d usec", T::get_name(), p_results.insert_usec, p_results.lookup_usec, p_results.iterate_usec, p_results.erase_usec));
+	print_line(vformat("  %-12s small maps %6d usec", "", p_results.small_usec));
+}
+
+static void benchmark() {
+	Settings settings;
+	List<String> args = OS::get_singleton()->get_cmdline_args();
+	for (List<String>::Element *E = args.front(); E; E = E->next()) {
+		if (!E->next()) {
+			break;
+		}
+		int value = E->next()->get().to_int();
+		if (E->get() == "--elements") {
+			settings.elements = MAX(value, settings.small_elements);
+		} else if (E->get() == "--rounds") {
+			settings.rounds = MAX(value, 1);
+		}
+	}
+
+	print_line(vformat("Maps: %d elements, %d rounds, small maps of %d elements.", settings.elements, settings.rounds, settings.small_elements));
+	print_map_results<MapAdapter>(run_map<MapAdapter>(settings));
+	print_map_results<HashMapAdapter>(run_map<HashMapAdapter>(settings));
+	print_map_results<OAHashMapAdapter>(run_map<OAHashMapAdapter>(settings));
+	print_map_results<FlatHashMapAdapter>(run_map<FlatHashMapAdapter>(settings));
+
+	SetResults set_results = run_sets(settings);
+	print_line("Sets of 16 pointers:");
+	print_line(vformat("  Set  %6d usec", set_results.set_usec));
+	print_line(vformat("  VSet %6d usec", set_results.vset_usec));
+
+	VariantResults variant_results = run_variant_containers(settings);
+	print_line("Variant containers:");
+	print_line(vformat("  Small Array      %6d usec, %d allocations each", variant_results.small_array_usec, variant_results.small_array_allocs));
+	print_line(vformat("  Small Dictionary %6d usec, %d allocations each", variant_results.small_dictionary_usec, variant_results.small_dictionary_allocs));
+	print_line(vformat("  Iterate Array %6d usec, Dictionary %6d usec", variant_results.array_iterate_usec, variant_results.dictionary_iterate_usec));
+	print_line(vformat("  Copy Array by reference %6d usec, duplicate %6d usec", variant_results.reference_usec, variant_results.duplicate_usec));
+}
+
+REGISTER_TEST_COMMAND("container-benchmark", &benchmark);
+
+// Keeps the harness working; timings are not checked, as they depend on the machine.
+TEST_CASE("[ContainerBenchmark] All containers give the same results") {
+	Settings settings;
+	settings.elements = 2000;
+	settings.rounds = 1;
+
+	uint64_t checksum = run_map<MapAdapter>(settings).checksum;
+	CHECK(checksum > 0);
+	CHECK(run_map<HashMapAdapter>(settings).checksum == checksum);
+	CHECK(run_map<OAHashMapAdapter>(settings).checksum == checksum);
+	CHECK(run_map<FlatHashMapAdapter>(settings).checksum == checksum);
+
+	SetResults set_results = run_sets(settings);
+	CHECK(set_results.checksum > 0);
+	CHECK(set_results.vset_checksum == set_results.checksum);
+
+	CHECK(run_variant_containers(settings).checksum > 0);
+}
+
+} // namespace TestContainerBenchmark
+
+#endif // TEST_CONTAINER_BENCHMARK_H
@@ -0,0 +1,155 @@
+/*************************************************************************/
+/*  test_dictionary.h                                                    */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_DICTIONARY_H
+#define TEST_DICTIONARY_H
+
+#include "core/os/memory.h"
+#include "core/variant/dictionary.h"
+#include "core/variant/variant.h"
+
+#include "tests/test_macros.h"
+
+namespace TestDictionary {
+
+TEST_CASE("[Dictionary] Keys keep the insertion order") {
+	Dictionary dictionary;
+	for (int i = 0; i < 20; i++) {
+		dictionary[itos(i * 7 % 20)] = i;
+	}
+	CHECK(dictionary.size() == 20);
+
+	Array keys = dictionary.keys();
+	Array values = dictionary.values();
+	int wrong = 0;
+	for (int i = 0; i < 20; i++) {
+		wrong += keys[i] != Variant(itos(i * 7 % 20));
+		wrong += values[i] != Variant(i);
+		wrong += dictionary.get_key_at_index(i) != keys[i];
+		wrong += dictionary.get_value_at_index(i) != values[i];
+	}
+	CHECK(wrong == 0);
+
+	int index = 0;
+	const Variant *key = nullptr;
+	while ((key = dictionary.next(key))) {
+		wrong += *key != keys[index];
+		index++;
+	}
+	CHECK(index == 20);
+	CHECK(wrong == 0);
+
+	// Iterating with a copy of the key, like scripts do.
+	Variant iter_key = *dictionary.next();
+	index = 1;
+	while (const Variant *next = dictionary.next(&iter_key)) {
+		iter_key = *next;
+		wrong += iter_key != keys[index];
+		index++;
+	}
+	CHECK(index == 20);
+	CHECK(wrong == 0);
+}
+
+TEST_CASE("[Dictionary] Erase and insert again") {
+	Dictionary dictionary;
+	dictionary["a"] = 1;
+	dictionary["b"] = 2;
+	dictionary["c"] = 3;
+
+	CHECK(dictionary.erase("b"));
+	CHECK(!dictionary.erase("b"));
+	CHECK(!dictionary.has("b"));
+	CHECK(dictionary.size() == 2);
+
+	dictionary["d"] = 4;
+	dictionary["e"] = 5;
+	dictionary["f"] = 6;
+	dictionary["b"] = 7;
+	CHECK(dictionary.size() == 6);
+
+	Array keys = dictionary.keys();
+	CHECK(keys[0] == Variant("a"));
+	CHECK(keys[1] == Variant("c"));
+	CHECK(keys[5] == Variant("b"));
+	CHECK(dictionary.get("b", 0) == Variant(7));
+	CHECK(dictionary.get("x", 0) == Variant(0));
+
+	dictionary.clear();
+	CHECK(dictionary.is_empty());
+	CHECK(dictionary.next() == nullptr);
+	dictionary["g"] = 8;
+	CHECK(dictionary.size() == 1);
+	CHECK(*dictionary.next() == Variant("g"));
+}
+
+TEST_CASE("[Dictionary] Values don't move when adding elements") {
+	Dictionary dictionary;
+	dictionary[0] = "zero";
+	Variant *value = dictionary.getptr(0);
+	for (int i = 1; i < 100; i++) {
+		dictionary[i] = itos(i);
+	}
+	CHECK(dictionary.getptr(0) == value);
+	CHECK(*value == Variant("zero"));
+}
+
+TEST_CASE("[Dictionary] Copies and hashes") {
+	Dictionary dictionary;
+	for (int i = 0; i < 6; i++) {
+		dictionary[i] = i * i;
+	}
+	Dictionary copy = dictionary.duplicate();
+	CHECK(copy != dictionary);
+	CHECK(copy.hash() == dictionary.hash());
+	CHECK(copy.keys().hash() == dictionary.keys().hash());
+
+	copy.erase(5);
+	CHECK(dictionary.has(5));
+	CHECK(copy.hash() != dictionary.hash());
+}
+
+#ifdef DEBUG_ENABLED
+TEST_CASE("[Dictionary] Small dictionaries are a single allocation") {
+	uint64_t from = Memory::get_alloc_total();
+	{
+		Dictionary dictionary;
+		dictionary[1] = 2;
+		dictionary[3] = 4;
+		dictionary[5] = 6;
+		dictionary[7] = 8;
+	}
+	CHECK(Memory::get_alloc_total() - from == 1);
+}
+#endif
+
+} // namespace TestDictionary
+
+#endif // TEST_DICTIONARY_H
@@ -0,0 +1,198 @@
+/*************************************************************************/
+/*  test_flat_hash_map.h                                                 */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_FLAT_HASH_MAP_H
+#define TEST_FLAT_HASH_MAP_H
+
+#include "core/math/random_pcg.h"
+#include "core/string/ustring.h"
+#include "core/templates/flat_hash_map.h"
+#include "core/templates/map.h"
+#include "core/templates/vset.h"
+
+#include "tests/test_macros.h"
+
+namespace TestFlatHashMap {
+
+TEST_CASE("[FlatHashMap] Insert, find and overwrite") {
+	FlatHashMap<int, int> map;
+	CHECK(map.is_empty());
+	CHECK(map.getptr(42) == nullptr);
+
+	map.insert(42, 84);
+	map.insert(42, 1234);
+	map[7] = 14;
+
+	CHECK(map.size() == 2);
+	CHECK(map[42] == 1234);
+	CHECK(*map.getptr(7) == 14);
+	CHECK(map.has(7));
+	CHECK(!map.has(8));
+	CHECK(map.find_index(8) == -1);
+}
+
+TEST_CASE("[FlatHashMap] Iteration follows insertion order") {
+	FlatHashMap<String, int> map;
+	for (int i = 0; i < 100; i++) {
+		map.insert(itos(i * 31 % 100), i);
+	}
+
+	int wrong = 0;
+	for (uint32_t i = 0; i < map.size(); i++) {
+		wrong += map.get_key(i) != itos(i * 31 % 100);
+		wrong += map.get_value(i) != int(i);
+	}
+	CHECK(wrong == 0);
+
+	// The last element takes the place of the erased one.
+	map.erase(itos(0));
+	CHECK(map.size() == 99);
+	CHECK(map.get_key(0) == itos(99 * 31 % 100));
+	CHECK(map[itos(99 * 31 % 100)] == 99);
+}
+
+TEST_CASE("[FlatHashMap] Erase while iterating") {
+	FlatHashMap<int, int> map;
+	for (int i = 0; i < 1000; i++) {
+		map.insert(i, i);
+	}
+
+	for (uint32_t i = 0; i < map.size();) {
+		if (map.get_value(i) % 3 == 0) {
+			map.erase_index(i);
+		} else {
+			i++;
+		}
+	}
+
+	CHECK(map.size() == 666);
+	int wrong = 0;
+	for (int i = 0; i < 1000; i++) {
+		wrong += map.has(i) == (i % 3 == 0);
+	}
+	CHECK(wrong == 0);
+}
+
+TEST_CASE("[FlatHashMap] Copy and clear") {
+	FlatHashMap<int, String> map;
+	for (int i = 0; i < 50; i++) {
+		map.insert(i, itos(i));
+	}
+
+	FlatHashMap<int, String> copy = map;
+	map.clear();
+	CHECK(map.is_empty());
+	CHECK(!map.has(10));
+
+	CHECK(copy.size() == 50);
+	CHECK(copy[10] == "10");
+	copy.erase(10);
+	CHECK(!copy.has(10));
+	CHECK(copy.has(11));
+
+	// Cleared maps can be filled again.
+	map.reserve(200);
+	for (int i = 0; i < 200; i++) {
+		map[i] = itos(i);
+	}
+	CHECK(map.size() == 200);
+	CHECK(map[199] == "199");
+}
+
+TEST_CASE("[FlatHashMap] Pointer keys") {
+	int values[16];
+	FlatHashMap<int *, int> map;
+	for (int i = 0; i < 16; i++) {
+		map[&values[i]] = i;
+	}
+	int wrong = 0;
+	for (int i = 0; i < 16; i++) {
+		wrong += map[&values[i]] != i;
+	}
+	CHECK(wrong == 0);
+}
+
+TEST_CASE("[FlatHashMap] Random operations match Map") {
+	// Few distinct keys, so inserts, overwrites and erases of existing keys are all frequent.
+	RandomPCG rng(42);
+
+	FlatHashMap<int, int> map;
+	Map<int, int> reference;
+	int mismatches = 0;
+
+	for (int i = 0; i < 20000; i++) {
+		int key = rng.rand() % 500;
+		switch (rng.rand() % 3) {
+			case 0: {
+				map.insert(key, i);
+				reference.insert(key, i);
+			} break;
+			case 1: {
+				mismatches += map.erase(key) != reference.erase(key);
+			} break;
+			case 2: {
+				const int *value = map.getptr(key);
+				const Map<int, int>::Element *E = reference.find(key);
+				mismatches += (value == nullptr) != (E == nullptr);
+				mismatches += value && *value != E->get();
+			} break;
+		}
+	}
+
+	CHECK(mismatches == 0);
+	CHECK(map.size() == uint32_t(reference.size()));
+	for (uint32_t i = 0; i < map.size(); i++) {
+		mismatches += reference[map.get_key(i)] != map.get_value(i);
+	}
+	CHECK(mismatches == 0);
+}
+
+TEST_CASE("[VSet] Sorted and cleared") {
+	VSet<int> set;
+	set.insert(5);
+	set.insert(1);
+	set.insert(3);
+	set.insert(3);
+
+	CHECK(set.size() == 3);
+	CHECK(set[0] == 1);
+	CHECK(set[1] == 3);
+	CHECK(set[2] == 5);
+	CHECK(set.has(3));
+
+	set.erase(3);
+	CHECK(!set.has(3));
+	set.clear();
+	CHECK(set.is_empty());
+}
+
+} // namespace TestFlatHashMap
+
+#endif // TEST_FLAT_HASH_MAP_H
@@ -0,0 +1,228 @@
+/*************************************************************************/
+/*  test_frame_arena.h                                                   */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_FRAME_ARENA_H
+#define TEST_FRAME_ARENA_H
+
+#include "core/os/frame_arena.h"
+#include "core/os/memory.h"
+#include "core/os/thread.h"
+#include "core/templates/list.h"
+#include "core/templates/local_vector.h"
+
+#include "tests/test_macros.h"
+
+namespace TestFrameArena {
+
+TEST_CASE("[FrameArena] Allocations are aligned and keep their content") {
+	FrameArenaScope scope;
+
+	const int count = 200;
+	uint8_t *mems[count];
+	for (int i = 0; i < count; i++) {
+		mems[i] = (uint8_t *)FrameArena::alloc(i * 37 + 1);
+		for (int j = 0; j < i * 37 + 1; j++) {
+			mems[i][j] = i;
+		}
+	}
+
+	int misaligned = 0;
+	int corrupted = 0;
+	for (int i = 0; i < count; i++) {
+		misaligned += (uintptr_t(mems[i]) % FrameArena::ALIGN) != 0;
+		for (int j = 0; j < i * 37 + 1; j++) {
+			corrupted += mems[i][j] != i;
+		}
+	}
+	CHECK(misaligned == 0);
+	CHECK(corrupted == 0);
+}
+
+TEST_CASE("[FrameArena] Reallocations") {
+	FrameArenaScope scope;
+
+	// The last allocation grows in place.
+	uint8_t *first = (uint8_t *)FrameArena::alloc(16);
+	uint8_t *last = (uint8_t *)FrameArena::alloc(16);
+	for (int i = 0; i < 16; i++) {
+		first[i] = 1;
+		last[i] = 2;
+	}
+	CHECK(FrameArena::realloc(last, 1024) == last);
+
+	// Others move, keeping their content.
+	uint8_t *moved = (uint8_t *)FrameArena::realloc(first, 64);
+	CHECK(moved != first);
+	int corrupted = 0;
+	for (int i = 0; i < 16; i++) {
+		corrupted += moved[i] != 1;
+		corrupted += last[i] != 2;
+	}
+	CHECK(corrupted == 0);
+
+	// Shrinking never moves.
+	CHECK(FrameArena::realloc(last, 8) == last);
+	CHECK(FrameArena::realloc(moved, 8) == moved);
+
+	// Too big for any block.
+	uint8_t *big = (uint8_t *)FrameArena::realloc(moved, FrameArena::BLOCK_SIZE * 3);
+	REQUIRE(big != nullptr);
+	CHECK(big[0] == 1);
+	CHECK(big[7] == 1);
+	big[FrameArena::BLOCK_SIZE * 3 - 1] = 3;
+}
+
+TEST_CASE("[FrameArena] Scopes give the memory back") {
+	FrameArenaScope scope;
+	FrameArena::alloc(100);
+	size_t used = FrameArena::get_thread_memory_used();
+
+	{
+		FrameArenaScope outer;
+		FrameArena::alloc(1000);
+		size_t outer_used = FrameArena::get_thread_memory_used();
+		CHECK(outer_used > used);
+		{
+			FrameArenaScope inner;
+			// Spills over to other blocks.
+			for (int i = 0; i < 10; i++) {
+				FrameArena::alloc(FrameArena::BLOCK_SIZE / 2);
+			}
+			CHECK(FrameArena::get_thread_memory_used() > outer_used);
+		}
+		CHECK(FrameArena::get_thread_memory_used() == outer_used);
+	}
+	CHECK(FrameArena::get_thread_memory_used() == used);
+
+	// The blocks left over are reused.
+	uint8_t *mem = (uint8_t *)FrameArena::alloc(FrameArena::BLOCK_SIZE);
+	mem[FrameArena::BLOCK_SIZE - 1] = 1;
+}
+
+TEST_CASE("[FrameArena] Containers") {
+	for (int frame = 0; frame < 3; frame++) {
+		FrameArenaScope scope;
+
+		LocalVector<int, uint32_t, false, FrameArena> vector;
+		List<int, FrameArena> list;
+
+		for (int i = 0; i < 5000; i++) {
+			vector.push_back(i);
+			list.push_back(i);
+		}
+
+		int wrong = 0;
+		int index = 0;
+		for (List<int, FrameArena>::Element *E = list.front(); E; E = E->next()) {
+			wrong += vector[index] != index;
+			wrong += E->get() != index;
+			index++;
+		}
+		CHECK(index == 5000);
+		CHECK(wrong == 0);
+
+		vector.remove(0);
+		CHECK(vector[0] == 1);
+		list.clear();
+	}
+}
+
+#ifdef DEBUG_ENABLED
+TEST_CASE("[FrameArena] Per frame containers don't touch the heap") {
+	// Like the scratch arrays of physics queries and culling: the arena has
+	// grown on the first frame, so the next ones reuse its memory.
+	uint64_t allocs_per_frame[3];
+	for (int frame = 0; frame < 3; frame++) {
+		uint64_t from = Memory::get_alloc_total();
+		{
+			FrameArenaScope scope;
+			LocalVector<uint64_t, uint32_t, false, FrameArena> vector;
+			List<uint64_t, FrameArena> list;
+			for (int i = 0; i < 2000; i++) {
+				vector.push_back(i);
+				list.push_back(i);
+			}
+		}
+		allocs_per_frame[frame] = Memory::get_alloc_total() - from;
+	}
+
+	MESSAGE("Heap allocations on the first frame: ", allocs_per_frame[0]);
+	CHECK(allocs_per_frame[1] == 0);
+	CHECK(allocs_per_frame[2] == 0);
+}
+#endif
+
+#if !defined(NO_THREADS)
+
+static void arena_thread(void *p_userdata) {
+	int *wrong = static_cast<int *>(p_userdata);
+	for (int frame = 0; frame < 10; frame++) {
+		LocalVector<int, uint32_t, false, FrameArena> vector;
+		for (int i = 0; i < 10000; i++) {
+			vector.push_back(i * frame);
+		}
+		for (int i = 0; i < 10000; i++) {
+			*wrong += vector[i] != i * frame;
+		}
+		vector.reset();
+		FrameArena::reset();
+	}
+	// Leave something allocated, it's freed when the thread exits.
+	FrameArena::alloc(1000);
+}
+
+TEST_CASE("[FrameArena] Each thread has its own arena") {
+	const int thread_count = 4;
+	int wrong[thread_count] = {};
+	Thread *threads[thread_count];
+
+	FrameArenaScope scope;
+	uint8_t *mem = (uint8_t *)FrameArena::alloc(64);
+	mem[0] = 42;
+	size_t used = FrameArena::get_thread_memory_used();
+
+	for (int i = 0; i < thread_count; i++) {
+		threads[i] = Thread::create(arena_thread, &wrong[i]);
+	}
+	for (int i = 0; i < thread_count; i++) {
+		Thread::wait_to_finish(threads[i]);
+		memdelete(threads[i]);
+		CHECK(wrong[i] == 0);
+	}
+
+	CHECK(mem[0] == 42);
+	CHECK(FrameArena::get_thread_memory_used() == used);
+}
+
+#endif // !defined(NO_THREADS)
+
+} // namespace TestFrameArena
+
+#endif // TEST_FRAME_ARENA_H
@@ -0,0 +1,254 @@
+/*************************************************************************/
+/*  test_hlod.h                                                          */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_HLOD_H
+#define TEST_HLOD_H
+
+#include "drivers/dummy/rasterizer_dummy.h"
+#include "scene/3d/hlod_generator.h"
+#include "scene/3d/mesh_instance_3d.h"
+#include "scene/resources/primitive_meshes.h"
+#include "servers/rendering/rendering_server_default.h"
+
+#include "thirdparty/doctest/doctest.h"
+
+namespace TestHLOD {
+
+// A `p_count`^3 grid of unit boxes, spaced `p_spacing` apart.
+static Vector<AABB> make_box_grid(int p_count, real_t p_spacing) {
+	Vector<AABB> aabbs;
+	for (int x = 0; x < p_count; x++) {
+		for (int y = 0; y < p_count; y++) {
+			for (int z = 0; z < p_count; z++) {
+				aabbs.push_back(AABB(Vector3(x, y, z) * p_spacing, Vector3(1, 1, 1)));
+			}
+		}
+	}
+	return aabbs;
+}
+
+TEST_CASE("[HLOD] Instances are clustered by grid cell") {
+	HLODGenerator::Settings settings;
+	settings.cluster_size = 4;
+
+	// 4x4x4 boxes, two per cell along each axis.
+	Vector<AABB> aabbs = make_box_grid(4, 2);
+	Vector<HLODGenerator::Cluster> clusters = HLODGenerator::build_clusters(aabbs, settings);
+
+	CHECK_MESSAGE(clusters.size() == 8, "Each cell should become a cluster.");
+
+	int clustered = 0;
+	for (int i = 0; i < clusters.size(); i++) {
+		CHECK(clusters[i].instances.size() == 8);
+		for (int j = 0; j < clusters[i].instances.size(); j++) {
+			CHECK_MESSAGE(clusters[i].aabb.grow(CMP_EPSILON).encloses(aabbs[clusters[i].instances[j]]), "The cluster bounds should enclose its instances.");
+		}
+		clustered += clusters[i].instances.size();
+	}
+	CHECK(clustered == aabbs.size());
+}
+
+TEST_CASE("[HLOD] Sparse cells are left untouched") {
+	HLODGenerator::Settings settings;
+	settings.cluster_size = 4;
+	settings.min_instances = 2;
+
+	Vector<AABB> aabbs = make_box_grid(2, 2); // One cell of 8 boxes.
+	aabbs.push_back(AABB(Vector3(100, 0, 0), Vector3(1, 1, 1))); // Alone in its cell.
+
+	Vector<HLODGenerator::Cluster> clusters = HLODGenerator::build_clusters(aabbs, settings);
+	REQUIRE(clusters.size() == 1);
+	CHECK(clusters[0].instances.size() == 8);
+	CHECK(clusters[0].instances.find(8) == -1);
+}
+
+TEST_CASE("[HLOD] Instance counts before and after") {
+	HLODGenerator::Settings settings;
+	settings.cluster_size = 4;
+
+	Vector<AABB> aabbs = make_box_grid(4, 2);
+	aabbs.push_back(AABB(Vector3(100, 0, 0), Vector3(1, 1, 1)));
+	Vector<HLODGenerator::Cluster> clusters = HLODGenerator::build_clusters(aabbs, settings);
+
+	settings.merge_meshes = true;
+	HLODGenerator::Stats stats = HLODGenerator::get_cluster_stats(clusters, aabbs.size(), settings);
+	CHECK(stats.clusters == 8);
+	CHECK(stats.instances_before == 65);
+	CHECK_MESSAGE(stats.instances_near == 9, "Merged clusters should draw one instance each up close.");
+	CHECK_MESSAGE(stats.instances_far == 9, "Clusters should draw one proxy each far away.");
+
+	settings.merge_meshes = false;
+	stats = HLODGenerator::get_cluster_stats(clusters, aabbs.size(), settings);
+	CHECK_MESSAGE(stats.instances_near == 65, "Unmerged clusters should draw their original instances up close.");
+	CHECK(stats.instances_far == 9);
+}
+
+// The same layout as make_box_grid(2, 2) plus a lone box, as MeshInstance3Ds.
+// The first box has a child, like a collision shape would be.
+static Node3D *make_box_scene(const Ref<Mesh> &p_mesh) {
+	Node3D *root = memnew(Node3D);
+	for (int x = 0; x < 2; x++) {
+		for (int y = 0; y < 2; y++) {
+			for (int z = 0; z < 2; z++) {
+				MeshInstance3D *mi = memnew(MeshInstance3D);
+				mi->set_mesh(p_mesh);
+				mi->set_transform(Transform(Basis(), Vector3(x, y, z) * 2 + Vector3(0.5, 0.5, 0.5)));
+				root->add_child(mi);
+			}
+		}
+	}
+	root->get_child(0)->add_child(memnew(Node3D));
+
+	MeshInstance3D *lone = memnew(MeshInstance3D);
+	lone->set_name("Lone");
+	lone->set_mesh(p_mesh);
+	lone->set_transform(Transform(Basis(), Vector3(100.5, 0.5, 0.5)));
+	root->add_child(lone);
+	return root;
+}
+
+static void find_mesh_instances(Node *p_node, Vector<MeshInstance3D *> &r_mesh_instances) {
+	MeshInstance3D *mi = Object::cast_to<MeshInstance3D>(p_node);
+	if (mi) {
+		r_mesh_instances.push_back(mi);
+	}
+	for (int i = 0; i < p_node->get_child_count(); i++) {
+		find_mesh_instances(p_node->get_child(i), r_mesh_instances);
+	}
+}
+
+TEST_CASE("[HLOD] Generating on a scene") {
+	RasterizerDummy::make_current();
+	RenderingServer *rendering_server = memnew(RenderingServerDefault);
+
+	Ref<BoxMesh> box;
+	box.instance();
+	box->set_size(Vector3(1, 1, 1));
+	const int box_index_count = box->surface_get_array_index_len(0);
+	REQUIRE(box_index_count > 0);
+
+	HLODGenerator::Settings settings;
+	settings.cluster_size = 4;
+	settings.distance = 50;
+
+	SUBCASE("Merged clusters") {
+		settings.merge_meshes = true;
+		Node3D *root = make_box_scene(box);
+		HLODGenerator::Stats stats = HLODGenerator::generate(root, settings);
+		CHECK(stats.clusters == 1);
+		CHECK(stats.instances_before == 9);
+
+		Vector<MeshInstance3D *> mesh_instances;
+		find_mesh_instances(root, mesh_instances);
+
+		int drawn_near = 0;
+		int drawn_far = 0;
+		MeshInstance3D *proxy = nullptr;
+		MeshInstance3D *detail = nullptr;
+		for (int i = 0; i < mesh_instances.size(); i++) {
+			MeshInstance3D *mi = mesh_instances[i];
+			if (mi->get_mesh().is_null()) {
+				CHECK_MESSAGE(mi->get_child_count() == 1, "Only the clustered instance with children should be kept.");
+				continue;
+			}
+			if (mi->get_lod_min_distance() > 0) {
+				proxy = mi;
+			} else if (mi->get_lod_max_distance() > 0) {
+				detail = mi;
+			}
+			drawn_near += mi->get_lod_min_distance() == 0 ? 1 : 0;
+			drawn_far += mi->get_lod_max_distance() == 0 ? 1 : 0;
+		}
+		CHECK_MESSAGE(mesh_instances.size() == 4, "The lone box, the kept box, the merged cluster and its proxy should be left.");
+		CHECK(drawn_near == stats.instances_near);
+		CHECK(drawn_far == stats.instances_far);
+		CHECK(drawn_near == 2);
+		CHECK(drawn_far == 2);
+
+		REQUIRE(proxy);
+		REQUIRE(detail);
+		CHECK(proxy->get_lod_min_distance() == 50);
+		CHECK(proxy->get_lod_max_distance() == 0);
+		CHECK(detail->get_lod_max_distance() == 50);
+		CHECK_MESSAGE(detail->get_node_or_null(detail->get_lod_parent()) == proxy, "The merged cluster should swap with its proxy as a group.");
+
+		REQUIRE(detail->get_mesh()->get_surface_count() == 1);
+		CHECK_MESSAGE(detail->get_mesh()->surface_get_array_index_len(0) == box_index_count * 8, "The merged cluster should contain every box.");
+		REQUIRE(proxy->get_mesh()->get_surface_count() == 1);
+		CHECK(proxy->get_mesh()->surface_get_array_index_len(0) > 0);
+		CHECK(proxy->get_mesh()->surface_get_array_index_len(0) <= box_index_count * 8);
+		CHECK_MESSAGE(proxy->get_mesh()->get_aabb().grow(CMP_EPSILON).encloses(AABB(Vector3(-1.5, -1.5, -1.5), Vector3(3, 3, 3))), "The proxy should cover the whole cluster.");
+
+		memdelete(root);
+	}
+
+	SUBCASE("Linked clusters") {
+		settings.merge_meshes = false;
+		Node3D *root = make_box_scene(box);
+		HLODGenerator::Stats stats = HLODGenerator::generate(root, settings);
+
+		Vector<MeshInstance3D *> mesh_instances;
+		find_mesh_instances(root, mesh_instances);
+		CHECK_MESSAGE(mesh_instances.size() == 10, "The original boxes should be kept next to the proxy.");
+
+		MeshInstance3D *proxy = nullptr;
+		int linked = 0;
+		int drawn_near = 0;
+		int drawn_far = 0;
+		for (int i = 0; i < mesh_instances.size(); i++) {
+			MeshInstance3D *mi = mesh_instances[i];
+			if (mi->get_lod_min_distance() > 0) {
+				proxy = mi;
+			}
+			drawn_near += mi->get_lod_min_distance() == 0 ? 1 : 0;
+			drawn_far += mi->get_lod_max_distance() == 0 ? 1 : 0;
+		}
+		REQUIRE(proxy);
+		for (int i = 0; i < mesh_instances.size(); i++) {
+			MeshInstance3D *mi = mesh_instances[i];
+			if (mi->get_lod_max_distance() == 50 && mi->get_node_or_null(mi->get_lod_parent()) == proxy) {
+				linked++;
+			}
+		}
+		CHECK_MESSAGE(linked == 8, "Every clustered box should swap with the proxy.");
+		CHECK(Object::cast_to<MeshInstance3D>(root->get_node(NodePath("Lone")))->get_lod_max_distance() == 0);
+		CHECK(drawn_near == stats.instances_near);
+		CHECK(drawn_far == stats.instances_far);
+
+		memdelete(root);
+	}
+
+	box.unref();
+	memdelete(rendering_server);
+}
+
+} // namespace TestHLOD
+
+#endif // TEST_HLOD_H
@@ -33,29 +33,41 @@
 #include "core/templates/list.h"
 
 #include "test_aabb.h"
+#include "test_array.h"
 #include "test_astar.h"
 #include "test_basis.h"
+#include "test_canvas_batching.h"
+#include "test_canvas_cull.h"
 #include "test_class_db.h"
 #include "test_color.h"
 #include "test_command_queue.h"
 #include "test_config_file.h"
+#include "test_container_benchmark.h"
 #include "test_crypto.h"
 #include "test_curve.h"
+#include "test_dictionary.h"
 #include "test_expression.h"
 #include "test_file_access.h"
+#include "test_flat_hash_map.h"
+#include "test_frame_arena.h"
 #include "test_geometry_2d.h"
 #include "test_gradient.h"
 #include "test_gui.h"
+#include "test_hlod.h"
 #include "test_json.h"
 #include "test_list.h"
 #include "test_local_vector.h"
 #include "test_lru.h"
 #include "test_marshalls.h"
 #include "test_math.h"
+#include "test_memory.h"
+#include "test_message_queue.h"
 #include "test_method_bind.h"
+#include "test_method_call_cache.h"
 #include "test_node_path.h"
 #include "test_oa_hash_map.h"
 #include "test_object.h"
+#include "test_occlusion_cull.h"
 #include "test_ordered_hash_map.h"
 #include "test_paged_array.h"
 #include "test_pck_packer.h"
@@ -64,9 +76,16 @@
 #include "test_random_number_generator.h"
 #include "test_rect2.h"
 #include "test_render.h"
+#include "test_render_benchmark.h"
+#include "test_resource.h"
+#include "test_resource_loader.h"
+#include "test_scene_importer_mesh.h"
 #include "test_shader_lang.h"
 #include "test_string.h"
+#include "test_string_benchmark.h"
+#include "test_string_name.h"
 #include "test_text_server.h"
+#include "test_texture_upload.h"
 #include "test_validate_testing.h"
 #include "test_variant.h"
 
@@ -0,0 +1,282 @@
+/*************************************************************************/
+/*  test_memory.h                                                        */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_MEMORY_H
+#define TEST_MEMORY_H
+
+#include "core/os/memory.h"
+#include "core/os/os.h"
+#include "core/os/thread.h"
+#include "core/string/ustring.h"
+#include "core/templates/list.h"
+#include "core/templates/map.h"
+#include "core/templates/vector.h"
+#include "core/variant/array.h"
+#include "core/variant/dictionary.h"
+
+#include "tests/test_macros.h"
+
+namespace TestMemory {
+
+static uint8_t *alloc_filled(size_t p_size, uint8_t p_value) {
+	uint8_t *mem = (uint8_t *)memalloc(p_size);
+	for (size_t i = 0; i < p_size; i++) {
+		mem[i] = p_value;
+	}
+	return mem;
+}
+
+static bool is_filled(const uint8_t *p_mem, size_t p_size, uint8_t p_value) {
+	for (size_t i = 0; i < p_size; i++) {
+		if (p_mem[i] != p_value) {
+			return false;
+		}
+	}
+	return true;
+}
+
+TEST_CASE("[Memory] Allocations keep their content") {
+	// Sizes across all the small object size classes and beyond.
+	const int count = 300;
+	uint8_t *mems[count];
+	for (int i = 0; i < count; i++) {
+		mems[i] = alloc_filled(i * 7 + 1, i);
+	}
+
+	int misaligned = 0;
+	int corrupted = 0;
+	for (int i = 0; i < count; i++) {
+		misaligned += (uintptr_t(mems[i]) % 8) != 0;
+		corrupted += !is_filled(mems[i], i * 7 + 1, i);
+	}
+	CHECK(misaligned == 0);
+	CHECK(corrupted == 0);
+
+	// Grow, then shrink back.
+	for (int i = 0; i < count; i++) {
+		mems[i] = (uint8_t *)memrealloc(mems[i], i * 13 + 1);
+		corrupted += !is_filled(mems[i], i * 7 + 1, i);
+		for (int j = i * 7 + 1; j < i * 13 + 1; j++) {
+			mems[i][j] = i;
+		}
+	}
+	for (int i = 0; i < count; i++) {
+		mems[i] = (uint8_t *)memrealloc(mems[i], i * 3 + 1);
+		corrupted += !is_filled(mems[i], i * 3 + 1, i);
+	}
+	CHECK(corrupted == 0);
+
+	for (int i = 0; i < count; i++) {
+		memfree(mems[i]);
+	}
+}
+
+TEST_CASE("[Memory] Reallocated vectors keep their data") {
+	// CowData keeps its size and reference count before the data, make sure they survive.
+	Vector<int> vector;
+	for (int i = 0; i < 2000; i++) {
+		vector.push_back(i);
+	}
+	Vector<int> copy = vector;
+	vector.resize(10);
+	vector.resize(500);
+
+	CHECK(copy.size() == 2000);
+	CHECK(copy[1999] == 1999);
+	CHECK(vector.size() == 500);
+	CHECK(vector[9] == 9);
+
+	String string;
+	for (int i = 0; i < 200; i++) {
+		string += "x";
+	}
+	CHECK(string.length() == 200);
+}
+
+#if !defined(NO_THREADS)
+
+struct AllocThreadData {
+	Vector<uint8_t *> mems;
+	int count = 0;
+	uint8_t value = 0;
+};
+
+static void alloc_thread(void *p_userdata) {
+	AllocThreadData *data = static_cast<AllocThreadData *>(p_userdata);
+	for (int i = 0; i < data->count; i++) {
+		data->mems.push_back(alloc_filled(i % 500 + 1, data->value));
+	}
+}
+
+static void free_thread(void *p_userdata) {
+	AllocThreadData *data = static_cast<AllocThreadData *>(p_userdata);
+	data->count = 0; // Counts the corrupted allocations.
+	for (int i = 0; i < data->mems.size(); i++) {
+		data->count += !is_filled(data->mems[i], i % 500 + 1, data->value);
+		memfree(data->mems[i]);
+	}
+	data->mems.clear();
+}
+
+TEST_CASE("[Memory] Allocations freed by other threads") {
+	const int thread_count = 4;
+	AllocThreadData data[thread_count];
+	Thread *threads[thread_count];
+
+	for (int i = 0; i < thread_count; i++) {
+		data[i].count = 5000;
+		data[i].value = i + 1;
+		threads[i] = Thread::create(alloc_thread, &data[i]);
+	}
+	for (int i = 0; i < thread_count; i++) {
+		Thread::wait_to_finish(threads[i]);
+		memdelete(threads[i]);
+	}
+
+	// The threads that allocated have exited, so the memory goes to new ones.
+	for (int i = 0; i < thread_count; i++) {
+		threads[i] = Thread::create(free_thread, &data[i]);
+	}
+	int corrupted = 0;
+	for (int i = 0; i < thread_count; i++) {
+		Thread::wait_to_finish(threads[i]);
+		memdelete(threads[i]);
+		corrupted += data[i].count;
+	}
+	CHECK(corrupted == 0);
+}
+
+#if defined(SMALL_OBJECT_ALLOCATOR_ENABLED) && defined(DEBUG_ENABLED)
+TEST_CASE("[Memory] Threads that only free keep the usage accurate") {
+	// Few and small enough that the freeing thread never merges its counters on the way.
+	AllocThreadData data;
+	data.value = 1;
+
+	Memory::_merge_thread_counters();
+	const uint64_t usage_before = Memory::get_mem_usage();
+	for (int i = 0; i < 100; i++) {
+		data.mems.push_back(alloc_filled(i % 500 + 1, data.value));
+	}
+	Memory::_merge_thread_counters();
+	CHECK(Memory::get_mem_usage() > usage_before);
+
+	Thread *thread = Thread::create(free_thread, &data);
+	Thread::wait_to_finish(thread);
+	memdelete(thread);
+	CHECK(data.count == 0);
+
+	Memory::_merge_thread_counters();
+	CHECK_MESSAGE(
+			Memory::get_mem_usage() == usage_before,
+			"The counters of a thread that only freed should be merged when it exits.");
+}
+#endif // defined(SMALL_OBJECT_ALLOCATOR_ENABLED) && defined(DEBUG_ENABLED)
+
+#endif // !defined(NO_THREADS)
+
+// Allocation patterns of the usual engine containers.
+static void container_workload(int p_iterations) {
+	for (int i = 0; i < p_iterations; i++) {
+		Vector<int> vector;
+		for (int j = 0; j < 64; j++) {
+			vector.push_back(j);
+		}
+
+		String string;
+		for (int j = 0; j < 16; j++) {
+			string += itos(j);
+		}
+
+		List<String> list;
+		for (int j = 0; j < 32; j++) {
+			list.push_back(string);
+		}
+		while (list.size()) {
+			list.pop_front();
+		}
+
+		Map<int, Variant> map;
+		for (int j = 0; j < 32; j++) {
+			map.insert(j, j);
+		}
+		for (int j = 0; j < 32; j += 2) {
+			map.erase(j);
+		}
+
+		Array array;
+		Dictionary dictionary;
+		for (int j = 0; j < 16; j++) {
+			array.push_back(string);
+			dictionary[j] = array;
+		}
+	}
+}
+
+#if !defined(NO_THREADS)
+static void container_workload_thread(void *p_userdata) {
+	container_workload(*static_cast<int *>(p_userdata));
+}
+#endif
+
+TEST_CASE("[Stress][Memory] Container allocation throughput") {
+	int iterations = 5000;
+
+	uint64_t from = OS::get_singleton()->get_ticks_usec();
+	container_workload(iterations);
+	uint64_t single_usec = OS::get_singleton()->get_ticks_usec() - from;
+
+#ifdef SMALL_OBJECT_ALLOCATOR_ENABLED
+	const char *allocator = "small object allocator";
+#else
+	const char *allocator = "system allocator";
+#endif
+
+#if !defined(NO_THREADS)
+	int thread_count = MAX(OS::get_singleton()->get_processor_count(), 2);
+	Vector<Thread *> threads;
+	from = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < thread_count; i++) {
+		threads.push_back(Thread::create(container_workload_thread, &iterations));
+	}
+	for (int i = 0; i < thread_count; i++) {
+		Thread::wait_to_finish(threads[i]);
+		memdelete(threads[i]);
+	}
+	uint64_t threaded_usec = OS::get_singleton()->get_ticks_usec() - from;
+
+	MESSAGE(allocator, ", 1 thread: ", single_usec, " usec, ", thread_count, " threads: ", threaded_usec, " usec (", iterations, " iterations each).");
+#else
+	MESSAGE(allocator, ", 1 thread: ", single_usec, " usec (", iterations, " iterations).");
+#endif
+}
+
+} // namespace TestMemory
+
+#endif // TEST_MEMORY_H
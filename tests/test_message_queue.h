@@ -0,0 +1,213 @@
+/*************************************************************************/
+/*  test_message_queue.h                                                 */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_MESSAGE_QUEUE_H
+#define TEST_MESSAGE_QUEUE_H
+
+#include "core/object/message_queue.h"
+#include "core/os/os.h"
+#include "core/os/thread.h"
+#include "core/templates/vector.h"
+
+#include "tests/test_macros.h"
+
+namespace TestMessageQueue {
+
+// Tests run without the engine main loop, so they make their own queue.
+struct QueueScope {
+	MessageQueue *queue = nullptr;
+
+	QueueScope() {
+		if (!MessageQueue::get_singleton()) {
+			queue = memnew(MessageQueue);
+		}
+	}
+	~QueueScope() {
+		if (queue) {
+			memdelete(queue);
+		}
+	}
+};
+
+class Receiver : public Object {
+public:
+	Vector<int> last_index; // Per producer.
+	int received = 0;
+	bool in_order = true;
+	int repush_count = 0;
+
+	void receive(int p_producer, int p_index) {
+		if (p_index != last_index[p_producer] + 1) {
+			in_order = false;
+		}
+		last_index.write[p_producer] = p_index;
+		received++;
+	}
+
+	void repush() {
+		received++;
+		if (--repush_count > 0) {
+			MessageQueue::get_singleton()->push_callable(callable_mp(this, &Receiver::repush));
+		}
+	}
+
+	Receiver(int p_producer_count = 1) {
+		last_index.resize(p_producer_count);
+		for (int i = 0; i < p_producer_count; i++) {
+			last_index.write[i] = -1;
+		}
+	}
+};
+
+TEST_CASE("[MessageQueue] Calls run in order") {
+	QueueScope scope;
+	MessageQueue *queue = MessageQueue::get_singleton();
+	Receiver receiver;
+	Callable callable = callable_mp(&receiver, &Receiver::receive);
+
+	for (int i = 0; i < 1000; i++) {
+		queue->push_callable(callable, 0, i);
+	}
+	CHECK(receiver.received == 0);
+	queue->flush();
+	CHECK(receiver.received == 1000);
+	CHECK(receiver.in_order);
+
+	// Calls pushed while flushing are run by the same flush.
+	receiver.received = 0;
+	receiver.repush_count = 100;
+	queue->push_callable(callable_mp(&receiver, &Receiver::repush));
+	queue->flush();
+	CHECK(receiver.received == 100);
+}
+
+TEST_CASE("[MessageQueue] Grows instead of overflowing") {
+	QueueScope scope;
+	MessageQueue *queue = MessageQueue::get_singleton();
+	Receiver receiver;
+	Callable callable = callable_mp(&receiver, &Receiver::receive);
+
+	// Well past the size of a page, several times so the pages are recycled.
+	const int count = 200000;
+	for (int i = 0; i < 3; i++) {
+		receiver.last_index.write[0] = -1;
+		receiver.received = 0;
+		int failed = 0;
+		for (int j = 0; j < count; j++) {
+			if (queue->push_callable(callable, 0, j) != OK) {
+				failed++;
+			}
+		}
+		queue->flush();
+		CHECK(failed == 0);
+		CHECK(receiver.received == count);
+		CHECK(receiver.in_order);
+	}
+}
+
+#if !defined(NO_THREADS)
+
+struct ProducerData {
+	const Callable *callable = nullptr;
+	int producer = 0;
+	int count = 0;
+};
+
+static void producer_thread(void *p_userdata) {
+	ProducerData *data = static_cast<ProducerData *>(p_userdata);
+	MessageQueue *queue = MessageQueue::get_singleton();
+	for (int i = 0; i < data->count; i++) {
+		queue->push_callable(*data->callable, data->producer, i);
+	}
+}
+
+// Pushes from p_producer_count threads while the main thread keeps flushing.
+static uint64_t run_producers(Receiver &r_receiver, int p_producer_count, int p_count) {
+	MessageQueue *queue = MessageQueue::get_singleton();
+	Callable callable = callable_mp(&r_receiver, &Receiver::receive);
+
+	Vector<ProducerData> data;
+	data.resize(p_producer_count);
+	for (int i = 0; i < p_producer_count; i++) {
+		data.write[i].callable = &callable;
+		data.write[i].producer = i;
+		data.write[i].count = p_count;
+	}
+
+	uint64_t from = OS::get_singleton()->get_ticks_usec();
+	Vector<Thread *> threads;
+	for (int i = 0; i < p_producer_count; i++) {
+		threads.push_back(Thread::create(producer_thread, &data.write[i]));
+	}
+	while (r_receiver.received < p_producer_count * p_count) {
+		queue->flush();
+	}
+	uint64_t usec = OS::get_singleton()->get_ticks_usec() - from;
+
+	for (int i = 0; i < p_producer_count; i++) {
+		Thread::wait_to_finish(threads[i]);
+		memdelete(threads[i]);
+	}
+	queue->flush();
+	return usec;
+}
+
+TEST_CASE("[MessageQueue] Calls pushed from many threads") {
+	QueueScope scope;
+	const int producer_count = 8;
+	const int count = 20000;
+	Receiver receiver(producer_count);
+
+	run_producers(receiver, producer_count, count);
+
+	CHECK(receiver.received == producer_count * count);
+	CHECK_MESSAGE(receiver.in_order, "The calls of each thread should run in the order they were pushed.");
+}
+
+TEST_CASE("[Stress][MessageQueue] Deferred call throughput") {
+	QueueScope scope;
+	const int count = 200000;
+	int producer_count = MAX(OS::get_singleton()->get_processor_count(), 2);
+
+	Receiver single_receiver(1);
+	uint64_t single_usec = MAX(run_producers(single_receiver, 1, count), uint64_t(1));
+	Receiver receiver(producer_count);
+	uint64_t usec = MAX(run_producers(receiver, producer_count, count), uint64_t(1));
+	CHECK(receiver.in_order);
+
+	MESSAGE("1 thread: ", uint64_t(count) * 1000000 / single_usec, " calls/sec.");
+	MESSAGE(producer_count, " threads: ", uint64_t(producer_count) * count * 1000000 / usec, " calls/sec.");
+}
+
+#endif // !defined(NO_THREADS)
+
+} // namespace TestMessageQueue
+
+#endif // TEST_MESSAGE_QUEUE_H
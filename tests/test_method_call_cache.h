@@ -0,0 +1,136 @@
+/*************************************************************************/
+/*  test_method_call_cache.h                                             */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_METHOD_CALL_CACHE_H
+#define TEST_METHOD_CALL_CACHE_H
+
+#include "core/object/class_db.h"
+#include "core/object/method_call_cache.h"
+#include "core/object/reference.h"
+#include "core/os/os.h"
+
+#include "tests/test_macros.h"
+
+namespace TestMethodCallCache {
+
+TEST_CASE("[MethodCallCache] Resolves the same methods as ClassDB") {
+	MethodCallCache cache;
+	const StringName get_class_name = "get_class";
+	const StringName reference_name = "reference";
+
+	// Twice, so the second lookup is a hit.
+	for (int i = 0; i < 2; i++) {
+		CHECK(ClassDB::get_method_cached(cache, "Object", get_class_name) == ClassDB::get_method("Object", get_class_name));
+		CHECK(ClassDB::get_method_cached(cache, "Reference", get_class_name) == ClassDB::get_method("Reference", get_class_name));
+		CHECK(ClassDB::get_method_cached(cache, "Reference", reference_name) == ClassDB::get_method("Reference", reference_name));
+		CHECK(ClassDB::get_method_cached(cache, "Object", reference_name) == nullptr);
+		CHECK(ClassDB::get_method_cached(cache, "NotAClass", get_class_name) == nullptr);
+	}
+	CHECK(ClassDB::get_method_cached(cache, "Object", get_class_name) != nullptr);
+
+	// More classes than the cache holds still resolve correctly.
+	const char *classes[] = { "Object", "Reference", "Resource", "Node", "Node2D", "Node3D", "Control" };
+	for (int i = 0; i < 3; i++) {
+		for (int j = 0; j < 7; j++) {
+			CHECK(ClassDB::get_method_cached(cache, classes[j], get_class_name) == ClassDB::get_method(classes[j], get_class_name));
+		}
+	}
+
+	// Copies start empty.
+	MethodCallCache copy = cache;
+	for (int i = 0; i < MethodCallCache::SIZE; i++) {
+		CHECK(copy.entries[i].load() == nullptr);
+	}
+}
+
+TEST_CASE("[MethodCallCache] Calls through a cache") {
+	Object object;
+	MethodCallCache cache;
+	Callable::CallError ce;
+
+	for (int i = 0; i < 2; i++) {
+		Variant ret = object.call("get_instance_id", nullptr, 0, ce, &cache);
+		CHECK(ce.error == Callable::CallError::CALL_OK);
+		CHECK(uint64_t(ret) == uint64_t(object.get_instance_id()));
+
+		object.call("not_a_method", nullptr, 0, ce, &cache);
+		CHECK(ce.error == Callable::CallError::CALL_ERROR_INVALID_METHOD);
+	}
+
+	Variant variant = &object;
+	Variant ret;
+	variant.call("get_class", nullptr, 0, ret, ce, &cache);
+	CHECK(ce.error == Callable::CallError::CALL_OK);
+	CHECK(String(ret) == "Object");
+}
+
+TEST_CASE("[MethodCallCache] Signals call through the cache of their connection") {
+	Object emitter;
+	Object target;
+	emitter.add_user_signal(MethodInfo("test_signal", PropertyInfo(Variant::STRING, "name")));
+	Vector<Variant> binds;
+	binds.push_back(5);
+	emitter.connect("test_signal", Callable(&target, "set_meta"), binds);
+
+	// The first emission resolves the method, the second one hits the cache.
+	CHECK(emitter.emit_signal("test_signal", "first") == OK);
+	CHECK(emitter.emit_signal("test_signal", "second") == OK);
+	CHECK(int(target.get_meta("first")) == 5);
+	CHECK(int(target.get_meta("second")) == 5);
+}
+
+TEST_CASE("[Stress][MethodCallCache] Calls per second") {
+	const int count = 1000000;
+	Ref<Reference> object;
+	object.instance();
+	const StringName name = "get_reference_count";
+	Callable::CallError ce;
+
+	uint64_t from = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < count; i++) {
+		object->call(name, nullptr, 0, ce);
+	}
+	uint64_t uncached_usec = MAX(OS::get_singleton()->get_ticks_usec() - from, uint64_t(1));
+
+	MethodCallCache cache;
+	from = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < count; i++) {
+		object->call(name, nullptr, 0, ce, &cache);
+	}
+	uint64_t cached_usec = MAX(OS::get_singleton()->get_ticks_usec() - from, uint64_t(1));
+	CHECK(ce.error == Callable::CallError::CALL_OK);
+
+	MESSAGE("ClassDB lookup: ", uint64_t(count) * 1000000 / uncached_usec, " calls/sec.");
+	MESSAGE("Call site cache: ", uint64_t(count) * 1000000 / cached_usec, " calls/sec.");
+}
+
+} // namespace TestMethodCallCache
+
+#endif // TEST_METHOD_CALL_CACHE_H
@@ -33,6 +33,7 @@
 
 #include "core/core_string_names.h"
 #include "core/object/object.h"
+#include "core/os/os.h"
 
 #include "thirdparty/doctest/doctest.h"
 
@@ -56,6 +57,25 @@ public:
 	int get_property() const { return property_value; }
 };
 
+// Dispatches some calls itself, like the objects wrapping Java classes do.
+class _TestCallOverrideObject : public _TestDerivedObject {
+	GDCLASS(_TestCallOverrideObject, _TestDerivedObject);
+
+public:
+	int overridden_calls = 0;
+
+	virtual Variant call(const StringName &p_method, const Variant **p_args, int p_argcount, Callable::CallError &r_error, MethodCallCache *p_cache = nullptr) override {
+		overridden_calls++;
+		if (p_method == "set_property" && p_argcount == 1) {
+			// Doubles the value, to tell it apart from calling the bind directly.
+			set_property(int(*p_args[0]) * 2);
+			r_error.error = Callable::CallError::CALL_OK;
+			return Variant();
+		}
+		return _TestDerivedObject::call(p_method, p_args, p_argcount, r_error, p_cache);
+	}
+};
+
 namespace TestObject {
 
 class _MockScriptInstance : public ScriptInstance {
@@ -300,6 +320,93 @@ TEST_CASE("[Object] Absent name getter") {
 			actual_value == Variant(),
 			"The returned value should equal nil variant.");
 }
+
+TEST_CASE("[Object] Signal emission to native methods") {
+	ClassDB::register_class<_TestDerivedObject>();
+	Object emitter;
+	_TestDerivedObject target;
+	emitter.add_user_signal(MethodInfo("test_signal", PropertyInfo(Variant::INT, "value")));
+	emitter.connect("test_signal", Callable(&target, "set_property"));
+
+	// Exact argument types, called directly.
+	CHECK(emitter.emit_signal("test_signal", 5) == OK);
+	CHECK_MESSAGE(
+			target.get_property() == 5,
+			"The property value should be set by the signal.");
+
+	// Arguments that need a conversion.
+	CHECK(emitter.emit_signal("test_signal", 7.0) == OK);
+	CHECK_MESSAGE(
+			target.get_property() == 7,
+			"The property value should be set by the signal, converted to an integer.");
+
+	// Arguments followed by binds.
+	Object bind_target;
+	Vector<Variant> binds;
+	binds.push_back(Color(0, 1, 0));
+	emitter.connect("test_signal", Callable(&bind_target, "set_meta"), binds);
+	CHECK(emitter.emit_signal("test_signal", "from_signal") == OK);
+	CHECK_MESSAGE(
+			Color(bind_target.get_meta("from_signal")).is_equal_approx(Color(0, 1, 0)),
+			"The metadata should be set by the signal with its bind as the value.");
+}
+
+TEST_CASE("[Object] Signal emission to objects overriding call") {
+	ClassDB::register_class<_TestCallOverrideObject>();
+	Object emitter;
+	_TestCallOverrideObject target;
+	emitter.add_user_signal(MethodInfo("test_signal", PropertyInfo(Variant::INT, "value")));
+	emitter.connect("test_signal", Callable(&target, "set_property"));
+
+	// Twice, so the second emission goes through the filled method cache.
+	for (int i = 1; i <= 2; i++) {
+		CHECK(emitter.emit_signal("test_signal", 5) == OK);
+		CHECK_MESSAGE(
+				target.overridden_calls == i,
+				"The signal should be delivered through the overridden call().");
+		CHECK_MESSAGE(
+				target.get_property() == 10,
+				"The overridden call() should handle the method, not its bind.");
+	}
+
+	// Methods it doesn't handle itself still reach their binds through it.
+	emitter.add_user_signal(MethodInfo("meta_signal", PropertyInfo(Variant::STRING, "name")));
+	Vector<Variant> binds;
+	binds.push_back(Color(0, 1, 0));
+	emitter.connect("meta_signal", Callable(&target, "set_meta"), binds);
+	CHECK(emitter.emit_signal("meta_signal", "from_signal") == OK);
+	CHECK(target.overridden_calls == 3);
+	CHECK_MESSAGE(
+			Color(target.get_meta("from_signal")).is_equal_approx(Color(0, 1, 0)),
+			"The metadata should be set by the signal with its bind as the value.");
+}
+
+TEST_CASE("[Stress][Object] Signal emission throughput") {
+	ClassDB::register_class<_TestDerivedObject>();
+	const int connection_count = 4;
+	const int emit_count = 250000;
+
+	Object emitter;
+	_TestDerivedObject targets[connection_count];
+	emitter.add_user_signal(MethodInfo("test_signal", PropertyInfo(Variant::INT, "value")));
+	for (int i = 0; i < connection_count; i++) {
+		emitter.connect("test_signal", Callable(&targets[i], "set_property"));
+	}
+
+	// Ints are called directly, floats go through MethodBind::call() to be converted.
+	const Variant values[2] = { 1, 1.0 };
+	for (int i = 0; i < 2; i++) {
+		const Variant *args[1] = { &values[i] };
+		uint64_t from = OS::get_singleton()->get_ticks_usec();
+		for (int j = 0; j < emit_count; j++) {
+			emitter.emit_signal("test_signal", args, 1);
+		}
+		uint64_t usec = MAX(OS::get_singleton()->get_ticks_usec() - from, uint64_t(1));
+
+		MESSAGE(Variant::get_type_name(values[i].get_type()), " argument: ", uint64_t(emit_count) * 1000000 / usec, " emissions/sec to ", connection_count, " connections.");
+	}
+	CHECK(targets[connection_count - 1].get_property() == 1);
+}
 } // namespace TestObject
 
 #endif // TEST_OBJECT_H
@@ -0,0 +1,233 @@
+/*************************************************************************/
+/*  test_occlusion_cull.h                                                */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_OCCLUSION_CULL_H
+#define TEST_OCCLUSION_CULL_H
+
+#include "drivers/dummy/rasterizer_dummy.h"
+#include "servers/rendering/renderer_scene_cull.h"
+#include "servers/rendering/renderer_scene_occlusion_cull.h"
+#include "servers/rendering/rendering_server_default.h"
+#include "servers/rendering/rendering_server_globals.h"
+
+#include "thirdparty/doctest/doctest.h"
+
+namespace TestOcclusionCull {
+
+// A camera at the origin looking down -Z, with a square wall occluder of
+// half-extent `p_wall_size` at `p_wall_z`.
+static void setup_wall(RendererSceneOcclusionCull &r_cull, real_t p_wall_size, real_t p_wall_z) {
+	CameraMatrix projection;
+	projection.set_perspective(70, 16.0 / 9.0, 0.05, 100);
+
+	r_cull.set_size(Size2i(256, 144));
+	r_cull.begin(Transform(), projection);
+
+	Vector<Vector3> vertices;
+	vertices.push_back(Vector3(-p_wall_size, -p_wall_size, 0));
+	vertices.push_back(Vector3(p_wall_size, -p_wall_size, 0));
+	vertices.push_back(Vector3(p_wall_size, p_wall_size, 0));
+	vertices.push_back(Vector3(-p_wall_size, p_wall_size, 0));
+
+	Vector<int32_t> indices;
+	indices.push_back(0);
+	indices.push_back(1);
+	indices.push_back(2);
+	indices.push_back(0);
+	indices.push_back(2);
+	indices.push_back(3);
+
+	r_cull.add_occluder(vertices, indices, Transform(Basis(), Vector3(0, 0, p_wall_z)));
+}
+
+static int count_occluded_grid(const RendererSceneOcclusionCull &p_cull, real_t p_x_offset, real_t p_z) {
+	int occluded = 0;
+	for (int i = -2; i <= 2; i++) {
+		for (int j = -2; j <= 2; j++) {
+			AABB box(Vector3(p_x_offset + i * 2.0 - 0.5, j * 2.0 - 0.5, p_z), Vector3(1, 1, 1));
+			if (p_cull.is_occluded(box)) {
+				occluded++;
+			}
+		}
+	}
+	return occluded;
+}
+
+TEST_CASE("[OcclusionCull] Nothing is occluded before rasterizing") {
+	RendererSceneOcclusionCull cull;
+	setup_wall(cull, 20, -10);
+	CHECK_MESSAGE(cull.get_triangle_count() == 2, "Both wall triangles should be in front of the near plane.");
+	CHECK(!cull.is_occluded(AABB(Vector3(-0.5, -0.5, -30), Vector3(1, 1, 1))));
+}
+
+TEST_CASE("[OcclusionCull] Boxes behind a wall are occluded") {
+	RendererSceneOcclusionCull cull;
+	setup_wall(cull, 20, -10);
+	cull.rasterize();
+
+	CHECK_MESSAGE(count_occluded_grid(cull, 0, -20) == 25, "All boxes behind the wall should be occluded.");
+	CHECK_MESSAGE(count_occluded_grid(cull, 0, -5) == 0, "Boxes in front of the wall should not be occluded.");
+	CHECK_MESSAGE(count_occluded_grid(cull, 0, -10.5) == 0, "Boxes crossing the wall should not be occluded.");
+}
+
+TEST_CASE("[OcclusionCull] Boxes beside a small wall are not occluded") {
+	RendererSceneOcclusionCull cull;
+	setup_wall(cull, 1, -10);
+	cull.rasterize();
+
+	CHECK(cull.is_occluded(AABB(Vector3(-0.25, -0.25, -30), Vector3(0.5, 0.5, 0.5))));
+	CHECK_MESSAGE(count_occluded_grid(cull, 40, -20) == 0, "Boxes outside of the wall should not be occluded.");
+	CHECK_MESSAGE(!cull.is_occluded(AABB(Vector3(-3, -3, -30), Vector3(6, 6, 1))), "A box larger than the wall should not be occluded.");
+}
+
+TEST_CASE("[OcclusionCull] Occluders crossing the near plane are clipped") {
+	RendererSceneOcclusionCull cull;
+	CameraMatrix projection;
+	projection.set_perspective(70, 16.0 / 9.0, 0.05, 100);
+	cull.set_size(Size2i(256, 144));
+	cull.begin(Transform(), projection);
+
+	// A floor plane going from behind the camera into the distance.
+	Vector<Vector3> vertices;
+	vertices.push_back(Vector3(-50, -1, 10));
+	vertices.push_back(Vector3(50, -1, 10));
+	vertices.push_back(Vector3(50, -1, -90));
+	vertices.push_back(Vector3(-50, -1, -90));
+	Vector<int32_t> indices;
+	indices.push_back(0);
+	indices.push_back(1);
+	indices.push_back(2);
+	indices.push_back(0);
+	indices.push_back(2);
+	indices.push_back(3);
+	cull.add_occluder(vertices, indices, Transform());
+	cull.rasterize();
+
+	CHECK_MESSAGE(cull.get_triangle_count() > 0, "The visible part of the floor should be kept.");
+	CHECK_MESSAGE(cull.is_occluded(AABB(Vector3(-0.5, -4, -20), Vector3(1, 1, 1))), "A box under the floor should be occluded.");
+	CHECK_MESSAGE(!cull.is_occluded(AABB(Vector3(-0.5, 0, -20), Vector3(1, 1, 1))), "A box above the floor should not be occluded.");
+	CHECK_MESSAGE(!cull.is_occluded(AABB(Vector3(-0.5, -2, -0.5), Vector3(1, 1, 1))), "A box crossing the near plane should not be occluded.");
+}
+
+TEST_CASE("[OcclusionCull] Threaded rasterization matches single threaded") {
+	RendererSceneOcclusionCull single;
+	setup_wall(single, 3, -10);
+	single.rasterize();
+
+	ThreadWorkPool pool;
+	pool.init(4);
+	RendererSceneOcclusionCull threaded;
+	setup_wall(threaded, 3, -10);
+	threaded.rasterize(&pool);
+	pool.finish();
+
+	for (int i = -10; i <= 10; i++) {
+		AABB box(Vector3(i * 0.5 - 0.25, -0.25, -20), Vector3(0.5, 0.5, 0.5));
+		CHECK(single.is_occluded(box) == threaded.is_occluded(box));
+	}
+}
+
+// Renders `p_camera` and returns how many geometry instances were kept for drawing.
+static int render_camera_instance_count(RendererSceneCull *p_scene, RID p_camera, RID p_scenario) {
+	p_scene->update();
+	p_scene->render_camera(RID(), p_camera, p_scenario, Size2(256, 144), 1.0, RID());
+	return p_scene->frustum_cull_result.geometry_instances.size();
+}
+
+TEST_CASE("[OcclusionCull] Instances behind an occluder are culled when rendering a camera") {
+	RasterizerDummy::make_current();
+	RenderingServer *rendering_server = memnew(RenderingServerDefault);
+	RendererSceneCull *scene = static_cast<RendererSceneCull *>(RSG::scene);
+	scene->use_occlusion_culling = true;
+
+	RID scenario = rendering_server->scenario_create();
+	RID camera = rendering_server->camera_create();
+	rendering_server->camera_set_perspective(camera, 70, 0.05, 100);
+
+	// The same grid of boxes as above, behind where the wall goes.
+	RID mesh = rendering_server->mesh_create();
+	Vector<RID> instances;
+	for (int i = -2; i <= 2; i++) {
+		for (int j = -2; j <= 2; j++) {
+			RID instance = rendering_server->instance_create2(mesh, scenario);
+			rendering_server->instance_set_custom_aabb(instance, AABB(Vector3(i * 2.0 - 0.5, j * 2.0 - 0.5, -20), Vector3(1, 1, 1)));
+			instances.push_back(instance);
+		}
+	}
+
+	const int visible_count = render_camera_instance_count(scene, camera, scenario);
+	CHECK_MESSAGE(visible_count == instances.size(), "Without occluders, every instance in view should be drawn.");
+
+	PackedVector3Array vertices;
+	vertices.push_back(Vector3(-20, -20, 0));
+	vertices.push_back(Vector3(20, -20, 0));
+	vertices.push_back(Vector3(20, 20, 0));
+	vertices.push_back(Vector3(-20, 20, 0));
+	PackedInt32Array indices;
+	indices.push_back(0);
+	indices.push_back(1);
+	indices.push_back(2);
+	indices.push_back(0);
+	indices.push_back(2);
+	indices.push_back(3);
+	RID occluder = rendering_server->occluder_create();
+	rendering_server->occluder_set_mesh(occluder, vertices, indices);
+	RID occluder_instance = rendering_server->instance_create2(occluder, scenario);
+	rendering_server->instance_set_transform(occluder_instance, Transform(Basis(), Vector3(0, 0, -10)));
+
+	const int occluded_count = render_camera_instance_count(scene, camera, scenario);
+	CHECK_MESSAGE(occluded_count < visible_count, "The occluder should reduce the number of drawn instances.");
+	CHECK_MESSAGE(occluded_count == 0, "Every instance is behind the occluder.");
+
+	rendering_server->instance_set_transform(occluder_instance, Transform(Basis(), Vector3(0, 0, -30)));
+	CHECK_MESSAGE(
+			render_camera_instance_count(scene, camera, scenario) == visible_count,
+			"Instances in front of the occluder should be drawn.");
+
+	scene->use_occlusion_culling = false;
+	rendering_server->instance_set_transform(occluder_instance, Transform(Basis(), Vector3(0, 0, -10)));
+	CHECK_MESSAGE(
+			render_camera_instance_count(scene, camera, scenario) == visible_count,
+			"Occluders should be ignored when occlusion culling is disabled.");
+
+	for (int i = 0; i < instances.size(); i++) {
+		rendering_server->free(instances[i]);
+	}
+	rendering_server->free(occluder_instance);
+	rendering_server->free(occluder);
+	rendering_server->free(mesh);
+	rendering_server->free(camera);
+	rendering_server->free(scenario);
+	memdelete(rendering_server);
+}
+
+} // namespace TestOcclusionCull
+
+#endif // TEST_OCCLUSION_CULL_H
@@ -0,0 +1,651 @@
+/*************************************************************************/
+/*  test_render_benchmark.h                                              */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_RENDER_BENCHMARK_H
+#define TEST_RENDER_BENCHMARK_H
+
+#include "core/config/project_settings.h"
+#include "core/os/frame_arena.h"
+#include "core/os/os.h"
+#include "drivers/dummy/rasterizer_dummy.h"
+#include "servers/rendering/renderer_canvas_batcher.h"
+#include "servers/rendering/renderer_canvas_cull.h"
+#include "servers/rendering/renderer_scene_cull.h"
+#include "servers/rendering/renderer_thread_pool.h"
+#include "servers/rendering/rendering_server_globals.h"
+
+#include "tests/test_macros.h"
+
+// Benchmarks the CPU side of rendering (instance updates and pairing, scene
+// and shadow culling, canvas culling and batching) without a GPU. The storage
+// and scene render of the dummy rasterizer are extended just enough for the
+// culling code to see real bounds, lights and probes; nothing is drawn.
+//
+// Run with: godot --test render-benchmark [--instances N] [--lights N] [--probes N] [--frames N] [--canvas-items N]
+
+namespace TestRenderBenchmark {
+
+class BenchmarkStorage : public RasterizerStorageDummy {
+	struct BenchmarkLight {
+		RS::LightType type;
+		float param[RS::LIGHT_PARAM_MAX];
+		bool shadow = false;
+	};
+
+	struct BenchmarkProbe {
+		Vector3 extents = Vector3(1, 1, 1);
+	};
+
+	mutable RID_PtrOwner<BenchmarkLight> light_owner;
+	mutable RID_PtrOwner<BenchmarkProbe> probe_owner;
+
+public:
+	// Meshes have a single surface without material, so they cast shadows.
+	int mesh_get_surface_count(RID p_mesh) const override { return 1; }
+	AABB mesh_get_aabb(RID p_mesh, RID p_skeleton = RID()) override { return AABB(Vector3(-0.5, -0.5, -0.5), Vector3(1, 1, 1)); }
+
+	RID light_create(RS::LightType p_type) override {
+		BenchmarkLight *light = memnew(BenchmarkLight);
+		light->type = p_type;
+		for (int i = 0; i < RS::LIGHT_PARAM_MAX; i++) {
+			light->param[i] = 0.0;
+		}
+		light->param[RS::LIGHT_PARAM_ENERGY] = 1.0;
+		light->param[RS::LIGHT_PARAM_RANGE] = 1.0;
+		light->param[RS::LIGHT_PARAM_SPOT_ANGLE] = 45;
+		return light_owner.make_rid(light);
+	}
+
+	void light_set_param(RID p_light, RS::LightParam p_param, float p_value) override {
+		BenchmarkLight *light = light_owner.getornull(p_light);
+		ERR_FAIL_COND(!light);
+		ERR_FAIL_INDEX(p_param, RS::LIGHT_PARAM_MAX);
+		light->param[p_param] = p_value;
+	}
+
+	void light_set_shadow(RID p_light, bool p_enabled) override {
+		BenchmarkLight *light = light_owner.getornull(p_light);
+		ERR_FAIL_COND(!light);
+		light->shadow = p_enabled;
+	}
+
+	bool light_has_shadow(RID p_light) const override {
+		const BenchmarkLight *light = light_owner.getornull(p_light);
+		ERR_FAIL_COND_V(!light, false);
+		return light->shadow;
+	}
+
+	RS::LightType light_get_type(RID p_light) const override {
+		const BenchmarkLight *light = light_owner.getornull(p_light);
+		ERR_FAIL_COND_V(!light, RS::LIGHT_OMNI);
+		return light->type;
+	}
+
+	float light_get_param(RID p_light, RS::LightParam p_param) override {
+		const BenchmarkLight *light = light_owner.getornull(p_light);
+		ERR_FAIL_COND_V(!light, 0.0);
+		ERR_FAIL_INDEX_V(p_param, RS::LIGHT_PARAM_MAX, 0.0);
+		return light->param[p_param];
+	}
+
+	AABB light_get_aabb(RID p_light) const override {
+		const BenchmarkLight *light = light_owner.getornull(p_light);
+		ERR_FAIL_COND_V(!light, AABB());
+
+		float range = light->param[RS::LIGHT_PARAM_RANGE];
+		if (light->type == RS::LIGHT_SPOT) {
+			float size = Math::tan(Math::deg2rad(light->param[RS::LIGHT_PARAM_SPOT_ANGLE])) * range;
+			return AABB(Vector3(-size, -size, -range), Vector3(size * 2, size * 2, range));
+		}
+		return AABB(-Vector3(range, range, range), Vector3(range, range, range) * 2);
+	}
+
+	RID reflection_probe_create() override {
+		return probe_owner.make_rid(memnew(BenchmarkProbe));
+	}
+
+	void reflection_probe_set_extents(RID p_probe, const Vector3 &p_extents) override {
+		BenchmarkProbe *probe = probe_owner.getornull(p_probe);
+		ERR_FAIL_COND(!probe);
+		probe->extents = p_extents;
+	}
+
+	Vector3 reflection_probe_get_extents(RID p_probe) const override {
+		const BenchmarkProbe *probe = probe_owner.getornull(p_probe);
+		ERR_FAIL_COND_V(!probe, Vector3());
+		return probe->extents;
+	}
+
+	AABB reflection_probe_get_aabb(RID p_probe) const override {
+		const BenchmarkProbe *probe = probe_owner.getornull(p_probe);
+		ERR_FAIL_COND_V(!probe, AABB());
+		return AABB(-probe->extents, probe->extents * 2);
+	}
+
+	RS::InstanceType get_base_type(RID p_rid) const override {
+		if (light_owner.owns(p_rid)) {
+			return RS::INSTANCE_LIGHT;
+		}
+		if (probe_owner.owns(p_rid)) {
+			return RS::INSTANCE_REFLECTION_PROBE;
+		}
+		return RasterizerStorageDummy::get_base_type(p_rid);
+	}
+
+	bool free(RID p_rid) override {
+		if (light_owner.owns(p_rid)) {
+			BenchmarkLight *light = light_owner.getornull(p_rid);
+			light_owner.free(p_rid);
+			memdelete(light);
+			return true;
+		}
+		if (probe_owner.owns(p_rid)) {
+			BenchmarkProbe *probe = probe_owner.getornull(p_rid);
+			probe_owner.free(p_rid);
+			memdelete(probe);
+			return true;
+		}
+		return RasterizerStorageDummy::free(p_rid);
+	}
+};
+
+// Records what the culling code hands over to the renderer.
+class BenchmarkSceneRender : public RasterizerSceneDummy {
+	struct BenchmarkGeometryInstance : public GeometryInstance {
+	};
+
+	// Light instances, probe instances and shadow atlases only need to be distinct, valid RIDs.
+	struct BenchmarkRenderData {
+	};
+
+	mutable RID_PtrOwner<BenchmarkRenderData> data_owner;
+
+	RID _make_rid() {
+		return data_owner.make_rid(memnew(BenchmarkRenderData));
+	}
+
+public:
+	uint32_t rendered_geometry = 0;
+	uint32_t rendered_lights = 0;
+	uint32_t rendered_reflection_probes = 0;
+	uint32_t shadow_passes = 0;
+	uint32_t shadow_casters = 0;
+	uint64_t last_light_version = 0;
+
+	void reset_stats() {
+		rendered_geometry = 0;
+		rendered_lights = 0;
+		rendered_reflection_probes = 0;
+		shadow_passes = 0;
+		shadow_casters = 0;
+	}
+
+	GeometryInstance *geometry_instance_create(RID p_base) override { return memnew(BenchmarkGeometryInstance); }
+	// Pair geometry with lights and probes like a renderer without clustering would, so pairing is measured.
+	uint32_t geometry_instance_get_pair_mask() override { return (1 << RS::INSTANCE_LIGHT) | (1 << RS::INSTANCE_REFLECTION_PROBE); }
+	void geometry_instance_free(GeometryInstance *p_geometry_instance) override { memdelete(p_geometry_instance); }
+
+	RID shadow_atlas_create() override { return _make_rid(); }
+	// Always redraw, so every shadowed light in view is culled each frame.
+	bool shadow_atlas_update_light(RID p_atlas, RID p_light_intance, float p_coverage, uint64_t p_light_version) override {
+		last_light_version = p_light_version;
+		return true;
+	}
+
+	RID render_buffers_create() override { return _make_rid(); }
+
+	RID light_instance_create(RID p_light) override { return _make_rid(); }
+	RID reflection_probe_instance_create(RID p_probe) override { return _make_rid(); }
+	bool reflection_probe_instance_has_reflection(RID p_instance) override { return true; }
+
+	void render_scene(RID p_render_buffers, const Transform &p_cam_transform, const CameraMatrix &p_cam_projection, bool p_cam_ortogonal, const PagedArray<GeometryInstance *> &p_instances, const PagedArray<RID> &p_lights, const PagedArray<RID> &p_reflection_probes, const PagedArray<RID> &p_gi_probes, const PagedArray<RID> &p_decals, const PagedArray<RID> &p_lightmaps, RID p_environment, RID p_camera_effects, RID p_shadow_atlas, RID p_reflection_atlas, RID p_reflection_probe, int p_reflection_probe_pass, float p_screen_lod_threshold) override {
+		rendered_geometry += p_instances.size();
+		rendered_lights += p_lights.size();
+		rendered_reflection_probes += p_reflection_probes.size();
+	}
+
+	void render_shadow(RID p_light, RID p_shadow_atlas, int p_pass, const PagedArray<GeometryInstance *> &p_instances, const Plane &p_camera_plane = Plane(), float p_lod_distance_multiplier = 0, float p_screen_lod_threshold = 0.0) override {
+		shadow_passes++;
+		shadow_casters += p_instances.size();
+	}
+
+	bool free(RID p_rid) override {
+		// Returning true for anything else would stop RendererSceneCull from freeing its own RIDs.
+		if (data_owner.owns(p_rid)) {
+			BenchmarkRenderData *data = data_owner.getornull(p_rid);
+			data_owner.free(p_rid);
+			memdelete(data);
+			return true;
+		}
+		return false;
+	}
+};
+
+class BenchmarkCompositor : public RasterizerDummy {
+public:
+	BenchmarkStorage benchmark_storage;
+	BenchmarkSceneRender benchmark_scene;
+
+	RendererStorage *get_storage() override { return &benchmark_storage; }
+	RendererSceneRender *get_scene() override { return &benchmark_scene; }
+};
+
+struct Settings {
+	int instances = 10000;
+	int lights = 64; // Half of them cast shadows, and every other one is a spot light.
+	int probes = 16;
+	int frames = 10;
+	int canvas_items = 10000;
+};
+
+struct Results {
+	// Per stage timings, in microseconds. Per frame stages are averaged.
+	uint64_t create_usec = 0; // Creating the instances and setting their base, scenario and transform.
+	uint64_t first_update_usec = 0; // First update of the dirty instances: bounds, indexing and pairing.
+	uint64_t move_update_usec = 0; // Update after moving a tenth of the instances.
+	uint64_t cull_usec = 0; // Scene and shadow culling, and preparing the render lists.
+	uint64_t free_usec = 0;
+	uint64_t canvas_cull_usec = 0;
+	uint64_t canvas_batch_usec = 0;
+
+	// Per frame counts.
+	uint32_t rendered_geometry = 0;
+	uint32_t rendered_lights = 0;
+	uint32_t rendered_reflection_probes = 0;
+	uint32_t shadow_passes = 0;
+	uint32_t shadow_casters = 0;
+	uint32_t canvas_items_drawn = 0;
+	uint32_t canvas_batches = 0;
+	uint64_t cull_allocs = 0; // Heap allocations made by scene culling, only counted in debug builds.
+};
+
+static void run_scene(const Settings &p_settings, Results &r_results) {
+	RendererStorage *prev_storage = RSG::storage;
+	RendererCompositor *prev_rasterizer = RSG::rasterizer;
+	RendererStorage *prev_base_storage = RendererStorage::base_singleton;
+	RendererCanvasRender *prev_canvas_render = RendererCanvasRender::singleton;
+	RendererSceneCull *prev_scene_cull = RendererSceneCull::singleton;
+
+	RendererThreadPool *thread_pool = nullptr;
+	if (!RendererThreadPool::singleton) {
+		thread_pool = memnew(RendererThreadPool);
+	}
+
+	BenchmarkCompositor *compositor = memnew(BenchmarkCompositor);
+	BenchmarkStorage &storage = compositor->benchmark_storage;
+	BenchmarkSceneRender &scene_render = compositor->benchmark_scene;
+	RSG::storage = &storage;
+	RSG::rasterizer = compositor;
+
+	// Settings not defined (no RenderingServer in tests) read as zero, so culling is threaded
+	// as soon as there are more instances than threads.
+	RendererSceneCull *scene_cull = memnew(RendererSceneCull);
+	scene_cull->set_scene_render(&scene_render);
+
+	RID scenario = scene_cull->scenario_create();
+	RID shadow_atlas = scene_render.shadow_atlas_create();
+
+	// Instances on a grid in the XZ plane, 4 units apart.
+	int side = MAX(int(Math::ceil(Math::sqrt(double(p_settings.instances)))), 1);
+	float extent = side * 4.0;
+	RID mesh = storage.mesh_create();
+	Vector<RID> instances;
+	Vector<RID> bases;
+
+	uint64_t from = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < p_settings.instances; i++) {
+		RID instance = scene_cull->instance_create();
+		scene_cull->instance_set_base(instance, mesh);
+		scene_cull->instance_set_scenario(instance, scenario);
+		scene_cull->instance_set_transform(instance, Transform(Basis(), Vector3((i % side) * 4.0, 0, (i / side) * 4.0)));
+		instances.push_back(instance);
+	}
+	r_results.create_usec = OS::get_singleton()->get_ticks_usec() - from;
+
+	for (int i = 0; i < p_settings.lights; i++) {
+		RID light = storage.light_create(i % 2 ? RS::LIGHT_SPOT : RS::LIGHT_OMNI);
+		storage.light_set_param(light, RS::LIGHT_PARAM_RANGE, 12.0);
+		storage.light_set_shadow(light, (i / 2) % 2 == 0);
+		bases.push_back(light);
+
+		RID instance = scene_cull->instance_create();
+		scene_cull->instance_set_base(instance, light);
+		scene_cull->instance_set_scenario(instance, scenario);
+		// Spread along the diagonal, pointing down.
+		float offset = (i + 0.5) * extent / p_settings.lights;
+		scene_cull->instance_set_transform(instance, Transform(Basis(Vector3(1, 0, 0), -Math_PI * 0.5), Vector3(offset, 6, offset)));
+		instances.push_back(instance);
+	}
+
+	for (int i = 0; i < p_settings.probes; i++) {
+		RID probe = storage.reflection_probe_create();
+		storage.reflection_probe_set_extents(probe, Vector3(16, 8, 16));
+		bases.push_back(probe);
+
+		RID instance = scene_cull->instance_create();
+		scene_cull->instance_set_base(instance, probe);
+		scene_cull->instance_set_scenario(instance, scenario);
+		float offset = (i + 0.5) * extent / p_settings.probes;
+		scene_cull->instance_set_transform(instance, Transform(Basis(), Vector3(offset, 4, extent - offset)));
+		instances.push_back(instance);
+	}
+
+	from = OS::get_singleton()->get_ticks_usec();
+	scene_cull->update_dirty_instances();
+	r_results.first_update_usec = OS::get_singleton()->get_ticks_usec() - from;
+
+	// Move a tenth of the mesh instances up and back, like animated props would.
+	from = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < p_settings.instances; i += 10) {
+		scene_cull->instance_set_transform(instances[i], Transform(Basis(), Vector3((i % side) * 4.0, 1, (i / side) * 4.0)));
+	}
+	scene_cull->update_dirty_instances();
+	r_results.move_update_usec = OS::get_singleton()->get_ticks_usec() - from;
+
+	// Stand in the middle of the grid looking along X, so the half behind the camera is culled.
+	RID camera = scene_cull->camera_create();
+	scene_cull->camera_set_perspective(camera, 70, 0.05, 200);
+	Transform camera_xform;
+	camera_xform.set_look_at(Vector3(extent * 0.5, 10, extent * 0.5), Vector3(extent, 0, extent * 0.5), Vector3(0, 1, 0));
+	scene_cull->camera_set_transform(camera, camera_xform);
+
+	int frames = MAX(p_settings.frames, 1);
+	uint64_t cull_usec = 0;
+	uint64_t cull_allocs = 0;
+	scene_render.reset_stats();
+	for (int i = 0; i < frames; i++) {
+		compositor->begin_frame(1.0 / 60.0);
+		scene_cull->update();
+
+		uint64_t allocs_from = Memory::get_alloc_total();
+		from = OS::get_singleton()->get_ticks_usec();
+		scene_cull->render_camera(RID(), camera, scenario, Size2(1920, 1080), 0.0, shadow_atlas);
+		cull_usec += OS::get_singleton()->get_ticks_usec() - from;
+		cull_allocs += Memory::get_alloc_total() - allocs_from;
+		FrameArena::reset(); // As done by the rendering thread after drawing.
+	}
+	r_results.cull_usec = cull_usec / frames;
+	r_results.cull_allocs = cull_allocs / frames;
+	r_results.rendered_geometry = scene_render.rendered_geometry / frames;
+	r_results.rendered_lights = scene_render.rendered_lights / frames;
+	r_results.rendered_reflection_probes = scene_render.rendered_reflection_probes / frames;
+	r_results.shadow_passes = scene_render.shadow_passes / frames;
+	r_results.shadow_casters = scene_render.shadow_casters / frames;
+
+	from = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < instances.size(); i++) {
+		scene_cull->free(instances[i]);
+	}
+	r_results.free_usec = OS::get_singleton()->get_ticks_usec() - from;
+
+	for (int i = 0; i < bases.size(); i++) {
+		storage.free(bases[i]);
+	}
+	storage.free(mesh);
+	scene_cull->free(camera);
+	scene_cull->free(scenario);
+	scene_render.free(shadow_atlas);
+	memdelete(scene_cull);
+	memdelete(compositor);
+
+	if (thread_pool) {
+		memdelete(thread_pool);
+	}
+
+	RSG::storage = prev_storage;
+	RSG::rasterizer = prev_rasterizer;
+	RendererStorage::base_singleton = prev_base_storage;
+	RendererCanvasRender::singleton = prev_canvas_render;
+	RendererSceneCull::singleton = prev_scene_cull;
+}
+
+static void run_canvas(const Settings &p_settings, Results &r_results) {
+	RendererCanvasCull cull;
+	RendererCanvasBatcher batcher;
+	RID canvas = cull.canvas_create();
+	RID root = cull.canvas_item_create();
+	cull.canvas_item_set_parent(root, canvas);
+
+	// 10x10 rects 12 pixels apart, so a 1920x1080 screen shows about 14000 of them.
+	int side = MAX(int(Math::ceil(Math::sqrt(double(p_settings.canvas_items)))), 1);
+	Vector<RID> items;
+	for (int i = 0; i < p_settings.canvas_items; i++) {
+		RID item = cull.canvas_item_create();
+		cull.canvas_item_set_parent(item, root);
+		cull.canvas_item_set_transform(item, Transform2D(0, Vector2((i % side) * 12, (i / side) * 12)));
+		cull.canvas_item_add_rect(item, Rect2(0, 0, 10, 10), Color(1, 1, 1));
+		items.push_back(item);
+	}
+
+	int frames = MAX(p_settings.frames, 1);
+	LocalVector<RendererCanvasRender::Item *> list;
+	uint64_t cull_usec = 0;
+	uint64_t batch_usec = 0;
+	for (int i = 0; i < frames; i++) {
+		uint64_t from = OS::get_singleton()->get_ticks_usec();
+		RendererCanvasRender::Item *first = cull.cull_canvas(canvas, Transform2D(), Rect2(0, 0, 1920, 1080));
+		cull_usec += OS::get_singleton()->get_ticks_usec() - from;
+
+		list.clear();
+		for (RendererCanvasRender::Item *item = first; item; item = item->next) {
+			list.push_back(item);
+		}
+
+		from = OS::get_singleton()->get_ticks_usec();
+		batcher.build(list.ptr(), list.size(), Transform2D(), nullptr, 65536);
+		batch_usec += OS::get_singleton()->get_ticks_usec() - from;
+	}
+	r_results.canvas_cull_usec = cull_usec / frames;
+	r_results.canvas_batch_usec = batch_usec / frames;
+	r_results.canvas_items_drawn = list.size();
+	r_results.canvas_batches = batcher.get_batch_count();
+
+	// Free the parent first, so children don't have to be erased from it one by one.
+	cull.free(root);
+	for (int i = 0; i < items.size(); i++) {
+		cull.free(items[i]);
+	}
+	cull.free(canvas);
+}
+
+static void benchmark() {
+	Settings settings;
+	List<String> args = OS::get_singleton()->get_cmdline_args();
+	for (List<String>::Element *E = args.front(); E; E = E->next()) {
+		if (!E->next()) {
+			break;
+		}
+		int value = E->next()->get().to_int();
+		if (E->get() == "--instances") {
+			settings.instances = value;
+		} else if (E->get() == "--lights") {
+			settings.lights = value;
+		} else if (E->get() == "--probes") {
+			settings.probes = value;
+		} else if (E->get() == "--frames") {
+			settings.frames = value;
+		} else if (E->get() == "--canvas-items") {
+			settings.canvas_items = value;
+		}
+	}
+
+	Results results;
+	run_scene(settings, results);
+	run_canvas(settings, results);
+
+	print_line(vformat("Scene: %d instances, %d lights, %d reflection probes, %d frames.", settings.instances, settings.lights, settings.probes, settings.frames));
+	print_line(vformat("  create:          %d usec", results.create_usec));
+	print_line(vformat("  first update:    %d usec (bounds, indexing and pairing)", results.first_update_usec));
+	print_line(vformat("  move update:     %d usec (%d instances moved)", results.move_update_usec, (settings.instances + 9) / 10));
+	print_line(vformat("  cull per frame:  %d usec (%d instances, %d lights, %d probes)", results.cull_usec, results.rendered_geometry, results.rendered_lights, results.rendered_reflection_probes));
+	print_line(vformat("  shadows:         %d passes with %d casters per frame", results.shadow_passes, results.shadow_casters));
+#ifdef DEBUG_ENABLED
+	print_line(vformat("  allocations:     %d per frame", results.cull_allocs));
+#endif
+	print_line(vformat("  free:            %d usec", results.free_usec));
+	print_line(vformat("Canvas: %d items.", settings.canvas_items));
+	print_line(vformat("  cull per frame:  %d usec (%d items drawn)", results.canvas_cull_usec, results.canvas_items_drawn));
+	print_line(vformat("  batch per frame: %d usec (%d batches)", results.canvas_batch_usec, results.canvas_batches));
+}
+
+REGISTER_TEST_COMMAND("render-benchmark", &benchmark);
+
+// Keeps the harness working; timings are not checked, as they depend on the machine.
+TEST_CASE("[RenderBenchmark] Small scenario runs and culls") {
+	Settings settings;
+	settings.instances = 400;
+	settings.lights = 8;
+	settings.probes = 2;
+	settings.frames = 2;
+	settings.canvas_items = 400;
+
+	Results results;
+	run_scene(settings, results);
+	CHECK(results.rendered_geometry > 0);
+	CHECK_MESSAGE(results.rendered_geometry < (uint32_t)settings.instances, "Part of the grid should be out of view.");
+	CHECK(results.rendered_lights > 0);
+	CHECK(results.rendered_reflection_probes > 0);
+	CHECK(results.shadow_passes > 0);
+
+	run_canvas(settings, results);
+	CHECK(results.canvas_items_drawn == (uint32_t)settings.canvas_items);
+	CHECK(results.canvas_batches == 1);
+}
+
+TEST_CASE("[RendererSceneCull] Viewports keep their own draw range state") {
+	RendererStorage *prev_storage = RSG::storage;
+	RendererCompositor *prev_rasterizer = RSG::rasterizer;
+	RendererStorage *prev_base_storage = RendererStorage::base_singleton;
+	RendererCanvasRender *prev_canvas_render = RendererCanvasRender::singleton;
+	RendererSceneCull *prev_scene_cull = RendererSceneCull::singleton;
+
+	RendererThreadPool *thread_pool = nullptr;
+	if (!RendererThreadPool::singleton) {
+		thread_pool = memnew(RendererThreadPool);
+	}
+
+	BenchmarkCompositor *compositor = memnew(BenchmarkCompositor);
+	BenchmarkStorage &storage = compositor->benchmark_storage;
+	BenchmarkSceneRender &scene_render = compositor->benchmark_scene;
+	RSG::storage = &storage;
+	RSG::rasterizer = compositor;
+
+	RendererSceneCull *scene_cull = memnew(RendererSceneCull);
+	scene_cull->set_scene_render(&scene_render);
+	RID scenario = scene_cull->scenario_create();
+
+	// A mesh only drawn up to 10 units away, lit by a shadowed omni light.
+	RID mesh = storage.mesh_create();
+	RID mesh_instance = scene_cull->instance_create();
+	scene_cull->instance_set_base(mesh_instance, mesh);
+	scene_cull->instance_set_scenario(mesh_instance, scenario);
+	scene_cull->instance_geometry_set_draw_range(mesh_instance, 0, 10, 0, 1);
+
+	RID light = storage.light_create(RS::LIGHT_OMNI);
+	storage.light_set_param(light, RS::LIGHT_PARAM_RANGE, 12.0);
+	storage.light_set_shadow(light, true);
+	RID light_instance = scene_cull->instance_create();
+	scene_cull->instance_set_base(light_instance, light);
+	scene_cull->instance_set_scenario(light_instance, scenario);
+	scene_cull->instance_set_transform(light_instance, Transform(Basis(), Vector3(0, 3, 0)));
+
+	scene_cull->update_dirty_instances();
+
+	// Two viewports looking at it, one within its draw range and one past it.
+	RID cameras[2];
+	RID render_buffers[2];
+	RID shadow_atlases[2];
+	const float distances[2] = { 5, 30 };
+	for (int i = 0; i < 2; i++) {
+		cameras[i] = scene_cull->camera_create();
+		scene_cull->camera_set_perspective(cameras[i], 70, 0.05, 200);
+		Transform camera_xform;
+		camera_xform.set_look_at(Vector3(0, 0, distances[i]), Vector3(), Vector3(0, 1, 0));
+		scene_cull->camera_set_transform(cameras[i], camera_xform);
+		render_buffers[i] = scene_render.render_buffers_create();
+		shadow_atlases[i] = scene_render.shadow_atlas_create();
+	}
+
+	uint64_t first_light_version = 0;
+	bool near_casts = true;
+	bool far_casts = false;
+	for (int frame = 0; frame < 4; frame++) {
+		compositor->begin_frame(1.0 / 60.0);
+		scene_cull->update();
+
+		for (int i = 0; i < 2; i++) {
+			scene_render.reset_stats();
+			scene_cull->render_camera(render_buffers[i], cameras[i], scenario, Size2(1920, 1080), 0.0, shadow_atlases[i]);
+			if (i == 0) {
+				near_casts = near_casts && scene_render.shadow_casters > 0;
+			} else {
+				far_casts = far_casts || scene_render.shadow_casters > 0;
+			}
+		}
+		FrameArena::reset();
+
+		if (frame == 0) {
+			first_light_version = scene_render.last_light_version;
+		}
+	}
+
+	CHECK_MESSAGE(near_casts, "The mesh should cast shadows in the viewport it is drawn in.");
+	CHECK_MESSAGE(!far_casts, "The mesh should not cast shadows in the viewport past its draw range.");
+	CHECK_MESSAGE(
+			scene_render.last_light_version == first_light_version,
+			"Viewports disagreeing on the draw range should not redraw the shadows every frame.");
+
+	for (int i = 0; i < 2; i++) {
+		scene_cull->free(cameras[i]);
+		scene_render.free(render_buffers[i]);
+		scene_render.free(shadow_atlases[i]);
+	}
+	scene_cull->free(mesh_instance);
+	scene_cull->free(light_instance);
+	storage.free(light);
+	storage.free(mesh);
+	scene_cull->free(scenario);
+	memdelete(scene_cull);
+	memdelete(compositor);
+
+	if (thread_pool) {
+		memdelete(thread_pool);
+	}
+
+	RSG::storage = prev_storage;
+	RSG::rasterizer = prev_rasterizer;
+	RendererStorage::base_singleton = prev_base_storage;
+	RendererCanvasRender::singleton = prev_canvas_render;
+	RendererSceneCull::singleton = prev_scene_cull;
+}
+
+} // namespace TestRenderBenchmark
+
+#endif // TEST_RENDER_BENCHMARK_H
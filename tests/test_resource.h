@@ -0,0 +1,298 @@
+/*************************************************************************/
+/*  test_resource.h                                                      */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_RESOURCE_H
+#define TEST_RESOURCE_H
+
+#include "core/io/resource.h"
+#include "core/io/resource_loader.h"
+#include "core/io/resource_saver.h"
+#include "core/os/dir_access.h"
+#include "core/os/file_access.h"
+#include "core/os/os.h"
+#include "core/variant/variant_parser.h"
+#include "scene/resources/curve.h"
+
+#include "thirdparty/doctest/doctest.h"
+
+namespace TestResource {
+
+TEST_CASE("[Resource] Sub-resources of a binary resource are loaded on demand") {
+	const int item_count = 1000;
+	const String save_path = OS::get_singleton()->get_cache_path().plus_file("resource_sub_resources.res");
+
+	// Each item references its own curve, so both are internal sub-resources of the saved file.
+	Array items;
+	Array curves;
+	for (int i = 0; i < item_count; i++) {
+		Ref<Curve> curve;
+		curve.instance();
+		curve->add_point(Vector2(0, i / float(item_count)));
+		curves.push_back(curve);
+
+		Ref<Resource> item;
+		item.instance();
+		item->set_meta("curve", curve);
+		items.push_back(item);
+	}
+	Ref<Resource> library;
+	library.instance();
+	library->set_meta("items", items);
+
+	REQUIRE(ResourceSaver::save(save_path, library) == OK);
+
+	const int item_subindex = Ref<Resource>(items[500])->get_subindex();
+	const int curve_subindex = Ref<Curve>(curves[500])->get_subindex();
+	const int other_curve_subindex = Ref<Curve>(curves[0])->get_subindex();
+
+	Ref<Resource> loaded_item = ResourceLoader::load(save_path + "::" + itos(item_subindex));
+	REQUIRE(loaded_item.is_valid());
+
+	Ref<Curve> loaded_curve = loaded_item->get_meta("curve");
+	REQUIRE(loaded_curve.is_valid());
+	CHECK_MESSAGE(
+			loaded_curve->get_point_position(0).is_equal_approx(Vector2(0, 0.5)),
+			"The sub-resource referenced by the loaded sub-resource should be loaded with it.");
+	CHECK_MESSAGE(
+			ResourceCache::has(save_path + "::" + itos(curve_subindex)),
+			"The sub-resource referenced by the loaded sub-resource should be cached.");
+	CHECK_MESSAGE(
+			!ResourceCache::has(save_path),
+			"Loading a sub-resource should not load the main resource.");
+	CHECK_MESSAGE(
+			!ResourceCache::has(save_path + "::" + itos(other_curve_subindex)),
+			"Loading a sub-resource should not load unrelated sub-resources.");
+
+	Ref<Resource> loaded_library = ResourceLoader::load(save_path);
+	REQUIRE(loaded_library.is_valid());
+	Array loaded_items = loaded_library->get_meta("items");
+	CHECK_MESSAGE(
+			loaded_items.size() == item_count,
+			"Loading the main resource afterwards should load every sub-resource.");
+	CHECK_MESSAGE(
+			Ref<Resource>(loaded_items[500]) == loaded_item,
+			"Loading the main resource afterwards should reuse the sub-resources loaded before.");
+
+	DirAccess::remove_file_or_error(save_path);
+}
+
+TEST_CASE("[Resource] Sub-resources of a binary resource are loaded on demand without the cache") {
+	const int item_count = 100;
+	const String save_path = OS::get_singleton()->get_cache_path().plus_file("resource_sub_resources_no_cache.res");
+
+	Array items;
+	for (int i = 0; i < item_count; i++) {
+		Ref<Curve> curve;
+		curve.instance();
+		curve->add_point(Vector2(0, i / float(item_count)));
+
+		Ref<Resource> item;
+		item.instance();
+		item->set_meta("curve", curve);
+		items.push_back(item);
+	}
+	Ref<Resource> library;
+	library.instance();
+	library->set_meta("items", items);
+
+	REQUIRE(ResourceSaver::save(save_path, library) == OK);
+
+	const int item_subindex = Ref<Resource>(items[50])->get_subindex();
+	library.unref();
+	items.clear();
+
+	// Nothing else from the file is loaded by the time the item references its curve.
+	Ref<Resource> loaded_item = ResourceLoader::load(save_path + "::" + itos(item_subindex), "", true);
+	REQUIRE(loaded_item.is_valid());
+
+	Ref<Curve> loaded_curve = loaded_item->get_meta("curve");
+	REQUIRE_MESSAGE(
+			loaded_curve.is_valid(),
+			"The sub-resource referenced by the loaded sub-resource should be loaded without the cache.");
+	CHECK(loaded_curve->get_point_position(0).is_equal_approx(Vector2(0, 0.5)));
+	CHECK_MESSAGE(
+			!ResourceCache::has(save_path),
+			"Loading a sub-resource should not load the main resource.");
+
+	DirAccess::remove_file_or_error(save_path);
+}
+
+TEST_CASE("[Resource] External dependencies of a binary resource are loaded in threads") {
+	const int dependency_count = 500;
+	const String cache_path = OS::get_singleton()->get_cache_path();
+	const String save_path = cache_path.plus_file("resource_external_dependencies.res");
+
+	Array curves;
+	for (int i = 0; i < dependency_count; i++) {
+		Ref<Curve> curve;
+		curve.instance();
+		curve->add_point(Vector2(0, i / float(dependency_count)));
+
+		const String curve_path = cache_path.plus_file("resource_external_dependency_" + itos(i) + ".res");
+		REQUIRE(ResourceSaver::save(curve_path, curve) == OK);
+		// Saved with its own path, the curve is referenced as an external dependency.
+		curve->set_path(curve_path);
+		curves.push_back(curve);
+	}
+
+	// This one is only referenced by an internal sub-resource, which is loaded from the cache below,
+	// so nothing references it while the file is parsed.
+	const String unreferenced_path = cache_path.plus_file("resource_external_dependency_unreferenced.res");
+	int item_subindex = 0;
+	{
+		Ref<Curve> curve;
+		curve.instance();
+		REQUIRE(ResourceSaver::save(unreferenced_path, curve) == OK);
+		curve->set_path(unreferenced_path);
+
+		Ref<Resource> item;
+		item.instance();
+		item->set_meta("curve", curve);
+
+		Ref<Resource> library;
+		library.instance();
+		library->set_meta("curves", curves);
+		library->set_meta("item", item);
+
+		REQUIRE(ResourceSaver::save(save_path, library) == OK);
+		item_subindex = item->get_subindex();
+	}
+
+	// Release everything so the dependencies are actually read back from disk.
+	const String first_dependency_path = Ref<Curve>(curves[0])->get_path();
+	curves.clear();
+	REQUIRE(!ResourceCache::has(first_dependency_path));
+	REQUIRE(!ResourceCache::has(unreferenced_path));
+
+	Ref<Resource> cached_item = ResourceLoader::load(save_path + "::" + itos(item_subindex));
+	REQUIRE(cached_item.is_valid());
+	REQUIRE(ResourceCache::has(unreferenced_path));
+
+	const uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	REQUIRE(ResourceLoader::load_threaded_request(save_path, "", true) == OK);
+	Error err = FAILED;
+	Ref<Resource> loaded_library = ResourceLoader::load_threaded_get(save_path, &err);
+	const uint64_t elapsed = OS::get_singleton()->get_ticks_usec() - begin;
+	MESSAGE("Loaded " << dependency_count << " external dependencies in " << elapsed << " usec.");
+
+	REQUIRE(err == OK);
+	REQUIRE(loaded_library.is_valid());
+	Array loaded_curves = loaded_library->get_meta("curves");
+	REQUIRE(loaded_curves.size() == dependency_count);
+
+	bool all_loaded = true;
+	for (int i = 0; i < dependency_count; i++) {
+		Ref<Curve> loaded_curve = loaded_curves[i];
+		if (loaded_curve.is_null() || !loaded_curve->get_point_position(0).is_equal_approx(Vector2(0, i / float(dependency_count)))) {
+			all_loaded = false;
+			break;
+		}
+	}
+	CHECK_MESSAGE(all_loaded, "Every external dependency should be loaded with its data.");
+	CHECK_MESSAGE(
+			ResourceLoader::load_threaded_get_status(first_dependency_path) == ResourceLoader::THREAD_LOAD_INVALID_RESOURCE,
+			"The threaded loads of the dependencies should be joined before the main resource is returned.");
+	CHECK_MESSAGE(
+			Ref<Resource>(loaded_library->get_meta("item")) == cached_item,
+			"The cached sub-resource should be reused.");
+	CHECK_MESSAGE(
+			ResourceLoader::load_threaded_get_status(unreferenced_path) == ResourceLoader::THREAD_LOAD_INVALID_RESOURCE,
+			"The threaded loads of dependencies that nothing references should be joined as well.");
+
+	for (int i = 0; i < dependency_count; i++) {
+		DirAccess::remove_file_or_error(cache_path.plus_file("resource_external_dependency_" + itos(i) + ".res"));
+	}
+	DirAccess::remove_file_or_error(unreferenced_path);
+	DirAccess::remove_file_or_error(save_path);
+}
+
+TEST_CASE("[Resource] Large text resources are parsed with read-ahead") {
+	const int element_count = 200000;
+	const String save_path = OS::get_singleton()->get_cache_path().plus_file("resource_large_text.tres");
+
+	PackedFloat32Array floats;
+	PackedVector3Array vertices;
+	PackedStringArray names;
+	floats.resize(element_count);
+	vertices.resize(element_count / 3);
+	names.resize(element_count / 100);
+	for (int i = 0; i < floats.size(); i++) {
+		floats.write[i] = i * 0.25;
+	}
+	for (int i = 0; i < vertices.size(); i++) {
+		vertices.write[i] = Vector3(i, -i, i * 0.5);
+	}
+	for (int i = 0; i < names.size(); i++) {
+		names.write[i] = "Node_" + itos(i) + String::utf8(" \xc3\xa9");
+	}
+	Dictionary data;
+	data["floats"] = floats;
+	data["vertices"] = vertices;
+	data["names"] = names;
+
+	String text;
+	REQUIRE(VariantWriter::write_to_string(data, text) == OK);
+	{
+		FileAccessRef f = FileAccess::open(save_path, FileAccess::WRITE);
+		REQUIRE(f);
+		f->store_string(text);
+	}
+
+	// Reading one character at a time is how every stream was parsed before read-ahead.
+	Variant parsed[2];
+	for (int i = 0; i < 2; i++) {
+		FileAccessRef f = FileAccess::open(save_path, FileAccess::READ);
+		REQUIRE(f);
+		VariantParser::StreamFile stream;
+		stream.f = f;
+		stream.readahead_enabled = i == 1;
+
+		String error_text;
+		int error_line = 0;
+		CHECK(VariantParser::parse(&stream, parsed[i], error_text, error_line) == OK);
+	}
+
+	CHECK_MESSAGE(parsed[0] == Variant(data), "The unbuffered parser should read back the written data.");
+	CHECK_MESSAGE(parsed[1] == Variant(data), "The read-ahead parser should read back the written data.");
+
+	Ref<Resource> resource;
+	resource.instance();
+	resource->set_meta("data", data);
+	REQUIRE(ResourceSaver::save(save_path, resource) == OK);
+	Ref<Resource> loaded = ResourceLoader::load(save_path, "", true);
+	REQUIRE(loaded.is_valid());
+	CHECK_MESSAGE(Variant(loaded->get_meta("data")) == Variant(data), "A large text resource should load back unchanged.");
+
+	DirAccess::remove_file_or_error(save_path);
+}
+
+} // namespace TestResource
+
+#endif // TEST_RESOURCE_H
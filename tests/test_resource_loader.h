@@ -0,0 +1,225 @@
+/*************************************************************************/
+/*  test_resource_loader.h                                               */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_RESOURCE_LOADER_H
+#define TEST_RESOURCE_LOADER_H
+
+#include "core/io/resource_loader.h"
+#include "core/os/mutex.h"
+#include "core/os/os.h"
+#include "core/os/semaphore.h"
+
+#include "thirdparty/doctest/doctest.h"
+
+namespace TestResourceLoader {
+
+#if !defined(NO_THREADS)
+
+// Loads an empty resource for any ".testload" path, but only once the test lets it through.
+class BlockingResourceFormatLoader : public ResourceFormatLoader {
+public:
+	Mutex mutex;
+	Semaphore release;
+	Vector<String> started;
+	HashMap<String, ObjectID> loaded;
+
+	virtual RES load(const String &p_path, const String &p_original_path = "", Error *r_error = nullptr, bool p_use_sub_threads = false, float *r_progress = nullptr, bool p_no_cache = false) override {
+		mutex.lock();
+		started.push_back(p_path);
+		mutex.unlock();
+
+		release.wait();
+
+		Ref<Resource> res;
+		res.instance();
+		mutex.lock();
+		loaded[p_path] = res->get_instance_id();
+		mutex.unlock();
+
+		if (r_error) {
+			*r_error = OK;
+		}
+		return res;
+	}
+
+	virtual void get_recognized_extensions(List<String> *p_extensions) const override {
+		p_extensions->push_back("testload");
+	}
+
+	virtual bool handles_type(const String &p_type) const override {
+		return p_type == "Resource";
+	}
+
+	virtual String get_resource_type(const String &p_path) const override {
+		return p_path.get_extension() == "testload" ? "Resource" : "";
+	}
+
+	int get_started_count() {
+		MutexLock lock(mutex);
+		return started.size();
+	}
+
+	String get_started(int p_index) {
+		MutexLock lock(mutex);
+		return started[p_index];
+	}
+
+	ObjectID get_loaded(const String &p_path) {
+		MutexLock lock(mutex);
+		const ObjectID *id = loaded.getptr(p_path);
+		return id ? *id : ObjectID();
+	}
+
+	bool wait_for_started(int p_count) {
+		for (int i = 0; i < 5000; i++) {
+			if (get_started_count() >= p_count) {
+				return true;
+			}
+			OS::get_singleton()->delay_usec(1000);
+		}
+		return false;
+	}
+};
+
+String test_load_path(const String &p_name) {
+	return OS::get_singleton()->get_cache_path().plus_file("resource_loader_" + p_name + ".testload");
+}
+
+// Occupies every loading thread, so the next requests have to wait in the queue.
+Vector<String> start_blocking_loads(Ref<BlockingResourceFormatLoader> &p_loader) {
+	Vector<String> paths;
+	const int thread_count = OS::get_singleton()->get_processor_count();
+	for (int i = 0; i < thread_count; i++) {
+		const String path = test_load_path("blocker_" + itos(i));
+		if (ResourceLoader::load_threaded_request(path) == OK) {
+			paths.push_back(path);
+		}
+	}
+	p_loader->wait_for_started(paths.size());
+	return paths;
+}
+
+TEST_CASE("[ResourceLoader] Queued threaded loads start by priority") {
+	Ref<BlockingResourceFormatLoader> loader;
+	loader.instance();
+	ResourceLoader::add_resource_format_loader(loader, true);
+
+	const Vector<String> blockers = start_blocking_loads(loader);
+	REQUIRE(blockers.size() == OS::get_singleton()->get_processor_count());
+	REQUIRE(loader->get_started_count() == blockers.size());
+
+	const String low_a = test_load_path("low_a");
+	const String low_b = test_load_path("low_b");
+	const String high = test_load_path("high");
+	REQUIRE(ResourceLoader::load_threaded_request(low_a, "", false, 0) == OK);
+	REQUIRE(ResourceLoader::load_threaded_request(low_b, "", false, 0) == OK);
+	REQUIRE(ResourceLoader::load_threaded_request(high, "", false, 10) == OK);
+	CHECK(ResourceLoader::load_threaded_get_queued_count() == 3);
+	CHECK(ResourceLoader::load_threaded_get_status(high) == ResourceLoader::THREAD_LOAD_IN_PROGRESS);
+
+	// Finishing one load frees a single thread for the queue.
+	int started = blockers.size();
+	loader->release.post();
+	REQUIRE(loader->wait_for_started(started + 1));
+	CHECK_MESSAGE(loader->get_started(started) == high, "The high priority request should start before the earlier low priority ones.");
+	CHECK(ResourceLoader::load_threaded_get_queued_count() == 2);
+
+	started++;
+	loader->release.post();
+	REQUIRE(loader->wait_for_started(started + 1));
+	CHECK_MESSAGE(loader->get_started(started) == low_a, "Requests of the same priority should start in request order.");
+
+	// Two loads were let through already.
+	const int total = blockers.size() + 3;
+	for (int i = 2; i < total; i++) {
+		loader->release.post();
+	}
+	for (int i = 0; i < blockers.size(); i++) {
+		CHECK(ResourceLoader::load_threaded_get(blockers[i]).is_valid());
+	}
+	CHECK(ResourceLoader::load_threaded_get(low_a).is_valid());
+	CHECK(ResourceLoader::load_threaded_get(low_b).is_valid());
+	CHECK(ResourceLoader::load_threaded_get(high).is_valid());
+	CHECK(ResourceLoader::load_threaded_get_queued_count() == 0);
+
+	ResourceLoader::remove_resource_format_loader(loader);
+}
+
+TEST_CASE("[ResourceLoader] Cancelled threaded loads are released") {
+	Ref<BlockingResourceFormatLoader> loader;
+	loader.instance();
+	ResourceLoader::add_resource_format_loader(loader, true);
+
+	const Vector<String> blockers = start_blocking_loads(loader);
+	REQUIRE(blockers.size() == OS::get_singleton()->get_processor_count());
+	REQUIRE(loader->get_started_count() == blockers.size());
+
+	// A queued load is dropped right away, it never reaches the loader.
+	const String queued = test_load_path("queued");
+	REQUIRE(ResourceLoader::load_threaded_request(queued) == OK);
+	REQUIRE(ResourceLoader::load_threaded_get_queued_count() == 1);
+	CHECK(ResourceLoader::load_threaded_cancel(queued) == OK);
+	CHECK(ResourceLoader::load_threaded_get_status(queued) == ResourceLoader::THREAD_LOAD_INVALID_RESOURCE);
+	CHECK(ResourceLoader::load_threaded_get_queued_count() == 0);
+	CHECK_MESSAGE(ResourceLoader::load_threaded_cancel(queued) == ERR_INVALID_PARAMETER, "The cancelled task should be gone.");
+
+	// A running load can't be interrupted, its result is released once the thread is done.
+	const String running = blockers[0];
+	CHECK(ResourceLoader::load_threaded_cancel(running) == OK);
+	CHECK(ResourceLoader::load_threaded_get_status(running) == ResourceLoader::THREAD_LOAD_INVALID_RESOURCE);
+
+	for (int i = 0; i < blockers.size(); i++) {
+		loader->release.post();
+	}
+	for (int i = 1; i < blockers.size(); i++) {
+		CHECK(ResourceLoader::load_threaded_get(blockers[i]).is_valid());
+	}
+
+	// Nothing else is requested from here on, the worker alone must erase the task and free its resource.
+	bool released = false;
+	for (int i = 0; i < 5000 && !released; i++) {
+		const ObjectID id = loader->get_loaded(running);
+		released = id.is_valid() && ObjectDB::get_instance(id) == nullptr;
+		if (!released) {
+			OS::get_singleton()->delay_usec(1000);
+		}
+	}
+	CHECK_MESSAGE(released, "The resource of a cancelled load should be freed when its thread ends.");
+	CHECK(ResourceLoader::load_threaded_get_status(running) == ResourceLoader::THREAD_LOAD_INVALID_RESOURCE);
+	CHECK(loader->get_started_count() == blockers.size());
+
+	ResourceLoader::remove_resource_format_loader(loader);
+}
+
+#endif // NO_THREADS
+
+} // namespace TestResourceLoader
+
+#endif // TEST_RESOURCE_LOADER_H
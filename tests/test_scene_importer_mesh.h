@@ -0,0 +1,252 @@
+/*************************************************************************/
+/*  test_scene_importer_mesh.h                                           */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_SCENE_IMPORTER_MESH_H
+#define TEST_SCENE_IMPORTER_MESH_H
+
+#ifdef TOOLS_ENABLED
+
+#include "editor/import/scene_importer_mesh.h"
+#include "scene/resources/surface_tool.h"
+
+#include "tests/test_macros.h"
+
+namespace TestSceneImporterMesh {
+
+const int GRID_SIZE = 4;
+
+// Every attribute is derived from the grid position, so the vertices can be checked after being moved around.
+static Vector2 grid_uv(const Vector3 &p_vertex) {
+	return Vector2(p_vertex.x, p_vertex.y) / (GRID_SIZE - 1);
+}
+
+static Color grid_color(const Vector3 &p_vertex) {
+	return Color(p_vertex.x / (GRID_SIZE - 1), p_vertex.y / (GRID_SIZE - 1), 0.5);
+}
+
+static int grid_id(const Vector3 &p_vertex) {
+	return int(Math::round(p_vertex.x)) + int(Math::round(p_vertex.y)) * GRID_SIZE;
+}
+
+// Triangles as sorted keys of their grid vertices, rotated to start at the lowest one to keep the winding.
+static Vector<int64_t> triangle_keys(const Vector<int> &p_indices, const Vector<Vector3> &p_vertices) {
+	Vector<int64_t> keys;
+	for (int i = 0; i < p_indices.size(); i += 3) {
+		int ids[3];
+		for (int j = 0; j < 3; j++) {
+			ids[j] = grid_id(p_vertices[p_indices[i + j]]);
+		}
+		int first = 0;
+		for (int j = 1; j < 3; j++) {
+			if (ids[j] < ids[first]) {
+				first = j;
+			}
+		}
+		int64_t key = 0;
+		for (int j = 0; j < 3; j++) {
+			key = key * 1024 + ids[(first + j) % 3];
+		}
+		keys.push_back(key);
+	}
+	keys.sort();
+	return keys;
+}
+
+TEST_CASE("[SceneImporterMesh] Vertex fetch optimization keeps attributes together") {
+	if (!SurfaceTool::optimize_vertex_fetch_remap_func) {
+		MESSAGE("meshoptimizer is not available, skipping.");
+		return;
+	}
+
+	// A grid with its vertices stored in a scrambled order, plus a vertex no triangle uses.
+	const int grid_vertex_count = GRID_SIZE * GRID_SIZE;
+	Vector<int> order; // Grid vertex of each stored vertex.
+	for (int i = 0; i < grid_vertex_count; i++) {
+		order.push_back((i * 7) % grid_vertex_count);
+	}
+	Vector<int> stored_index; // Stored vertex of each grid vertex.
+	stored_index.resize(grid_vertex_count);
+	for (int i = 0; i < grid_vertex_count; i++) {
+		stored_index.write[order[i]] = i;
+	}
+
+	Vector<Vector3> vertices;
+	Vector<Vector3> normals;
+	Vector<float> tangents;
+	Vector<Vector2> uvs;
+	Vector<Color> colors;
+	Vector<Vector3> blend_vertices;
+	for (int i = 0; i <= grid_vertex_count; i++) {
+		const Vector3 v = i < grid_vertex_count ? Vector3(order[i] % GRID_SIZE, order[i] / GRID_SIZE, 0) : Vector3(-1, -1, 0);
+		vertices.push_back(v);
+		normals.push_back(Vector3(v.x, v.y, 1).normalized());
+		tangents.push_back(1);
+		tangents.push_back(v.x);
+		tangents.push_back(v.y);
+		tangents.push_back(1);
+		uvs.push_back(grid_uv(v));
+		colors.push_back(grid_color(v));
+		blend_vertices.push_back(v + Vector3(0, 0, 1));
+	}
+
+	Vector<int> indices;
+	for (int y = 0; y < GRID_SIZE - 1; y++) {
+		for (int x = 0; x < GRID_SIZE - 1; x++) {
+			const int a = stored_index[y * GRID_SIZE + x];
+			const int b = stored_index[y * GRID_SIZE + x + 1];
+			const int c = stored_index[(y + 1) * GRID_SIZE + x];
+			const int d = stored_index[(y + 1) * GRID_SIZE + x + 1];
+			indices.push_back(a);
+			indices.push_back(b);
+			indices.push_back(c);
+			indices.push_back(b);
+			indices.push_back(d);
+			indices.push_back(c);
+		}
+	}
+	// A coarse LOD covering the whole grid with two triangles.
+	Vector<int> lod_indices;
+	lod_indices.push_back(stored_index[0]);
+	lod_indices.push_back(stored_index[GRID_SIZE - 1]);
+	lod_indices.push_back(stored_index[grid_vertex_count - GRID_SIZE]);
+	lod_indices.push_back(stored_index[GRID_SIZE - 1]);
+	lod_indices.push_back(stored_index[grid_vertex_count - 1]);
+	lod_indices.push_back(stored_index[grid_vertex_count - GRID_SIZE]);
+
+	Array arrays;
+	arrays.resize(Mesh::ARRAY_MAX);
+	arrays[Mesh::ARRAY_VERTEX] = vertices;
+	arrays[Mesh::ARRAY_NORMAL] = normals;
+	arrays[Mesh::ARRAY_TANGENT] = tangents;
+	arrays[Mesh::ARRAY_TEX_UV] = uvs;
+	arrays[Mesh::ARRAY_COLOR] = colors;
+	arrays[Mesh::ARRAY_INDEX] = indices;
+
+	Array blend_arrays;
+	blend_arrays.resize(Mesh::ARRAY_MAX);
+	blend_arrays[Mesh::ARRAY_VERTEX] = blend_vertices;
+	Array blend_shapes;
+	blend_shapes.push_back(blend_arrays);
+
+	Dictionary lods;
+	lods[1.0] = lod_indices;
+
+	Ref<EditorSceneImporterMesh> mesh;
+	mesh.instance();
+	mesh->add_blend_shape("Raised");
+	mesh->add_surface(Mesh::PRIMITIVE_TRIANGLES, arrays, blend_shapes, lods);
+	REQUIRE(mesh->get_surface_count() == 1);
+
+	mesh->optimize_indices(true, true);
+
+	const Array new_arrays = mesh->get_surface_arrays(0);
+	const Vector<Vector3> new_vertices = new_arrays[Mesh::ARRAY_VERTEX];
+	const Vector<Vector3> new_normals = new_arrays[Mesh::ARRAY_NORMAL];
+	const Vector<float> new_tangents = new_arrays[Mesh::ARRAY_TANGENT];
+	const Vector<Vector2> new_uvs = new_arrays[Mesh::ARRAY_TEX_UV];
+	const Vector<Color> new_colors = new_arrays[Mesh::ARRAY_COLOR];
+	const Vector<int> new_indices = new_arrays[Mesh::ARRAY_INDEX];
+
+	CHECK_MESSAGE(new_vertices.size() == grid_vertex_count, "The unused vertex should be dropped.");
+	REQUIRE(new_normals.size() == new_vertices.size());
+	REQUIRE(new_tangents.size() == new_vertices.size() * 4);
+	REQUIRE(new_uvs.size() == new_vertices.size());
+	REQUIRE(new_colors.size() == new_vertices.size());
+	REQUIRE(new_indices.size() == indices.size());
+
+	bool attributes_match = true;
+	for (int i = 0; i < new_vertices.size(); i++) {
+		const Vector3 v = new_vertices[i];
+		attributes_match = attributes_match && new_normals[i].is_equal_approx(Vector3(v.x, v.y, 1).normalized());
+		attributes_match = attributes_match && Math::is_equal_approx(new_tangents[i * 4 + 1], v.x) && Math::is_equal_approx(new_tangents[i * 4 + 2], v.y);
+		attributes_match = attributes_match && new_uvs[i].is_equal_approx(grid_uv(v));
+		attributes_match = attributes_match && new_colors[i].is_equal_approx(grid_color(v));
+	}
+	CHECK_MESSAGE(attributes_match, "Every attribute should move with its vertex.");
+
+	int next_vertex = 0;
+	bool first_use_order = true;
+	for (int i = 0; i < new_indices.size(); i++) {
+		if (new_indices[i] == next_vertex) {
+			next_vertex++;
+		} else if (new_indices[i] > next_vertex) {
+			first_use_order = false;
+		}
+	}
+	CHECK_MESSAGE(first_use_order, "Vertices should be stored in the order the triangles use them.");
+
+	CHECK_MESSAGE(triangle_keys(new_indices, new_vertices) == triangle_keys(indices, vertices), "The triangles and their winding should be kept.");
+
+	REQUIRE(mesh->get_surface_lod_count(0) == 1);
+	CHECK_MESSAGE(triangle_keys(mesh->get_surface_lod_indices(0, 0), new_vertices) == triangle_keys(lod_indices, vertices), "LOD indices should be remapped too.");
+
+	const Array new_blend_arrays = mesh->get_surface_blend_shape_arrays(0, 0);
+	const Vector<Vector3> new_blend_vertices = new_blend_arrays[Mesh::ARRAY_VERTEX];
+	REQUIRE(new_blend_vertices.size() == new_vertices.size());
+	bool blend_shapes_match = true;
+	for (int i = 0; i < new_vertices.size(); i++) {
+		blend_shapes_match = blend_shapes_match && new_blend_vertices[i].is_equal_approx(new_vertices[i] + Vector3(0, 0, 1));
+	}
+	CHECK_MESSAGE(blend_shapes_match, "Blend shapes should be remapped like the surface.");
+}
+
+TEST_CASE("[SceneImporterMesh] Surfaces with indices out of range are left untouched") {
+	Vector<Vector3> vertices;
+	vertices.push_back(Vector3(0, 0, 0));
+	vertices.push_back(Vector3(1, 0, 0));
+	vertices.push_back(Vector3(0, 1, 0));
+	Vector<int> indices;
+	indices.push_back(0);
+	indices.push_back(1);
+	indices.push_back(3);
+
+	Array arrays;
+	arrays.resize(Mesh::ARRAY_MAX);
+	arrays[Mesh::ARRAY_VERTEX] = vertices;
+	arrays[Mesh::ARRAY_INDEX] = indices;
+
+	Ref<EditorSceneImporterMesh> mesh;
+	mesh.instance();
+	mesh->add_surface(Mesh::PRIMITIVE_TRIANGLES, arrays);
+
+	ERR_PRINT_OFF;
+	mesh->optimize_indices(true, true);
+	ERR_PRINT_ON;
+
+	const Array new_arrays = mesh->get_surface_arrays(0);
+	CHECK(Vector<int>(new_arrays[Mesh::ARRAY_INDEX]) == indices);
+	CHECK(Vector<Vector3>(new_arrays[Mesh::ARRAY_VERTEX]) == vertices);
+}
+
+} // namespace TestSceneImporterMesh
+
+#endif // TOOLS_ENABLED
+
+#endif // TEST_SCENE_IMPORTER_MESH_H
@@ -32,10 +32,189 @@
 #define TEST_SHADER_LANG_H
 
 #include "core/os/main_loop.h"
+#include "core/os/os.h"
+#include "servers/rendering/renderer_rd/shader_compiler_rd.h"
+#include "servers/rendering/renderer_rd/shader_rd.h"
+#include "servers/rendering/renderer_thread_pool.h"
+
+#include "tests/test_macros.h"
 
 namespace TestShaderLang {
 
 MainLoop *test();
+
+static const char *cache_test_shader = R"(
+shader_type spatial;
+render_mode blend_add, cull_front, cull_disabled, unshaded;
+
+uniform vec4 albedo : hint_color;
+uniform float amount = 1.0;
+
+void vertex() {
+	VERTEX += NORMAL * amount;
+}
+
+void fragment() {
+	ALBEDO = albedo.rgb;
+	ALPHA = 0.5;
+}
+)";
+
+struct CacheTestFlags {
+	int blend_mode = 0;
+	int cull = 0;
+	bool unshaded = false;
+	bool uses_alpha = false;
+	bool uses_discard = false;
+	bool uses_vertex = false;
+	bool writes_projection = false;
+	Map<StringName, ShaderLanguage::ShaderNode::Uniform> uniforms;
+
+	ShaderCompilerRD::IdentifierActions get_actions() {
+		ShaderCompilerRD::IdentifierActions actions;
+		actions.render_mode_values["blend_add"] = Pair<int *, int>(&blend_mode, 1);
+		actions.render_mode_values["blend_mix"] = Pair<int *, int>(&blend_mode, 2);
+		actions.render_mode_values["cull_front"] = Pair<int *, int>(&cull, 1);
+		actions.render_mode_values["cull_disabled"] = Pair<int *, int>(&cull, 2);
+		actions.render_mode_flags["unshaded"] = &unshaded;
+		actions.usage_flag_pointers["ALPHA"] = &uses_alpha;
+		actions.usage_flag_pointers["DISCARD"] = &uses_discard;
+		actions.write_flag_pointers["VERTEX"] = &uses_vertex;
+		actions.write_flag_pointers["PROJECTION_MATRIX"] = &writes_projection;
+		actions.uniforms = &uniforms;
+		return actions;
+	}
+};
+
+TEST_CASE("[ShaderCompilerRD] Compile cache") {
+	REQUIRE(ShaderTypes::get_singleton());
+
+	ShaderCompilerRD compiler;
+	ShaderCompilerRD::DefaultIdentifierActions default_actions;
+	default_actions.base_uniform_string = "material.";
+	compiler.initialize(default_actions);
+
+	CacheTestFlags first;
+	ShaderCompilerRD::IdentifierActions first_actions = first.get_actions();
+	ShaderCompilerRD::GeneratedCode first_code;
+	REQUIRE(compiler.compile(RS::SHADER_SPATIAL, cache_test_shader, &first_actions, "", first_code) == OK);
+
+	CHECK(compiler.get_cache_misses() == 1);
+	CHECK(compiler.get_cache_hits() == 0);
+	CHECK_MESSAGE(first.blend_mode == 1, "Render mode values are applied on a miss.");
+	CHECK_MESSAGE(first.cull == 2, "The last render mode setting a value wins.");
+	CHECK(first.unshaded);
+	CHECK(first.uses_alpha);
+	CHECK(!first.uses_discard);
+	CHECK(first.uses_vertex);
+	CHECK(!first.writes_projection);
+	CHECK(first.uniforms.size() == 2);
+
+	SUBCASE("Compiling the same code again replays the result") {
+		CacheTestFlags second;
+		ShaderCompilerRD::IdentifierActions second_actions = second.get_actions();
+		ShaderCompilerRD::GeneratedCode second_code;
+		REQUIRE(compiler.compile(RS::SHADER_SPATIAL, cache_test_shader, &second_actions, "", second_code) == OK);
+
+		CHECK(compiler.get_cache_misses() == 1);
+		CHECK(compiler.get_cache_hits() == 1);
+		CHECK(second.blend_mode == first.blend_mode);
+		CHECK(second.cull == first.cull);
+		CHECK(second.unshaded);
+		CHECK(second.uses_alpha);
+		CHECK(!second.uses_discard);
+		CHECK(second.uses_vertex);
+		CHECK(!second.writes_projection);
+		CHECK(second.uniforms.size() == 2);
+		CHECK(second.uniforms.has("albedo"));
+		CHECK(second.uniforms.has("amount"));
+
+		CHECK(second_code.vertex == first_code.vertex);
+		CHECK(second_code.fragment == first_code.fragment);
+		CHECK(second_code.uniforms == first_code.uniforms);
+		CHECK(second_code.defines == first_code.defines);
+		CHECK(second_code.uniform_offsets == first_code.uniform_offsets);
+		CHECK(second_code.uniform_total_size == first_code.uniform_total_size);
+	}
+
+	SUBCASE("Different code or actions miss the cache") {
+		CacheTestFlags second;
+		ShaderCompilerRD::IdentifierActions second_actions = second.get_actions();
+		ShaderCompilerRD::GeneratedCode second_code;
+		String code = String(cache_test_shader).replace("ALPHA = 0.5;", "discard;");
+		REQUIRE(compiler.compile(RS::SHADER_SPATIAL, code, &second_actions, "", second_code) == OK);
+
+		CHECK(compiler.get_cache_misses() == 2);
+		CHECK(!second.uses_alpha);
+		CHECK(second.uses_discard);
+		CHECK(second_code.fragment != first_code.fragment);
+
+		CacheTestFlags third;
+		ShaderCompilerRD::IdentifierActions third_actions = third.get_actions();
+		third_actions.usage_flag_pointers.erase("DISCARD");
+		ShaderCompilerRD::GeneratedCode third_code;
+		REQUIRE(compiler.compile(RS::SHADER_SPATIAL, cache_test_shader, &third_actions, "", third_code) == OK);
+
+		CHECK_MESSAGE(compiler.get_cache_misses() == 3, "Requesting other flags must not reuse a result that didn't record them.");
+		CHECK(third.uses_alpha);
+	}
+
+	SUBCASE("Errors are not cached") {
+		CacheTestFlags second;
+		ShaderCompilerRD::IdentifierActions second_actions = second.get_actions();
+		ShaderCompilerRD::GeneratedCode second_code;
+		String code = String(cache_test_shader).replace("ALPHA = 0.5;", "ALPHA = undefined_variable;");
+
+		ERR_PRINT_OFF;
+		CHECK(compiler.compile(RS::SHADER_SPATIAL, code, &second_actions, "", second_code) != OK);
+		CHECK(compiler.compile(RS::SHADER_SPATIAL, code, &second_actions, "", second_code) != OK);
+		ERR_PRINT_ON;
+
+		CHECK(compiler.get_cache_misses() == 3);
+		CHECK(compiler.get_cache_hits() == 0);
+	}
+}
+
+class AsyncTestShaderRD : public ShaderRD {
+public:
+	AsyncTestShaderRD() {
+		static const char vertex_code[] = "#version 450\n\nVERSION_DEFINES\n\nlayout(location = 0) in vec3 vertex_attrib;\n\nvoid main() {\n\tgl_Position = vec4(vertex_attrib, 1.0);\n}\n";
+		static const char fragment_code[] = "#version 450\n\nVERSION_DEFINES\n\nlayout(location = 0) out vec4 frag_color;\n\nvoid main() {\n\tfrag_color = vec4(1.0);\n}\n";
+		setup(vertex_code, fragment_code, nullptr, "AsyncTestShaderRD");
+	}
+};
+
+TEST_CASE("[ShaderRD] Versions compiling in the background are not compiled on the calling thread") {
+	if (!RD::get_singleton() || !RendererThreadPool::singleton) {
+		MESSAGE("No rendering device, skipping.");
+		return;
+	}
+
+	AsyncTestShaderRD shader;
+	Vector<String> variant_defines;
+	variant_defines.push_back("");
+	shader.initialize(variant_defines);
+
+	RID version = shader.version_create();
+	shader.version_set_code(version, "", "", "", "", "", "", Vector<String>()); // The first code is compiled right away.
+	REQUIRE(shader.version_is_valid(version));
+
+	// What setting the code of a spatial shader does with rendering/forward_renderer/async_shader_compile enabled.
+	shader.version_set_code(version, "", "", "", "", "", "", Vector<String>());
+	REQUIRE(shader.version_compile_async(version));
+
+	// Updating the materials of the shader asks for it before the background compile is polled.
+	CHECK_MESSAGE(!shader.version_is_valid(version), "The version must stay invalid until the background compile is done.");
+	CHECK(shader.version_get_shader(version, 0) == RID());
+
+	while (shader.version_is_compiling(version)) {
+		OS::get_singleton()->delay_usec(1000);
+	}
+	CHECK(shader.version_is_valid(version));
+	CHECK(shader.version_get_shader(version, 0).is_valid());
+
+	shader.version_free(version);
 }
+} // namespace TestShaderLang
 
 #endif // TEST_SHADER_LANG_H
@@ -1272,6 +1272,57 @@ TEST_CASE("[String] humanize_size") {
 	CHECK(String::humanize_size(100523550) == "95.86 MiB");
 	CHECK(String::humanize_size(5345555000) == "4.97 GiB");
 }
+
+TEST_CASE("[String] UTF-8 round trip around the vectorized blocks") {
+	// ASCII runs of every length, before and after multibyte characters.
+	const char32_t others[4] = { 0xe9, 0x416, 0x6f22, 0x1f600 };
+	const int other_lengths[4] = { 2, 2, 3, 4 };
+	int wrong = 0;
+	for (int len = 0; len < 40; len++) {
+		for (int other = 0; other < 4; other++) {
+			String s;
+			for (int i = 0; i < len; i++) {
+				s += char32_t('a' + i % 26);
+			}
+			s += others[other];
+			for (int i = 0; i < len; i++) {
+				s += char32_t('A' + i % 26);
+			}
+
+			CharString utf8 = s.utf8();
+			wrong += utf8.length() != len * 2 + other_lengths[other];
+			wrong += String::utf8(utf8.get_data()) != s;
+			wrong += String::utf8(utf8.get_data(), utf8.length()) != s;
+		}
+	}
+	CHECK(wrong == 0);
+
+	// The explicit length stops at a zero byte.
+	CHECK(String::utf8("abcdefghijklmnopqrstuvwxyz\0abc", 30) == "abcdefghijklmnopqrstuvwxyz");
+}
+
+TEST_CASE("[String] Find around the vectorized blocks") {
+	String s = "a,b,cc,ddd,eeee,fffff,gggggg,hhhhhhh,iiiiiiii";
+	CHECK(s.find(",") == 1);
+	CHECK(s.find(",", 30) == 36);
+	CHECK(s.find("iii") == 37);
+	CHECK(s.find("iiii", 42) == -1);
+	CHECK(s.find(String("ii"), 43) == 43);
+	CHECK(s.find(String("x")) == -1);
+	CHECK(s.find_char('i') == 37);
+	CHECK(s.find_char('i', 44) == 44);
+	CHECK(s.find_char('x') == -1);
+	CHECK(s.split(",").size() == 9);
+	CHECK(s.replace(",", "") == "abccdddeeeefffffgggggghhhhhhhiiiiiiii");
+}
+
+TEST_CASE("[String] to_lower around the vectorized blocks") {
+	String lower = "already lowercase, with digits 1234 and punctuation!";
+	CHECK(lower.to_lower() == lower);
+	CHECK(String("MIXED case [AND] @SYMBOLS@ Z").to_lower() == "mixed case [and] @symbols@ z");
+	CHECK(String::utf8("lowercase then ÀÉÎ").to_lower() == String::utf8("lowercase then àéî"));
+	CHECK(String::utf8("ünïcödé ünïcödé ünïcödé").to_lower() == String::utf8("ünïcödé ünïcödé ünïcödé"));
+}
 } // namespace TestString
 
 #endif // TEST_STRING_H
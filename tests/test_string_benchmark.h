@@ -0,0 +1,178 @@
+/*************************************************************************/
+/*  test_string_benchmark.h                                              */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_STRING_BENCHMARK_H
+#define TEST_STRING_BENCHMARK_H
+
+#include "core/math/random_pcg.h"
+#include "core/os/os.h"
+#include "core/string/ustring.h"
+
+#include "tests/test_macros.h"
+
+// Times the String operations that dominate importing JSON and CSV files,
+// looking up translations and loading text resources, on an ASCII corpus and
+// on a mixed one with accented, Cyrillic, CJK and emoji text.
+//
+// Run with: godot --test string-benchmark [--lines N] [--rounds N]
+
+namespace TestStringBenchmark {
+
+struct Settings {
+	int lines = 20000;
+	int rounds = 5;
+};
+
+struct Results {
+	uint64_t parse_utf8_usec = 0;
+	uint64_t utf8_usec = 0;
+	uint64_t find_usec = 0;
+	uint64_t split_usec = 0;
+	uint64_t replace_usec = 0;
+	uint64_t to_lower_usec = 0;
+	uint64_t compare_usec = 0;
+	uint64_t checksum = 0; // Of the lengths and counts, the same for both corpora.
+};
+
+// CSV like lines, like translation tables. The mixed corpus has the same
+// structure, with words replaced by other scripts of the same length.
+static CharString make_corpus(int p_lines, bool p_mixed) {
+	static const char *ascii_words[4] = { "Hello", "Quit", "Options", "Cancel" };
+	static const char *mixed_words[4] = { "Héllo", "Выйт", "オプション設定", "Can😀el" };
+	RandomPCG rng(7);
+	String corpus;
+	for (int i = 0; i < p_lines; i++) {
+		const char *word = (p_mixed ? mixed_words : ascii_words)[rng.rand() % 4];
+		corpus += "KEY_" + itos(i) + "," + String::utf8(word) + " " + itos(rng.rand() % 1000) + ",\"Some longer TEXT, for the Description\"\n";
+	}
+	return corpus.utf8();
+}
+
+static Results run(const Settings &p_settings, bool p_mixed) {
+	Results results;
+	CharString corpus = make_corpus(p_settings.lines, p_mixed);
+	String text;
+
+	for (int round = 0; round < p_settings.rounds; round++) {
+		uint64_t from = OS::get_singleton()->get_ticks_usec();
+		text.parse_utf8(corpus.get_data(), corpus.length());
+		results.parse_utf8_usec += OS::get_singleton()->get_ticks_usec() - from;
+
+		from = OS::get_singleton()->get_ticks_usec();
+		CharString utf8 = text.utf8();
+		results.utf8_usec += OS::get_singleton()->get_ticks_usec() - from;
+		results.checksum += utf8.length() == corpus.length();
+
+		from = OS::get_singleton()->get_ticks_usec();
+		int found = 0;
+		for (int pos = text.find("TEXT"); pos != -1; pos = text.find("TEXT", pos + 1)) {
+			found++;
+		}
+		results.find_usec += OS::get_singleton()->get_ticks_usec() - from;
+		results.checksum += found;
+
+		from = OS::get_singleton()->get_ticks_usec();
+		Vector<String> lines = text.split("\n");
+		results.split_usec += OS::get_singleton()->get_ticks_usec() - from;
+		results.checksum += lines.size();
+
+		from = OS::get_singleton()->get_ticks_usec();
+		String replaced = text.replace("Description", "Desc");
+		results.replace_usec += OS::get_singleton()->get_ticks_usec() - from;
+		results.checksum += text.length() - replaced.length();
+
+		from = OS::get_singleton()->get_ticks_usec();
+		String lower = text.to_lower();
+		results.to_lower_usec += OS::get_singleton()->get_ticks_usec() - from;
+		results.checksum += lower.length() == text.length();
+
+		// Like looking up the lines of a translation table.
+		from = OS::get_singleton()->get_ticks_usec();
+		int equal = 0;
+		for (int i = 1; i < lines.size(); i++) {
+			equal += lines[i] == lines[i - 1];
+			equal += lines[i] == lines[i];
+		}
+		results.compare_usec += OS::get_singleton()->get_ticks_usec() - from;
+		results.checksum += equal;
+	}
+
+	results.parse_utf8_usec /= p_settings.rounds;
+	results.utf8_usec /= p_settings.rounds;
+	results.find_usec /= p_settings.rounds;
+	results.split_usec /= p_settings.rounds;
+	results.replace_usec /= p_settings.rounds;
+	results.to_lower_usec /= p_settings.rounds;
+	results.compare_usec /= p_settings.rounds;
+	return results;
+}
+
+static void print_results(const char *p_name, const Results &p_results) {
+	print_line(vformat("  %-6s parse_utf8 %6d  utf8 %6d  find %6d usec", p_name, p_results.parse_utf8_usec, p_results.utf8_usec, p_results.find_usec));
+	print_line(vformat("  %-6s split %6d  replace %6d  to_lower %6d", "", p_results.split_usec, p_results.replace_usec, p_results.to_lower_usec));
+	print_line(vformat("  %-6s compare %6d usec", "", p_results.compare_usec));
+}
+
+static void benchmark() {
+	Settings settings;
+	List<String> args = OS::get_singleton()->get_cmdline_args();
+	for (List<String>::Element *E = args.front(); E; E = E->next()) {
+		if (!E->next()) {
+			break;
+		}
+		int value = E->next()->get().to_int();
+		if (E->get() == "--lines") {
+			settings.lines = MAX(value, 1);
+		} else if (E->get() == "--rounds") {
+			settings.rounds = MAX(value, 1);
+		}
+	}
+
+	print_line(vformat("Strings: %d lines, %d rounds.", settings.lines, settings.rounds));
+	print_results("ASCII", run(settings, false));
+	print_results("Mixed", run(settings, true));
+}
+
+REGISTER_TEST_COMMAND("string-benchmark", &benchmark);
+
+// Keeps the harness working; timings are not checked, as they depend on the machine.
+TEST_CASE("[StringBenchmark] Both corpora give the same results") {
+	Settings settings;
+	settings.lines = 200;
+	settings.rounds = 1;
+
+	uint64_t checksum = run(settings, false).checksum;
+	CHECK(checksum > 0);
+	CHECK(run(settings, true).checksum == checksum);
+}
+
+} // namespace TestStringBenchmark
+
+#endif // TEST_STRING_BENCHMARK_H
@@ -0,0 +1,176 @@
+/*************************************************************************/
+/*  test_string_name.h                                                   */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_STRING_NAME_H
+#define TEST_STRING_NAME_H
+
+#include "core/os/os.h"
+#include "core/os/thread.h"
+#include "core/string/string_name.h"
+#include "core/templates/vector.h"
+
+#include "tests/test_macros.h"
+
+namespace TestStringName {
+
+TEST_CASE("[StringName] Equal names share their data") {
+	StringName from_cstring("test_string_name_unique");
+	StringName from_string(String("test_string_name_unique"));
+	StringName from_static = StaticCString::create("test_string_name_unique");
+	StringName other("test_string_name_other");
+
+	CHECK(from_cstring == from_string);
+	CHECK(from_cstring == from_static);
+	CHECK(from_cstring.data_unique_pointer() == from_string.data_unique_pointer());
+	CHECK(from_cstring != other);
+	CHECK(String(from_static) == "test_string_name_unique");
+
+	CHECK(StringName::search("test_string_name_unique") == from_cstring);
+	CHECK(StringName::search(String("test_string_name_other")) == other);
+	CHECK(StringName::search(U"test_string_name_other") == other);
+	CHECK(StringName::search("test_string_name_missing") == StringName());
+}
+
+TEST_CASE("[StringName] Released names are removed") {
+	{
+		StringName name("test_string_name_released");
+		StringName copy = name;
+		CHECK(StringName::search("test_string_name_released") == name);
+	}
+	CHECK(StringName::search("test_string_name_released") == StringName());
+
+	// Interning it again gives a working name.
+	StringName name("test_string_name_released");
+	CHECK(StringName::search("test_string_name_released") == name);
+}
+
+TEST_CASE("[StringName] Many names stay searchable") {
+	// Enough names to grow the table well past its initial size.
+	const int count = 50000;
+	Vector<StringName> names;
+	names.resize(count);
+	for (int i = 0; i < count; i++) {
+		names.write[i] = StringName("test_string_name_" + itos(i));
+	}
+
+	int found = 0;
+	for (int i = 0; i < count; i++) {
+		if (StringName::search("test_string_name_" + itos(i)) == names[i] && StringName(String("test_string_name_" + itos(i))) == names[i]) {
+			found++;
+		}
+	}
+	CHECK(found == count);
+
+	names.clear();
+	CHECK(StringName::search("test_string_name_0") == StringName());
+	CHECK(StringName::search("test_string_name_" + itos(count - 1)) == StringName());
+}
+
+#if !defined(NO_THREADS)
+
+struct InternThreadData {
+	int thread_index = 0;
+	int name_count = 0;
+	int iterations = 0;
+	Vector<StringName> shared; // Kept alive until the main thread has compared them.
+};
+
+// Interns names shared by all threads and names only this thread uses, releasing and creating
+// them again on every iteration, which hits both the lookup and the insert and remove paths.
+static void intern_thread(void *p_userdata) {
+	InternThreadData *data = static_cast<InternThreadData *>(p_userdata);
+	data->shared.resize(data->name_count);
+
+	for (int i = 0; i < data->iterations; i++) {
+		Vector<StringName> own;
+		own.resize(data->name_count);
+		for (int j = 0; j < data->name_count; j++) {
+			data->shared.write[j] = StringName("test_string_name_shared_" + itos(j));
+			own.write[j] = StringName("test_string_name_thread_" + itos(data->thread_index) + "_" + itos(j));
+		}
+	}
+}
+
+static uint64_t run_intern_threads(int p_thread_count, int p_name_count, int p_iterations, bool &r_unique) {
+	Vector<InternThreadData> data;
+	data.resize(p_thread_count);
+	for (int i = 0; i < p_thread_count; i++) {
+		data.write[i].thread_index = i;
+		data.write[i].name_count = p_name_count;
+		data.write[i].iterations = p_iterations;
+	}
+
+	uint64_t from = OS::get_singleton()->get_ticks_usec();
+	Vector<Thread *> threads;
+	for (int i = 0; i < p_thread_count; i++) {
+		threads.push_back(Thread::create(intern_thread, &data.write[i]));
+	}
+	for (int i = 0; i < p_thread_count; i++) {
+		Thread::wait_to_finish(threads[i]);
+		memdelete(threads[i]);
+	}
+	uint64_t usec = OS::get_singleton()->get_ticks_usec() - from;
+
+	r_unique = true;
+	for (int i = 1; i < p_thread_count; i++) {
+		for (int j = 0; j < p_name_count; j++) {
+			if (data[i].shared[j].data_unique_pointer() != data[0].shared[j].data_unique_pointer()) {
+				r_unique = false;
+			}
+		}
+	}
+	return usec;
+}
+
+TEST_CASE("[StringName] Names interned from many threads are unique") {
+	bool unique = false;
+	run_intern_threads(8, 500, 20, unique);
+	CHECK_MESSAGE(unique, "All threads should get the same data for the same name.");
+	CHECK(StringName::search("test_string_name_shared_0") == StringName());
+}
+
+TEST_CASE("[Stress][StringName] Interning contention") {
+	const int name_count = 2000;
+	const int iterations = 50;
+	int thread_count = MAX(OS::get_singleton()->get_processor_count(), 2);
+
+	bool unique = false;
+	uint64_t single_usec = run_intern_threads(1, name_count, iterations, unique);
+	uint64_t threaded_usec = run_intern_threads(thread_count, name_count, iterations, unique);
+	CHECK(unique);
+
+	MESSAGE("1 thread: ", single_usec, " usec, ", thread_count, " threads: ", threaded_usec, " usec (", name_count * iterations * 2, " names interned per thread).");
+}
+
+#endif // !defined(NO_THREADS)
+
+} // namespace TestStringName
+
+#endif // TEST_STRING_NAME_H
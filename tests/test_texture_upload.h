@@ -0,0 +1,169 @@
+/*************************************************************************/
+/*  test_texture_upload.h                                                */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_TEXTURE_UPLOAD_H
+#define TEST_TEXTURE_UPLOAD_H
+
+#include "core/io/image.h"
+#include "core/io/resource_loader.h"
+#include "core/io/resource_saver.h"
+#include "core/os/dir_access.h"
+#include "core/os/memory.h"
+#include "core/os/os.h"
+#include "drivers/dummy/rasterizer_dummy.h"
+#include "scene/resources/texture.h"
+#include "servers/rendering/rendering_server_default.h"
+
+#include "thirdparty/doctest/doctest.h"
+
+namespace TestTextureUpload {
+
+// A RenderingServer on top of the dummy rasterizer, so textures take the same
+// path from ImageTexture to the storage as in a running project.
+struct DummyRenderingServer {
+	RenderingServer *rendering_server = nullptr;
+
+	DummyRenderingServer() {
+		RasterizerDummy::make_current();
+		rendering_server = memnew(RenderingServerDefault);
+	}
+
+	~DummyRenderingServer() {
+		memdelete(rendering_server);
+	}
+};
+
+static bool shares_data(const Ref<Image> &p_a, const Ref<Image> &p_b) {
+	return p_a->get_data().ptr() == p_b->get_data().ptr();
+}
+
+static Ref<Image> create_test_image(int p_size) {
+	Vector<uint8_t> data;
+	data.resize(p_size * p_size * 4);
+	uint8_t *w = data.ptrw();
+	for (int i = 0; i < data.size(); i++) {
+		w[i] = i & 0xFF;
+	}
+	Ref<Image> image;
+	image.instance();
+	image->create(p_size, p_size, false, Image::FORMAT_RGBA8, data);
+	return image;
+}
+
+TEST_CASE("[TextureUpload] ImageTexture hands the image data to the storage without copying") {
+	DummyRenderingServer server;
+	Ref<Image> image = create_test_image(64);
+
+	{
+		Ref<ImageTexture> texture;
+		texture.instance();
+		texture->create_from_image(image);
+		REQUIRE(texture->get_rid().is_valid());
+
+		Ref<Image> stored = RSG::storage->texture_2d_get(texture->get_rid());
+		REQUIRE(stored.is_valid());
+		CHECK_MESSAGE(
+				shares_data(image, stored),
+				"Creating a texture should share the image data instead of copying it.");
+
+		Ref<Image> updated_image = create_test_image(64);
+		texture->update(updated_image);
+		CHECK_MESSAGE(
+				shares_data(updated_image, RSG::storage->texture_2d_get(texture->get_rid())),
+				"Updating a texture should share the image data instead of copying it.");
+
+		// Creating it again replaces the texture behind the same RID.
+		Ref<Image> replacement_image = create_test_image(8);
+		texture->create_from_image(replacement_image);
+		CHECK_MESSAGE(
+				shares_data(replacement_image, RSG::storage->texture_2d_get(texture->get_rid())),
+				"Replacing a texture should share the image data instead of copying it.");
+		CHECK(texture->get_width() == 8);
+	}
+}
+
+TEST_CASE("[TextureUpload] Loaded textures keep a single copy of the decoded data") {
+	DummyRenderingServer server;
+	const int size = 512;
+	const String save_path = OS::get_singleton()->get_cache_path().plus_file("texture_upload.res");
+
+	{
+		Ref<ImageTexture> texture;
+		texture.instance();
+		texture->create_from_image(create_test_image(size));
+		REQUIRE(ResourceSaver::save(save_path, texture) == OK);
+	}
+
+#ifdef DEBUG_ENABLED
+	const uint64_t mem_before = Memory::get_mem_usage();
+#endif
+	{
+		// Load it the way the editor and games do, decoding in a loader thread.
+		REQUIRE(ResourceLoader::load_threaded_request(save_path) == OK);
+		Error err = FAILED;
+		Ref<ImageTexture> loaded = ResourceLoader::load_threaded_get(save_path, &err);
+		REQUIRE(err == OK);
+		REQUIRE(loaded.is_valid());
+
+		Ref<Image> stored = RSG::storage->texture_2d_get(loaded->get_rid());
+		REQUIRE(stored.is_valid());
+		CHECK(stored->get_width() == size);
+		CHECK(stored->get_pixel(3, 5) == create_test_image(size)->get_pixel(3, 5));
+
+		// The image is a sub-resource of the texture, cached under its path while the storage references it.
+		Ref<Image> decoded;
+		List<Ref<Resource>> cached;
+		ResourceCache::get_cached_resources(&cached);
+		for (List<Ref<Resource>>::Element *E = cached.front(); E; E = E->next()) {
+			if (E->get()->get_path().begins_with(save_path + "::") && Object::cast_to<Image>(E->get().ptr())) {
+				decoded = E->get();
+			}
+		}
+		REQUIRE(decoded.is_valid());
+		CHECK_MESSAGE(
+				shares_data(decoded, stored),
+				"The storage should keep the image decoded by the loader instead of a copy.");
+
+#ifdef DEBUG_ENABLED
+		// The file buffer is gone once loaded, only the pixels the storage keeps remain.
+		const int64_t image_bytes = size * size * 4;
+		const int64_t mem_used = int64_t(Memory::get_mem_usage()) - int64_t(mem_before);
+		CHECK_MESSAGE(
+				mem_used < image_bytes * 3 / 2,
+				"Loading a texture should not keep more than one copy of its pixels.");
+#endif
+	}
+
+	DirAccess::remove_file_or_error(save_path);
+}
+
+} // namespace TestTextureUpload
+
+#endif // TEST_TEXTURE_UPLOAD_H